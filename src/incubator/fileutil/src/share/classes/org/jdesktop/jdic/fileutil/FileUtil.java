@@ -60,6 +60,8 @@ public class FileUtil {
 		
 		private File directory;
 		
+		private String directoryPath;
+		
 		private boolean firstRead;
 		
 		private NativeFileUtil internalFileUtil;
@@ -72,28 +74,31 @@ public class FileUtil {
 		}
 
 		public boolean hasNext() throws IOException {
-			if(this.directory.isDirectory()) {
-				String name;
-				if(this.firstRead) {
-					name = this.internalFileUtil.readFirst(this.directory.getCanonicalPath());
-					this.firstRead = false;
-					this.closed = false;
-				}
-				else {
-					name = this.internalFileUtil.readNext();
-				}
-				
-				if(name != null) {
-					this.nextFile = new File(this.directory.getCanonicalPath() + name);
-					return true;
-				}
-				else {
-					this.nextFile = null;
-					this.close(); // to save resources
+			String name;
+			if(this.firstRead) {
+				this.firstRead = false;
+				if(!this.directory.isDirectory()) {
 					return false;
 				}
+				// resolved once, not for every entry
+				this.directoryPath = this.directory.getCanonicalPath();
+				name = this.internalFileUtil.readFirst(this.directoryPath);
+				this.closed = false;
+			}
+			else if(this.closed) {
+				return false;
 			}
 			else {
+				name = this.internalFileUtil.readNext();
+			}
+			
+			if(name != null) {
+				this.nextFile = new File(this.directoryPath + name);
+				return true;
+			}
+			else {
+				this.nextFile = null;
+				this.close(); // to save resources
 				return false;
 			}
 		}
@@ -129,17 +134,12 @@ public class FileUtil {
 		}
 
 		public boolean hasNext() throws IOException {
-			if(super.hasNext()) {
+			while(super.hasNext()) {
 				if(this.filter.accept(this.next())) {
 					return true;
 				}
-				else {
-					return this.hasNext();
-				}
-			}
-			else {
-				return false;
 			}
+			return false;
 		}		
 	}
 	
@@ -156,17 +156,12 @@ public class FileUtil {
 		}
 
 		public boolean hasNext() throws IOException {
-			if(super.hasNext()) {
+			while(super.hasNext()) {
 				if(this.filter.accept(this.directory, this.next().getName())) {
 					return true;
 				}
-				else {
-					return this.hasNext();
-				}
-			}
-			else {
-				return false;
 			}
+			return false;
 		}		
 	}
     
@@ -245,5 +240,26 @@ public class FileUtil {
     public FileIterator listFiles(FilenameFilter filter) {
     	return new InnerFilenameFilterIterator(filter);
     }
+    
+    /**
+     * Returns a FileIterator object, used to traverse all the files below the 
+     * directory denoted by the File argument, at any depth. Directories are 
+     * read by several native threads, and only the entries that pass the filters 
+     * of the options cross into Java. The files will not be in any particular
+     * order.
+     * <p>
+     * The FileIterator should be closed when it isn't read to the end, to stop 
+     * the threads.
+     * 
+     * @param root the directory to walk.
+     * @param options the filters and options of the walk.
+     * @return a FileIterator object.
+     * @throws IOException If the directory can't be read.
+     * @throws UnsupportedOperationException if the method isn't supported in the specific platform.
+     */
+    public static FileIterator walk(File root, WalkOptions options) throws IOException, 
+            UnsupportedOperationException {
+    	return NativeFileUtil.getNativeFileUtil().walk(root.getCanonicalPath(), options);
+    }
 
 }
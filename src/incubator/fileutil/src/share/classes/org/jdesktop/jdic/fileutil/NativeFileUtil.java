@@ -100,4 +100,17 @@ abstract class NativeFileUtil {
     
     public abstract void close();    
 
+    /**
+     * Returns a FileIterator over the entries below a directory, at any depth.
+     * 
+     * @param fullPath the canonical path of the directory.
+     * @param options the filters and options of the walk.
+     * @return a FileIterator object.
+     * @throws IOException If the directory can't be read.
+     * @throws UnsupportedOperationException if the method isn't supported in the specific platform.
+     */
+    public FileIterator walk(String fullPath, WalkOptions options) throws IOException, UnsupportedOperationException {
+    	throw new UnsupportedOperationException("Your platform doesn't support this method");
+    }
+
 }
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2005 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+package org.jdesktop.jdic.fileutil;
+
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * Options of a recursive directory walk. The filters are evaluated by native
+ * code, so the entries they reject never reach Java.
+ * <p>
+ * Directories are always traversed, within the maximum depth. An entry is
+ * returned only if it passes all the filters that are set: its name must
+ * match one of the glob patterns or extensions, if there are any, and its
+ * size and modification time must lie within the given bounds. The size
+ * bounds apply to files only.
+ *
+ * @see FileUtil#walk(java.io.File, WalkOptions)
+ */
+public class WalkOptions {
+
+	private int maxDepth = -1;
+
+	private boolean followLinks;
+
+	private boolean oneFileSystem;
+
+	private boolean includeDirectories;
+
+	private List globs = new ArrayList();
+
+	private List extensions = new ArrayList();
+
+	private long minSize = -1;
+
+	private long maxSize = -1;
+
+	private long modifiedAfter = -1;
+
+	private long modifiedBefore = -1;
+
+	private int threads;
+
+	/**
+	 * Creates options that return every file below the root.
+	 */
+	public WalkOptions() {
+	}
+
+	/**
+	 * Sets the maximum depth of the returned entries. The entries of the root
+	 * have depth 1. A negative depth means that there is no limit, which is
+	 * the default.
+	 */
+	public void setMaxDepth(int maxDepth) {
+		this.maxDepth = maxDepth;
+	}
+
+	public int getMaxDepth() {
+		return this.maxDepth;
+	}
+
+	/**
+	 * Sets whether symbolic links to directories are traversed. Each directory
+	 * is traversed at most once, so links can't make the walk loop. By default
+	 * links are returned as entries, but not followed.
+	 */
+	public void setFollowLinks(boolean followLinks) {
+		this.followLinks = followLinks;
+	}
+
+	public boolean getFollowLinks() {
+		return this.followLinks;
+	}
+
+	/**
+	 * Sets whether the walk stays on the file system of the root. Directories
+	 * on which other file systems are mounted are returned, but not traversed.
+	 */
+	public void setOneFileSystem(boolean oneFileSystem) {
+		this.oneFileSystem = oneFileSystem;
+	}
+
+	public boolean getOneFileSystem() {
+		return this.oneFileSystem;
+	}
+
+	/**
+	 * Sets whether directories are returned as well as files. They are not
+	 * returned by default.
+	 */
+	public void setIncludeDirectories(boolean includeDirectories) {
+		this.includeDirectories = includeDirectories;
+	}
+
+	public boolean getIncludeDirectories() {
+		return this.includeDirectories;
+	}
+
+	/**
+	 * Adds a shell glob pattern, such as "*.txt" or "report-??.pdf", which is
+	 * matched against the names of entries.
+	 */
+	public void addGlob(String pattern) {
+		this.globs.add(pattern);
+	}
+
+	public String[] getGlobs() {
+		return (String[]) this.globs.toArray(new String[this.globs.size()]);
+	}
+
+	/**
+	 * Adds an extension, such as "txt", which is matched against the names of
+	 * entries regardless of case.
+	 */
+	public void addExtension(String extension) {
+		this.extensions.add(extension.startsWith(".") ? extension.substring(1) : extension);
+	}
+
+	public String[] getExtensions() {
+		return (String[]) this.extensions.toArray(new String[this.extensions.size()]);
+	}
+
+	/**
+	 * Sets the minimum size in bytes of returned files, or -1 for none.
+	 */
+	public void setMinSize(long minSize) {
+		this.minSize = minSize;
+	}
+
+	public long getMinSize() {
+		return this.minSize;
+	}
+
+	/**
+	 * Sets the maximum size in bytes of returned files, or -1 for none.
+	 */
+	public void setMaxSize(long maxSize) {
+		this.maxSize = maxSize;
+	}
+
+	public long getMaxSize() {
+		return this.maxSize;
+	}
+
+	/**
+	 * Only entries modified at or after this time are returned. The time is
+	 * measured in milliseconds since the epoch, as by File.lastModified(); -1
+	 * for no bound.
+	 */
+	public void setModifiedAfter(long time) {
+		this.modifiedAfter = time;
+	}
+
+	public long getModifiedAfter() {
+		return this.modifiedAfter;
+	}
+
+	/**
+	 * Only entries modified before this time are returned. The time is
+	 * measured in milliseconds since the epoch, as by File.lastModified(); -1
+	 * for no bound.
+	 */
+	public void setModifiedBefore(long time) {
+		this.modifiedBefore = time;
+	}
+
+	public long getModifiedBefore() {
+		return this.modifiedBefore;
+	}
+
+	/**
+	 * Sets the number of threads traversing directories. 0, the default, uses
+	 * one thread for each available processor.
+	 */
+	public void setThreads(int threads) {
+		this.threads = threads;
+	}
+
+	public int getThreads() {
+		return this.threads;
+	}
+
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2005 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+package org.jdesktop.jdic.fileutil;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * An open directory, read in batches of entries.
+ * <p>
+ * Each call into native code fills a direct buffer with as many entries as
+ * fit. An entry is laid out in native byte order as its inode number
+ * (8 bytes), the length of its name (2 bytes), its type (1 byte) and the
+ * bytes of its name. The entries "." and ".." are left out.
+ */
+class UnixDirectory {
+
+	static final int TYPE_UNKNOWN = 0;
+	static final int TYPE_FILE = 1;
+	static final int TYPE_DIRECTORY = 2;
+	static final int TYPE_SYMLINK = 3;
+	static final int TYPE_OTHER = 4;
+
+	private static final int BUFFER_SIZE = 32 * 1024;
+
+	private static final int HEADER_SIZE = 11;
+
+	private long handle;
+
+	private final ByteBuffer buffer;
+
+	private int offset;
+
+	private int remaining;
+
+	private byte[] nameBytes = new byte[256];
+
+	private char[] nameChars = new char[256];
+
+	private String name;
+
+	private int type;
+
+	private long inode;
+
+	private UnixDirectory(long handle) {
+		this.handle = handle;
+		this.buffer = ByteBuffer.allocateDirect(BUFFER_SIZE);
+		this.buffer.order(ByteOrder.nativeOrder());
+	}
+
+	/**
+	 * Opens a directory.
+	 *
+	 * @param fullPath the path of the directory.
+	 * @return the open directory, or null if it can't be opened.
+	 */
+	static UnixDirectory open(String fullPath) {
+		long handle = openDirectory(fullPath);
+		return handle == 0 ? null : new UnixDirectory(handle);
+	}
+
+	/**
+	 * Advances to the next entry of the directory.
+	 *
+	 * @return false if there are no more entries, or they can't be read.
+	 */
+	boolean next() {
+		if (this.remaining == 0) {
+			if (this.handle == 0) {
+				return false;
+			}
+			int count = readDirectory(this.handle, this.buffer);
+			if (count <= 0) {
+				this.close();
+				return false;
+			}
+			this.remaining = count;
+			this.offset = 0;
+		}
+
+		this.inode = this.buffer.getLong(this.offset);
+		int length = this.buffer.getShort(this.offset + 8) & 0xffff;
+		this.type = this.buffer.get(this.offset + 10);
+		this.buffer.position(this.offset + HEADER_SIZE);
+		this.offset += HEADER_SIZE + length;
+		this.remaining--;
+
+		if (length > this.nameBytes.length) {
+			this.nameBytes = new byte[length];
+			this.nameChars = new char[length];
+		}
+		this.buffer.get(this.nameBytes, 0, length);
+		this.name = decode(this.nameBytes, this.nameChars, length);
+		return true;
+	}
+
+	/**
+	 * Returns the name of the current entry.
+	 */
+	String getName() {
+		return this.name;
+	}
+
+	/**
+	 * Returns the type of the current entry, one of the TYPE constants.
+	 * TYPE_UNKNOWN is returned if the file system doesn't report types.
+	 */
+	int getType() {
+		return this.type;
+	}
+
+	/**
+	 * Returns the inode number of the current entry.
+	 */
+	long getInode() {
+		return this.inode;
+	}
+
+	/**
+	 * Closes the directory. Closing a closed directory has no effect.
+	 */
+	void close() {
+		if (this.handle != 0) {
+			closeDirectory(this.handle);
+			this.handle = 0;
+		}
+		this.remaining = 0;
+	}
+
+	protected void finalize() throws Throwable {
+		this.close();
+	}
+
+	/**
+	 * Decodes a file name. Most names are ASCII, which is decoded without 
+	 * going through a charset.
+	 * 
+	 * @param bytes the bytes of the name.
+	 * @param chars room for at least length chars.
+	 */
+	static String decode(byte[] bytes, char[] chars, int length) {
+		for (int i = 0; i < length; i++) {
+			byte b = bytes[i];
+			if (b < 0) {
+				return new String(bytes, 0, length);
+			}
+			chars[i] = (char) b;
+		}
+		return new String(chars, 0, length);
+	}
+
+	private static native long openDirectory(String fullPath);
+
+	private static native int readDirectory(long handle, ByteBuffer buffer);
+
+	private static native void closeDirectory(long handle);
+
+}
@@ -36,7 +36,7 @@ class UnixNativeFileUtil extends NativeFileUtil {
     	System.loadLibrary("jdic_fileutil");
     }
 	
-	private int handle;
+	private UnixDirectory directory;
 	
 	/**
      * This method isn't supported on Linux. It will throw an UnsupportedOperationException.
@@ -94,39 +94,31 @@ class UnixNativeFileUtil extends NativeFileUtil {
 	}
     
     public void close() {
-    	this.findClose();
+		if(this.directory != null) {
+			this.directory.close();
+			this.directory = null;
+		}
 	}
 
 	public String readFirst(String fullPath) {
-		String path = this.findFirst(fullPath);
-		if(path != null) {
-			if(path.equals(".") || path.equals("..")) {
-				path = this.readNext();
-			}
-			path = File.separator + path;
-		}
-		return path;
+		this.close();
+		this.directory = UnixDirectory.open(fullPath);
+		return this.readNext();
 	}
 
 	public String readNext() {
-		String path = this.findNext();
-		if(path != null) {
-			if(path.equals(".") || path.equals("..")) {
-				path = this.findNext();
-			}
-			path = File.separator + path;
+		if(this.directory == null || !this.directory.next()) {
+			return null;
 		}
-		return path;
+		return File.separator + this.directory.getName();
+	}
+
+	public FileIterator walk(String fullPath, WalkOptions options) throws IOException {
+		return new UnixWalker(fullPath, options);
 	}
 
 	private native long getFreeSpace(String fullPath);
 	
 	private native long getTotalSpace(String fullPath);
-	
-	private native String findFirst(String fullPath);
-	
-	private native String findNext();
-	
-	private native boolean findClose();
 
 }
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2005 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+package org.jdesktop.jdic.fileutil;
+
+import java.io.File;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.NoSuchElementException;
+
+/**
+ * A recursive walk over a directory tree, done by a pool of native threads.
+ * <p>
+ * The threads take directories from each other's queues when their own run
+ * dry, evaluate the filters of the walk, and hand the paths that pass to
+ * Java in batches. A batch is laid out in native byte order as, for each
+ * path, its length in bytes (4 bytes) followed by its bytes.
+ */
+class UnixWalker implements FileIterator {
+
+	/* keep in sync with BATCH_SIZE in UnixWalker.c */
+	private static final int BATCH_SIZE = 64 * 1024;
+
+	private static final int FOLLOW_LINKS = 1;
+	private static final int ONE_FILE_SYSTEM = 2;
+	private static final int INCLUDE_DIRECTORIES = 4;
+
+	private long handle;
+
+	private final ByteBuffer buffer;
+
+	private int offset;
+
+	private int remaining;
+
+	private byte[] pathBytes = new byte[1024];
+
+	private char[] pathChars = new char[1024];
+
+	private File nextFile;
+
+	/**
+	 * Starts walking a directory.
+	 *
+	 * @param fullPath the canonical path of the directory.
+	 * @param options the filters and options of the walk.
+	 * @throws IOException If the directory can't be opened.
+	 */
+	UnixWalker(String fullPath, WalkOptions options) throws IOException {
+		int flags = 0;
+		if (options.getFollowLinks()) {
+			flags |= FOLLOW_LINKS;
+		}
+		if (options.getOneFileSystem()) {
+			flags |= ONE_FILE_SYSTEM;
+		}
+		if (options.getIncludeDirectories()) {
+			flags |= INCLUDE_DIRECTORIES;
+		}
+
+		int threads = options.getThreads();
+		if (threads <= 0) {
+			threads = Runtime.getRuntime().availableProcessors();
+		}
+
+		this.handle = start(fullPath, flags, options.getMaxDepth(),
+				options.getGlobs(), options.getExtensions(),
+				options.getMinSize(), options.getMaxSize(),
+				options.getModifiedAfter(), options.getModifiedBefore(),
+				threads);
+		if (this.handle == 0) {
+			throw new IOException("Can't read the directory " + fullPath);
+		}
+
+		this.buffer = ByteBuffer.allocateDirect(BATCH_SIZE);
+		this.buffer.order(ByteOrder.nativeOrder());
+	}
+
+	public boolean hasNext() throws IOException {
+		if (this.remaining == 0) {
+			if (this.handle == 0) {
+				this.nextFile = null;
+				return false;
+			}
+			int count = next(this.handle, this.buffer);
+			if (count <= 0) {
+				this.nextFile = null;
+				this.close(); // to save resources
+				return false;
+			}
+			this.remaining = count;
+			this.offset = 0;
+		}
+
+		int length = this.buffer.getInt(this.offset);
+		this.buffer.position(this.offset + 4);
+		this.offset += 4 + length;
+		this.remaining--;
+
+		if (length > this.pathBytes.length) {
+			this.pathBytes = new byte[length];
+			this.pathChars = new char[length];
+		}
+		this.buffer.get(this.pathBytes, 0, length);
+		this.nextFile = new File(UnixDirectory.decode(this.pathBytes, this.pathChars, length));
+		return true;
+	}
+
+	public File next() throws NoSuchElementException {
+		if (this.nextFile == null) {
+			throw new NoSuchElementException();
+		}
+		return this.nextFile;
+	}
+
+	/**
+	 * Stops the walk, waiting for its threads to finish.
+	 */
+	public void close() {
+		if (this.handle != 0) {
+			stop(this.handle);
+			this.handle = 0;
+		}
+		this.remaining = 0;
+	}
+
+	protected void finalize() throws Throwable {
+		this.close();
+	}
+
+	private static native long start(String fullPath, int flags, int maxDepth,
+			String[] globs, String[] extensions, long minSize, long maxSize,
+			long modifiedAfter, long modifiedBefore, int threads);
+
+	private static native int next(long handle, ByteBuffer buffer);
+
+	private static native void stop(long handle);
+
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2005 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+#include <jni.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/types.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#include "UnixDirectory.h"
+
+/*
+ * Directories are read in batches into the direct buffer of a
+ * UnixDirectory. Each entry is written as its inode number (8 bytes), the
+ * length of its name (2 bytes), its type (1 byte) and its name, without
+ * padding, in native byte order. On Linux the entries come from
+ * getdents64(), many to a system call; elsewhere from readdir().
+ */
+
+#if defined(__linux__) && defined(SYS_getdents64)
+#define USE_GETDENTS64
+#endif
+
+#define HEADER_SIZE 11
+#define KERNEL_BUFFER_SIZE (32 * 1024)
+
+/* keep in sync with the TYPE constants of UnixDirectory */
+#define TYPE_UNKNOWN 0
+#define TYPE_FILE 1
+#define TYPE_DIRECTORY 2
+#define TYPE_SYMLINK 3
+#define TYPE_OTHER 4
+
+#ifdef USE_GETDENTS64
+struct linux_dirent64 {
+    unsigned long long d_ino;
+    long long d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+#endif
+
+typedef struct {
+#ifdef USE_GETDENTS64
+    int fd;
+    size_t pos;
+    size_t end;
+    long long kernel[KERNEL_BUFFER_SIZE / sizeof(long long)];
+#else
+    DIR *dir;
+    struct dirent *pending;     /* read, but didn't fit into the last batch */
+#endif
+} DirectoryHandle;
+
+static jbyte mapType(unsigned char type) {
+    switch (type) {
+    case DT_UNKNOWN:
+        return TYPE_UNKNOWN;
+    case DT_REG:
+        return TYPE_FILE;
+    case DT_DIR:
+        return TYPE_DIRECTORY;
+    case DT_LNK:
+        return TYPE_SYMLINK;
+    default:
+        return TYPE_OTHER;
+    }
+}
+
+static int isDotOrDotDot(const char *name) {
+    return name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0));
+}
+
+/*
+ * Appends an entry to the batch. Returns 0 if it doesn't fit.
+ */
+static int putEntry(char *out, size_t capacity, size_t *used,
+        unsigned long long ino, unsigned char type, const char *name) {
+    size_t length = strlen(name);
+    jlong inode = (jlong) ino;
+    unsigned short nameLength = (unsigned short) length;
+    jbyte entryType = mapType(type);
+    char *p = out + *used;
+
+    if (length > 0xffff || HEADER_SIZE + length > capacity - *used) {
+        return 0;
+    }
+    memcpy(p, &inode, 8);
+    memcpy(p + 8, &nameLength, 2);
+    memcpy(p + 10, &entryType, 1);
+    memcpy(p + HEADER_SIZE, name, length);
+    *used += HEADER_SIZE + length;
+    return 1;
+}
+
+/*
+ * Class:     org_jdesktop_jdic_fileutil_UnixDirectory
+ * Method:    openDirectory
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_fileutil_UnixDirectory_openDirectory
+  (JNIEnv *env, jclass cls, jstring fullPath) {
+    DirectoryHandle *handle;
+    const char *cpFullPath = (*env)->GetStringUTFChars(env, fullPath, NULL);
+    if (cpFullPath == NULL) {
+        return 0;
+    }
+
+    handle = (DirectoryHandle *) malloc(sizeof(DirectoryHandle));
+    if (handle == NULL) {
+        (*env)->ReleaseStringUTFChars(env, fullPath, cpFullPath);
+        return 0;
+    }
+
+#ifdef USE_GETDENTS64
+    {
+        int flags = O_RDONLY;
+#ifdef O_DIRECTORY
+        flags |= O_DIRECTORY;
+#endif
+#ifdef O_CLOEXEC
+        flags |= O_CLOEXEC;
+#endif
+        handle->fd = open(cpFullPath, flags);
+        handle->pos = 0;
+        handle->end = 0;
+    }
+    (*env)->ReleaseStringUTFChars(env, fullPath, cpFullPath);
+    if (handle->fd < 0) {
+        free(handle);
+        return 0;
+    }
+#else
+    handle->dir = opendir(cpFullPath);
+    handle->pending = NULL;
+    (*env)->ReleaseStringUTFChars(env, fullPath, cpFullPath);
+    if (handle->dir == NULL) {
+        free(handle);
+        return 0;
+    }
+#endif
+
+    return (jlong) (size_t) handle;
+}
+
+/*
+ * Class:     org_jdesktop_jdic_fileutil_UnixDirectory
+ * Method:    readDirectory
+ * Signature: (JLjava/nio/ByteBuffer;)I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_fileutil_UnixDirectory_readDirectory
+  (JNIEnv *env, jclass cls, jlong jHandle, jobject buffer) {
+    DirectoryHandle *handle = (DirectoryHandle *) (size_t) jHandle;
+    char *out = (char *) (*env)->GetDirectBufferAddress(env, buffer);
+    jlong capacity = (*env)->GetDirectBufferCapacity(env, buffer);
+    size_t used = 0;
+    jint count = 0;
+
+    if (handle == NULL || out == NULL || capacity <= 0) {
+        return -1;
+    }
+
+#ifdef USE_GETDENTS64
+    for (;;) {
+        struct linux_dirent64 *entry;
+
+        if (handle->pos >= handle->end) {
+            long n = syscall(SYS_getdents64, handle->fd, handle->kernel, sizeof(handle->kernel));
+            if (n <= 0) {
+                return (n < 0 && count == 0) ? -1 : count;
+            }
+            handle->pos = 0;
+            handle->end = (size_t) n;
+        }
+
+        entry = (struct linux_dirent64 *) ((char *) handle->kernel + handle->pos);
+        if (!isDotOrDotDot(entry->d_name)) {
+            if (!putEntry(out, (size_t) capacity, &used, entry->d_ino, entry->d_type, entry->d_name)) {
+                return count > 0 ? count : -1;
+            }
+            count++;
+        }
+        handle->pos += entry->d_reclen;
+    }
+#else
+    for (;;) {
+        struct dirent *entry = handle->pending;
+        handle->pending = NULL;
+        if (entry == NULL) {
+            entry = readdir(handle->dir);
+            if (entry == NULL) {
+                return count;
+            }
+        }
+
+        if (!isDotOrDotDot(entry->d_name)) {
+#ifdef _DIRENT_HAVE_D_TYPE
+            unsigned char type = entry->d_type;
+#else
+            unsigned char type = DT_UNKNOWN;
+#endif
+            if (!putEntry(out, (size_t) capacity, &used, entry->d_ino, type, entry->d_name)) {
+                handle->pending = entry;
+                return count > 0 ? count : -1;
+            }
+            count++;
+        }
+    }
+#endif
+}
+
+/*
+ * Class:     org_jdesktop_jdic_fileutil_UnixDirectory
+ * Method:    closeDirectory
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_fileutil_UnixDirectory_closeDirectory
+  (JNIEnv *env, jclass cls, jlong jHandle) {
+    DirectoryHandle *handle = (DirectoryHandle *) (size_t) jHandle;
+    if (handle == NULL) {
+        return;
+    }
+
+#ifdef USE_GETDENTS64
+    close(handle->fd);
+#else
+    closedir(handle->dir);
+#endif
+    free(handle);
+}
@@ -0,0 +1,51 @@
+/* DO NOT EDIT THIS FILE - it is machine generated */
+#include <jni.h>
+/* Header for class org_jdesktop_jdic_fileutil_UnixDirectory */
+
+#ifndef _Included_org_jdesktop_jdic_fileutil_UnixDirectory
+#define _Included_org_jdesktop_jdic_fileutil_UnixDirectory
+#ifdef __cplusplus
+extern "C" {
+#endif
+#undef org_jdesktop_jdic_fileutil_UnixDirectory_TYPE_UNKNOWN
+#define org_jdesktop_jdic_fileutil_UnixDirectory_TYPE_UNKNOWN 0L
+#undef org_jdesktop_jdic_fileutil_UnixDirectory_TYPE_FILE
+#define org_jdesktop_jdic_fileutil_UnixDirectory_TYPE_FILE 1L
+#undef org_jdesktop_jdic_fileutil_UnixDirectory_TYPE_DIRECTORY
+#define org_jdesktop_jdic_fileutil_UnixDirectory_TYPE_DIRECTORY 2L
+#undef org_jdesktop_jdic_fileutil_UnixDirectory_TYPE_SYMLINK
+#define org_jdesktop_jdic_fileutil_UnixDirectory_TYPE_SYMLINK 3L
+#undef org_jdesktop_jdic_fileutil_UnixDirectory_TYPE_OTHER
+#define org_jdesktop_jdic_fileutil_UnixDirectory_TYPE_OTHER 4L
+#undef org_jdesktop_jdic_fileutil_UnixDirectory_BUFFER_SIZE
+#define org_jdesktop_jdic_fileutil_UnixDirectory_BUFFER_SIZE 32768L
+#undef org_jdesktop_jdic_fileutil_UnixDirectory_HEADER_SIZE
+#define org_jdesktop_jdic_fileutil_UnixDirectory_HEADER_SIZE 11L
+/*
+ * Class:     org_jdesktop_jdic_fileutil_UnixDirectory
+ * Method:    openDirectory
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_fileutil_UnixDirectory_openDirectory
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_fileutil_UnixDirectory
+ * Method:    readDirectory
+ * Signature: (JLjava/nio/ByteBuffer;)I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_fileutil_UnixDirectory_readDirectory
+  (JNIEnv *, jclass, jlong, jobject);
+
+/*
+ * Class:     org_jdesktop_jdic_fileutil_UnixDirectory
+ * Method:    closeDirectory
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_fileutil_UnixDirectory_closeDirectory
+  (JNIEnv *, jclass, jlong);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -21,7 +21,6 @@
 #include <jni.h>
 #include <sys/statfs.h>
 #include <sys/types.h>
-#include <dirent.h>
 #include "UnixNativeFileUtil.h"
 
 /*
@@ -63,80 +62,3 @@ JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_fileutil_UnixNativeFileUtil_getTo
     
     return retorno;
 }
-
-JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_fileutil_UnixNativeFileUtil_findFirst
-  (JNIEnv *env, jobject obj, jstring fullPath) {
-    char* cpFullPath = (char*) (*env)->GetStringUTFChars(env, fullPath, NULL);
-    
-    jclass cls = (*env)->GetObjectClass(env, obj);
-    jfieldID fid= (*env)->GetFieldID(env, cls, "handle", "I");
-    
-    if (fid == NULL) {
-        return; /* failed to find the field */
-    }
-    jint handle = (*env)->GetIntField(env, obj, fid);
-    
-    struct dirent *pDirEntry;
-    
-    DIR *pDir = opendir(cpFullPath);
-    if(pDir == NULL) {
-        return NULL;
-    }
-    else {
-        pDirEntry = readdir(pDir);
-        if(pDirEntry == NULL) {
-            return NULL;
-        }
-        else {
-            handle = (jint) pDir;
-            (*env)->SetIntField(env, obj, fid, handle);
-            return (*env)->NewStringUTF(env, pDirEntry->d_name);
-        }          
-    }
-}
-  
-JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_fileutil_UnixNativeFileUtil_findNext
-  (JNIEnv *env, jobject obj) {
-    jclass cls = (*env)->GetObjectClass(env, obj);
-    jfieldID fid= (*env)->GetFieldID(env, cls, "handle", "I");
-    
-    if (fid == NULL) {
-        return; /* failed to find the field */
-    }
-    jint handle = (*env)->GetIntField(env, obj, fid);
-    
-    struct dirent *pDirEntry; 
-    DIR *pDir = (DIR*) handle;
-      
-    pDirEntry = readdir(pDir);
-        
-    if(pDirEntry == NULL) {
-        return NULL;
-    }
-    else {
-        handle = (jint) pDir;
-        (*env)->SetIntField(env, obj, fid, handle);
-        return (*env)->NewStringUTF(env, pDirEntry->d_name);;
-    }
-}
-  
-JNIEXPORT jboolean JNICALL Java_org_jdesktop_jdic_fileutil_UnixNativeFileUtil_findClose
-  (JNIEnv *env, jobject obj) {
-    jclass cls = (*env)->GetObjectClass(env, obj);
-    jfieldID fid = fid = (*env)->GetFieldID(env, cls, "handle", "I");
-    
-    if (fid == NULL) {
-        return; /* failed to find the field */
-    }
-    
-    jint handle = (*env)->GetIntField(env, obj, fid);
-    
-    DIR *pDir = (DIR*) handle;
-    
-    if(closedir(pDir) == 0) {
-        return JNI_TRUE;
-    }
-    else {
-        return JNI_FALSE;
-    }
-}
@@ -23,30 +23,6 @@ JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_fileutil_UnixNativeFileUtil_getFr
 JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_fileutil_UnixNativeFileUtil_getTotalSpace
   (JNIEnv *, jobject, jstring);
 
-/*
- * Class:     org_jdesktop_jdic_fileutil_UnixNativeFileUtil
- * Method:    findFirst
- * Signature: (Ljava/lang/String;)Ljava/lang/String;
- */
-JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_fileutil_UnixNativeFileUtil_findFirst
-  (JNIEnv *, jobject, jstring);
-
-/*
- * Class:     org_jdesktop_jdic_fileutil_UnixNativeFileUtil
- * Method:    findNext
- * Signature: ()Ljava/lang/String;
- */
-JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_fileutil_UnixNativeFileUtil_findNext
-  (JNIEnv *, jobject);
-
-/*
- * Class:     org_jdesktop_jdic_fileutil_UnixNativeFileUtil
- * Method:    findClose
- * Signature: ()Z
- */
-JNIEXPORT jboolean JNICALL Java_org_jdesktop_jdic_fileutil_UnixNativeFileUtil_findClose
-  (JNIEnv *, jobject);
-
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,828 @@
+/*
+ * Copyright (C) 2005 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+#include <jni.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "UnixWalker.h"
+
+/*
+ * A recursive directory walk over a pool of threads.
+ *
+ * Each directory still to be read is a Task. Every thread keeps its own
+ * queue of tasks: it adds the subdirectories it finds at the tail and takes
+ * its next task from the tail, so it goes depth first through the part of
+ * the tree it owns. A thread whose queue is empty steals from the head of
+ * another queue, which holds the oldest, and so usually the largest,
+ * subtrees.
+ *
+ * Subdirectories are opened with openat() relative to their parent, which
+ * stays open while any of its subdirectories is queued, and entries are
+ * examined with fstatat(), so paths are never resolved from the root. An
+ * entry is only stat()ed when its type isn't reported by the file system or
+ * a filter needs its size or modification time.
+ *
+ * Threads append the paths which pass the filters to batches of BATCH_SIZE
+ * bytes, each path as its length (4 bytes) followed by its bytes. Full
+ * batches are queued for Java; when MAX_BATCHES are queued, the threads wait
+ * for Java to catch up.
+ */
+
+/* keep in sync with UnixWalker.java */
+#define BATCH_SIZE (64 * 1024)
+#define FOLLOW_LINKS 1
+#define ONE_FILE_SYSTEM 2
+#define INCLUDE_DIRECTORIES 4
+
+#define MAX_BATCHES 16
+#define MAX_THREADS 64
+
+typedef struct Directory {
+    DIR *dir;
+    int fd;
+    int refs;
+} Directory;
+
+typedef struct Task {
+    struct Task *prev;
+    struct Task *next;
+    Directory *parent;          /* NULL for the root */
+    char *path;
+    size_t nameOffset;          /* of the name within path */
+    int depth;
+} Task;
+
+typedef struct Batch {
+    struct Batch *next;
+    jint count;
+    size_t used;
+    char data[BATCH_SIZE];
+} Batch;
+
+struct Walk;
+
+typedef struct Worker {
+    struct Walk *walk;
+    pthread_t thread;
+    pthread_mutex_t lock;       /* guards the queue */
+    Task *head;
+    Task *tail;
+    Batch *batch;
+    char *path;                 /* scratch space for the paths of entries */
+    size_t pathCapacity;
+} Worker;
+
+typedef struct Visited {
+    struct Visited *next;
+    dev_t dev;
+    ino_t ino;
+} Visited;
+
+typedef struct Walk {
+    int flags;
+    int maxDepth;
+    char **globs;
+    int globCount;
+    char **extensions;
+    int extensionCount;
+    jlong minSize;
+    jlong maxSize;
+    jlong modifiedAfter;
+    jlong modifiedBefore;
+    dev_t rootDev;
+
+    Worker *workers;
+    int threads;
+    int started;
+
+    pthread_mutex_t lock;       /* guards everything below */
+    pthread_cond_t workAvailable;
+    pthread_cond_t batchAvailable;
+    pthread_cond_t batchTaken;
+    int pending;                /* tasks queued or being read */
+    int queued;                 /* tasks queued */
+    int idle;
+    int finished;               /* threads which have exited */
+    int cancelled;              /* also read without the lock */
+    Batch *batchHead;
+    Batch *batchTail;
+    int batches;
+
+    Visited **visited;          /* directories, when links are followed */
+    size_t visitedBuckets;
+} Walk;
+
+static int isCancelled(Walk *walk) {
+    return __atomic_load_n(&walk->cancelled, __ATOMIC_RELAXED);
+}
+
+static void releaseDirectory(Directory *directory) {
+    if (directory != NULL && __sync_sub_and_fetch(&directory->refs, 1) == 0) {
+        closedir(directory->dir);
+        free(directory);
+    }
+}
+
+static void freeTask(Task *task) {
+    releaseDirectory(task->parent);
+    free(task->path);
+    free(task);
+}
+
+static Task *newTask(Directory *parent, const char *path, size_t length, size_t nameOffset, int depth) {
+    Task *task = (Task *) malloc(sizeof(Task));
+    if (task == NULL) {
+        return NULL;
+    }
+    task->path = (char *) malloc(length + 1);
+    if (task->path == NULL) {
+        free(task);
+        return NULL;
+    }
+    memcpy(task->path, path, length + 1);
+    task->nameOffset = nameOffset;
+    task->depth = depth;
+    task->parent = parent;
+    task->prev = NULL;
+    task->next = NULL;
+    if (parent != NULL) {
+        __sync_add_and_fetch(&parent->refs, 1);
+    }
+    return task;
+}
+
+static void pushTask(Worker *worker, Task *task) {
+    Walk *walk = worker->walk;
+
+    pthread_mutex_lock(&worker->lock);
+    task->prev = worker->tail;
+    if (worker->tail != NULL) {
+        worker->tail->next = task;
+    } else {
+        worker->head = task;
+    }
+    worker->tail = task;
+    pthread_mutex_unlock(&worker->lock);
+
+    pthread_mutex_lock(&walk->lock);
+    walk->pending++;
+    walk->queued++;
+    if (walk->idle > 0) {
+        pthread_cond_signal(&walk->workAvailable);
+    }
+    pthread_mutex_unlock(&walk->lock);
+}
+
+/*
+ * Takes a task from the tail of the worker's own queue, or else steals one
+ * from the head of another queue.
+ */
+static Task *takeTask(Worker *worker) {
+    Walk *walk = worker->walk;
+    Task *task = NULL;
+    int self = (int) (worker - walk->workers);
+    int i;
+
+    pthread_mutex_lock(&worker->lock);
+    if (worker->tail != NULL) {
+        task = worker->tail;
+        worker->tail = task->prev;
+        if (worker->tail != NULL) {
+            worker->tail->next = NULL;
+        } else {
+            worker->head = NULL;
+        }
+    }
+    pthread_mutex_unlock(&worker->lock);
+
+    for (i = 1; task == NULL && i < walk->threads; i++) {
+        Worker *victim = &walk->workers[(self + i) % walk->threads];
+        pthread_mutex_lock(&victim->lock);
+        if (victim->head != NULL) {
+            task = victim->head;
+            victim->head = task->next;
+            if (victim->head != NULL) {
+                victim->head->prev = NULL;
+            } else {
+                victim->tail = NULL;
+            }
+        }
+        pthread_mutex_unlock(&victim->lock);
+    }
+
+    if (task != NULL) {
+        pthread_mutex_lock(&walk->lock);
+        walk->queued--;
+        pthread_mutex_unlock(&walk->lock);
+        task->prev = NULL;
+        task->next = NULL;
+    }
+    return task;
+}
+
+/*
+ * Queues the worker's batch for Java, waiting while too many are queued.
+ * Returns 0 if the walk was cancelled.
+ */
+static int flushBatch(Worker *worker) {
+    Walk *walk = worker->walk;
+    Batch *batch = worker->batch;
+    int cancelled;
+
+    if (batch == NULL || batch->count == 0) {
+        return !isCancelled(walk);
+    }
+    worker->batch = NULL;
+
+    pthread_mutex_lock(&walk->lock);
+    while (walk->batches >= MAX_BATCHES && !walk->cancelled) {
+        pthread_cond_wait(&walk->batchTaken, &walk->lock);
+    }
+    cancelled = walk->cancelled;
+    if (!cancelled) {
+        batch->next = NULL;
+        if (walk->batchTail != NULL) {
+            walk->batchTail->next = batch;
+        } else {
+            walk->batchHead = batch;
+        }
+        walk->batchTail = batch;
+        walk->batches++;
+        pthread_cond_signal(&walk->batchAvailable);
+    }
+    pthread_mutex_unlock(&walk->lock);
+
+    if (cancelled) {
+        free(batch);
+    }
+    return !cancelled;
+}
+
+/*
+ * Appends a path to the worker's batch. Returns 0 if the walk was cancelled.
+ */
+static int putPath(Worker *worker, const char *path, size_t length) {
+    jint pathLength = (jint) length;
+
+    if (4 + length > BATCH_SIZE) {
+        return 1;               /* can't be returned; skipped */
+    }
+    if (worker->batch != NULL && 4 + length > BATCH_SIZE - worker->batch->used) {
+        if (!flushBatch(worker)) {
+            return 0;
+        }
+    }
+    if (worker->batch == NULL) {
+        worker->batch = (Batch *) malloc(sizeof(Batch));
+        if (worker->batch == NULL) {
+            return 1;
+        }
+        worker->batch->count = 0;
+        worker->batch->used = 0;
+    }
+
+    memcpy(worker->batch->data + worker->batch->used, &pathLength, 4);
+    memcpy(worker->batch->data + worker->batch->used + 4, path, length);
+    worker->batch->used += 4 + length;
+    worker->batch->count++;
+    return 1;
+}
+
+/*
+ * Records a directory as traversed. Returns 0 if it already was.
+ */
+static int visit(Walk *walk, dev_t dev, ino_t ino) {
+    size_t bucket = ((size_t) ino ^ ((size_t) dev * 31)) % walk->visitedBuckets;
+    Visited *visited;
+    int found = 0;
+
+    pthread_mutex_lock(&walk->lock);
+    for (visited = walk->visited[bucket]; visited != NULL; visited = visited->next) {
+        if (visited->dev == dev && visited->ino == ino) {
+            found = 1;
+            break;
+        }
+    }
+    if (!found) {
+        visited = (Visited *) malloc(sizeof(Visited));
+        if (visited != NULL) {
+            visited->dev = dev;
+            visited->ino = ino;
+            visited->next = walk->visited[bucket];
+            walk->visited[bucket] = visited;
+        }
+    }
+    pthread_mutex_unlock(&walk->lock);
+    return !found;
+}
+
+static int matchesName(Walk *walk, const char *name, size_t length) {
+    int i;
+
+    if (walk->globCount == 0 && walk->extensionCount == 0) {
+        return 1;
+    }
+    for (i = 0; i < walk->extensionCount; i++) {
+        size_t extLength = strlen(walk->extensions[i]);
+        if (extLength < length && name[length - extLength - 1] == '.'
+                && strcasecmp(name + length - extLength, walk->extensions[i]) == 0) {
+            return 1;
+        }
+    }
+    for (i = 0; i < walk->globCount; i++) {
+        if (fnmatch(walk->globs[i], name, 0) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int matchesStat(Walk *walk, const struct stat *st, int isDirectory) {
+    jlong modified = (jlong) st->st_mtime * 1000;
+#ifdef __linux__
+    modified += st->st_mtim.tv_nsec / 1000000;
+#endif
+
+    if (!isDirectory) {
+        if (walk->minSize >= 0 && (jlong) st->st_size < walk->minSize) {
+            return 0;
+        }
+        if (walk->maxSize >= 0 && (jlong) st->st_size > walk->maxSize) {
+            return 0;
+        }
+    }
+    if (walk->modifiedAfter >= 0 && modified < walk->modifiedAfter) {
+        return 0;
+    }
+    if (walk->modifiedBefore >= 0 && modified >= walk->modifiedBefore) {
+        return 0;
+    }
+    return 1;
+}
+
+static int needsStat(Walk *walk) {
+    return walk->minSize >= 0 || walk->maxSize >= 0
+        || walk->modifiedAfter >= 0 || walk->modifiedBefore >= 0;
+}
+
+/*
+ * Reads the directory of a task, reporting its entries and queuing its
+ * subdirectories. Returns 0 if the walk was cancelled.
+ */
+static int readTask(Worker *worker, Task *task) {
+    Walk *walk = worker->walk;
+    int flags = O_RDONLY;
+    Directory *directory;
+    struct dirent *entry;
+    size_t pathLength = strlen(task->path);
+    int fd;
+
+#ifdef O_DIRECTORY
+    flags |= O_DIRECTORY;
+#endif
+#ifdef O_CLOEXEC
+    flags |= O_CLOEXEC;
+#endif
+    if (task->parent != NULL) {
+        fd = openat(task->parent->fd, task->path + task->nameOffset, flags);
+    } else {
+        fd = open(task->path, flags);
+    }
+    if (fd < 0) {
+        return 1;
+    }
+
+    if (task->parent != NULL && (walk->flags & (ONE_FILE_SYSTEM | FOLLOW_LINKS))) {
+        struct stat st;
+        if (fstat(fd, &st) != 0
+                || ((walk->flags & ONE_FILE_SYSTEM) && st.st_dev != walk->rootDev)
+                || ((walk->flags & FOLLOW_LINKS) && !visit(walk, st.st_dev, st.st_ino))) {
+            close(fd);
+            return 1;
+        }
+    }
+
+    directory = (Directory *) malloc(sizeof(Directory));
+    if (directory == NULL) {
+        close(fd);
+        return 1;
+    }
+    directory->dir = fdopendir(fd);
+    if (directory->dir == NULL) {
+        close(fd);
+        free(directory);
+        return 1;
+    }
+    directory->fd = fd;
+    directory->refs = 1;
+
+    /* the path of each entry is built in the scratch space */
+    if (worker->pathCapacity < pathLength + 258) {
+        char *path = (char *) realloc(worker->path, pathLength + 258);
+        if (path == NULL) {
+            releaseDirectory(directory);
+            return 1;
+        }
+        worker->path = path;
+        worker->pathCapacity = pathLength + 258;
+    }
+    memcpy(worker->path, task->path, pathLength);
+    if (pathLength == 0 || worker->path[pathLength - 1] != '/') {
+        worker->path[pathLength++] = '/';
+    }
+
+    while (!isCancelled(walk) && (entry = readdir(directory->dir)) != NULL) {
+        const char *name = entry->d_name;
+        size_t nameLength;
+        int depth = task->depth + 1;
+        int isDirectory;
+        int isReported;
+        int isDescended;
+        int statted = 0;
+        struct stat st;
+
+        if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) {
+            continue;
+        }
+        nameLength = strlen(name);
+
+#ifdef _DIRENT_HAVE_D_TYPE
+        if (entry->d_type == DT_UNKNOWN
+                || (entry->d_type == DT_LNK && (walk->flags & FOLLOW_LINKS))) {
+#endif
+            int statFlags = (walk->flags & FOLLOW_LINKS) ? 0 : AT_SYMLINK_NOFOLLOW;
+            if (fstatat(directory->fd, name, &st, statFlags) != 0
+                    && (statFlags != 0 || fstatat(directory->fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0)) {
+                continue;
+            }
+            statted = 1;
+            isDirectory = S_ISDIR(st.st_mode);
+#ifdef _DIRENT_HAVE_D_TYPE
+        } else {
+            isDirectory = entry->d_type == DT_DIR;
+        }
+#endif
+
+        isDescended = isDirectory && (walk->maxDepth < 0 || depth < walk->maxDepth);
+        isReported = (!isDirectory || (walk->flags & INCLUDE_DIRECTORIES))
+            && (walk->maxDepth < 0 || depth <= walk->maxDepth)
+            && matchesName(walk, name, nameLength);
+        if (!isReported && !isDescended) {
+            continue;
+        }
+
+        if (isReported && needsStat(walk)) {
+            if (!statted) {
+                if (fstatat(directory->fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                    continue;
+                }
+                statted = 1;
+            }
+            isReported = matchesStat(walk, &st, isDirectory);
+        }
+
+        if (pathLength + nameLength + 1 > worker->pathCapacity) {
+            char *path = (char *) realloc(worker->path, pathLength + nameLength + 1);
+            if (path == NULL) {
+                continue;
+            }
+            worker->path = path;
+            worker->pathCapacity = pathLength + nameLength + 1;
+        }
+        memcpy(worker->path + pathLength, name, nameLength + 1);
+
+        if (isReported && !putPath(worker, worker->path, pathLength + nameLength)) {
+            break;
+        }
+        if (isDescended) {
+            Task *child = newTask(directory, worker->path, pathLength + nameLength, pathLength, depth);
+            if (child != NULL) {
+                pushTask(worker, child);
+            }
+        }
+    }
+
+    releaseDirectory(directory);
+    return !isCancelled(walk);
+}
+
+static void *runWorker(void *arg) {
+    Worker *worker = (Worker *) arg;
+    Walk *walk = worker->walk;
+
+    for (;;) {
+        Task *task = takeTask(worker);
+        if (task != NULL) {
+            int more = readTask(worker, task);
+            freeTask(task);
+
+            pthread_mutex_lock(&walk->lock);
+            if (--walk->pending == 0) {
+                pthread_cond_broadcast(&walk->workAvailable);
+            }
+            pthread_mutex_unlock(&walk->lock);
+            if (!more) {
+                break;
+            }
+            continue;
+        }
+
+        /* hand over what was found before waiting for more work */
+        if (!flushBatch(worker)) {
+            break;
+        }
+
+        pthread_mutex_lock(&walk->lock);
+        while (walk->queued == 0 && walk->pending > 0 && !walk->cancelled) {
+            walk->idle++;
+            pthread_cond_wait(&walk->workAvailable, &walk->lock);
+            walk->idle--;
+        }
+        if (walk->pending == 0 || walk->cancelled) {
+            pthread_mutex_unlock(&walk->lock);
+            break;
+        }
+        pthread_mutex_unlock(&walk->lock);
+    }
+
+    flushBatch(worker);
+
+    pthread_mutex_lock(&walk->lock);
+    walk->finished++;
+    pthread_cond_broadcast(&walk->batchAvailable);
+    pthread_mutex_unlock(&walk->lock);
+    return NULL;
+}
+
+static char **copyStrings(JNIEnv *env, jobjectArray array, int *count) {
+    char **strings;
+    int i;
+    int n;
+
+    *count = array == NULL ? 0 : (*env)->GetArrayLength(env, array);
+    strings = (char **) calloc(*count + 1, sizeof(char *));
+    if (strings == NULL) {
+        return NULL;
+    }
+    /* nulls and strings that can't be copied are left out */
+    for (i = 0, n = 0; i < *count; i++) {
+        jstring string = (jstring) (*env)->GetObjectArrayElement(env, array, i);
+        const char *chars;
+        if (string == NULL) {
+            continue;
+        }
+        chars = (*env)->GetStringUTFChars(env, string, NULL);
+        if (chars != NULL) {
+            strings[n] = strdup(chars);
+            if (strings[n] != NULL) {
+                n++;
+            }
+            (*env)->ReleaseStringUTFChars(env, string, chars);
+        }
+        (*env)->DeleteLocalRef(env, string);
+    }
+    *count = n;
+    return strings;
+}
+
+static void freeStrings(char **strings) {
+    char **p;
+    if (strings == NULL) {
+        return;
+    }
+    for (p = strings; *p != NULL; p++) {
+        free(*p);
+    }
+    free(strings);
+}
+
+static void freeWalk(Walk *walk) {
+    int i;
+    size_t bucket;
+
+    for (i = 0; i < walk->threads; i++) {
+        Worker *worker = &walk->workers[i];
+        while (worker->head != NULL) {
+            Task *task = worker->head;
+            worker->head = task->next;
+            freeTask(task);
+        }
+        free(worker->batch);
+        free(worker->path);
+        pthread_mutex_destroy(&worker->lock);
+    }
+    while (walk->batchHead != NULL) {
+        Batch *batch = walk->batchHead;
+        walk->batchHead = batch->next;
+        free(batch);
+    }
+    if (walk->visited != NULL) {
+        for (bucket = 0; bucket < walk->visitedBuckets; bucket++) {
+            while (walk->visited[bucket] != NULL) {
+                Visited *visited = walk->visited[bucket];
+                walk->visited[bucket] = visited->next;
+                free(visited);
+            }
+        }
+        free(walk->visited);
+    }
+    freeStrings(walk->globs);
+    freeStrings(walk->extensions);
+    free(walk->workers);
+    pthread_mutex_destroy(&walk->lock);
+    pthread_cond_destroy(&walk->workAvailable);
+    pthread_cond_destroy(&walk->batchAvailable);
+    pthread_cond_destroy(&walk->batchTaken);
+    free(walk);
+}
+
+/*
+ * Class:     org_jdesktop_jdic_fileutil_UnixWalker
+ * Method:    start
+ * Signature: (Ljava/lang/String;II[Ljava/lang/String;[Ljava/lang/String;JJJJI)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_fileutil_UnixWalker_start
+  (JNIEnv *env, jclass cls, jstring fullPath, jint flags, jint maxDepth,
+   jobjectArray globs, jobjectArray extensions, jlong minSize, jlong maxSize,
+   jlong modifiedAfter, jlong modifiedBefore, jint threads) {
+    Walk *walk;
+    Task *root;
+    struct stat st;
+    const char *cpFullPath;
+    int i;
+
+    if (threads < 1) {
+        threads = 1;
+    } else if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+
+    walk = (Walk *) calloc(1, sizeof(Walk));
+    if (walk == NULL) {
+        return 0;
+    }
+    walk->workers = (Worker *) calloc(threads, sizeof(Worker));
+    if (walk->workers == NULL) {
+        free(walk);
+        return 0;
+    }
+    pthread_mutex_init(&walk->lock, NULL);
+    pthread_cond_init(&walk->workAvailable, NULL);
+    pthread_cond_init(&walk->batchAvailable, NULL);
+    pthread_cond_init(&walk->batchTaken, NULL);
+    walk->threads = threads;
+    for (i = 0; i < threads; i++) {
+        walk->workers[i].walk = walk;
+        pthread_mutex_init(&walk->workers[i].lock, NULL);
+    }
+
+    walk->flags = flags;
+    walk->maxDepth = maxDepth;
+    walk->minSize = minSize;
+    walk->maxSize = maxSize;
+    walk->modifiedAfter = modifiedAfter;
+    walk->modifiedBefore = modifiedBefore;
+    walk->globs = copyStrings(env, globs, &walk->globCount);
+    walk->extensions = copyStrings(env, extensions, &walk->extensionCount);
+    if (walk->globs == NULL || walk->extensions == NULL) {
+        freeWalk(walk);
+        return 0;
+    }
+    if (flags & FOLLOW_LINKS) {
+        walk->visitedBuckets = 4096;
+        walk->visited = (Visited **) calloc(walk->visitedBuckets, sizeof(Visited *));
+        if (walk->visited == NULL) {
+            freeWalk(walk);
+            return 0;
+        }
+    }
+
+    cpFullPath = (*env)->GetStringUTFChars(env, fullPath, NULL);
+    if (cpFullPath == NULL) {
+        freeWalk(walk);
+        return 0;
+    }
+    if (stat(cpFullPath, &st) != 0 || !S_ISDIR(st.st_mode)
+            || (root = newTask(NULL, cpFullPath, strlen(cpFullPath), 0, 0)) == NULL) {
+        (*env)->ReleaseStringUTFChars(env, fullPath, cpFullPath);
+        freeWalk(walk);
+        return 0;
+    }
+    (*env)->ReleaseStringUTFChars(env, fullPath, cpFullPath);
+    walk->rootDev = st.st_dev;
+    if (flags & FOLLOW_LINKS) {
+        visit(walk, st.st_dev, st.st_ino);
+    }
+
+    pushTask(&walk->workers[0], root);
+    for (i = 0; i < threads; i++) {
+        if (pthread_create(&walk->workers[i].thread, NULL, runWorker, &walk->workers[i]) != 0) {
+            break;
+        }
+        walk->started++;
+    }
+    if (walk->started == 0) {
+        freeWalk(walk);
+        return 0;
+    }
+    if (walk->started < threads) {
+        /* the threads that did start still finish the walk */
+        pthread_mutex_lock(&walk->lock);
+        walk->finished += threads - walk->started;
+        pthread_mutex_unlock(&walk->lock);
+    }
+    return (jlong) (size_t) walk;
+}
+
+/*
+ * Class:     org_jdesktop_jdic_fileutil_UnixWalker
+ * Method:    next
+ * Signature: (JLjava/nio/ByteBuffer;)I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_fileutil_UnixWalker_next
+  (JNIEnv *env, jclass cls, jlong handle, jobject buffer) {
+    Walk *walk = (Walk *) (size_t) handle;
+    char *out = (char *) (*env)->GetDirectBufferAddress(env, buffer);
+    jlong capacity = (*env)->GetDirectBufferCapacity(env, buffer);
+    Batch *batch;
+    jint count;
+
+    if (walk == NULL || out == NULL || capacity < BATCH_SIZE) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&walk->lock);
+    while (walk->batchHead == NULL && walk->finished < walk->threads && !walk->cancelled) {
+        pthread_cond_wait(&walk->batchAvailable, &walk->lock);
+    }
+    batch = walk->batchHead;
+    if (batch != NULL) {
+        walk->batchHead = batch->next;
+        if (walk->batchHead == NULL) {
+            walk->batchTail = NULL;
+        }
+        walk->batches--;
+        pthread_cond_signal(&walk->batchTaken);
+    }
+    pthread_mutex_unlock(&walk->lock);
+
+    if (batch == NULL) {
+        return 0;
+    }
+    memcpy(out, batch->data, batch->used);
+    count = batch->count;
+    free(batch);
+    return count;
+}
+
+/*
+ * Class:     org_jdesktop_jdic_fileutil_UnixWalker
+ * Method:    stop
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_fileutil_UnixWalker_stop
+  (JNIEnv *env, jclass cls, jlong handle) {
+    Walk *walk = (Walk *) (size_t) handle;
+    int i;
+
+    if (walk == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&walk->lock);
+    __atomic_store_n(&walk->cancelled, 1, __ATOMIC_RELAXED);
+    pthread_cond_broadcast(&walk->workAvailable);
+    pthread_cond_broadcast(&walk->batchTaken);
+    pthread_cond_broadcast(&walk->batchAvailable);
+    pthread_mutex_unlock(&walk->lock);
+
+    for (i = 0; i < walk->started; i++) {
+        pthread_join(walk->workers[i].thread, NULL);
+    }
+    freeWalk(walk);
+}
@@ -0,0 +1,45 @@
+/* DO NOT EDIT THIS FILE - it is machine generated */
+#include <jni.h>
+/* Header for class org_jdesktop_jdic_fileutil_UnixWalker */
+
+#ifndef _Included_org_jdesktop_jdic_fileutil_UnixWalker
+#define _Included_org_jdesktop_jdic_fileutil_UnixWalker
+#ifdef __cplusplus
+extern "C" {
+#endif
+#undef org_jdesktop_jdic_fileutil_UnixWalker_BATCH_SIZE
+#define org_jdesktop_jdic_fileutil_UnixWalker_BATCH_SIZE 65536L
+#undef org_jdesktop_jdic_fileutil_UnixWalker_FOLLOW_LINKS
+#define org_jdesktop_jdic_fileutil_UnixWalker_FOLLOW_LINKS 1L
+#undef org_jdesktop_jdic_fileutil_UnixWalker_ONE_FILE_SYSTEM
+#define org_jdesktop_jdic_fileutil_UnixWalker_ONE_FILE_SYSTEM 2L
+#undef org_jdesktop_jdic_fileutil_UnixWalker_INCLUDE_DIRECTORIES
+#define org_jdesktop_jdic_fileutil_UnixWalker_INCLUDE_DIRECTORIES 4L
+/*
+ * Class:     org_jdesktop_jdic_fileutil_UnixWalker
+ * Method:    start
+ * Signature: (Ljava/lang/String;II[Ljava/lang/String;[Ljava/lang/String;JJJJI)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_fileutil_UnixWalker_start
+  (JNIEnv *, jclass, jstring, jint, jint, jobjectArray, jobjectArray, jlong, jlong, jlong, jlong, jint);
+
+/*
+ * Class:     org_jdesktop_jdic_fileutil_UnixWalker
+ * Method:    next
+ * Signature: (JLjava/nio/ByteBuffer;)I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_fileutil_UnixWalker_next
+  (JNIEnv *, jclass, jlong, jobject);
+
+/*
+ * Class:     org_jdesktop_jdic_fileutil_UnixWalker
+ * Method:    stop
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_fileutil_UnixWalker_stop
+  (JNIEnv *, jclass, jlong);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
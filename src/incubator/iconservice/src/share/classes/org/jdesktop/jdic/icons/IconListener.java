@@ -0,0 +1,36 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+package org.jdesktop.jdic.icons;
+
+import java.awt.Image;
+
+/**
+ * The listener interface for receiving icons prefetched by
+ * {@link IconService#prefetch IconService.prefetch}.
+ */
+public interface IconListener {
+
+    /**
+     * Invoked when the icons of one of the requested sizes have been loaded.
+     * This is called on a background thread, not the event dispatch thread.
+     * @param names The names of the icons, as passed to prefetch
+     * @param size The size of the icons
+     * @param icons An icon of the requested size, or null, for each name
+     */
+    void iconsLoaded(String[] names, int size, Image[] icons);
+}
@@ -0,0 +1,186 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+package org.jdesktop.jdic.icons;
+
+import java.awt.Component;
+import java.awt.Image;
+import java.awt.MediaTracker;
+import java.awt.Toolkit;
+
+import java.util.LinkedList;
+
+import org.jdesktop.jdic.icons.spi.IconProvider;
+
+/**
+ * Loads icons on a pool of background daemon threads.  The names of each
+ * request are split among the threads, and each thread looks up its share
+ * of the names together and waits for the images to be decoded.
+ */
+class IconPrefetcher {
+
+    private static final int maxThreads= Math.max(1, Math.min(4, Runtime.getRuntime().availableProcessors()));
+
+    private static final LinkedList tasks= new LinkedList();
+    private static int threads;
+    private static int idleThreads;
+
+    // MediaTracker only needs a component to obtain the toolkit from
+    private static final Component component= new Component() {};
+
+    /**
+     * Suppress default constructor for noninstantiability.
+     */
+    private IconPrefetcher() {
+    }
+
+    /**
+     * Load icons of each name in each size.
+     * @param listener Receives the icons of each size, or null.
+     */
+    static void prefetch(IconProvider provider, String[] names, int[] sizes, Toolkit toolkit, IconListener listener) {
+        if(names.length==0) {
+            // nothing to load, but listeners still wait for each size
+            if(listener!=null) {
+                for(int s= 0; s<sizes.length; ++s) {
+                    listener.iconsLoaded(names, sizes[s], new Image[0]);
+                }
+            }
+            return;
+        }
+
+        int chunks= Math.min(maxThreads, names.length);
+        synchronized(tasks) {
+            for(int s= 0; s<sizes.length; ++s) {
+                Request request= new Request(provider, names, sizes[s], toolkit, listener, chunks);
+                for(int c= 0; c<chunks; ++c) {
+                    tasks.add(new Task(request, names.length*c/chunks, names.length*(c+1)/chunks));
+                }
+            }
+
+            if(idleThreads<tasks.size() && threads<maxThreads) {
+                for(int n= Math.min(tasks.size()-idleThreads, maxThreads-threads); n>0; --n) {
+                    Thread thread= new Thread("IconPrefetcher") {
+                        public void run() {
+                            runTasks();
+                        }
+                    };
+                    thread.setDaemon(true);
+                    thread.start();
+                    ++threads;
+                }
+            }
+            tasks.notifyAll();
+        }
+    }
+
+    private static void runTasks() {
+        for(;;) {
+            Task task;
+            synchronized(tasks) {
+                ++idleThreads;
+                try {
+                    while(tasks.isEmpty()) {
+                        tasks.wait();
+                    }
+                }
+                catch(InterruptedException ex) {
+                    --threads;
+                    --idleThreads;
+                    return;
+                }
+                --idleThreads;
+                task= (Task)tasks.removeFirst();
+            }
+
+            try {
+                task.run();
+            }
+            catch(Throwable ignore) {
+                // a failing provider must not cost the pool a thread
+            }
+        }
+    }
+
+    private static class Request {
+        final IconProvider provider;
+        final String[] names;
+        final int size;
+        final Toolkit toolkit;
+        final IconListener listener;
+
+        final Image[] icons;
+        int pendingTasks;
+
+        Request(IconProvider provider, String[] names, int size, Toolkit toolkit, IconListener listener, int tasks) {
+            this.provider= provider;
+            this.names= names;
+            this.size= size;
+            this.toolkit= toolkit;
+            this.listener= listener;
+            icons= new Image[names.length];
+            pendingTasks= tasks;
+        }
+
+        void taskDone(int from, Image[] loaded) {
+            synchronized(this) {
+                System.arraycopy(loaded, 0, icons, from, loaded.length);
+                if(--pendingTasks>0)
+                    return;
+            }
+            if(listener!=null)
+                listener.iconsLoaded(names, size, icons);
+        }
+    }
+
+    private static class Task {
+        final Request request;
+        final int from;
+        final int to;
+
+        Task(Request request, int from, int to) {
+            this.request= request;
+            this.from= from;
+            this.to= to;
+        }
+
+        void run() {
+            String[] names= new String[to-from];
+            System.arraycopy(request.names, from, names, 0, names.length);
+
+            Image[] icons= new Image[names.length];
+            try {
+                Image[] found= request.provider.getIcons(names, request.size, request.toolkit);
+                if(found!=null)
+                    icons= found;
+
+                MediaTracker tracker= new MediaTracker(component);
+                for(int i= 0; i<icons.length; ++i) {
+                    if(icons[i]!=null)
+                        tracker.addImage(icons[i], 0);
+                }
+                tracker.waitForAll();
+            }
+            catch(InterruptedException ignore) {
+            }
+            finally {
+                // the listener is called even if some icons failed to load
+                request.taskDone(from, icons);
+            }
+        }
+    }
+}
@@ -63,6 +63,45 @@ public class IconService {
         return provider.getIcon(name, size, toolkit);
     }
 
+    /**
+     * Return icons of the requested size from the desktop, as {@link #getIcon(String, int) getIcon}
+     * would return each of them.  Looking up several icons at once is faster than one at a time.
+     * The returned images are created by the default Toolkit.
+     * @param names The names of the icons
+     * @param size The requested size of the returned images
+     * @return An icon of the requested size, or null, for each name
+     */
+    public static Image[] getIcons(String[] names, int size) {
+        return getIcons(names, size, Toolkit.getDefaultToolkit());
+    }
+
+    /**
+     * Return icons of the requested size from the desktop, as {@link #getIcon(String, int, Toolkit) getIcon}
+     * would return each of them.  Looking up several icons at once is faster than one at a time.
+     * @param names The names of the icons
+     * @param size The requested size of the returned images
+     * @param toolkit The toolkit to use to create the images.
+     * @return An icon of the requested size, or null, for each name
+     */
+    public static Image[] getIcons(String[] names, int size, Toolkit toolkit) {
+        return provider.getIcons(names, size, toolkit);
+    }
+
+    /**
+     * Load icons in the background, so that they are ready when they are needed.
+     * Each name is loaded in each size, on background threads, and the images are decoded.
+     * The images are created by the default Toolkit.
+     * For example, an application may prefetch the icons of its toolbars and menus at startup.
+     * @param names The names of the icons
+     * @param sizes The requested sizes of the icons
+     * @param listener Receives the icons of each size, on a background thread, once they are loaded.
+     * If names is empty, it receives an empty array for each size at once, on the calling thread.
+     * May be null if the icons are only loaded to warm the caches of the provider.
+     */
+    public static void prefetch(String[] names, int[] sizes, IconListener listener) {
+        IconPrefetcher.prefetch(provider, names, sizes, Toolkit.getDefaultToolkit(), listener);
+    }
+
     /**
      * Obtain the icon theme that is being used.
      * @return The icon theme name.  This may be null if themes are not used by the platform.
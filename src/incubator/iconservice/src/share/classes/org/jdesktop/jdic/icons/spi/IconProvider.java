@@ -76,6 +76,24 @@ public abstract class IconProvider implements Provider {
      */
     public abstract Image getIcon(String name, int size, Toolkit toolkit);
 
+    /**
+     * Return icons of the requested size from the desktop.
+     * Providers may override this to look up several icons more efficiently than one at a time.
+     * This default implementation calls {@link #getIcon getIcon} for each name.
+     * @param names The names of the icons
+     * @param size The requested size of the returned images
+     * @param toolkit The toolkit to use to create the images.
+     * @return An icon of the requested size, or null, for each name
+     */
+    public Image[] getIcons(String[] names, int size, Toolkit toolkit) {
+        Image[] icons= new Image[names.length];
+        for(int i= 0; i<names.length; ++i) {
+            if(names[i]!=null)
+                icons[i]= getIcon(names[i], size, toolkit);
+        }
+        return icons;
+    }
+
     /**
      * Obtain the icon theme that is being used.
      * @return The icon theme name.  This may be null if themes are not used by the platform.
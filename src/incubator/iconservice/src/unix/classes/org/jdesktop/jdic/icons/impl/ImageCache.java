@@ -0,0 +1,150 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+package org.jdesktop.jdic.icons.impl;
+
+import java.awt.Image;
+
+import java.lang.ref.ReferenceQueue;
+import java.lang.ref.SoftReference;
+
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.LinkedHashMap;
+import java.util.Map;
+
+/**
+* A cache of images, with a budget of bytes.  The least recently used
+* images beyond the budget are only softly referenced, so that they are
+* still found until the garbage collector needs their memory.
+*/
+class ImageCache {
+
+    private final long budget;
+    private long used;
+
+    private final LinkedHashMap images= new LinkedHashMap(16, 0.75f, true);   // key to Entry, least recently used first
+    private final Map evicted= new HashMap();     // key to SoftEntry
+    private final ReferenceQueue cleared= new ReferenceQueue();
+
+    private int hits;
+    private int misses;
+
+    /**
+    * @param budget The number of bytes of images which are held strongly.
+    * If 0, nothing is cached.
+    */
+    ImageCache(long budget) {
+        this.budget= budget;
+    }
+
+    /**
+    * Obtain a cached image.
+    * @return The image, or null if it is not cached.
+    */
+    synchronized Image get(Object key) {
+        Entry entry= (Entry)images.get(key);
+        if(entry!=null) {
+            ++hits;
+            return entry.image;
+        }
+
+        purge();
+        SoftEntry soft= (SoftEntry)evicted.remove(key);
+        Image image= soft==null ?null :(Image)soft.get();
+        if(image==null) {
+            ++misses;
+            return null;
+        }
+
+        ++hits;
+        put(key, image, soft.bytes);
+        return image;
+    }
+
+    /**
+    * Cache an image.
+    * @param bytes The number of bytes the image is estimated to occupy.
+    */
+    synchronized void put(Object key, Image image, int bytes) {
+        if(budget<=0)
+            return;
+
+        evicted.remove(key);
+        Entry old= (Entry)images.put(key, new Entry(image, bytes));
+        if(old!=null)
+            used-= old.bytes;
+        used+= bytes;
+
+        for(Iterator it= images.entrySet().iterator(); used>budget && it.hasNext(); ) {
+            Map.Entry eldest= (Map.Entry)it.next();
+            Entry entry= (Entry)eldest.getValue();
+            it.remove();
+            used-= entry.bytes;
+            evicted.put(eldest.getKey(), new SoftEntry(eldest.getKey(), entry, cleared));
+        }
+    }
+
+    /**
+    * Remove all images.
+    */
+    synchronized void clear() {
+        images.clear();
+        evicted.clear();
+        used= 0;
+        purge();
+    }
+
+    synchronized int getHits() {
+        return hits;
+    }
+
+    synchronized int getMisses() {
+        return misses;
+    }
+
+    /**
+    * Forget the evicted images which the garbage collector has reclaimed.
+    */
+    private void purge() {
+        for(SoftEntry soft; (soft= (SoftEntry)cleared.poll())!=null; ) {
+            if(evicted.get(soft.key)==soft)
+                evicted.remove(soft.key);
+        }
+    }
+
+    private static class Entry {
+        final Image image;
+        final int bytes;
+
+        Entry(Image image, int bytes) {
+            this.image= image;
+            this.bytes= bytes;
+        }
+    }
+
+    private static class SoftEntry extends SoftReference {
+        final Object key;
+        final int bytes;
+
+        SoftEntry(Object key, Entry entry, ReferenceQueue queue) {
+            super(entry.image, queue);
+            this.key= key;
+            this.bytes= entry.bytes;
+        }
+    }
+}
@@ -24,13 +24,45 @@ import java.awt.Toolkit;
 
 import java.io.File;
 
+import java.security.AccessController;
+import java.security.PrivilegedAction;
+
 /**
 * An icon provider based upon <a href="http://freedesktop.org/Standards/icon-theme-spec">
 * freedesktop icon theme specification</a>
 */
 public class UnixIconProvider extends IconProvider {
 
-    private XdgIconTheme theme;
+    /**
+    * The system property which sets the number of bytes of icon images
+    * held in memory.  The default is 4 megabytes; 0 disables caching.
+    */
+    public static final String CACHE_SIZE_PROPERTY= "org.jdesktop.jdic.icons.cacheSize";
+
+    private static final String ICON_THEME_KEY= "/desktop/gnome/interface/icon_theme";
+
+    private volatile XdgIconTheme theme;
+    private boolean themeSet;     // if set by setTheme(), the desktop setting is no longer followed
+    private int settingsSerial;
+
+    private final ImageCache cache= new ImageCache(getCacheSize());
+    private int cacheVersion;
+
+    private static long getCacheSize() {
+        String size= (String)AccessController.doPrivileged(new PrivilegedAction() {
+            public Object run() {
+                // need permission: PropertyPermission("org.jdesktop.jdic.icons.cacheSize", "read")
+                return System.getProperty(CACHE_SIZE_PROPERTY);
+            }
+        });
+        try {
+            if(size!=null)
+                return Long.parseLong(size.trim());
+        }
+        catch(NumberFormatException ex) {
+        }
+        return 4*1024*1024;
+    }
 
     /**
     * Initialize the Provider instance.  If this method returns false, this instance should not be used.
@@ -40,7 +72,8 @@ public class UnixIconProvider extends IconProvider {
         if(!XdgDirectory.isLoaded())
             return false;
 
-        theme= new XdgIconTheme(XdgDirectory.getGconfValue("/desktop/gnome/interface/icon_theme"));
+        settingsSerial= XdgDirectory.getGconfSerial();
+        theme= new XdgIconTheme(XdgDirectory.getGconfValue(ICON_THEME_KEY));
         return true;
     }
 
@@ -53,9 +86,68 @@ public class UnixIconProvider extends IconProvider {
      * @return An icon of the requested size or null
      */
     public Image getIcon(String name, int size, Toolkit toolkit) {
-        File f= theme.getIcon(name, size);
-        if(f==null)
-            return null;
+        return getIcons(new String[] { name }, size, toolkit)[0];
+    }
+
+    /**
+     * Return icons of the requested size from the desktop.
+     * The icons which are not cached are looked up together, searching each theme once.
+     * @param names The names of the icons
+     * @param size The requested size of the returned images
+     * @param toolkit The toolkit to use to create the images.
+     * @return An icon of the requested size, or null, for each name
+     */
+    public Image[] getIcons(String[] names, int size, Toolkit toolkit) {
+        followDesktopTheme();
+        XdgIconTheme theme= this.theme;
+        int version= XdgIconTheme.getVersion();
+        if(version!=cacheVersion) {
+            cache.clear();
+            cacheVersion= version;
+        }
+
+        Image[] icons= new Image[names.length];
+        IconKey[] keys= new IconKey[names.length];
+        int[] missing= new int[names.length];
+        int n= 0;
+        for(int i= 0; i<names.length; ++i) {
+            if(names[i]==null)
+                continue;
+
+            keys[i]= new IconKey(theme, names[i], size, toolkit);
+            icons[i]= cache.get(keys[i]);
+            if(icons[i]==null)
+                missing[n++]= i;
+        }
+        if(n==0)
+            return icons;
+
+        String[] missingNames= new String[n];
+        for(int j= 0; j<n; ++j) {
+            missingNames[j]= names[missing[j]];
+        }
+
+        File[] files= theme.getIcons(missingNames, size);
+        for(int j= 0; j<n; ++j) {
+            if(files[j]==null)
+                continue;
+
+            int i= missing[j];
+            icons[i]= createIcon(files[j], size, toolkit);
+
+            // decoded as 32 bit pixels
+            cache.put(keys[i], icons[i], size*size*4);
+        }
+        return icons;
+    }
+
+    private static Image createIcon(File f, int size, Toolkit toolkit) {
+        // AWT cannot decode SVG, use a rendering of the requested size
+        if(f.getName().endsWith(".svg")) {
+            File raster= XdgSvgRasterizer.getRaster(f, size);
+            if(raster!=null)
+                return toolkit.createImage(raster.getAbsolutePath());
+        }
 
         Image rc= toolkit.createImage(f.getAbsolutePath());
         try {
@@ -68,6 +160,20 @@ public class UnixIconProvider extends IconProvider {
         return rc.getScaledInstance(size, size, Image.SCALE_DEFAULT);
     }
 
+    /**
+    * Obtain the number of icons found in the image cache, for tuning its size.
+    */
+    public int getCacheHits() {
+        return cache.getHits();
+    }
+
+    /**
+    * Obtain the number of icons not found in the image cache, for tuning its size.
+    */
+    public int getCacheMisses() {
+        return cache.getMisses();
+    }
+
     /**
      * Obtain the icon theme that is being used.
      * @return The icon theme name.  This may be null if themes are not used by the platform.
@@ -81,7 +187,53 @@ public class UnixIconProvider extends IconProvider {
      * @param The icon theme name.  This may be ignored if themes are not used by the platform.
      */
     public void setTheme(String iconTheme) {
+        themeSet= true;
         theme= new XdgIconTheme(iconTheme);
+        cache.clear();
+    }
+
+    /**
+    * Switch to the icon theme of the desktop when the user changes it.
+    */
+    private synchronized void followDesktopTheme() {
+        if(themeSet)
+            return;
+
+        int serial= XdgDirectory.getGconfSerial();
+        if(serial==settingsSerial)
+            return;
+        settingsSerial= serial;
+
+        String name= XdgDirectory.getGconfValue(ICON_THEME_KEY);
+        if(!theme.getName().equals(name==null ?"hicolor" :name)) {
+            theme= new XdgIconTheme(name);
+            cache.clear();
+        }
+    }
+
+    private static class IconKey {
+        final XdgIconTheme theme;
+        final String name;
+        final int size;
+        final Toolkit toolkit;
+
+        IconKey(XdgIconTheme theme, String name, int size, Toolkit toolkit) {
+            this.theme= theme;
+            this.name= name;
+            this.size= size;
+            this.toolkit= toolkit;
+        }
+
+        public boolean equals(Object o) {
+            if(!(o instanceof IconKey))
+                return false;
+            IconKey key= (IconKey)o;
+            return theme==key.theme && size==key.size && toolkit==key.toolkit && name.equals(key.name);
+        }
+
+        public int hashCode() {
+            return name.hashCode()*31+size;
+        }
     }
 
 }
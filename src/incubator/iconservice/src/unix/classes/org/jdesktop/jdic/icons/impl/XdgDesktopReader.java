@@ -17,21 +17,18 @@
 
 package org.jdesktop.jdic.icons.impl;
 
-import java.io.BufferedReader;
 import java.io.File;
 import java.io.FileInputStream;
 import java.io.InputStream;
-import java.io.InputStreamReader;
 import java.io.IOException;
 
 import java.util.Arrays;
 import java.util.Comparator;
+import java.util.HashMap;
 import java.util.Iterator;
 import java.util.Locale;
 import java.util.Map;
-import java.util.TreeMap;
 
-import java.util.regex.Matcher;
 import java.util.regex.Pattern;
 
 /**
@@ -40,14 +37,15 @@ import java.util.regex.Pattern;
 */
 public class XdgDesktopReader {
 
-    final private Map.Entry[] groups;
+    final private Map groups= new HashMap();    // group name to Group
+    private Map.Entry[] sortedGroups;
 
     /**
     * Read the contents of a desktop entry file.
     * @param file The file to read.
     */
     public XdgDesktopReader(File file) throws IOException {
-        this(new FileInputStream(file));
+        this(new FileInputStream(file), (int)file.length());
     }
 
     /**
@@ -55,86 +53,230 @@ public class XdgDesktopReader {
     * @param input The stream to read.  The stream will be closed before this constructor returns.
     */
     public XdgDesktopReader(InputStream input) throws IOException {
+        this(input, 4096);
+    }
+
+    private XdgDesktopReader(InputStream input, int sizeHint) throws IOException {
+        byte[] buffer;
+        int length= 0;
         try {
-            groups= readLines(new BufferedReader(new InputStreamReader(input, "UTF-8")));
+            buffer= new byte[Math.max(sizeHint, 0)+1];
+            for(;;) {
+                if(length==buffer.length) {
+                    byte[] larger= new byte[buffer.length*2];
+                    System.arraycopy(buffer, 0, larger, 0, length);
+                    buffer= larger;
+                }
+                int n= input.read(buffer, length, buffer.length-length);
+                if(n<0)
+                    break;
+                length+= n;
+            }
         }
         finally {
             input.close();
         }
+        parse(buffer, length);
     }
 
-    static private Pattern comment= Pattern.compile("\\s*(#.*)?");
-    static private Pattern groupHeader= Pattern.compile("\\s*\\[([^\\]\\x00-\\x1F\\x7F]+)\\]\\s*");
-    static private Pattern keyValue= Pattern.compile("\\s*([A-Za-z0-9-]+)(\\[([A-Za-z0-9_@-]+)\\])?\\s*=\\s*([^\\x00-\\x1F\\x7F]*)");
+    private static boolean isSpace(int b) {
+        // the characters of \s in regular expressions
+        return b==' ' || b=='\t' || b=='\n' || b==0x0B || b=='\f' || b=='\r';
+    }
 
-    private Map.Entry[] readLines(BufferedReader reader) throws IOException {
+    private static boolean isControl(int b) {
+        // bytes of multibyte UTF-8 characters are negative
+        return b>=0 && b<0x20 || b==0x7F;
+    }
 
-        String groupName= null;
-        TreeMap groupMap= new TreeMap();
-            // while we build up groups, keep map of group name to Map.Entry[]
+    private static boolean isKeyChar(int b) {
+        return b>='A' && b<='Z' || b>='a' && b<='z' || b>='0' && b<='9' || b=='-';
+    }
 
-        TreeMap entryMap= new TreeMap();
-            // while we build up group, keep map of key name to Object[]
-            // Object[0]==locale
-            // Object[1]==value
+    private static boolean isLocaleChar(int b) {
+        return isKeyChar(b) || b=='_' || b=='@';
+    }
 
-        for(int lineNo= 1; ;++lineNo) {
-            String line= reader.readLine();
-            if(line==null)
-                break;
+    /**
+    * Parse the contents of the file in one pass over its bytes.  Lines end with
+    * \n, \r or \r\n.  Of the localized values of a key, only the one which best
+    * matches the default locale is kept.
+    */
+    private void parse(byte[] b, int length) throws IOException {
+        String[] defaultLocale= getDefaultLocale();
 
-            if(comment.matcher(line).matches())
+        String groupName= null;
+        Map entries= null;      // key to value, of the current group
+        Map locales= null;      // key to locale of its localized value, of the current group
+
+        for(int lineStart= 0; lineStart<length; ) {
+            int lineEnd= lineStart;
+            while(lineEnd<length && b[lineEnd]!='\n' && b[lineEnd]!='\r')
+                ++lineEnd;
+            int next= lineEnd+1;
+            if(lineEnd+1<length && b[lineEnd]=='\r' && b[lineEnd+1]=='\n')
+                ++next;
+
+            int i= lineStart;
+            while(i<lineEnd && isSpace(b[i]))
+                ++i;
+
+            // comment or blank line
+            if(i==lineEnd || b[i]=='#') {
+                lineStart= next;
                 continue;
-            
-            final Matcher groupMatcher= groupHeader.matcher(line);
-            if(groupMatcher.matches()) {
-                // translate prior Map into Group
-                if(groupName!=null) {
-                    groupMap.put(groupName, createEntries(entryMap, true));
-                    entryMap.clear();
+            }
+
+            if(b[i]=='[') {
+                int nameStart= ++i;
+                while(i<lineEnd && b[i]!=']' && !isControl(b[i]))
+                    ++i;
+                int nameEnd= i;
+                if(i<lineEnd && b[i]==']' && nameEnd>nameStart) {
+                    ++i;
+                    while(i<lineEnd && isSpace(b[i]))
+                        ++i;
+                    if(i==lineEnd) {
+                        if(groupName!=null)
+                            groups.put(groupName, new Group(entries));
+                        groupName= new String(b, nameStart, nameEnd-nameStart, "UTF-8");
+                        entries= new HashMap();
+                        locales= new HashMap();
+                        lineStart= next;
+                        continue;
+                    }
                 }
+                throw new IOException("Improper format, line "+getLine(b, lineStart, lineEnd)+" is not group header, key value, or comment");
+            }
 
-                groupName= groupMatcher.group(1);
-                continue;
+            int keyStart= i;
+            while(i<lineEnd && isKeyChar(b[i]))
+                ++i;
+            int keyEnd= i;
+
+            int localeStart= -1;
+            int localeEnd= -1;
+            if(keyEnd>keyStart && i<lineEnd && b[i]=='[') {
+                localeStart= ++i;
+                while(i<lineEnd && isLocaleChar(b[i]))
+                    ++i;
+                localeEnd= i;
+                if(i<lineEnd && b[i]==']' && localeEnd>localeStart)
+                    ++i;
+                else
+                    keyEnd= keyStart;   // not a key
             }
 
-            final Matcher keyMatcher= keyValue.matcher(line);
-            if(keyMatcher.matches()) {
-                if(groupName==null)
-                    throw new IOException("Improper format, key value before group header at line "+line);
+            while(i<lineEnd && isSpace(b[i]))
+                ++i;
+            boolean isKeyValue= keyEnd>keyStart && i<lineEnd && b[i]=='=';
+            if(isKeyValue) {
+                ++i;
+                while(i<lineEnd && isSpace(b[i]))
+                    ++i;
+                for(int v= i; v<lineEnd; ++v) {
+                    if(isControl(b[v])) {
+                        isKeyValue= false;
+                        break;
+                    }
+                }
+            }
+            if(!isKeyValue)
+                throw new IOException("Improper format, line "+getLine(b, lineStart, lineEnd)+" is not group header, key value, or comment");
 
-                Locale locale= getLocale(keyMatcher.group(3));
-                if(locale!=null && !localeIsEffective(locale))
-                    continue;
+            if(groupName==null)
+                throw new IOException("Improper format, key value before group header at line "+getLine(b, lineStart, lineEnd));
 
-                String key= keyMatcher.group(1);
+            lineStart= next;
 
-                Object[] value= (Object[])entryMap.get(key);
-                if(value==null || moreEffective((Locale)value[0], locale)) {
-                    entryMap.put(key, new Object[] {locale, replaceEscape(keyMatcher.group(4))});
-                }
-                continue;
+            String[] locale= null;
+            if(localeStart>=0) {
+                locale= getLocale(b, localeStart, localeEnd);
+                if(!localeIsEffective(locale, defaultLocale))
+                    continue;
             }
 
-            throw new IOException("Improper format, line "+line+" is not group header, key value, or comment");
+            String key= internKey(b, keyStart, keyEnd);
+            if(entries.containsKey(key) && !moreEffective((String[])locales.get(key), locale))
+                continue;
+
+            entries.put(key, replaceEscape(new String(b, i, lineEnd-i, "UTF-8")));
+            if(locale!=null)
+                locales.put(key, locale);
+            else
+                locales.remove(key);
         }
         if(groupName!=null) {
-            groupMap.put(groupName, createEntries(entryMap, true));
+            groups.put(groupName, new Group(entries));
+        }
+    }
+
+    private static String getLine(byte[] b, int start, int end) throws IOException {
+        return new String(b, start, end-start, "UTF-8");
+    }
+
+    private static String[] keyTable= new String[256];
+    private static int keyCount;
+
+    /**
+    * Obtain the key of the given bytes.  Keys are shared by all readers, so
+    * that the few distinct keys of desktop files are created only once.
+    */
+    private static synchronized String internKey(byte[] b, int start, int end) {
+        int hash= 0;
+        for(int i= start; i<end; ++i) {
+            hash= hash*31+b[i];
         }
 
-        return createEntries(groupMap, false);
+        int mask= keyTable.length-1;
+        for(int slot= hash & mask; ; slot= (slot+1) & mask) {
+            String key= keyTable[slot];
+            if(key==null)
+                break;
+            if(key.length()==end-start) {
+                int i= start;
+                while(i<end && key.charAt(i-start)==b[i])
+                    ++i;
+                if(i==end)
+                    return key;
+            }
+        }
+
+        char[] chars= new char[end-start];
+        for(int i= start; i<end; ++i) {
+            chars[i-start]= (char)b[i];
+        }
+        String key= new String(chars).intern();
+
+        if(++keyCount*2>keyTable.length) {
+            String[] old= keyTable;
+            keyTable= new String[old.length*2];
+            for(int i= 0; i<old.length; ++i) {
+                if(old[i]!=null)
+                    putKey(old[i]);
+            }
+        }
+        putKey(key);
+        return key;
+    }
+
+    private static void putKey(String key) {
+        // keys hash as their bytes do, since they are ASCII
+        int mask= keyTable.length-1;
+        int slot= key.hashCode() & mask;
+        while(keyTable[slot]!=null)
+            slot= (slot+1) & mask;
+        keyTable[slot]= key;
     }
 
-    private Map.Entry[] createEntries(TreeMap entries, boolean isEntry) {
-        Map.Entry[] rc= new Map.Entry[entries.size()];
+    private static Map.Entry[] createEntries(Map map) {
+        Map.Entry[] rc= new Map.Entry[map.size()];
         int i= 0;
-        for(Iterator it= entries.entrySet().iterator(); it.hasNext(); ) {
+        for(Iterator it= map.entrySet().iterator(); it.hasNext(); ) {
             final Map.Entry entry= (Map.Entry)it.next();
 
             final Object key= entry.getKey();
-            final Object value= isEntry 
-                                    ?((Object[])entry.getValue())[1] 
-                                    :new Group((Map.Entry[])entry.getValue());
+            final Object value= entry.getValue();
 
             rc[i++]= new Map.Entry() {
                 public Object getKey() {
@@ -159,6 +301,7 @@ public class XdgDesktopReader {
                 }
             };
         }
+        Arrays.sort(rc, entryComparator);
         return rc;
     }
 
@@ -207,57 +350,69 @@ public class XdgDesktopReader {
         }
     }
 
-    private static Locale getLocale(String locale) {
-        if(locale==null)
-            return null;
+    /**
+    * Obtain the language, country and variant of the locale of the given bytes.
+    * Like Locale, the language is lower case and the country upper case.
+    */
+    private static String[] getLocale(byte[] b, int start, int end) {
+        int under= -1;
+        int at= -1;
+        for(int i= start; i<end; ++i) {
+            if(b[i]=='_' && under<0 && at<0)
+                under= i;
+            else if(b[i]=='@' && at<0)
+                at= i;
+        }
 
-        int under= locale.indexOf('_');
-        int at= locale.indexOf('@', under+1);
+        int languageEnd= under>=0 ?under :at>=0 ?at :end;
+        int countryEnd= at>=0 ?at :end;
+        return new String[] {
+            getLatin1(b, start, languageEnd).toLowerCase(),
+            under>=0 ?getLatin1(b, under+1, countryEnd).toUpperCase() :"",
+            at>=0 ?getLatin1(b, at+1, end) :""
+        };
+    }
 
-        if(under>-1) {
-            if(at>-1) {
-                return new Locale(locale.substring(0, under), locale.substring(under+1, at), locale.substring(at+1));
-            }
-            return new Locale(locale.substring(0, under), locale.substring(under+1));
-        }
-        if(at>-1) {
-            return new Locale(locale.substring(0, at), "", locale.substring(at+1));
+    /**
+    * Obtain the string of the given bytes, one char per byte.
+    */
+    private static String getLatin1(byte[] b, int start, int end) {
+        char[] chars= new char[end-start];
+        for(int i= start; i<end; ++i) {
+            chars[i-start]= (char)(b[i] & 0xff);
         }
-        return new Locale(locale);
+        return new String(chars);
     }
 
-    private static boolean localeIsEffective(Locale locale) {
+    private static String[] getDefaultLocale() {
         Locale dl= Locale.getDefault();
+        return new String[] { dl.getLanguage(), dl.getCountry(), dl.getVariant() };
+    }
 
-        if(!locale.getLanguage().equals(dl.getLanguage())) {
-            return false;
-        }
-
-        String country= locale.getCountry();
-        if(country.length()>0 && !country.equals(dl.getCountry())) {
+    private static boolean localeIsEffective(String[] locale, String[] defaultLocale) {
+        if(!locale[0].equals(defaultLocale[0])) {
             return false;
         }
 
-        String variant= locale.getVariant();
-        if(variant!=null && !variant.equals(dl.getVariant())) {
+        String country= locale[1];
+        if(country.length()>0 && !country.equals(defaultLocale[1])) {
             return false;
         }
 
-        return true;
+        return locale[2].equalsIgnoreCase(defaultLocale[2]);
     }
 
-    private static boolean moreEffective(Locale oldValue, Locale newValue) {
+    private static boolean moreEffective(String[] oldValue, String[] newValue) {
         if(oldValue==null)
             return true;
 
         if(newValue==null)
             return false;
 
-        if(oldValue.getCountry().length()>newValue.getCountry().length())
+        if(oldValue[1].length()>newValue[1].length())
             return false;
 
-        String oldVariant= oldValue.getVariant();
-        return oldVariant==null || oldVariant.length()==0;
+        return oldValue[2].length()==0;
     }
 
     private static Comparator entryComparator= new Comparator() {
@@ -302,7 +457,11 @@ public class XdgDesktopReader {
     *  The key of the Map.Entry element is the name of a Group, the value of the Map.Entry element is the Group.
     */
     public Iterator getGroups() {
-        return mapEntryIterator(groups);
+        synchronized(groups) {
+            if(sortedGroups==null)
+                sortedGroups= createEntries(groups);
+        }
+        return mapEntryIterator(sortedGroups);
     }
 
     /**
@@ -311,17 +470,17 @@ public class XdgDesktopReader {
     * @return null, if no group found with the given name; otherwise, the group of entries.
     */
     public Group getGroup(String groupName) {
-        int index= Arrays.binarySearch(groups, groupName, entryComparator);
-        return index<0 ?null :(Group)groups[index].getValue();
+        return (Group)groups.get(groupName);
     }
 
     static private Pattern semiColon= Pattern.compile(";");
 
     public static class Group {
 
-        private final Map.Entry[] entries;
+        private final Map entries;     // key to value
+        private Map.Entry[] sortedEntries;
 
-        Group(Map.Entry[] entries) {
+        Group(Map entries) {
             this.entries= entries;
         }
 
@@ -331,7 +490,11 @@ public class XdgDesktopReader {
         *  The key of the Map.Entry element is the name of the entry, the value of the Map.Entry element is the value of the entry.
         */
         public Iterator getEntries() {
-            return mapEntryIterator(entries);
+            synchronized(entries) {
+                if(sortedEntries==null)
+                    sortedEntries= createEntries(entries);
+            }
+            return mapEntryIterator(sortedEntries);
         }
     
         /**
@@ -340,8 +503,7 @@ public class XdgDesktopReader {
         * @return null, if no entry found with the given name; otherwise, the value of the entry.
         */
         public String getString(String entryName) {
-            int index= Arrays.binarySearch(entries, entryName, entryComparator);
-            return index<0 ?null :entries[index].getValue().toString();
+            return (String)entries.get(entryName);
         }
 
         /**
@@ -18,7 +18,9 @@
 package org.jdesktop.jdic.icons.impl;
 
 import java.io.File;
+import java.util.HashMap;
 import java.util.Iterator;
+import java.util.Map;
 import java.util.regex.Pattern;
 
 /**
@@ -60,7 +62,20 @@ public class XdgDirectory {
     * @param variableName The name of the environment variable to obtain.
     * @return The value of the environment variable.  Return a null if variable is not set or is an empty string.
     */
-    private static native String getEnvironmentVariable(String variableName);
+    private static String getEnvironmentVariable(String variableName) {
+        // the environment of the process does not change under Java
+        synchronized(environment) {
+            if(environment.containsKey(variableName))
+                return (String)environment.get(variableName);
+            String value= getEnvironmentValue(variableName);
+            environment.put(variableName, value);
+            return value;
+        }
+    }
+
+    private static final Map environment= new HashMap();
+
+    private static native String getEnvironmentValue(String variableName);
 
     /**
     * Obtain the value of a gconf key
@@ -69,6 +84,20 @@ public class XdgDirectory {
     */
     native static String getGconfValue(String key);
 
+    /**
+    * Obtain the values of several gconf keys at once.  Settings are served
+    * from a gconf client kept by native code, which preloads the GNOME
+    * interface and URL handler settings and follows their changes.
+    * @param keys The names of the gconf variables to obtain.
+    * @return The value of each gconf variable, or null if it is not set.
+    */
+    native static String[] getGconfValues(String[] keys);
+
+    /**
+    * Obtain a number which changes whenever one of the preloaded gconf settings changes.
+    */
+    native static int getGconfSerial();
+
     /**
     * Obtain File based upon value of environment variable.  A default 
     * location is used if the environment variable is not set or is empty.
@@ -0,0 +1,96 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+package org.jdesktop.jdic.icons.impl;
+
+import java.io.File;
+
+/**
+* The icon-theme.cache of a theme directory, as written by gtk-update-icon-cache.
+* The cache file is mapped into memory by native code and queried in place.
+*/
+class XdgIconCache {
+
+    static final int HAS_SUFFIX_XPM= 1;
+    static final int HAS_SUFFIX_SVG= 2;
+    static final int HAS_SUFFIX_PNG= 4;
+
+    private long cache;
+    private final String[] directories;
+
+    private XdgIconCache(long cache, String[] directories) {
+        this.cache= cache;
+        this.directories= directories;
+    }
+
+    /**
+    * Open the icon-theme.cache of a theme directory.
+    * @param themeDir The base directory of the theme.
+    * @return The cache, or null if there is no cache or it is older than the theme directory.
+    */
+    static XdgIconCache open(File themeDir) {
+        if(!XdgDirectory.isLoaded())
+            return null;
+
+        File file= new File(themeDir, "icon-theme.cache");
+        long modTime= file.lastModified();
+        if(modTime==0 || modTime<themeDir.lastModified())
+            return null;
+
+        long cache= open(file.getPath());
+        if(cache==0)
+            return null;
+
+        String[] directories= getDirectories(cache);
+        if(directories==null) {
+            close(cache);
+            return null;
+        }
+        return new XdgIconCache(cache, directories);
+    }
+
+    /**
+    * Obtain the directories of the theme, relative to the theme directory.
+    * Images found by lookup() refer to this array by index.
+    */
+    String[] getDirectories() {
+        return directories;
+    }
+
+    /**
+    * Find the images of an icon.
+    * @param iconName The name of the icon, without extension.
+    * @param images Receives the directory index of each image in the high
+    * 16 bits, and its HAS_SUFFIX flags in the low 16 bits.
+    * @return The number of images of the icon, which may be larger than the images array.
+    */
+    int lookup(String iconName, int[] images) {
+        return lookup(cache, iconName, images);
+    }
+
+    protected void finalize() {
+        if(cache!=0) {
+            close(cache);
+            cache= 0;
+        }
+    }
+
+    private static native long open(String path);
+    private static native void close(long cache);
+    private static native String[] getDirectories(long cache);
+    private static native int lookup(long cache, String iconName, int[] images);
+}
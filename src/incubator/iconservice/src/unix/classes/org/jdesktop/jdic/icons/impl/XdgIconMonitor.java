@@ -0,0 +1,140 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+package org.jdesktop.jdic.icons.impl;
+
+import java.io.File;
+
+import java.lang.ref.WeakReference;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Map;
+
+/**
+* Watches the directories of icon themes for changes, using inotify.
+* A daemon thread waits for changes and invalidates the themes watching
+* the changed directories, so themes need not check their files themselves.
+*/
+class XdgIconMonitor {
+
+    /**
+    * not instantiable
+    */
+    private XdgIconMonitor() {
+    }
+
+    private static final int fd= XdgDirectory.isLoaded() ?init() :-1;
+
+    private static Map watches= new HashMap();  // Integer watch to List of WeakReference to XdgIconTheme
+    private static Thread thread;
+
+    /**
+    * Can directories be watched on this platform?
+    */
+    static boolean isAvailable() {
+        return fd>=0;
+    }
+
+    /**
+    * Invalidate a theme when the entries of a directory change, or the directory itself is removed.
+    * @param dir The directory to watch.
+    * @param theme The theme to invalidate.
+    * @return false, if the directory could not be watched.
+    */
+    static boolean watch(File dir, XdgIconTheme theme) {
+        if(fd<0)
+            return false;
+
+        synchronized(watches) {
+            // under the lock, so that events of the watch are not taken for a stale watch
+            int wd= addWatch(fd, dir.getPath());
+            if(wd<0)
+                return false;
+
+            Integer key= new Integer(wd);
+            List themes= (List)watches.get(key);
+            if(themes==null) {
+                themes= new ArrayList(1);
+                watches.put(key, themes);
+            }
+
+            for(Iterator it= themes.iterator(); it.hasNext(); ) {
+                Object watcher= ((WeakReference)it.next()).get();
+                if(watcher==theme)
+                    return true;
+                if(watcher==null)
+                    it.remove();
+            }
+            themes.add(new WeakReference(theme));
+
+            if(thread==null) {
+                thread= new Thread("XdgIconMonitor") {
+                    public void run() {
+                        readEvents();
+                    }
+                };
+                thread.setDaemon(true);
+                thread.start();
+            }
+        }
+        return true;
+    }
+
+    private static void readEvents() {
+        int[] changed= new int[64];
+        for(;;) {
+            int n= readEvents(fd, changed);
+            if(n<0)
+                return;
+
+            List invalid= new ArrayList();
+            synchronized(watches) {
+                for(int i= 0; i<n; ++i) {
+                    if(changed[i]==-1) {
+                        // events were lost: everything may have changed
+                        for(Iterator it= watches.values().iterator(); it.hasNext(); ) {
+                            invalid.addAll((List)it.next());
+                        }
+                        watches.clear();
+                        break;
+                    }
+
+                    // themes watch their directories again when they are rebuilt
+                    List themes= (List)watches.remove(new Integer(changed[i]));
+                    if(themes!=null)
+                        invalid.addAll(themes);
+                    else
+                        removeWatch(fd, changed[i]);
+                }
+            }
+
+            for(Iterator it= invalid.iterator(); it.hasNext(); ) {
+                XdgIconTheme theme= (XdgIconTheme)((WeakReference)it.next()).get();
+                if(theme!=null)
+                    theme.invalidate();
+            }
+        }
+    }
+
+    private static native int init();
+    private static native int addWatch(int fd, String path);
+    private static native void removeWatch(int fd, int wd);
+    private static native int readEvents(int fd, int[] watches);
+}
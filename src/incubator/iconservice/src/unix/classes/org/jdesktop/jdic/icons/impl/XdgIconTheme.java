@@ -42,28 +42,123 @@ public class XdgIconTheme {
     private long lastModTime;
     private List directories;
     private List inherits;
+    private Map icons;    // icon name to List of Entry, in directory order
+    private List caches;  // Cache of the base directories with a valid icon-theme.cache
+    private List stamps;  // Stamp of each directory and cache read, when they are not watched
+    private volatile boolean stale;   // set by XdgIconMonitor when a watched directory changes
+
+    private static volatile int version;  // changed whenever any theme is invalidated or reread
 
     XdgIconTheme(String name) {
         this.name= name==null ?"hicolor" :name;
         directories= new ArrayList();
         inherits= new ArrayList();
+        icons= new HashMap();
+        caches= new ArrayList();
+        stamps= new ArrayList();
+        reload();
+    }
+
+    private void reload() {
         readIndex();
         if(inherits.size()==0 && !name.equals("hicolor")) {
             inherits.add(new XdgIconTheme("hicolor"));
         }
     }
 
+    /**
+    * Rebuild the theme before its next lookup.
+    */
+    void invalidate() {
+        stale= true;
+        ++version;
+    }
+
+    /**
+    * Obtain a number which changes whenever the icons of any theme may have changed.
+    */
+    static int getVersion() {
+        return version;
+    }
+
     String getName() {
         return name;
     }
 
     File getIcon(String iconName, int size) {
-        Fit fit= new Fit(iconName, size);
-        fit.findIconThatFits(this);
-        if(fit.bestFit!=null)
-            return fit.bestFit;
+        return getIcons(new String[] { iconName }, size)[0];
+    }
+
+    /**
+    * Find the icons of several names at once.  Each theme is searched
+    * once, for all the icons not yet found in the requested size.
+    * @return The icon file of each name, or null.
+    */
+    File[] getIcons(String[] iconNames, int size) {
+        Fit[] fits= new Fit[iconNames.length];
+        List pending= new ArrayList(iconNames.length);
+        for(int i= 0; i<iconNames.length; ++i) {
+            if(iconNames[i]!=null) {
+                fits[i]= new Fit(iconNames[i], size);
+                pending.add(fits[i]);
+            }
+        }
 
-        return getIconFile(iconName);
+        findIconsThatFit(pending, this, new HashMap());
+
+        File[] files= new File[iconNames.length];
+        for(int i= 0; i<iconNames.length; ++i) {
+            if(fits[i]!=null && fits[i].bestFit!=null)
+                files[i]= fits[i].bestFit;
+            else
+                files[i]= getIconFile(iconNames[i]);
+        }
+        return files;
+    }
+
+    /**
+    * Search a theme, and then its parents, for the icons that have not been found in the requested size.
+    * @param pending The Fit of each icon, removed once it is found in the requested size.
+    * @param beenHere themeName to theme
+    */
+    private static void findIconsThatFit(List pending, XdgIconTheme theme, Map beenHere) {
+        beenHere.put(theme.getName(), theme);
+
+        XdgIconTheme[] parents= theme.findIcons(pending);
+        for(int i= 0; i<parents.length && pending.size()>0; ++i) {
+            if(beenHere.get(parents[i].getName())!=null)
+                continue;
+
+            findIconsThatFit(pending, parents[i], beenHere);
+        }
+    }
+
+    /**
+    * Search this theme for each pending icon.
+    * @return The parents of this theme.
+    */
+    private synchronized XdgIconTheme[] findIcons(List pending) {
+        if(!XdgIconMonitor.isAvailable()) {
+            reload();
+        }
+        else if(stale) {
+            stale= false;
+            reload();
+        }
+
+        for(Iterator it= pending.iterator(); it.hasNext(); ) {
+            Fit fit= (Fit)it.next();
+            fit.themeFit= null;
+            findIcon(fit);
+            if(fit.themeFit!=null && fit.themeError<fit.minError) {
+                fit.minError= fit.themeError;
+                fit.bestFit= fit.themeFit;
+                if(fit.minError==0)
+                    it.remove();
+            }
+        }
+
+        return (XdgIconTheme[])inherits.toArray(new XdgIconTheme[inherits.size()]);
     }
 
     private static String home;
@@ -109,12 +204,22 @@ public class XdgIconTheme {
 
     static private Pattern comma= Pattern.compile(",");
 
+    /**
+    * Read index.theme and index the icons of the theme.  If the theme
+    * directories are watched by XdgIconMonitor, the theme is read again
+    * only after it has been invalidated.  Otherwise index.theme, and the
+    * directories and caches the icons were indexed from, are checked for
+    * modification every 5 seconds.
+    */
     private void readIndex() {
-        long currentTime= System.currentTimeMillis();
-        if(currentTime-lastReadTime <5000) {
-            return;
+        boolean monitored= XdgIconMonitor.isAvailable();
+        if(!monitored) {
+            long currentTime= System.currentTimeMillis();
+            if(currentTime-lastReadTime <5000) {
+                return;
+            }
+            lastReadTime= currentTime;
         }
-        lastReadTime= currentTime;
 
         File indexTheme= getThemeFile("index.theme");
         if(indexTheme==null) {
@@ -124,14 +229,20 @@ public class XdgIconTheme {
             }
         }
 
-        long modTime= indexTheme.lastModified();
-        if(lastModTime==modTime) {
-            return;
+        if(!monitored) {
+            long modTime= indexTheme.lastModified();
+            if(lastModTime==modTime && !stampsChanged()) {
+                return;
+            }
+            lastModTime= modTime;
         }
-        lastModTime= modTime;
 
+        ++version;
         inherits.clear();
         directories.clear();
+        icons.clear();
+        caches.clear();
+        stamps.clear();
 
         try {
             XdgDesktopReader index= new XdgDesktopReader(indexTheme);
@@ -150,13 +261,14 @@ public class XdgIconTheme {
                         continue;
         
                     try {
-                        Directory dir= new Directory(dirName, dirGroup);
+                        Directory dir= new Directory(dirName, directories.size(), dirGroup);
                         directories.add(dir);
                     }
                     catch(Exception ex) {
                     }
                 }
             }
+            listDirectories(monitored);
     
             Iterator inh= group.getStrings("Inherits", comma);
             if(inh!=null) {
@@ -170,56 +282,261 @@ public class XdgIconTheme {
         }
     }
 
-    private static class Fit {
-
-        final String iconName;
-        final int size;
+    static private final String[] extensions= { ".png", ".svg", ".xpm" };
 
-        int minError;
-        File bestFit;
+    static private final int[] suffixFlags= {
+        XdgIconCache.HAS_SUFFIX_PNG, XdgIconCache.HAS_SUFFIX_SVG, XdgIconCache.HAS_SUFFIX_XPM
+    };
 
-        Map beenHere;    // themeName to theme
+    /**
+    * Index the icons of each base directory of the theme.  A base directory
+    * with an up to date icon-theme.cache is queried through the cache.
+    * Otherwise every directory of the theme is listed once, and the files
+    * found are indexed by file name and by icon name without extension.
+    * @param watch Watch the base directories, and the listed directories, for changes.
+    */
+    private void listDirectories(boolean watch) {
+        List bases= new ArrayList();
+        File f= new File(getHome()+"/.icons/"+name);
+        if(f.canRead())
+            bases.add(f);
+        for(Iterator it= XdgDirectory.getDataDirs("/icons/"+name); it.hasNext(); ) {
+            bases.add(it.next());
+        }
 
-        Fit(String iconName, int size) {
-            this.iconName= iconName;
-            this.size= size;
-            minError= Integer.MAX_VALUE;
-            beenHere= new HashMap();
+        if(watch) {
+            for(Iterator it= bases.iterator(); it.hasNext(); ) {
+                XdgIconMonitor.watch((File)it.next(), this);
+            }
+        }
+        else {
+            // a home theme directory created later is noticed as well
+            if(!f.canRead())
+                stamps.add(new Stamp(f));
+            for(Iterator it= bases.iterator(); it.hasNext(); ) {
+                File baseDir= (File)it.next();
+                stamps.add(new Stamp(baseDir));
+                stamps.add(new Stamp(new File(baseDir, "icon-theme.cache")));
+            }
         }
 
-        boolean findIconThatFits(XdgIconTheme theme) {
+        Map dirsByName= new HashMap();
+        for(Iterator dirs= directories.iterator(); dirs.hasNext(); ) {
+            Directory directory= (Directory)dirs.next();
+            dirsByName.put(directory.dirName, directory);
+        }
 
-            beenHere.put(theme.getName(), theme);
+        List listed= new ArrayList();
+        for(int base= 0; base<bases.size(); ++base) {
+            File baseDir= (File)bases.get(base);
+            XdgIconCache iconCache= XdgIconCache.open(baseDir);
+            if(iconCache!=null)
+                caches.add(new Cache(iconCache, baseDir, base, dirsByName));
+            else
+                listed.add(new Integer(base));
+        }
+        if(listed.size()==0)
+            return;
 
-            for(Iterator dirs= theme.directories.iterator(); dirs.hasNext(); ) {
-                Directory directory= (Directory)dirs.next();
-                int err= directory.error(size);
-                if(err==0) {
-                    File f= directory.getDirectoryIcon(iconName);
-                    if(f!=null) {
-                        bestFit= f;
-                        return true;
+        for(Iterator dirs= directories.iterator(); dirs.hasNext(); ) {
+            Directory directory= (Directory)dirs.next();
+            for(Iterator it= listed.iterator(); it.hasNext(); ) {
+                int base= ((Integer)it.next()).intValue();
+                File dir= new File((File)bases.get(base), directory.dirName);
+                if(!watch)
+                    stamps.add(new Stamp(dir));
+                String[] files= dir.list();
+                if(files==null)
+                    continue;
+                if(watch)
+                    XdgIconMonitor.watch(dir, this);
+
+                for(int i= 0; i<files.length; ++i) {
+                    String fileName= files[i];
+                    File file= new File(dir, fileName);
+                    addEntry(fileName, directory, base, file, 0);
+                    for(int e= 0; e<extensions.length; ++e) {
+                        if(fileName.endsWith(extensions[e])) {
+                            String iconName= fileName.substring(0, fileName.length()-extensions[e].length());
+                            addEntry(iconName, directory, base, file, e+1);
+                            break;
+                        }
                     }
                 }
-                if(err<minError) {
-                    File f= directory.getDirectoryIcon(iconName);
-                    if(f!=null) {
-                        minError= err;
-                        bestFit= f;
+            }
+        }
+    }
+
+    /**
+    * Check whether any directory or cache the icons were indexed from has
+    * been modified since.
+    */
+    private boolean stampsChanged() {
+        for(Iterator it= stamps.iterator(); it.hasNext(); ) {
+            Stamp stamp= (Stamp)it.next();
+            if(stamp.file.lastModified()!=stamp.modTime)
+                return true;
+        }
+        return false;
+    }
+
+    private void addEntry(String iconName, Directory directory, int base, File file, int rank) {
+        List entries= (List)icons.get(iconName);
+        if(entries==null) {
+            entries= new ArrayList(1);
+            icons.put(iconName, entries);
+        }
+        else {
+            // directories are listed one after the other, so an earlier
+            // entry from the same directory can only be the last one
+            Entry last= (Entry)entries.get(entries.size()-1);
+            if(last.directory==directory && last.base==base) {
+                if(last.rank<=rank)
+                    return;
+                entries.remove(entries.size()-1);
+            }
+        }
+        entries.add(new Entry(directory, base, file, rank));
+    }
+
+    /**
+    * Offer the icons of this theme to fit.
+    */
+    private void findIcon(Fit fit) {
+        List entries= (List)icons.get(fit.iconName);
+        if(entries!=null) {
+            for(Iterator it= entries.iterator(); it.hasNext(); ) {
+                Entry entry= (Entry)it.next();
+                fit.offer(entry.directory, entry.base, entry.file);
+            }
+        }
+
+        if(caches.size()==0)
+            return;
+
+        // icon-theme.cache knows icons by name without extension
+        String iconName= fit.iconName;
+        int wanted= 0;
+        for(int e= 0; e<extensions.length; ++e) {
+            if(iconName.endsWith(extensions[e])) {
+                iconName= iconName.substring(0, iconName.length()-extensions[e].length());
+                wanted= suffixFlags[e];
+                break;
+            }
+        }
+
+        for(Iterator it= caches.iterator(); it.hasNext(); ) {
+            Cache cache= (Cache)it.next();
+            int n= cache.iconCache.lookup(iconName, fit.images);
+            if(n>fit.images.length) {
+                fit.images= new int[n];
+                n= cache.iconCache.lookup(iconName, fit.images);
+            }
+
+            for(int i= 0; i<n; ++i) {
+                int dirIndex= fit.images[i]>>>16;
+                int flags= fit.images[i]&0xffff;
+                if(dirIndex>=cache.directories.length || cache.directories[dirIndex]==null)
+                    continue;
+
+                String extension= null;
+                for(int e= 0; e<extensions.length; ++e) {
+                    if((flags & suffixFlags[e])!=0 && (wanted==0 || wanted==suffixFlags[e])) {
+                        extension= extensions[e];
+                        break;
                     }
                 }
+                if(extension==null)
+                    continue;
+
+                Directory directory= cache.directories[dirIndex];
+                File file= new File(cache.baseDir, directory.dirName+"/"+iconName+extension);
+                fit.offer(directory, cache.base, file);
             }
+        }
+    }
 
-            for(Iterator inh= theme.inherits.iterator(); inh.hasNext(); ) {
-                XdgIconTheme parent= (XdgIconTheme)inh.next();
-                if(beenHere.get(parent.getName())!=null)
-                    continue;
+    private static class Entry {
+        final Directory directory;
+        final int base;     // index of the base directory
+        final File file;
+        final int rank;     // 0 for the exact file name, else extension preference
+
+        Entry(Directory directory, int base, File file, int rank) {
+            this.directory= directory;
+            this.base= base;
+            this.file= file;
+            this.rank= rank;
+        }
+    }
 
-                if(findIconThatFits(parent))
-                    return true;
+    private static class Stamp {
+        final File file;
+        final long modTime;     // 0 if the file did not exist
+
+        Stamp(File file) {
+            this.file= file;
+            this.modTime= file.lastModified();
+        }
+    }
+
+    private static class Cache {
+        final XdgIconCache iconCache;
+        final File baseDir;
+        final int base;     // index of the base directory
+        final Directory[] directories;  // theme directory of each cache directory, or null
+
+        Cache(XdgIconCache iconCache, File baseDir, int base, Map dirsByName) {
+            this.iconCache= iconCache;
+            this.baseDir= baseDir;
+            this.base= base;
+
+            String[] names= iconCache.getDirectories();
+            directories= new Directory[names.length];
+            for(int i= 0; i<names.length; ++i) {
+                if(names[i]!=null)
+                    directories[i]= (Directory)dirsByName.get(names[i]);
             }
+        }
+    }
+
+    private static class Fit {
 
-            return false;
+        final String iconName;
+        final int size;
+
+        int minError;
+        File bestFit;
+
+        // best icon of the theme being searched
+        int themeError;
+        Directory themeDirectory;
+        int themeBase;
+        File themeFit;
+
+        int[] images= new int[8];
+
+        Fit(String iconName, int size) {
+            this.iconName= iconName;
+            this.size= size;
+            minError= Integer.MAX_VALUE;
+        }
+
+        /**
+        * Consider an icon of the theme being searched.  Of the icons that
+        * fit equally well, the one in the first directory of the theme wins,
+        * and then the one in the first base directory.
+        */
+        void offer(Directory directory, int base, File file) {
+            int err= directory.error(size);
+            if(themeFit==null || err<themeError
+                || err==themeError && (directory.index<themeDirectory.index
+                    || directory.index==themeDirectory.index && base<themeBase)) {
+                themeError= err;
+                themeDirectory= directory;
+                themeBase= base;
+                themeFit= file;
+            }
         }
     };
 
@@ -227,9 +544,11 @@ public class XdgIconTheme {
         int maxSize;
         int minSize;
         final String dirName;
+        final int index;    // position in the Directories list of the theme
 
-        Directory(String dirName, XdgDesktopReader.Group group) {
+        Directory(String dirName, int index, XdgDesktopReader.Group group) {
             this.dirName= dirName;
+            this.index= index;
 
             Integer i= group.getInteger("Size");
             if(i==null)
@@ -264,10 +583,6 @@ public class XdgIconTheme {
 
             return 0;
         }
-
-        File getDirectoryIcon(String iconName) {
-            return getThemeFile(dirName+"/"+iconName);
-        }
     }
 
 }                                                          
@@ -0,0 +1,108 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+package org.jdesktop.jdic.icons.impl;
+
+import java.io.File;
+import java.io.IOException;
+import java.io.UnsupportedEncodingException;
+
+import java.security.MessageDigest;
+import java.security.NoSuchAlgorithmException;
+
+/**
+* Renders scalable icons to PNG files of the requested size, which AWT can
+* decode.  The rendered files are kept in ${cache directory}/jdic/icons,
+* named after the icon file, its modification time and the size, so an
+* icon is rendered only once in each size until it changes.
+*/
+class XdgSvgRasterizer {
+
+    /**
+    * not instantiable
+    */
+    private XdgSvgRasterizer() {
+    }
+
+    /**
+    * Obtain a PNG file of an SVG icon, rendered at the given size.
+    * @param svg The SVG icon.
+    * @param size The width and height of the rendered icon.
+    * @return The PNG file, or null if the icon could not be rendered.
+    */
+    static File getRaster(File svg, int size) {
+        if(!XdgDirectory.isLoaded() || size<=0)
+            return null;
+
+        long modTime= svg.lastModified();
+        if(modTime==0)
+            return null;
+
+        String digest= getDigest(svg.getAbsolutePath());
+        if(digest==null)
+            return null;
+
+        File dir= new File(XdgDirectory.getCacheDir(), "jdic/icons");
+        File raster= new File(dir, digest+"-"+Long.toHexString(modTime)+"-"+size+".png");
+        if(raster.exists())
+            return raster;
+
+        if(!dir.isDirectory() && !dir.mkdirs())
+            return null;
+
+        // render to a temporary file, so that no other process sees a partial file
+        File temp;
+        try {
+            temp= File.createTempFile("raster", ".tmp", dir);
+        }
+        catch(IOException ex) {
+            return null;
+        }
+
+        if(!rasterize(svg.getPath(), size, temp.getPath())) {
+            temp.delete();
+            return null;
+        }
+        if(!temp.renameTo(raster)) {
+            temp.delete();
+            return raster.exists() ?raster :null;
+        }
+        return raster;
+    }
+
+    private static final char[] hexDigits= "0123456789abcdef".toCharArray();
+
+    private static String getDigest(String path) {
+        try {
+            byte[] digest= MessageDigest.getInstance("MD5").digest(path.getBytes("UTF-8"));
+            char[] hex= new char[digest.length*2];
+            for(int i= 0; i<digest.length; ++i) {
+                hex[2*i]= hexDigits[(digest[i]>>4) & 0xF];
+                hex[2*i+1]= hexDigits[digest[i] & 0xF];
+            }
+            return new String(hex);
+        }
+        catch(NoSuchAlgorithmException ex) {
+            return null;
+        }
+        catch(UnsupportedEncodingException ex) {
+            return null;
+        }
+    }
+
+    private static native boolean rasterize(String svgPath, int size, String pngPath);
+}
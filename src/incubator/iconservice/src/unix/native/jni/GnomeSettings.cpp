@@ -0,0 +1,197 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+/*
+ * GConf settings read by the icon code, a copy of the GnomeSettings module
+ * of JDIC, which this library doesn't link against.  One GConf client is 
+ * kept for the life of the library.  The directories holding the settings 
+ * used are preloaded into it in one batch, and it keeps them up to date 
+ * from change notifications, so reading a setting does not go to the GConf
+ * daemon.  Values read are also kept in gSettings, and removed from it 
+ * when they change.
+ *
+ * The client belongs to a thread of its own, which runs a private main
+ * context.  The client is created with that context as the thread default,
+ * so its notifications are dispatched there, and settings which are not
+ * cached yet are fetched there too.  No other main context is ever
+ * iterated, so sources the application attaches to the default context
+ * are never dispatched on the threads that ask for settings.
+ */
+
+#include "GnomeSettings.h"
+#include <pthread.h>
+
+#include <glib.h>
+#include <gconf/gconf-client.h>
+
+static const char *gPreloadDirs[] = {
+    "/desktop/gnome/interface",       // icon theme
+};
+
+static pthread_once_t gSettingsOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t gSettingsMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gSettingsCond = PTHREAD_COND_INITIALIZER;
+static GMainContext *gContext = NULL;
+static GConfClient *gClient = NULL;     // used on the settings thread only
+static GHashTable *gSettings = NULL;    // key to value, or NULL if the key is not set
+static int gSettingsSerial = 0;         // incremented whenever a setting changes
+static bool gSettingsReady = false;
+
+/* A request to fetch settings on the settings thread. */
+struct Fetch {
+    const char **keys;
+    char **values;
+    int count;
+    bool done;
+};
+
+static void SettingChanged(GConfClient *, guint, GConfEntry *entry, gpointer)
+{
+    pthread_mutex_lock(&gSettingsMutex);
+    g_hash_table_remove(gSettings, gconf_entry_get_key(entry));
+    ++gSettingsSerial;
+    pthread_mutex_unlock(&gSettingsMutex);
+}
+
+/* Called with gSettingsMutex locked.  Returns false if the key is not cached. */
+static bool LookupSetting(const char *key, char **value)
+{
+    gpointer cached;
+    if (!g_hash_table_lookup_extended(gSettings, key, NULL, &cached))
+        return false;
+    *value = g_strdup((const char *)cached);
+    return true;
+}
+
+static gboolean FetchSettings(gpointer data)
+{
+    Fetch *fetch = (Fetch *)data;
+
+    pthread_mutex_lock(&gSettingsMutex);
+    for (int i = 0; i < fetch->count; i++) {
+        if (fetch->keys[i] == NULL || LookupSetting(fetch->keys[i], &fetch->values[i]))
+            continue;
+        char *value = gconf_client_get_string(gClient, fetch->keys[i], NULL);
+        g_hash_table_insert(gSettings, g_strdup(fetch->keys[i]), value);
+        fetch->values[i] = g_strdup(value);
+    }
+    fetch->done = true;
+    pthread_cond_broadcast(&gSettingsCond);
+    pthread_mutex_unlock(&gSettingsMutex);
+
+    return FALSE;
+}
+
+static void *RunSettingsThread(void *)
+{
+    g_main_context_push_thread_default(gContext);
+
+    GConfClient *client = gconf_client_get_for_engine(gconf_engine_get_default());
+    for (size_t i = 0; i < sizeof(gPreloadDirs) / sizeof(gPreloadDirs[0]); i++) {
+        gconf_client_add_dir(client, gPreloadDirs[i],
+                             GCONF_CLIENT_PRELOAD_RECURSIVE, NULL);
+        gconf_client_notify_add(client, gPreloadDirs[i], SettingChanged,
+                                NULL, NULL, NULL);
+    }
+
+    pthread_mutex_lock(&gSettingsMutex);
+    gClient = client;
+    gSettingsReady = true;
+    pthread_cond_broadcast(&gSettingsCond);
+    pthread_mutex_unlock(&gSettingsMutex);
+
+    GMainLoop *loop = g_main_loop_new(gContext, FALSE);
+    g_main_loop_run(loop);
+    return NULL;
+}
+
+static void InitSettings()
+{
+#if !GLIB_CHECK_VERSION(2, 32, 0)
+    if (!g_thread_supported())
+        g_thread_init(NULL);
+#endif
+    g_type_init();
+    gContext = g_main_context_new();
+    gSettings = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    bool started = pthread_create(&thread, &attr, RunSettingsThread, NULL) == 0;
+    pthread_attr_destroy(&attr);
+
+    pthread_mutex_lock(&gSettingsMutex);
+    while (started && !gSettingsReady)
+        pthread_cond_wait(&gSettingsCond, &gSettingsMutex);
+    pthread_mutex_unlock(&gSettingsMutex);
+}
+
+void InitGconfSettings()
+{
+    pthread_once(&gSettingsOnce, InitSettings);
+}
+
+void GetGconfStrings(const char **keys, char **values, int count)
+{
+    InitGconfSettings();
+
+    // all the values under one lock, so that they are consistent with each other
+    pthread_mutex_lock(&gSettingsMutex);
+    bool cached = true;
+    for (int i = 0; i < count; i++) {
+        values[i] = NULL;
+        if (keys[i] != NULL && !LookupSetting(keys[i], &values[i]))
+            cached = false;
+    }
+    pthread_mutex_unlock(&gSettingsMutex);
+    if (cached || !gSettingsReady)
+        return;
+
+    for (int i = 0; i < count; i++) {
+        g_free(values[i]);
+        values[i] = NULL;
+    }
+    Fetch fetch = { keys, values, count, false };
+    GSource *source = g_idle_source_new();
+    g_source_set_callback(source, FetchSettings, &fetch, NULL);
+    g_source_attach(source, gContext);
+    g_source_unref(source);
+
+    pthread_mutex_lock(&gSettingsMutex);
+    while (!fetch.done)
+        pthread_cond_wait(&gSettingsCond, &gSettingsMutex);
+    pthread_mutex_unlock(&gSettingsMutex);
+}
+
+char *GetGconfString(const char *key)
+{
+    char *value;
+    GetGconfStrings(&key, &value, 1);
+    return value;
+}
+
+int GetGconfSerial()
+{
+    InitGconfSettings();
+
+    pthread_mutex_lock(&gSettingsMutex);
+    int serial = gSettingsSerial;
+    pthread_mutex_unlock(&gSettingsMutex);
+    return serial;
+}
@@ -0,0 +1,46 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+#ifndef _GnomeSettings_H_
+#define _GnomeSettings_H_
+
+/*
+ * Starts the GConf client.  Other functions call it as needed.
+ */
+void InitGconfSettings();
+
+/*
+ * Returns the value of a GConf string setting, or NULL if it is not set.
+ * The value is served from a cache kept up to date by GConf notifications,
+ * and is to be freed with g_free().
+ */
+char *GetGconfString(const char *key);
+
+/*
+ * Reads several GConf string settings at once, consistently with each
+ * other.  Each value is NULL if its key is NULL or not set, and is to be
+ * freed with g_free().
+ */
+void GetGconfStrings(const char **keys, char **values, int count);
+
+/*
+ * Returns a number which changes whenever one of the preloaded settings
+ * changes.
+ */
+int GetGconfSerial();
+
+#endif
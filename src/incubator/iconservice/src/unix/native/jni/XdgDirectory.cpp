@@ -17,21 +17,26 @@
 
 #include <jni.h>
 #include "XdgDirectory.h"
+#include "GnomeSettings.h"
 #include <stdlib.h>
 #include <glib.h>
-#include <gconf/gconf-client.h>
+
+/*
+ * GConf settings are read through GnomeSettings.cpp, which keeps one GConf
+ * client and caches the settings it reads.
+ */
 
 JNIEXPORT void JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_gConfInit
   (JNIEnv *env, jclass) {  
-    g_type_init();
+    InitGconfSettings();
 }
 
 /*
  * Class:     org_jdesktop_jdic_icons_impl_XdgDirectory
- * Method:    getEnvironmentVariable
+ * Method:    getEnvironmentValue
  * Signature: (Ljava/lang/String;)Ljava/lang/String;
  */
-JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getEnvironmentVariable
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getEnvironmentValue
   (JNIEnv *env, jclass, jstring key) {
 
     jboolean isCopy;
@@ -55,11 +60,10 @@ JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getEnvi
 JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getGconfValue
   (JNIEnv *env, jclass, jstring jKey) {
     char const *cKey= env->GetStringUTFChars(jKey, 0);
+    if(cKey==0)
+        return 0;
 
-    GConfClient *client = gconf_client_get_default();
-    char *cValue= gconf_client_get_string (client, cKey, NULL);
-    g_object_unref(client);
-
+    char *cValue= GetGconfString(cKey);
     env->ReleaseStringUTFChars(jKey, cKey);
 
     if(cValue==0)
@@ -70,4 +74,64 @@ JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getGcon
     return jValue;
 }
 
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgDirectory
+ * Method:    getGconfValues
+ * Signature: ([Ljava/lang/String;)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getGconfValues
+  (JNIEnv *env, jclass, jobjectArray jKeys) {
+    jsize count= env->GetArrayLength(jKeys);
+
+    jclass stringClass= env->FindClass("java/lang/String");
+    if(stringClass==0)
+        return 0;
+    jobjectArray jValues= env->NewObjectArray(count, stringClass, 0);
+    if(jValues==0)
+        return 0;
+
+    char const **cKeys= (char const **)g_malloc0(sizeof(char const *)*(count+1));
+    jstring *jKeyRefs= (jstring *)g_malloc0(sizeof(jstring)*(count+1));
+    char **cValues= (char **)g_malloc0(sizeof(char *)*(count+1));
+
+    for(jsize i= 0; i<count; ++i) {
+        jKeyRefs[i]= (jstring)env->GetObjectArrayElement(jKeys, i);
+        if(jKeyRefs[i]!=0)
+            cKeys[i]= env->GetStringUTFChars(jKeyRefs[i], 0);
+    }
+
+    GetGconfStrings(cKeys, cValues, count);
+
+    for(jsize i= 0; i<count; ++i) {
+        if(cKeys[i]!=0)
+            env->ReleaseStringUTFChars(jKeyRefs[i], cKeys[i]);
+        if(jKeyRefs[i]!=0)
+            env->DeleteLocalRef(jKeyRefs[i]);
+
+        if(cValues[i]!=0) {
+            jstring jValue= env->NewStringUTF(cValues[i]);
+            g_free(cValues[i]);
+            if(jValue!=0) {
+                env->SetObjectArrayElement(jValues, i, jValue);
+                env->DeleteLocalRef(jValue);
+            }
+        }
+    }
+
+    g_free(cValues);
+    g_free(jKeyRefs);
+    g_free(cKeys);
+    return jValues;
+}
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgDirectory
+ * Method:    getGconfSerial
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getGconfSerial
+  (JNIEnv *env, jclass) {
+    return GetGconfSerial();
+}
+
 
@@ -17,10 +17,10 @@ JNIEXPORT void JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_gConfInit
 
 /*
  * Class:     org_jdesktop_jdic_icons_impl_XdgDirectory
- * Method:    getEnvironmentVariable
+ * Method:    getEnvironmentValue
  * Signature: (Ljava/lang/String;)Ljava/lang/String;
  */
-JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getEnvironmentVariable
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getEnvironmentValue
   (JNIEnv *, jclass, jstring);
 
 /*
@@ -31,6 +31,22 @@ JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getEnvi
 JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getGconfValue
   (JNIEnv *, jclass, jstring);
 
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgDirectory
+ * Method:    getGconfValues
+ * Signature: ([Ljava/lang/String;)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getGconfValues
+  (JNIEnv *, jclass, jobjectArray);
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgDirectory
+ * Method:    getGconfSerial
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_icons_impl_XdgDirectory_getGconfSerial
+  (JNIEnv *, jclass);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,229 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+/*
+ * Reader for the icon-theme.cache files written by gtk-update-icon-cache.
+ * The file is mapped read only and queried in place.  All numbers are
+ * big endian:
+ *
+ *   Header:        u16 major (1), u16 minor (0), u32 hash, u32 directories
+ *   Directories:   u32 count, u32 offset of each directory name
+ *   Hash:          u32 buckets, u32 offset of the first icon of each bucket
+ *   Icon:          u32 next icon in chain, u32 name, u32 image list
+ *   Image list:    u32 count, then for each image u16 directory index,
+ *                  u16 flags, u32 image data
+ */
+
+#include <jni.h>
+#include "XdgIconCache.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+struct IconCache {
+    unsigned char const *buffer;
+    size_t size;
+};
+
+static unsigned int getUInt16(IconCache const *cache, size_t offset) {
+    unsigned char const *p= cache->buffer+offset;
+    return (p[0]<<8) | p[1];
+}
+
+static unsigned int getUInt32(IconCache const *cache, size_t offset) {
+    unsigned char const *p= cache->buffer+offset;
+    return ((unsigned int)p[0]<<24) | (p[1]<<16) | (p[2]<<8) | p[3];
+}
+
+/* Does [offset, offset+length) lie within the cache? */
+static bool isValid(IconCache const *cache, size_t offset, size_t length) {
+    return offset<=cache->size && length<=cache->size-offset;
+}
+
+/* Returns the NUL terminated string at offset, or 0. */
+static char const *getString(IconCache const *cache, size_t offset) {
+    if(offset>=cache->size)
+        return 0;
+    char const *s= (char const *)cache->buffer+offset;
+    return memchr(s, 0, cache->size-offset) ? s : 0;
+}
+
+/* The hash function of gtk-update-icon-cache, over signed chars. */
+static unsigned int iconNameHash(char const *name) {
+    signed char const *p= (signed char const *)name;
+    unsigned int h= *p;
+    if(h) {
+        for(++p; *p; ++p)
+            h= (h<<5)-h+*p;
+    }
+    return h;
+}
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconCache
+ * Method:    open
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconCache_open
+  (JNIEnv *env, jclass, jstring jPath) {
+    char const *path= env->GetStringUTFChars(jPath, 0);
+    if(path==0)
+        return 0;
+
+    int fd= open(path, O_RDONLY);
+    env->ReleaseStringUTFChars(jPath, path);
+    if(fd<0)
+        return 0;
+
+    struct stat st;
+    if(fstat(fd, &st)!=0 || st.st_size<12) {
+        close(fd);
+        return 0;
+    }
+
+    void *map= mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(map==MAP_FAILED)
+        return 0;
+
+    IconCache header= { (unsigned char const *)map, (size_t)st.st_size };
+    unsigned int hashOffset= getUInt32(&header, 4);
+    unsigned int dirsOffset= getUInt32(&header, 8);
+    if(getUInt16(&header, 0)!=1 || getUInt16(&header, 2)!=0
+        || !isValid(&header, hashOffset, 4) || !isValid(&header, dirsOffset, 4)) {
+        munmap(map, st.st_size);
+        return 0;
+    }
+
+    IconCache *cache= (IconCache *)malloc(sizeof(IconCache));
+    if(cache==0) {
+        munmap(map, st.st_size);
+        return 0;
+    }
+    *cache= header;
+    return (jlong)(size_t)cache;
+}
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconCache
+ * Method:    close
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconCache_close
+  (JNIEnv *env, jclass, jlong handle) {
+    IconCache *cache= (IconCache *)(size_t)handle;
+    if(cache==0)
+        return;
+
+    munmap((void *)cache->buffer, cache->size);
+    free(cache);
+}
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconCache
+ * Method:    getDirectories
+ * Signature: (J)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconCache_getDirectories
+  (JNIEnv *env, jclass, jlong handle) {
+    IconCache const *cache= (IconCache const *)(size_t)handle;
+
+    size_t dirsOffset= getUInt32(cache, 8);
+    unsigned int count= getUInt32(cache, dirsOffset);
+    if(count>(cache->size-dirsOffset-4)/4)
+        return 0;
+
+    jclass stringClass= env->FindClass("java/lang/String");
+    if(stringClass==0)
+        return 0;
+
+    jobjectArray dirs= env->NewObjectArray(count, stringClass, 0);
+    if(dirs==0)
+        return 0;
+
+    for(unsigned int i= 0; i<count; ++i) {
+        char const *name= getString(cache, getUInt32(cache, dirsOffset+4+4*i));
+        if(name==0)
+            continue;
+
+        jstring jName= env->NewStringUTF(name);
+        if(jName==0)
+            return 0;
+        env->SetObjectArrayElement(dirs, i, jName);
+        env->DeleteLocalRef(jName);
+    }
+    return dirs;
+}
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconCache
+ * Method:    lookup
+ * Signature: (JLjava/lang/String;[I)I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconCache_lookup
+  (JNIEnv *env, jclass, jlong handle, jstring jName, jintArray jImages) {
+    IconCache const *cache= (IconCache const *)(size_t)handle;
+
+    // icon names are short; longer ones cannot be looked up without copying
+    char name[256];
+    jsize length= env->GetStringLength(jName);
+    if(length>=(jsize)(sizeof(name)/3))
+        return 0;
+    env->GetStringUTFRegion(jName, 0, length, name);
+    name[env->GetStringUTFLength(jName)]= 0;
+
+    size_t hashOffset= getUInt32(cache, 4);
+    unsigned int buckets= getUInt32(cache, hashOffset);
+    // counts are checked by division, so that they can't wrap on 32 bits
+    if(buckets==0 || !isValid(cache, hashOffset, 4)
+       || buckets>(cache->size-hashOffset-4)/4)
+        return 0;
+
+    unsigned int bucket= iconNameHash(name)%buckets;
+    size_t iconOffset= getUInt32(cache, hashOffset+4+4*bucket);
+
+    // a chain longer than the file can hold icons is corrupt
+    for(size_t steps= cache->size/12; iconOffset!=0 && steps>0; --steps) {
+        if(!isValid(cache, iconOffset, 12))
+            return 0;
+
+        char const *iconName= getString(cache, getUInt32(cache, iconOffset+4));
+        if(iconName!=0 && strcmp(iconName, name)==0) {
+            size_t listOffset= getUInt32(cache, iconOffset+8);
+            if(!isValid(cache, listOffset, 4))
+                return 0;
+
+            unsigned int count= getUInt32(cache, listOffset);
+            if(count>(cache->size-listOffset-4)/8)
+                return 0;
+
+            jsize capacity= env->GetArrayLength(jImages);
+            for(unsigned int i= 0; i<count && (jsize)i<capacity; ++i) {
+                size_t image= listOffset+4+8*i;
+                jint value= (getUInt16(cache, image)<<16) | getUInt16(cache, image+2);
+                env->SetIntArrayRegion(jImages, i, 1, &value);
+            }
+            return count;
+        }
+        iconOffset= getUInt32(cache, iconOffset);
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+/* DO NOT EDIT THIS FILE - it is machine generated */
+#include <jni.h>
+/* Header for class org_jdesktop_jdic_icons_impl_XdgIconCache */
+
+#ifndef _Included_org_jdesktop_jdic_icons_impl_XdgIconCache
+#define _Included_org_jdesktop_jdic_icons_impl_XdgIconCache
+#ifdef __cplusplus
+extern "C" {
+#endif
+#undef org_jdesktop_jdic_icons_impl_XdgIconCache_HAS_SUFFIX_XPM
+#define org_jdesktop_jdic_icons_impl_XdgIconCache_HAS_SUFFIX_XPM 1L
+#undef org_jdesktop_jdic_icons_impl_XdgIconCache_HAS_SUFFIX_SVG
+#define org_jdesktop_jdic_icons_impl_XdgIconCache_HAS_SUFFIX_SVG 2L
+#undef org_jdesktop_jdic_icons_impl_XdgIconCache_HAS_SUFFIX_PNG
+#define org_jdesktop_jdic_icons_impl_XdgIconCache_HAS_SUFFIX_PNG 4L
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconCache
+ * Method:    open
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconCache_open
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconCache
+ * Method:    close
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconCache_close
+  (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconCache
+ * Method:    getDirectories
+ * Signature: (J)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconCache_getDirectories
+  (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconCache
+ * Method:    lookup
+ * Signature: (JLjava/lang/String;[I)I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconCache_lookup
+  (JNIEnv *, jclass, jlong, jstring, jintArray);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,128 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+/*
+ * Watches icon theme directories with inotify.  Platforms without inotify
+ * report that monitoring is not available, and the themes fall back to
+ * checking index.theme periodically.
+ */
+
+#include <jni.h>
+#include "XdgIconMonitor.h"
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+
+#define WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO \
+    | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF)
+#endif
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconMonitor
+ * Method:    init
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconMonitor_init
+  (JNIEnv *env, jclass) {
+#ifdef __linux__
+    return inotify_init();
+#else
+    return -1;
+#endif
+}
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconMonitor
+ * Method:    addWatch
+ * Signature: (ILjava/lang/String;)I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconMonitor_addWatch
+  (JNIEnv *env, jclass, jint fd, jstring jPath) {
+#ifdef __linux__
+    char const *path= env->GetStringUTFChars(jPath, 0);
+    if(path==0)
+        return -1;
+
+    int wd= inotify_add_watch(fd, path, WATCH_MASK | IN_ONLYDIR);
+    env->ReleaseStringUTFChars(jPath, path);
+    return wd;
+#else
+    return -1;
+#endif
+}
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconMonitor
+ * Method:    removeWatch
+ * Signature: (II)V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconMonitor_removeWatch
+  (JNIEnv *env, jclass, jint fd, jint wd) {
+#ifdef __linux__
+    inotify_rm_watch(fd, wd);
+#endif
+}
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconMonitor
+ * Method:    readEvents
+ * Signature: (I[I)I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconMonitor_readEvents
+  (JNIEnv *env, jclass, jint fd, jintArray jWatches) {
+#ifdef __linux__
+    char buffer[8192] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    ssize_t length;
+    do {
+        length= read(fd, buffer, sizeof(buffer));
+    } while(length<0 && errno==EINTR);
+    if(length<=0)
+        return -1;
+
+    // report each watch once, however many of its entries changed
+    jsize capacity= env->GetArrayLength(jWatches);
+    jint watches[256];
+    jsize count= 0;
+    for(char *p= buffer; p<buffer+length; ) {
+        struct inotify_event *event= (struct inotify_event *)p;
+        p+= sizeof(struct inotify_event)+event->len;
+
+        // an overflowed queue is reported as watch -1: everything may have changed
+        jint wd= (event->mask & IN_Q_OVERFLOW) ? -1 : event->wd;
+        jsize i= 0;
+        while(i<count && watches[i]!=wd)
+            ++i;
+        if(i<count)
+            continue;
+
+        if(count==capacity || count==(jsize)(sizeof(watches)/sizeof(watches[0]))) {
+            wd= -1;
+            count= 0;
+        }
+        watches[count++]= wd;
+        if(wd==-1)
+            break;
+    }
+    env->SetIntArrayRegion(jWatches, 0, count, watches);
+    return count;
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,45 @@
+/* DO NOT EDIT THIS FILE - it is machine generated */
+#include <jni.h>
+/* Header for class org_jdesktop_jdic_icons_impl_XdgIconMonitor */
+
+#ifndef _Included_org_jdesktop_jdic_icons_impl_XdgIconMonitor
+#define _Included_org_jdesktop_jdic_icons_impl_XdgIconMonitor
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconMonitor
+ * Method:    init
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconMonitor_init
+  (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconMonitor
+ * Method:    addWatch
+ * Signature: (ILjava/lang/String;)I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconMonitor_addWatch
+  (JNIEnv *, jclass, jint, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconMonitor
+ * Method:    removeWatch
+ * Signature: (II)V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconMonitor_removeWatch
+  (JNIEnv *, jclass, jint, jint);
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgIconMonitor
+ * Method:    readEvents
+ * Signature: (I[I)I
+ */
+JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_icons_impl_XdgIconMonitor_readEvents
+  (JNIEnv *, jclass, jint, jintArray);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,97 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+/*
+ * Renders SVG icons to PNG files with librsvg.  librsvg is loaded when it
+ * is first needed, so that the library works without it on systems where
+ * it is not installed.
+ */
+
+#include <jni.h>
+#include "XdgSvgRasterizer.h"
+#include <dlfcn.h>
+#include <pthread.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef void *(*RsvgPixbufFromFileAtSize)(char const *, int, int, GError **);
+typedef gboolean (*GdkPixbufSave)(void *, char const *, char const *, GError **, ...);
+
+static pthread_mutex_t gRsvgMutex= PTHREAD_MUTEX_INITIALIZER;
+static bool gRsvgLoaded;
+static RsvgPixbufFromFileAtSize gPixbufFromFileAtSize;
+static GdkPixbufSave gPixbufSave;
+
+/* Called with gRsvgMutex locked. */
+static bool LoadRsvg() {
+    if(gRsvgLoaded)
+        return gPixbufFromFileAtSize!=0;
+    gRsvgLoaded= true;
+
+    void *rsvg= dlopen("librsvg-2.so.2", RTLD_LAZY);
+    if(rsvg==0)
+        rsvg= dlopen("librsvg-2.so", RTLD_LAZY);
+    if(rsvg==0)
+        return false;
+
+    // gdk-pixbuf is a dependency of librsvg, so it is found through the same handle
+    gPixbufSave= (GdkPixbufSave)dlsym(rsvg, "gdk_pixbuf_save");
+    gPixbufFromFileAtSize= (RsvgPixbufFromFileAtSize)dlsym(rsvg, "rsvg_pixbuf_from_file_at_size");
+    if(gPixbufSave==0 || gPixbufFromFileAtSize==0) {
+        gPixbufFromFileAtSize= 0;
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgSvgRasterizer
+ * Method:    rasterize
+ * Signature: (Ljava/lang/String;ILjava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jdesktop_jdic_icons_impl_XdgSvgRasterizer_rasterize
+  (JNIEnv *env, jclass, jstring jSvgPath, jint size, jstring jPngPath) {
+    char const *svgPath= env->GetStringUTFChars(jSvgPath, 0);
+    if(svgPath==0)
+        return JNI_FALSE;
+    char const *pngPath= env->GetStringUTFChars(jPngPath, 0);
+    if(pngPath==0) {
+        env->ReleaseStringUTFChars(jSvgPath, svgPath);
+        return JNI_FALSE;
+    }
+
+    jboolean rc= JNI_FALSE;
+
+    // librsvg and gdk-pixbuf are not reliably thread safe
+    pthread_mutex_lock(&gRsvgMutex);
+    if(LoadRsvg()) {
+        GError *error= 0;
+        void *pixbuf= gPixbufFromFileAtSize(svgPath, size, size, &error);
+        if(pixbuf!=0) {
+            if(gPixbufSave(pixbuf, pngPath, "png", &error, (char *)0))
+                rc= JNI_TRUE;
+            g_object_unref(pixbuf);
+        }
+        if(error!=0)
+            g_error_free(error);
+    }
+    pthread_mutex_unlock(&gRsvgMutex);
+
+    env->ReleaseStringUTFChars(jPngPath, pngPath);
+    env->ReleaseStringUTFChars(jSvgPath, svgPath);
+    return rc;
+}
@@ -0,0 +1,21 @@
+/* DO NOT EDIT THIS FILE - it is machine generated */
+#include <jni.h>
+/* Header for class org_jdesktop_jdic_icons_impl_XdgSvgRasterizer */
+
+#ifndef _Included_org_jdesktop_jdic_icons_impl_XdgSvgRasterizer
+#define _Included_org_jdesktop_jdic_icons_impl_XdgSvgRasterizer
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+ * Class:     org_jdesktop_jdic_icons_impl_XdgSvgRasterizer
+ * Method:    rasterize
+ * Signature: (Ljava/lang/String;ILjava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jdesktop_jdic_icons_impl_XdgSvgRasterizer_rasterize
+  (JNIEnv *, jclass, jstring, jint, jstring);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -34,6 +34,33 @@ JNIEXPORT void JNICALL
 Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeSetEnv
   (JNIEnv *, jclass);
 
+/*
+ * Class:     org_jdesktop_jdic_browser_internal_WebBrowserUtil
+ * Method:    nativeLog
+ * Signature: (ILjava/lang/String;)V
+ */
+JNIEXPORT void JNICALL 
+Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeLog
+  (JNIEnv *, jclass, jint, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_browser_internal_WebBrowserUtil
+ * Method:    nativeGetLogLevel
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL 
+Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeGetLogLevel
+  (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jdesktop_jdic_browser_internal_WebBrowserUtil
+ * Method:    nativeSetLogLevel
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL 
+Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeSetLogLevel
+  (JNIEnv *, jclass, jint);
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,6 +25,7 @@
 #include "CC_DMWebKitView.h"
 #include "org_jdesktop_jdic_browser_WebKitWebBrowser.h"
 #include "WebBrowserUtil.h"
+#include "../../../share/native/utils/Logger.h"
 JavaVM *JVM = NULL;
 
 
@@ -111,3 +112,43 @@ Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeSetEnv
   (JNIEnv *env, jclass) {
   
 }
+
+/*
+ * Class:     org_jdesktop_jdic_browser_internal_WebBrowserUtil
+ * Method:    nativeLog
+ * Signature: (ILjava/lang/String;)V
+ */
+JNIEXPORT void JNICALL 
+Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeLog
+  (JNIEnv *env, jclass, jint level, jstring msg)
+{
+    const char *msgChars = env->GetStringUTFChars(msg, NULL);
+    if (msgChars == NULL)
+        return;
+    Log(level, msgChars);
+    env->ReleaseStringUTFChars(msg, msgChars);
+}
+
+/*
+ * Class:     org_jdesktop_jdic_browser_internal_WebBrowserUtil
+ * Method:    nativeGetLogLevel
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL 
+Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeGetLogLevel
+  (JNIEnv *, jclass)
+{
+    return GetLogLevel();
+}
+
+/*
+ * Class:     org_jdesktop_jdic_browser_internal_WebBrowserUtil
+ * Method:    nativeSetLogLevel
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL 
+Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeSetLogLevel
+  (JNIEnv *, jclass, jint level)
+{
+    SetLogLevel(level);
+}
@@ -284,4 +284,28 @@ public class BrowserEngineManager {
 		}
 		return activeEngine;
 	}
-}
\ No newline at end of file
+
+	/**
+	 * Sets the memory and disk budget of the active engine. It's applied when
+	 * the native browser starts, so it must be set before the first
+	 * <code>WebBrowser</code> is created.
+	 * 
+	 * @param budget
+	 *            the resource budget, or <code>null</code> for the browser
+	 *            defaults.
+	 * @see IBrowserEngine#setResourceBudget
+	 * @since 0.9.2
+	 */
+	public void setResourceBudget(BrowserResourceBudget budget) {
+		IBrowserEngine engine = getActiveEngine();
+		if (engine == null) {
+			return;
+		}
+		if (engine.isInitialized()) {
+			WebBrowserUtil.error("Engine " + engine.getBrowserName()
+					+ " has been initialized, the resource budget won't be"
+					+ " applied until the native browser is restarted.");
+		}
+		engine.setResourceBudget(budget);
+	}
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+package org.jdesktop.jdic.browser;
+
+/**
+ * A <code>BrowserResourceBudget</code> object bounds the memory and disk
+ * resources the embedded browser may use. It's handed to an engine through
+ * <code>IBrowserEngine.setResourceBudget()</code> or
+ * <code>BrowserEngineManager.setResourceBudget()</code> before the first
+ * <code>WebBrowser</code> is created, and applied by the native browser when
+ * it starts up. Changing the budget afterwards has no effect on the native
+ * browser already running.
+ * <p>
+ * All values default to <code>-1</code>, which leaves the browser's own
+ * default in place. Decoded images are kept in the memory cache by the
+ * Mozilla versions supported, so the memory cache size bounds them too.
+ * 
+ * @see IBrowserEngine#setResourceBudget
+ * @see WebBrowser#purgeCaches
+ * @since 0.9.2
+ */
+public class BrowserResourceBudget {
+	private int memoryCacheSize = -1;
+
+	private int diskCacheSize = -1;
+
+	private String diskCacheDirectory = null;
+
+	private int maxHistoryEntries = -1;
+
+	/**
+	 * Returns the size of the memory cache in kilobytes.
+	 * 
+	 * @return the size of the memory cache in kilobytes, or -1 for the
+	 *         browser default.
+	 */
+	public int getMemoryCacheSize() {
+		return memoryCacheSize;
+	}
+
+	/**
+	 * Sets the size of the memory cache in kilobytes. 0 disables the memory
+	 * cache.
+	 * 
+	 * @param kilobytes
+	 *            the size of the memory cache, or -1 for the browser default.
+	 */
+	public void setMemoryCacheSize(int kilobytes) {
+		memoryCacheSize = kilobytes;
+	}
+
+	/**
+	 * Returns the size of the disk cache in kilobytes.
+	 * 
+	 * @return the size of the disk cache in kilobytes, or -1 for the browser
+	 *         default.
+	 */
+	public int getDiskCacheSize() {
+		return diskCacheSize;
+	}
+
+	/**
+	 * Sets the size of the disk cache in kilobytes. 0 disables the disk
+	 * cache.
+	 * 
+	 * @param kilobytes
+	 *            the size of the disk cache, or -1 for the browser default.
+	 */
+	public void setDiskCacheSize(int kilobytes) {
+		diskCacheSize = kilobytes;
+	}
+
+	/**
+	 * Returns the directory the disk cache is created in.
+	 * 
+	 * @return the disk cache directory, or <code>null</code> for the
+	 *         browser default.
+	 */
+	public String getDiskCacheDirectory() {
+		return diskCacheDirectory;
+	}
+
+	/**
+	 * Sets the directory the disk cache is created in.
+	 * 
+	 * @param directory
+	 *            the absolute path of the disk cache directory, or
+	 *            <code>null</code> for the browser default.
+	 */
+	public void setDiskCacheDirectory(String directory) {
+		diskCacheDirectory = directory;
+	}
+
+	/**
+	 * Returns the maximum number of history entries kept by each
+	 * <code>WebBrowser</code>.
+	 * 
+	 * @return the maximum number of history entries, or -1 for the browser
+	 *         default.
+	 */
+	public int getMaxHistoryEntries() {
+		return maxHistoryEntries;
+	}
+
+	/**
+	 * Sets the maximum number of back/forward history entries kept by each
+	 * <code>WebBrowser</code>. The native browser is shared, so the same
+	 * maximum applies to all the <code>WebBrowser</code>s of an engine.
+	 * 
+	 * @param entries
+	 *            the maximum number of history entries, or -1 for the
+	 *            browser default.
+	 */
+	public void setMaxHistoryEntries(int entries) {
+		maxHistoryEntries = entries;
+	}
+}
@@ -128,4 +128,25 @@ public interface IBrowserEngine {
 	 * @return a WebBrowser instance
 	 */
 	public IWebBrowser getWebBrowser();
+
+	/**
+	 * Sets the memory and disk budget of the embedded browser. It's applied
+	 * when the native browser starts, so it must be set before the first
+	 * <code>WebBrowser</code> is created. Engines which can't bound their
+	 * resources ignore it.
+	 * 
+	 * @param budget
+	 *            the resource budget, or <code>null</code> for the browser
+	 *            defaults.
+	 * @since 0.9.2
+	 */
+	public void setResourceBudget(BrowserResourceBudget budget);
+
+	/**
+	 * 
+	 * @return the resource budget set by <code>setResourceBudget()</code>,
+	 *         or <code>null</code>.
+	 * @since 0.9.2
+	 */
+	public BrowserResourceBudget getResourceBudget();
 }
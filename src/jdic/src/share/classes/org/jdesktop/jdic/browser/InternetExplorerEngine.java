@@ -35,6 +35,9 @@ import org.jdesktop.jdic.init.JdicManager;
  */
 public class InternetExplorerEngine implements IBrowserEngine {
 
+	/** not used by this engine */
+	private BrowserResourceBudget resourceBudget = null;
+
 	private static final String NSPR4_DLL = "nspr4.dll";
 
 	private static final String IELIB = "ielib";
@@ -203,4 +206,22 @@ public class InternetExplorerEngine implements IBrowserEngine {
 	public IWebBrowser getWebBrowser() {
 		return new WebBrowser();
 	}
+
+	/*
+	 * (non-Javadoc)
+	 * 
+	 * @see org.jdesktop.jdic.browser.IBrowserEngine#setResourceBudget(org.jdesktop.jdic.browser.BrowserResourceBudget)
+	 */
+	public void setResourceBudget(BrowserResourceBudget budget) {
+		resourceBudget = budget;
+	}
+
+	/*
+	 * (non-Javadoc)
+	 * 
+	 * @see org.jdesktop.jdic.browser.IBrowserEngine#getResourceBudget()
+	 */
+	public BrowserResourceBudget getResourceBudget() {
+		return resourceBudget;
+	}
 }
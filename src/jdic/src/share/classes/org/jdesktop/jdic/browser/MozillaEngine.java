@@ -36,6 +36,9 @@ import org.jdesktop.jdic.init.JdicManager;
  */
 public class MozillaEngine implements IBrowserEngine {
 
+	/** the resource budget applied when the native browser starts */
+	private BrowserResourceBudget resourceBudget = null;
+
 	private static final String BROWSER_NAME = BrowserEngineManager.MOZILLA;
 
 	private static final String MOZILLA_FIVE_HOME = "MOZILLA_FIVE_HOME";
@@ -411,4 +414,22 @@ public class MozillaEngine implements IBrowserEngine {
 	public IWebBrowser getWebBrowser() {
 		return new WebBrowser();
 	}
-}
\ No newline at end of file
+
+	/*
+	 * (non-Javadoc)
+	 * 
+	 * @see org.jdesktop.jdic.browser.IBrowserEngine#setResourceBudget(org.jdesktop.jdic.browser.BrowserResourceBudget)
+	 */
+	public void setResourceBudget(BrowserResourceBudget budget) {
+		resourceBudget = budget;
+	}
+
+	/*
+	 * (non-Javadoc)
+	 * 
+	 * @see org.jdesktop.jdic.browser.IBrowserEngine#getResourceBudget()
+	 */
+	public BrowserResourceBudget getResourceBudget() {
+		return resourceBudget;
+	}
+}
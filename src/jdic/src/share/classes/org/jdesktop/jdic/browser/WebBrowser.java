@@ -28,6 +28,7 @@ import java.awt.Toolkit;
 import java.awt.event.FocusEvent;
 import java.awt.event.FocusListener;
 import java.awt.event.KeyEvent;
+import java.awt.image.BufferedImage;
 import java.io.File;
 import java.io.FileOutputStream;
 import java.io.IOException;
@@ -35,6 +36,7 @@ import java.io.InputStream;
 import java.io.OutputStream;
 import java.net.JarURLConnection;
 import java.net.URL;
+import java.nio.ByteBuffer;
 import java.util.Enumeration;
 import java.util.StringTokenizer;
 import java.util.Vector;
@@ -71,6 +73,66 @@ import org.jdesktop.jdic.init.JdicInitException;
  * @version 0.1, 03/07/17
  */
 public class WebBrowser extends Canvas implements IWebBrowser {
+	/**
+	 * Resource type of loads which don't fall into any other type. Fonts
+	 * and media files are loaded with this type by the Mozilla versions
+	 * supported.
+	 * 
+	 * @see #blockResources
+	 * @since 0.9.2
+	 */
+	public static final int RESOURCE_OTHER = 0x01;
+
+	/**
+	 * Resource type of scripts.
+	 * 
+	 * @since 0.9.2
+	 */
+	public static final int RESOURCE_SCRIPT = 0x02;
+
+	/**
+	 * Resource type of images.
+	 * 
+	 * @since 0.9.2
+	 */
+	public static final int RESOURCE_IMAGE = 0x04;
+
+	/**
+	 * Resource type of style sheets.
+	 * 
+	 * @since 0.9.2
+	 */
+	public static final int RESOURCE_STYLESHEET = 0x08;
+
+	/**
+	 * Resource type of plugin content, loaded by object, embed or applet
+	 * elements.
+	 * 
+	 * @since 0.9.2
+	 */
+	public static final int RESOURCE_OBJECT = 0x10;
+
+	/**
+	 * Resource type of frames and iframes.
+	 * 
+	 * @since 0.9.2
+	 */
+	public static final int RESOURCE_SUBDOCUMENT = 0x20;
+
+	/**
+	 * Resource type of top level documents.
+	 * 
+	 * @since 0.9.2
+	 */
+	public static final int RESOURCE_DOCUMENT = 0x40;
+
+	/**
+	 * All resource types.
+	 * 
+	 * @since 0.9.2
+	 */
+	public static final int RESOURCE_ALL = 0x7f;
+
 	private static final String FILE_PROTOCOL = "file:///";
 
 	private static final String FILE = "file";
@@ -674,17 +736,11 @@ public class WebBrowser extends Canvas implements IWebBrowser {
 			eventThread.fireNativeEvent(instanceNum,
 					NativeEventData.EVENT_NAVIGATE, urlString);
 		} else {
+			// The URL, POST data and headers are sent as a binary payload, 
+			// the POST data is streamed to the native browser as is.
 			eventThread.fireNativeEvent(instanceNum,
-					NativeEventData.EVENT_NAVIGATE_POST,
-					// Note!!! Use "<instance number>,<event ID>," string as the
-					// message field delimiter, which must be identical in the
-					// native side used to parse the post string values.
-					urlString + instanceNum + ","
-							+ NativeEventData.EVENT_NAVIGATE_POST + ","
-							+ ((postData == null) ? "" : postData)
-							+ instanceNum + ","
-							+ NativeEventData.EVENT_NAVIGATE_POST + ","
-							+ ((headers == null) ? "" : headers));
+					NativeEventData.EVENT_NAVIGATE_POST, new String[] {
+							urlString, postData, headers });
 		}
 	}
 
@@ -944,6 +1000,208 @@ public class WebBrowser extends Canvas implements IWebBrowser {
 		return null;
 	}
 
+	/**
+	 * Blocks loading the given resource types from the hosts matching the
+	 * given pattern.
+	 * <p>
+	 * The rules set by this method and {@link #allowResources} are checked
+	 * in the order they were added and the last matching rule wins. Loads
+	 * no rule matches are allowed. Only http, https and ftp loads are
+	 * checked. For example, to load pages without images and plugins except
+	 * the images from one host:
+	 * <pre>
+	 * webBrowser.blockResources(WebBrowser.RESOURCE_IMAGE
+	 *         | WebBrowser.RESOURCE_OBJECT, &quot;*&quot;);
+	 * webBrowser.allowResources(WebBrowser.RESOURCE_IMAGE, 
+	 *         &quot;*.example.com&quot;);
+	 * </pre>
+	 * Request filtering is only supported by the Mozilla engine.
+	 * 
+	 * @param types
+	 *            a combination of the <code>RESOURCE_*</code> constants.
+	 * @param hostPattern
+	 *            "*" for all hosts, a host name, or "*.&lt;domain&gt;" for a
+	 *            domain and all its subdomains.
+	 * @see #getBlockedRequestCount
+	 * @since 0.9.2
+	 */
+	public void blockResources(int types, String hostPattern) {
+		addResourceRule(true, types, hostPattern);
+	}
+
+	/**
+	 * Allows loading the given resource types from the hosts matching the
+	 * given pattern, overriding the rules added before.
+	 * 
+	 * @param types
+	 *            a combination of the <code>RESOURCE_*</code> constants.
+	 * @param hostPattern
+	 *            "*" for all hosts, a host name, or "*.&lt;domain&gt;" for a
+	 *            domain and all its subdomains.
+	 * @see #blockResources
+	 * @since 0.9.2
+	 */
+	public void allowResources(int types, String hostPattern) {
+		addResourceRule(false, types, hostPattern);
+	}
+
+	/**
+	 * Removes all the rules added by {@link #blockResources} and 
+	 * {@link #allowResources}.
+	 * 
+	 * @since 0.9.2
+	 */
+	public void clearResourceRules() {
+		eventThread.fireNativeEvent(instanceNum,
+				NativeEventData.EVENT_CLEARCONTENTRULES);
+	}
+
+	/**
+	 * Drops the content of the memory and disk caches of the embedded
+	 * browser, and asks it to release whatever memory it can. The caches are
+	 * shared by all <code>WebBrowser</code> instances. The Internet Explorer
+	 * engine ignores the call.
+	 * 
+	 * @see BrowserResourceBudget
+	 * @since 0.9.2
+	 */
+	public void purgeCaches() {
+		eventThread.fireNativeEvent(instanceNum,
+				NativeEventData.EVENT_PURGECACHES);
+	}
+
+	/**
+	 * Returns the number of requests blocked so far for the given resource
+	 * types.
+	 * 
+	 * @param types
+	 *            a combination of the <code>RESOURCE_*</code> constants.
+	 * @return the number of blocked requests, or -1 if the native browser
+	 *         doesn't support request filtering.
+	 * @since 0.9.2
+	 */
+	public int getBlockedRequestCount(int types) {
+		eventThread.fireNativeEvent(instanceNum,
+				NativeEventData.EVENT_GETBLOCKEDCOUNT);
+
+		if (waitForResult() == false) {
+			return -1;
+		}
+		// The result is a comma separated list of counters, one for each
+		// resource type bit, lowest bit first.
+		String result = eventThread.getEventRetString();
+		if (null == result || result.length() == 0) {
+			return -1;
+		}
+		int count = 0;
+		StringTokenizer st = new StringTokenizer(result, ",");
+		for (int bit = 1; st.hasMoreTokens(); bit <<= 1) {
+			int typeCount = Integer.parseInt(st.nextToken());
+			if ((types & bit) != 0) {
+				count += typeCount;
+			}
+		}
+		return count;
+	}
+
+	/**
+	 * Returns a snapshot of the latency and throughput counters of the
+	 * communication with the native browser, which are shared by all
+	 * <code>WebBrowser</code> objects. The native counters are fetched from
+	 * the native browser, if it answers in time.
+	 * 
+	 * @return the statistics, dumpable with
+	 *         {@link WebBrowserStatistics#toJSON}.
+	 * @since 0.9.2
+	 */
+	public WebBrowserStatistics getStatistics() {
+		eventThread.fireNativeEvent(instanceNum,
+				NativeEventData.EVENT_GETSTATS);
+
+		if (waitForResult() == true) {
+			eventThread.getStats().setNativeStats(
+					eventThread.getEventRetString());
+		}
+		return new WebBrowserStatistics(eventThread.getStats().copy());
+	}
+
+	private void addResourceRule(boolean block, int types, String hostPattern) {
+		if (null == hostPattern || hostPattern.length() == 0) {
+			throw new IllegalArgumentException("Invalid host pattern");
+		}
+		eventThread.fireNativeEvent(instanceNum,
+				NativeEventData.EVENT_ADDCONTENTRULE, (block ? "1" : "0")
+						+ "," + (types & RESOURCE_ALL) + "," + hostPattern);
+	}
+
+	/**
+	 * Takes a snapshot of the rendered page.
+	 * <p>
+	 * The native browser paints the requested area into a shared memory
+	 * segment, which is mapped and converted into an image without the
+	 * pixels passing through the socket connection. On Windows the browser
+	 * window does not have to be visible; on other platforms covered or
+	 * hidden parts of the window are captured only as far as the window
+	 * system keeps their contents.
+	 * 
+	 * @param area
+	 *            the area to capture, relative to the top left corner of the
+	 *            browser window, or <code>null</code> for the whole window.
+	 *            The area is clipped to the window bounds.
+	 * @return the rendered pixels of the area, or <code>null</code> if the
+	 *         browser window isn't created yet or the snapshot fails.
+	 * @since 0.9.2
+	 */
+	public BufferedImage snapshot(Rectangle area) {
+		if (null == area) {
+			area = new Rectangle(0, 0, 0, 0);
+		}
+		eventThread.fireNativeEvent(instanceNum,
+				NativeEventData.EVENT_SNAPSHOT, area);
+
+		if (waitForResult() == false) {
+			return null;
+		}
+
+		// The result is in the format of "<segment name>,<width>,<height>",
+		// or empty if the native browser failed to take the snapshot.
+		String result = eventThread.getEventRetString();
+		if (null == result || result.length() == 0) {
+			return null;
+		}
+		StringTokenizer st = new StringTokenizer(result, ",");
+		if (st.countTokens() != 3) {
+			return null;
+		}
+		String name = st.nextToken();
+		int width = Integer.parseInt(st.nextToken());
+		int height = Integer.parseInt(st.nextToken());
+
+		ByteBuffer pixels = nativeMapSnapshot(name, width * height * 4);
+		if (null == pixels) {
+			WebBrowserUtil.error("Can't map the snapshot buffer " + name);
+			return null;
+		}
+		try {
+			BufferedImage image = new BufferedImage(width, height,
+					BufferedImage.TYPE_INT_ARGB);
+			int[] row = new int[width];
+			for (int y = 0; y < height; y++) {
+				for (int x = 0; x < width; x++) {
+					int r = pixels.get() & 0xff;
+					int g = pixels.get() & 0xff;
+					int b = pixels.get() & 0xff;
+					int a = pixels.get() & 0xff;
+					row[x] = (a << 24) | (r << 16) | (g << 8) | b;
+				}
+				image.setRGB(0, y, width, 1, row, 0, width);
+			}
+			return image;
+		} finally {
+			nativeUnmapSnapshot(pixels);
+		}
+	}
+
 	/**
 	 * Enables or disables debug message output. Debug message out is disabled
 	 * initially by default. Calls it via reflection when necessary.
@@ -1041,6 +1299,10 @@ public class WebBrowser extends Canvas implements IWebBrowser {
 	/* native functions */
 	private native int nativeGetWindow(String javaHome);
 
+	private static native ByteBuffer nativeMapSnapshot(String name, int size);
+
+	private static native void nativeUnmapSnapshot(ByteBuffer buffer);
+
 	class MyFocusListener implements FocusListener {
 		public void focusGained(FocusEvent e) {
 			WebBrowserUtil.trace("\nMyFocusListener: focusGained\n");
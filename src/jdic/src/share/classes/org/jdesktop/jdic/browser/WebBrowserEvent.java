@@ -157,6 +157,25 @@ public class WebBrowserEvent extends EventObject {
 	 */
 	public static final int WEBBROWSER_EXECUTESCRIPT = 63 + WEBBROWSER_FIRST;
 
+	/**
+	 * Event fired when the native browser has rendered a snapshot requested
+	 * by a WebBrowser object's snapshot method.
+	 */
+	public static final int WEBBROWSER_SNAPSHOT = 64 + WEBBROWSER_FIRST;
+
+	/**
+	 * Event fired when the native browser returns the blocked request
+	 * counters requested by a WebBrowser object's getBlockedRequestCount
+	 * method.
+	 */
+	public static final int WEBBROWSER_GETBLOCKEDCOUNT = 65 + WEBBROWSER_FIRST;
+
+	/**
+	 * Event fired when the native browser returns its latency counters
+	 * requested by a WebBrowser object's getStatistics method.
+	 */
+	public static final int WEBBROWSER_GETSTATS = 66 + WEBBROWSER_FIRST;
+
 	/**
 	 * The event's id.
 	 */
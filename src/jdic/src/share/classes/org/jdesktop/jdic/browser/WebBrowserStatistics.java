@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+package org.jdesktop.jdic.browser;
+
+import java.lang.reflect.Field;
+import java.lang.reflect.Modifier;
+import java.util.HashMap;
+
+import org.jdesktop.jdic.browser.internal.EventStats;
+import org.jdesktop.jdic.browser.internal.NativeEventData;
+
+/**
+ * A <code>WebBrowserStatistics</code> object is a snapshot of the latency
+ * and throughput counters of the communication between the
+ * <code>WebBrowser</code> objects and the native browser, taken by
+ * <code>WebBrowser.getStatistics()</code>. The counters are shared by all
+ * the <code>WebBrowser</code> objects and count from the start of the native
+ * browser.
+ * <p>
+ * Times are kept per phase and event type, with a histogram whose bucket 0
+ * holds the times below 250 microseconds and each further bucket twice the
+ * range of the previous one. Events sent to the native browser and events
+ * fired by it have distinct type numbers, see {@link #getEventName}.
+ * <p>
+ * The socket transit time isn't measured directly, as the two processes
+ * don't share a clock: it's the round trip time of a request minus the
+ * native dispatch time of the same request, see {@link #toJSON}.
+ * 
+ * @see WebBrowser#getStatistics
+ * @since 0.9.2
+ */
+public class WebBrowserStatistics {
+	/**
+	 * Time an event sent to the native browser waits in the Java event
+	 * queue, per event type.
+	 */
+	public static final int QUEUE_WAIT = EventStats.PHASE_QUEUE_WAIT;
+
+	/**
+	 * Time between sending a request to the native browser and receiving its
+	 * answer, per request type. For a navigation it's the time until the
+	 * document is completed.
+	 */
+	public static final int ROUND_TRIP = EventStats.PHASE_ROUND_TRIP;
+
+	/**
+	 * Time spent in the <code>WebBrowserListener</code>s, per type of the
+	 * event fired by the native browser.
+	 */
+	public static final int LISTENER = EventStats.PHASE_LISTENER;
+
+	/**
+	 * Time the native browser spends handling an event, per event type.
+	 */
+	public static final int NATIVE_DISPATCH = EventStats.PHASE_NATIVE_DISPATCH;
+
+	/**
+	 * Time between the native browser firing an event and writing it to the
+	 * socket, per event type.
+	 */
+	public static final int NATIVE_SEND_DELAY = EventStats.PHASE_NATIVE_SEND_DELAY;
+
+	private static final String[] PHASE_NAMES = { "queueWait", "roundTrip",
+			"listener", "nativeDispatch", "nativeSendDelay" };
+
+	// event type -> event name
+	private static HashMap eventNames = null;
+
+	private EventStats stats;
+
+	private long elapsedMillis;
+
+	WebBrowserStatistics(EventStats stats) {
+		this.stats = stats;
+		this.elapsedMillis = Math.max(1, System.currentTimeMillis()
+				- stats.getStartTime());
+	}
+
+	/**
+	 * Returns the name of the given event type, like "EVENT_NAVIGATE" for an
+	 * event sent to the native browser or "WEBBROWSER_DOCUMENT_COMPLETED" for
+	 * an event fired by it.
+	 * 
+	 * @param type
+	 *            the event type.
+	 * @return the name of the event type.
+	 */
+	public static synchronized String getEventName(int type) {
+		if (eventNames == null) {
+			eventNames = new HashMap();
+			addEventNames(NativeEventData.class, "EVENT_");
+			addEventNames(WebBrowserEvent.class, "WEBBROWSER_");
+		}
+		String name = (String) eventNames.get(new Integer(type));
+		return name == null ? String.valueOf(type) : name;
+	}
+
+	private static void addEventNames(Class eventClass, String prefix) {
+		Field[] fields = eventClass.getFields();
+		for (int i = 0; i < fields.length; i++) {
+			if (fields[i].getName().startsWith(prefix)
+					&& Modifier.isStatic(fields[i].getModifiers())
+					&& fields[i].getType() == Integer.TYPE) {
+				try {
+					eventNames.put(new Integer(fields[i].getInt(null)),
+							fields[i].getName());
+				} catch (IllegalAccessException e) {
+				}
+			}
+		}
+	}
+
+	/**
+	 * Returns the event types recorded for the given phase.
+	 * 
+	 * @param phase
+	 *            one of the phase constants.
+	 * @return the event types, in ascending order.
+	 */
+	public int[] getEventTypes(int phase) {
+		return stats.getTypes(phase);
+	}
+
+	/**
+	 * Returns the number of times recorded for the given phase and event
+	 * type.
+	 */
+	public long getCount(int phase, int type) {
+		return EventStats.getCount(stats.getHistogram(phase, type));
+	}
+
+	/**
+	 * Returns the mean time of the given phase and event type in
+	 * milliseconds, or 0 if nothing was recorded.
+	 */
+	public double getMeanMillis(int phase, int type) {
+		long[] histogram = stats.getHistogram(phase, type);
+		long count = EventStats.getCount(histogram);
+		return count == 0 ? 0 : EventStats.getTotal(histogram) / 1000.0
+				/ count;
+	}
+
+	/**
+	 * Returns the maximum time of the given phase and event type in
+	 * milliseconds.
+	 */
+	public double getMaxMillis(int phase, int type) {
+		return EventStats.getMax(stats.getHistogram(phase, type)) / 1000.0;
+	}
+
+	/**
+	 * Returns the histogram of the given phase and event type. Bucket 0
+	 * counts the times below 250 microseconds, bucket i the times between
+	 * 250 * 2^(i-1) and 250 * 2^i microseconds, the last bucket everything
+	 * above.
+	 */
+	public long[] getHistogram(int phase, int type) {
+		return EventStats.getBuckets(stats.getHistogram(phase, type));
+	}
+
+	/**
+	 * Returns the number of messages of the given event type sent to the
+	 * native browser.
+	 */
+	public long getMessagesSent(int type) {
+		return stats.getMessageCount(true, type)[0];
+	}
+
+	/**
+	 * Returns the number of messages of the given event type received from
+	 * the native browser.
+	 */
+	public long getMessagesReceived(int type) {
+		return stats.getMessageCount(false, type)[0];
+	}
+
+	/** Returns the number of bytes sent to the native browser. */
+	public long getBytesSent() {
+		return stats.getBytesSent();
+	}
+
+	/** Returns the number of bytes received from the native browser. */
+	public long getBytesReceived() {
+		return stats.getBytesReceived();
+	}
+
+	/**
+	 * Returns the time elapsed between the start of the native browser and
+	 * this snapshot, in milliseconds.
+	 */
+	public long getElapsedMillis() {
+		return elapsedMillis;
+	}
+
+	private double perSecond(long count) {
+		return count * 1000.0 / elapsedMillis;
+	}
+
+	private static String format(double value) {
+		return String.valueOf(Math.round(value * 1000) / 1000.0);
+	}
+
+	private void appendHistogram(StringBuffer json, int phase, int type) {
+		long[] histogram = stats.getHistogram(phase, type);
+		json.append("{\"count\":").append(EventStats.getCount(histogram));
+		json.append(",\"meanMs\":").append(
+				format(getMeanMillis(phase, type)));
+		json.append(",\"maxMs\":").append(format(getMaxMillis(phase, type)));
+		json.append(",\"buckets\":[");
+		long[] buckets = EventStats.getBuckets(histogram);
+		for (int i = 0; i < buckets.length; i++) {
+			json.append(i == 0 ? "" : ",").append(buckets[i]);
+		}
+		json.append("]}");
+	}
+
+	private void appendMessages(StringBuffer json, boolean sentMessages) {
+		int[] types = stats.getMessageTypes(sentMessages);
+		json.append("{");
+		for (int i = 0; i < types.length; i++) {
+			long[] counter = stats.getMessageCount(sentMessages, types[i]);
+			json.append(i == 0 ? "" : ",");
+			json.append("\"").append(getEventName(types[i])).append("\":");
+			json.append("{\"messages\":").append(counter[0]);
+			json.append(",\"chars\":").append(counter[1]);
+			json.append(",\"perSecond\":").append(
+					format(perSecond(counter[0])));
+			json.append("}");
+		}
+		json.append("}");
+	}
+
+	/**
+	 * Returns the statistics as a JSON object:
+	 * 
+	 * <pre>
+	 * {&quot;elapsedMs&quot;:..., 
+	 *  &quot;bytesSent&quot;:..., &quot;bytesSentPerSecond&quot;:..., 
+	 *  &quot;bytesReceived&quot;:..., &quot;bytesReceivedPerSecond&quot;:..., 
+	 *  &quot;sent&quot;:{&quot;EVENT_NAVIGATE&quot;:{&quot;messages&quot;:..., &quot;chars&quot;:..., &quot;perSecond&quot;:...}, ...}, 
+	 *  &quot;received&quot;:{...}, 
+	 *  &quot;queueWait&quot;:{&quot;EVENT_NAVIGATE&quot;:{&quot;count&quot;:..., &quot;meanMs&quot;:..., &quot;maxMs&quot;:..., &quot;buckets&quot;:[...]}, ...}, 
+	 *  &quot;roundTrip&quot;:{...}, &quot;listener&quot;:{...}, 
+	 *  &quot;nativeDispatch&quot;:{...}, &quot;nativeSendDelay&quot;:{...}, 
+	 *  &quot;transitMeanMs&quot;:{&quot;EVENT_GETURL&quot;:..., ...}}
+	 * </pre>
+	 * 
+	 * The transit time of a request is its mean round trip time minus its
+	 * mean native dispatch time.
+	 * 
+	 * @return the statistics in JSON format.
+	 */
+	public String toJSON() {
+		StringBuffer json = new StringBuffer();
+		json.append("{\"elapsedMs\":").append(elapsedMillis);
+		json.append(",\"bytesSent\":").append(getBytesSent());
+		json.append(",\"bytesSentPerSecond\":").append(
+				format(perSecond(getBytesSent())));
+		json.append(",\"bytesReceived\":").append(getBytesReceived());
+		json.append(",\"bytesReceivedPerSecond\":").append(
+				format(perSecond(getBytesReceived())));
+		json.append(",\"sent\":");
+		appendMessages(json, true);
+		json.append(",\"received\":");
+		appendMessages(json, false);
+
+		for (int phase = 0; phase < EventStats.PHASE_COUNT; phase++) {
+			json.append(",\"").append(PHASE_NAMES[phase]).append("\":{");
+			int[] types = getEventTypes(phase);
+			for (int i = 0; i < types.length; i++) {
+				json.append(i == 0 ? "" : ",");
+				json.append("\"").append(getEventName(types[i])).append("\":");
+				appendHistogram(json, phase, types[i]);
+			}
+			json.append("}");
+		}
+
+		json.append(",\"transitMeanMs\":{");
+		int[] types = getEventTypes(ROUND_TRIP);
+		boolean first = true;
+		for (int i = 0; i < types.length; i++) {
+			if (getCount(NATIVE_DISPATCH, types[i]) == 0) {
+				continue;
+			}
+			double transit = getMeanMillis(ROUND_TRIP, types[i])
+					- getMeanMillis(NATIVE_DISPATCH, types[i]);
+			json.append(first ? "" : ",");
+			json.append("\"").append(getEventName(types[i])).append("\":");
+			json.append(format(Math.max(0, transit)));
+			first = false;
+		}
+		json.append("}}");
+		return json.toString();
+	}
+
+	/**
+	 * Returns the statistics in JSON format.
+	 * 
+	 * @see #toJSON
+	 */
+	public String toString() {
+		return toJSON();
+	}
+}
@@ -30,6 +30,9 @@ import org.jdesktop.jdic.init.JdicManager;
  */
 class WebKitEngine implements IBrowserEngine {
 
+	/** not used by this engine */
+	private BrowserResourceBudget resourceBudget = null;
+
 	private static final String WEBKIT = BrowserEngineManager.WEBKIT;
 	/** Whether the Mozilla/GRE is available */
 	private static boolean isEngineAvailable = true;
@@ -200,4 +203,12 @@ class WebKitEngine implements IBrowserEngine {
 		}
 		return null;
 	}
+
+	public void setResourceBudget(BrowserResourceBudget budget) {
+		resourceBudget = budget;
+	}
+
+	public BrowserResourceBudget getResourceBudget() {
+		return resourceBudget;
+	}
 }
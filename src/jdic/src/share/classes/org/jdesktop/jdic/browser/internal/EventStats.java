@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */
+
+package org.jdesktop.jdic.browser.internal;
+
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.StringTokenizer;
+
+/**
+ * An internal class that collects the latency and throughput counters of the
+ * communication between <code>WebBrowser</code> and the native browser.
+ * The counters are always on and cheap enough for production use: a
+ * recorded time only increments a few longs of a fixed size histogram.
+ * <p>
+ * Times are kept in microseconds. The Java side measures them with
+ * <code>System.currentTimeMillis()</code>, the native side with a
+ * microsecond clock.
+ * 
+ * @see org.jdesktop.jdic.browser.WebBrowserStatistics
+ */
+public class EventStats {
+	/** Time an event waits in the queue of <code>NativeEventThread</code>. */
+	public static final int PHASE_QUEUE_WAIT = 0;
+
+	/**
+	 * Time between sending a request to the native browser and receiving its
+	 * answer, keyed by the request event.
+	 */
+	public static final int PHASE_ROUND_TRIP = 1;
+
+	/** Time spent in the listeners of an event from the native browser. */
+	public static final int PHASE_LISTENER = 2;
+
+	/** Time the native browser spends handling an event. */
+	public static final int PHASE_NATIVE_DISPATCH = 3;
+
+	/**
+	 * Time an event of the native browser waits before it's written to the
+	 * socket.
+	 */
+	public static final int PHASE_NATIVE_SEND_DELAY = 4;
+
+	public static final int PHASE_COUNT = 5;
+
+	/** Must keep same with STATS_BUCKET_COUNT in EventStats.h. */
+	public static final int BUCKET_COUNT = 16;
+
+	/** Must keep same with STATS_BUCKET_BASE in EventStats.h. */
+	public static final long BUCKET_BASE_MICROS = 250;
+
+	// histogram layout: count, total, max, buckets.
+	private static final int COUNT = 0;
+
+	private static final int TOTAL = 1;
+
+	private static final int MAX = 2;
+
+	private static final int FIRST_BUCKET = 3;
+
+	// (phase << 16 | event type) -> long[] histogram
+	private HashMap histograms = new HashMap();
+
+	// event type -> long[] { messages, bytes }
+	private HashMap sent = new HashMap();
+
+	private HashMap received = new HashMap();
+
+	private long startTime = System.currentTimeMillis();
+
+	private long bytesSent = 0;
+
+	private long bytesReceived = 0;
+
+	/**
+	 * Returns the histogram bucket of the given time: bucket 0 holds the
+	 * times below BUCKET_BASE_MICROS, each further bucket twice the range of
+	 * the previous one, the last bucket everything above.
+	 */
+	public static int getBucket(long micros) {
+		int bucket = 0;
+		long bound = BUCKET_BASE_MICROS;
+		while (bucket < BUCKET_COUNT - 1 && micros >= bound) {
+			bucket++;
+			bound <<= 1;
+		}
+		return bucket;
+	}
+
+	private static Integer key(int phase, int type) {
+		return new Integer(phase << 16 | (type & 0xffff));
+	}
+
+	private long[] getHistogram(Integer key, boolean create) {
+		long[] histogram = (long[]) histograms.get(key);
+		if (histogram == null && create) {
+			histogram = new long[FIRST_BUCKET + BUCKET_COUNT];
+			histograms.put(key, histogram);
+		}
+		return histogram;
+	}
+
+	public synchronized void record(int phase, int type, long micros) {
+		if (micros < 0) {
+			// the clock was set back.
+			micros = 0;
+		}
+		long[] histogram = getHistogram(key(phase, type), true);
+		histogram[COUNT]++;
+		histogram[TOTAL] += micros;
+		histogram[MAX] = Math.max(histogram[MAX], micros);
+		histogram[FIRST_BUCKET + getBucket(micros)]++;
+	}
+
+	private static void countMessage(HashMap counters, int type, int bytes) {
+		Integer key = new Integer(type);
+		long[] counter = (long[]) counters.get(key);
+		if (counter == null) {
+			counter = new long[2];
+			counters.put(key, counter);
+		}
+		counter[0]++;
+		counter[1] += bytes;
+	}
+
+	/**
+	 * Counts a message sent to the native browser, with the number of
+	 * characters of the message.
+	 */
+	public synchronized void countSent(int type, int length) {
+		countMessage(sent, type, length);
+	}
+
+	/**
+	 * Counts a message received from the native browser, with the number of
+	 * characters of the message.
+	 */
+	public synchronized void countReceived(int type, int length) {
+		countMessage(received, type, length);
+	}
+
+	/** Counts the bytes written to the socket. */
+	public synchronized void countBytesSent(int bytes) {
+		bytesSent += bytes;
+	}
+
+	/** Counts the bytes read from the socket. */
+	public synchronized void countBytesReceived(int bytes) {
+		bytesReceived += bytes;
+	}
+
+	/**
+	 * Replaces the native counters with the ones of a CEVENT_GETSTATS
+	 * message, which are in the format:
+	 * 
+	 * <pre>
+	 * &lt;phase&gt;,&lt;event&gt;,&lt;count&gt;,&lt;total&gt;,&lt;max&gt;,&lt;bucket 0&gt;,...,&lt;bucket 15&gt;;...
+	 * </pre>
+	 */
+	public synchronized void setNativeStats(String nativeStats) {
+		if (nativeStats == null) {
+			return;
+		}
+		StringTokenizer entries = new StringTokenizer(nativeStats, ";");
+		while (entries.hasMoreTokens()) {
+			StringTokenizer fields = new StringTokenizer(entries.nextToken(),
+					",");
+			try {
+				int phase = Integer.parseInt(fields.nextToken());
+				int type = Integer.parseInt(fields.nextToken());
+				long[] histogram = getHistogram(key(phase, type), true);
+				for (int i = 0; i < histogram.length; i++) {
+					histogram[i] = Long.parseLong(fields.nextToken());
+				}
+			} catch (RuntimeException e) {
+				WebBrowserUtil.trace("Invalid native statistics: "
+						+ e.getMessage());
+			}
+		}
+	}
+
+	/**
+	 * Returns a copy of the counters, which isn't updated anymore.
+	 */
+	public synchronized EventStats copy() {
+		EventStats copy = new EventStats();
+		copy.startTime = startTime;
+		copy.bytesSent = bytesSent;
+		copy.bytesReceived = bytesReceived;
+		copyCounters(histograms, copy.histograms);
+		copyCounters(sent, copy.sent);
+		copyCounters(received, copy.received);
+		return copy;
+	}
+
+	private static void copyCounters(HashMap from, HashMap to) {
+		Iterator it = from.keySet().iterator();
+		while (it.hasNext()) {
+			Object key = it.next();
+			to.put(key, ((long[]) from.get(key)).clone());
+		}
+	}
+
+	/**
+	 * Returns the event types with a histogram of the given phase, in
+	 * ascending order.
+	 */
+	public synchronized int[] getTypes(int phase) {
+		int count = 0;
+		int[] types = new int[histograms.size()];
+		Iterator it = histograms.keySet().iterator();
+		while (it.hasNext()) {
+			int key = ((Integer) it.next()).intValue();
+			if ((key >>> 16) == phase) {
+				types[count++] = key & 0xffff;
+			}
+		}
+		int[] result = new int[count];
+		System.arraycopy(types, 0, result, 0, count);
+		Arrays.sort(result);
+		return result;
+	}
+
+	/**
+	 * Returns the histogram of the given phase and event type: the count,
+	 * total and maximum time followed by the BUCKET_COUNT bucket counters,
+	 * or <code>null</code>.
+	 */
+	public synchronized long[] getHistogram(int phase, int type) {
+		long[] histogram = getHistogram(key(phase, type), false);
+		return histogram == null ? null : (long[]) histogram.clone();
+	}
+
+	public static long getCount(long[] histogram) {
+		return histogram == null ? 0 : histogram[COUNT];
+	}
+
+	public static long getTotal(long[] histogram) {
+		return histogram == null ? 0 : histogram[TOTAL];
+	}
+
+	public static long getMax(long[] histogram) {
+		return histogram == null ? 0 : histogram[MAX];
+	}
+
+	public static long[] getBuckets(long[] histogram) {
+		long[] buckets = new long[BUCKET_COUNT];
+		if (histogram != null) {
+			System.arraycopy(histogram, FIRST_BUCKET, buckets, 0,
+					BUCKET_COUNT);
+		}
+		return buckets;
+	}
+
+	/**
+	 * Returns the event types with messages sent (or received) so far, in
+	 * ascending order.
+	 */
+	public synchronized int[] getMessageTypes(boolean sentMessages) {
+		HashMap counters = sentMessages ? sent : received;
+		int[] types = new int[counters.size()];
+		int i = 0;
+		Iterator it = counters.keySet().iterator();
+		while (it.hasNext()) {
+			types[i++] = ((Integer) it.next()).intValue();
+		}
+		Arrays.sort(types);
+		return types;
+	}
+
+	/**
+	 * Returns the number of messages and characters sent (or received) so
+	 * far for the given event type.
+	 */
+	public synchronized long[] getMessageCount(boolean sentMessages, int type) {
+		long[] counter = (long[]) (sentMessages ? sent : received)
+				.get(new Integer(type));
+		return counter == null ? new long[2] : (long[]) counter.clone();
+	}
+
+	public synchronized long getBytesSent() {
+		return bytesSent;
+	}
+
+	public synchronized long getBytesReceived() {
+		return bytesReceived;
+	}
+
+	public synchronized long getStartTime() {
+		return startTime;
+	}
+}
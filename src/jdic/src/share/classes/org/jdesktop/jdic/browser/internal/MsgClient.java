@@ -34,6 +34,7 @@ import java.nio.charset.CharsetDecoder;
 import java.nio.charset.CharsetEncoder;
 import java.util.HashSet;
 import java.util.Iterator;
+import java.util.LinkedList;
 import java.util.Set;
 
 import org.jdesktop.jdic.browser.BrowserEngineManager;
@@ -64,6 +65,11 @@ public class MsgClient {
 
 	private static final String MSG_DELIMITER_END = MSG_DELIMITER + "_end";
 
+	// a message with a binary payload is sent as a header message
+	//   #<instance>,<event>,<field length>[,<field length>...]
+	// followed by the bytes of each field.
+	private static final String MSG_PAYLOAD = "#";
+
 	private Selector selector = null;
 
 	private SocketChannel channel = null;
@@ -84,14 +90,20 @@ public class MsgClient {
 
 	private String sendBuffer = new String();
 
+	// the encoded messages and payloads waiting to be written, in order.
+	private LinkedList sendQueue = new LinkedList();
+
 	private String recvBuffer = new String();
 
+	private EventStats stats;
+
 	// cached long message pieces, once a complete message is received, it will
 	// be handled and removed from the set.
 	private static Set msgPieces = new HashSet();
 
-	public MsgClient() {		
+	public MsgClient(EventStats stats) {		
 		WebBrowserUtil.trace("Msg Client started");
+		this.stats = stats;
 		// For IE on Windows, use the system default charset. With JDK 5.0,
 		// there is a method Charset.defaultCharset().
 		// Note: for Mozilla on Windows/*nix, use "UTF-8", as there is no
@@ -183,6 +195,40 @@ public class MsgClient {
 		sendBuffer += msg + MSG_DELIMITER;		
 	}
 
+	/**
+	 * Appends a message whose string fields are sent as a binary payload, 
+	 * each preceded by its length in bytes in the message header. The 
+	 * fields may contain any characters, including the message delimiter, 
+	 * and are written to the socket without further copies.
+	 */
+	public void sendPayloadMessage(int instance, int type, String[] fields)
+			throws UnsupportedEncodingException {
+		byte[][] fieldBytes = new byte[fields.length][];
+		String header = MSG_PAYLOAD + instance + "," + type;
+		for (int i = 0; i < fields.length; i++) {
+			fieldBytes[i] = (fields[i] == null) ? new byte[0] : fields[i]
+					.getBytes(charsetName);
+			header += "," + fieldBytes[i].length;
+		}
+
+		sendMessage(header);
+		queueSendBuffer();
+		for (int i = 0; i < fieldBytes.length; i++) {
+			if (fieldBytes[i].length > 0) {
+				sendQueue.add(ByteBuffer.wrap(fieldBytes[i]));
+			}
+		}
+	}
+
+	// Moves the messages of the send buffer to the send queue.
+	private void queueSendBuffer() throws UnsupportedEncodingException {
+		if (sendBuffer.length() > 0) {
+			WebBrowserUtil.trace("Send data to socket: " + sendBuffer);
+			sendQueue.add(ByteBuffer.wrap(sendBuffer.getBytes(charsetName)));
+			sendBuffer = "";
+		}
+	}
+
 	public String getMessage() {
 		int pos = recvBuffer.indexOf(MSG_DELIMITER);
 		if (pos < 0)
@@ -282,7 +328,9 @@ public class MsgClient {
 	private void readFromChannel(SocketChannel channel) throws IOException {
 		ByteBuffer buffer = ByteBuffer.allocateDirect(BUFFERSIZE);
 		CharBuffer charBuffer = CharBuffer.allocate(BUFFERSIZE);
-		while (channel.read(buffer) > 0) {
+		int len;
+		while ((len = channel.read(buffer)) > 0) {
+			stats.countBytesReceived(len);
 			buffer.flip();
 			decoder.decode(buffer, charBuffer, false);//should can deal all at once
 			charBuffer.flip();
@@ -294,24 +342,25 @@ public class MsgClient {
 	}
 	
 	/**
-	 * write content of buffer to channel
+	 * write content of buffer to channel. Writes as much as the channel 
+	 * takes, the rest is written when the channel is writable again.
 	 * 
 	 * @param keyChannel
 	 * @throws UnsupportedEncodingException
 	 * @throws IOException
 	 */
 	private void writeToChannel(SocketChannel keyChannel) throws IOException {
-		if (sendBuffer.length() > 0) {
-			WebBrowserUtil.trace("Send data to socket: " + sendBuffer);
-			ByteBuffer buf = ByteBuffer.wrap(sendBuffer.getBytes(charsetName));
-			keyChannel.write(buf);
-			while (buf.hasRemaining()) {
+		queueSendBuffer();
+		while (!sendQueue.isEmpty()) {
+			ByteBuffer buf = (ByteBuffer) sendQueue.getFirst();
+			int len = keyChannel.write(buf);
+			stats.countBytesSent(len);
+			if (buf.hasRemaining()) {
 				WebBrowserUtil
 						.trace("==there're still contens in write buffer==");
-				// write until the buffer is drained
-				keyChannel.write(buf);
+				break;
 			}
-			sendBuffer = "";
+			sendQueue.removeFirst();
 		}
 	}
 
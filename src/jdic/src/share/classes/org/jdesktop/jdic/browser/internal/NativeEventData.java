@@ -53,11 +53,22 @@ public class NativeEventData
 	public   final static int EVENT_GETCONTENT        = 15;
 	public   final static int EVENT_SETCONTENT        = 16;
 	public   final static int EVENT_EXECUTESCRIPT     = 17;
+	public   final static int EVENT_SNAPSHOT          = 18;
+	public   final static int EVENT_ADDCONTENTRULE    = 19;
+	public   final static int EVENT_CLEARCONTENTRULES = 20;
+	public   final static int EVENT_GETBLOCKEDCOUNT   = 21;
+	public   final static int EVENT_PURGECACHES       = 22;
+	public   final static int EVENT_GETSTATS          = 23;
+	public   final static int EVENT_SETLOGLEVEL       = 24;
     
     int instance;
     int type;
     Rectangle rectValue;
     String stringValue;
+    // the fields of an event sent with a binary payload.
+    String[] fieldValues;
+    // when the event was queued, for the queue wait statistics.
+    long queuedTime = System.currentTimeMillis();
 
     NativeEventData (int instance, int type)
     {
@@ -78,4 +89,11 @@ public class NativeEventData
         this.type = type;
         this.stringValue = stringValue;
     }    
+
+    NativeEventData (int instance, int type, String[] fieldValues)
+    {
+        this.instance = instance;
+        this.type = type;
+        this.fieldValues = fieldValues;
+    }
 } // end of class NativeEventData
@@ -27,9 +27,11 @@ import java.io.File;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.InputStreamReader;
+import java.io.UnsupportedEncodingException;
 import java.security.AccessController;
 import java.security.PrivilegedActionException;
 import java.security.PrivilegedExceptionAction;
+import java.util.HashMap;
 import java.util.Vector;
 
 import javax.swing.SwingUtilities;
@@ -38,6 +40,7 @@ import org.jdesktop.jdic.browser.IWebBrowser;
 import org.jdesktop.jdic.browser.IBrowserEngine;
 import org.jdesktop.jdic.browser.WebBrowserEvent;
 import org.jdesktop.jdic.browser.BrowserEngineManager;
+import org.jdesktop.jdic.browser.BrowserResourceBudget;
 import org.jdesktop.jdic.init.JdicInitException;
 import org.jdesktop.jdic.init.JdicManager;
 
@@ -66,6 +69,14 @@ public class NativeEventThread extends Thread {
 
 	private boolean stopThreads = false;
 
+	// latency and throughput counters of the messages exchanged with the
+	// native browser.
+	private EventStats stats = new EventStats();
+
+	// requests waiting for an answer of the native browser, for the round
+	// trip statistics: (instance, answer type) -> { request type, time sent }
+	private HashMap pendingRequests = new HashMap();
+
 	private static NativeEventThread nativeEventThread = null;
 
 	/**
@@ -165,6 +176,13 @@ public void run() {
 		return messenger;
 	}
 
+	/**
+	 * @return Returns the latency and throughput counters.
+	 */
+	public EventStats getStats() {
+		return stats;
+	}
+
 	public synchronized void fireNativeEvent(int instance, int type) {
 		nativeEvents.addElement(new NativeEventData(instance, type));
 	}
@@ -180,6 +198,28 @@ public void run() {
 				.addElement(new NativeEventData(instance, type, stringValue));
 	}
 
+	/**
+	 * Fires an event whose string fields are sent to the native browser as a
+	 * binary payload, with no restriction on their content or length.
+	 */
+	public synchronized void fireNativeEvent(int instance, int type,
+			String[] fieldValues) {
+		nativeEvents
+				.addElement(new NativeEventData(instance, type, fieldValues));
+	}
+
+	/**
+	 * Passes the level of the JDIC log on to the native browser, if it's
+	 * running.
+	 */
+	static void setNativeLogLevel(int level) {
+		NativeEventThread eventThread = nativeEventThread;
+		if (eventThread != null) {
+			eventThread.fireNativeEvent(-1, NativeEventData.EVENT_SETLOGLEVEL,
+					String.valueOf(level));
+		}
+	}
+
 	public void setBrowsersInitFailReason(String msg) {
 		((IWebBrowser) webBrowsers.elementAt(0)).setInitFailureMessage(msg);
 	}
@@ -190,7 +230,7 @@ public void run() {
 	 */
 	private void init() throws PrivilegedActionException, JdicInitException {
 		try {
-			messenger = new MsgClient();
+			messenger = new MsgClient(stats);
 
 			engine = BrowserEngineManager.instance().getActiveEngine();
 			engine.initialize();
@@ -200,14 +240,27 @@ public void run() {
 					+ File.separator + engine.getEmbeddedBinaryName();
 			final String cmd = (new File(filepath).exists()) ? filepath
 					: engine.getEmbeddedBinaryName();
+			final String[] cmdArray;
+			BrowserResourceBudget budget = engine.getResourceBudget();
+			if (budget == null) {
+				cmdArray = new String[] { cmd, "-port=" + messenger.getPort() };
+			} else {
+				// the directory goes last as it may contain commas.
+				String dir = budget.getDiskCacheDirectory();
+				cmdArray = new String[] { cmd,
+						"-port=" + messenger.getPort(),
+						"-budget=" + budget.getMemoryCacheSize() + ","
+								+ budget.getDiskCacheSize() + ","
+								+ budget.getMaxHistoryEntries() + ","
+								+ (dir == null ? "" : dir) };
+			}
 			WebBrowserUtil.trace("Executing " + cmd + " -port="
-					+ messenger.getPort());
+					+ messenger.getPort()
+					+ (cmdArray.length > 2 ? " " + cmdArray[2] : ""));
 			AccessController.doPrivileged(new PrivilegedExceptionAction() {
 				public Object run() throws IOException {
 					nativeBrowserProcess = Runtime.getRuntime()
-							.exec(
-									new String[] { cmd,
-											"-port=" + messenger.getPort() });
+							.exec(cmdArray);
 					new StreamGobbler(nativeBrowserProcess.getErrorStream()).start();
 					new StreamGobbler(nativeBrowserProcess.getInputStream()).start();
 					return null;
@@ -247,6 +300,8 @@ public void run() {
 
 		// call native browser to init
 		fireNativeEvent(-1, NativeEventData.EVENT_INIT);
+		fireNativeEvent(-1, NativeEventData.EVENT_SETLOGLEVEL, String
+				.valueOf(WebBrowserUtil.getLogLevel()));
 	}
 
 	private IWebBrowser getWebBrowserFromInstance(int instance) {
@@ -282,8 +337,9 @@ public void run() {
 
 	private boolean processEventFromJava(NativeEventData nativeEvent) {
 		IWebBrowser browser =null;
-		// for init action, needn't browser
-		if (NativeEventData.EVENT_INIT != nativeEvent.type) {
+		// for init and log level actions, needn't browser
+		if (NativeEventData.EVENT_INIT != nativeEvent.type
+				&& NativeEventData.EVENT_SETLOGLEVEL != nativeEvent.type) {
 			browser = getWebBrowserFromInstance(nativeEvent.instance);
 			if (null == browser) {
 				return true;
@@ -310,6 +366,10 @@ public void run() {
 		case NativeEventData.EVENT_FOCUSGAINED:
 		case NativeEventData.EVENT_FOCUSLOST:
 		case NativeEventData.EVENT_GETCONTENT:
+		case NativeEventData.EVENT_CLEARCONTENTRULES:
+		case NativeEventData.EVENT_GETBLOCKEDCOUNT:
+		case NativeEventData.EVENT_PURGECACHES:
+		case NativeEventData.EVENT_GETSTATS:
 			messenger.sendMessage(msg);
 			break;
 		case NativeEventData.EVENT_SHUTDOWN:
@@ -326,23 +386,77 @@ public void run() {
 			}
 			break;
 		case NativeEventData.EVENT_SET_BOUNDS:
+		case NativeEventData.EVENT_SNAPSHOT:
 			msg += nativeEvent.rectValue.x + "," + nativeEvent.rectValue.y
 					+ "," + nativeEvent.rectValue.width + ","
 					+ nativeEvent.rectValue.height;
 			messenger.sendMessage(msg);
 			break;
-		case NativeEventData.EVENT_NAVIGATE:
 		case NativeEventData.EVENT_NAVIGATE_POST:
+			try {
+				messenger.sendPayloadMessage(nativeEvent.instance,
+						nativeEvent.type, nativeEvent.fieldValues);
+			} catch (UnsupportedEncodingException e) {
+				WebBrowserUtil.error(e.getMessage());
+			}
+			break;
+		case NativeEventData.EVENT_NAVIGATE:
 		case NativeEventData.EVENT_SETCONTENT:
 		case NativeEventData.EVENT_EXECUTESCRIPT:
+		case NativeEventData.EVENT_ADDCONTENTRULE:
+		case NativeEventData.EVENT_SETLOGLEVEL:
 			msg += nativeEvent.stringValue;
 			messenger.sendMessage(msg);
 			break;
 		}
 
+		long now = System.currentTimeMillis();
+		stats.countSent(nativeEvent.type, msg.length());
+		stats.record(EventStats.PHASE_QUEUE_WAIT, nativeEvent.type,
+				(now - nativeEvent.queuedTime) * 1000);
+		int answerType = getAnswerType(nativeEvent.type);
+		if (answerType != 0) {
+			pendingRequests.put(requestKey(nativeEvent.instance, answerType),
+					new long[] { nativeEvent.type, now });
+		}
+
 		return true;
 	}
 
+	/*
+	 * Returns the type of the event the native browser answers the given
+	 * request with, or 0.
+	 */
+	private static int getAnswerType(int requestType) {
+		switch (requestType) {
+		case NativeEventData.EVENT_CREATEWINDOW:
+			return WebBrowserEvent.WEBBROWSER_INIT_WINDOW_SUCC;
+		case NativeEventData.EVENT_DESTROYWINDOW:
+			return WebBrowserEvent.WEBBROWSER_DESTROYWINDOW_SUCC;
+		case NativeEventData.EVENT_NAVIGATE_POST:
+		case NativeEventData.EVENT_NAVIGATE:
+		case NativeEventData.EVENT_SETCONTENT:
+			return WebBrowserEvent.WEBBROWSER_DOCUMENT_COMPLETED;
+		case NativeEventData.EVENT_GETURL:
+			return WebBrowserEvent.WEBBROWSER_RETURN_URL;
+		case NativeEventData.EVENT_GETCONTENT:
+			return WebBrowserEvent.WEBBROWSER_GETCONTENT;
+		case NativeEventData.EVENT_EXECUTESCRIPT:
+			return WebBrowserEvent.WEBBROWSER_EXECUTESCRIPT;
+		case NativeEventData.EVENT_SNAPSHOT:
+			return WebBrowserEvent.WEBBROWSER_SNAPSHOT;
+		case NativeEventData.EVENT_GETBLOCKEDCOUNT:
+			return WebBrowserEvent.WEBBROWSER_GETBLOCKEDCOUNT;
+		case NativeEventData.EVENT_GETSTATS:
+			return WebBrowserEvent.WEBBROWSER_GETSTATS;
+		}
+		return 0;
+	}
+
+	private static Long requestKey(int instance, int answerType) {
+		return new Long(((long) instance << 32) | answerType);
+	}
+
 	private void processMessageFromNative(String msg) {
 		NativeEventData eventData = parseMessageString(msg);
 		if (eventData == null)
@@ -352,6 +466,14 @@ public void run() {
 				+ eventData.instance + ", " + eventData.type + ", "
 				+ eventData.stringValue);
 
+		stats.countReceived(eventData.type, msg.length());
+		long[] request = (long[]) pendingRequests.remove(requestKey(
+				eventData.instance, eventData.type));
+		if (request != null) {
+			stats.record(EventStats.PHASE_ROUND_TRIP, (int) request[0],
+					(System.currentTimeMillis() - request[1]) * 1000);
+		}
+
 		if (WebBrowserEvent.WEBBROWSER_INIT_FAILED == eventData.type) {
 			setBrowsersInitFailReason(eventData.stringValue);
 			WebBrowserUtil.error(eventData.stringValue);
@@ -380,6 +502,9 @@ public void run() {
 		if (WebBrowserEvent.WEBBROWSER_RETURN_URL == eventData.type
 				|| WebBrowserEvent.WEBBROWSER_GETCONTENT == eventData.type
 				|| WebBrowserEvent.WEBBROWSER_EXECUTESCRIPT == eventData.type
+				|| WebBrowserEvent.WEBBROWSER_SNAPSHOT == eventData.type
+				|| WebBrowserEvent.WEBBROWSER_GETBLOCKEDCOUNT == eventData.type
+				|| WebBrowserEvent.WEBBROWSER_GETSTATS == eventData.type
 				|| WebBrowserEvent.WEBBROWSER_DESTROYWINDOW_SUCC == eventData.type) {
 			eventRetString = eventData.stringValue;
 			notifyWebBrowser(eventData.instance);
@@ -398,7 +523,10 @@ public void run() {
 		// of IWebBrowser.
 		Runnable dispatchEvent = new Runnable() {
 			public void run() {
+				long start = System.currentTimeMillis();
 				browser.dispatchWebBrowserEvent(event);
+				stats.record(EventStats.PHASE_LISTENER, event.getID(),
+						(System.currentTimeMillis() - start) * 1000);
 			}
 		};
 
@@ -72,6 +72,23 @@ public class WebBrowserUtil {
 
 	private static boolean isDebugOn = false;
 
+	/**
+	 * Levels of the JDIC log, which is shared with the native code. Must keep
+	 * same with Logger.h.
+	 */
+	public static final int LOG_OFF = -1;
+
+	public static final int LOG_ERROR = 0;
+
+	public static final int LOG_WARNING = 1;
+
+	public static final int LOG_INFO = 2;
+
+	public static final int LOG_DEBUG = 3;
+
+	// the level of the native log, read once the native library is loaded.
+	private static int logLevel = LOG_OFF;
+
 	/* native functions */
 	private static native String nativeGetBrowserPath();
 
@@ -79,6 +96,12 @@ public class WebBrowserUtil {
 
 	private static native void nativeSetEnv();
 
+	private static native void nativeLog(int level, String msg);
+
+	private static native int nativeGetLogLevel();
+
+	private static native void nativeSetLogLevel(int level);
+
 	/** Loads the jdic library (unless it has already been loaded) */
 	public static void loadLibrary() {
 		if (!nativeLibLoaded) {
@@ -97,6 +120,12 @@ public class WebBrowserUtil {
 				}
 			});
 			nativeLibLoaded = true;
+			try {
+				logLevel = nativeGetLogLevel();
+			} catch (UnsatisfiedLinkError e) {
+				// a native library built without the JDIC log.
+				logLevel = LOG_OFF;
+			}
 		}
 	}
 
@@ -145,12 +174,51 @@ public class WebBrowserUtil {
 	public static void trace(String msg) {
 		if (isDebugOn)
 			System.out.println("*** Jtrace: " + msg);
+		log(LOG_DEBUG, msg);
 	}
 
 	public static void error(String msg) {
 		System.err.println("*** Error: " + msg);
 	}
 
+	/**
+	 * Writes the given message to the JDIC log, the same log the native code
+	 * writes to. The log file and the initial level are set with the
+	 * JDIC_LOG_FILE and JDIC_LOG_LEVEL environment variables. Nothing is
+	 * logged until the native library is loaded.
+	 * 
+	 * @param level
+	 *            one of the <code>LOG_*</code> levels.
+	 * @param msg
+	 *            the message.
+	 */
+	public static void log(int level, String msg) {
+		if (level <= logLevel && msg != null) {
+			nativeLog(level, msg);
+		}
+	}
+
+	/**
+	 * Sets the level of the JDIC log, both for this process and the native
+	 * browser process.
+	 * 
+	 * @param level
+	 *            one of the <code>LOG_*</code> levels.
+	 */
+	public static void setLogLevel(int level) {
+		loadLibrary();
+		nativeSetLogLevel(level);
+		logLevel = nativeGetLogLevel();
+		NativeEventThread.setNativeLogLevel(logLevel);
+	}
+
+	/**
+	 * Returns the level of the JDIC log.
+	 */
+	public static int getLogLevel() {
+		return logLevel;
+	}
+
 	/**
 	 * Sets trace messages on or off. If on, the trace messages will be printed
 	 * out in the console.
@@ -21,8 +21,13 @@
 package org.jdesktop.jdic.filetypes;
 
 import java.net.URL;
+import java.util.ArrayList;
+import java.util.Collection;
+import java.util.HashMap;
 import java.util.Iterator;
+import java.util.LinkedHashMap;
 import java.util.List;
+import java.util.Map;
 import org.jdesktop.jdic.filetypes.internal.AppAssociationWriter;
 import org.jdesktop.jdic.filetypes.internal.AppAssociationWriterFactory;
 import org.jdesktop.jdic.filetypes.internal.AppAssociationReader;
@@ -58,6 +63,12 @@ public class AssociationService {
     private AppAssociationReader appAssocReader;
     // A platform-dependent instance of AppAssociationWriter.
     private AppAssociationWriter appAssocWriter;
+    // The number of threads the batch lookups use, 0 for one per processor.
+    private int lookupThreadCount = 0;
+
+    // The kinds of keys the batch lookups take.
+    private final static int MIME_TYPE_KEY = 0;
+    private final static int FILE_EXT_KEY = 1;
   
     // Add the initialization code from package org.jdesktop.jdic.init.
     // To set the environment variables or initialize the set up for 
@@ -230,6 +241,316 @@ public class AssociationService {
         return assoc;
     }        
   
+    /**
+     * Sets the number of threads the batch lookup methods use.
+     * <p>
+     * The batch lookup methods are <code>getMimeTypeAssociations</code>,
+     * <code>getFileExtensionAssociations</code> and 
+     * <code>getAssociationsByContent</code> with several URLs. The default,
+     * 0, uses one thread per processor; 1 does the lookups on the calling 
+     * thread only. Where the system association info can't be read from 
+     * several threads at once, as with GnomeVFS, the lookups always run on
+     * the calling thread.
+     *
+     * @param threadCount the number of threads, or 0 for one per processor.
+     * @throws IllegalArgumentException if the given number is negative.
+     */
+    public void setLookupThreadCount(int threadCount) {
+        if (threadCount < 0) {
+            throw new IllegalArgumentException("The specified thread count is negative");
+        }
+        lookupThreadCount = threadCount;
+    }
+
+    /**
+     * Returns the number of threads the batch lookup methods use, 0 for one
+     * per processor.
+     *
+     * @return the number of threads.
+     */
+    public int getLookupThreadCount() {
+        return lookupThreadCount;
+    }
+
+    /**
+     * Returns the associations representing the file types of the given MIME
+     * types.
+     * <p>
+     * The result is the same as calling <code>getMimeTypeAssociation</code>
+     * for each MIME type, but repeated MIME types are looked up once and the
+     * lookups run on several threads, see <code>setLookupThreadCount</code>.
+     *
+     * @param mimeTypes a collection of MIME type names.
+     * @return a map from each given MIME type to the appropriate 
+     *         <code>Association</code> object, or to <code>null</code> if the 
+     *         MIME type is not found in the system.
+     */
+    public Map getMimeTypeAssociations(Collection mimeTypes) {
+        if (mimeTypes == null) {
+            throw new IllegalArgumentException("The specified mime type collection is null");
+        }
+
+        Map distinctKeys = new LinkedHashMap();
+        Iterator iter = mimeTypes.iterator();
+        while (iter.hasNext()) {
+            String mimeType = (String) iter.next();
+            if (mimeType == null) {
+                throw new IllegalArgumentException("The specified mime type is null");
+            }
+            distinctKeys.put(mimeType, mimeType);
+        }
+
+        return lookupAssociations(distinctKeys, MIME_TYPE_KEY);
+    }
+
+    /**
+     * Returns the associations representing the file types of the given file
+     * extensions.
+     * <p>
+     * The result is the same as calling 
+     * <code>getFileExtensionAssociation</code> for each file extension, but 
+     * repeated file extensions, with or without the leading '.' character, 
+     * share one lookup and one <code>Association</code> object, and the 
+     * lookups run on several threads, see <code>setLookupThreadCount</code>.
+     *
+     * @param fileExts a collection of file extension names.
+     * @return a map from each given file extension to the appropriate 
+     *         <code>Association</code> object, or to <code>null</code> if the 
+     *         file extension is not found in the system.
+     */
+    public Map getFileExtensionAssociations(Collection fileExts) {
+        if (fileExts == null) {
+            throw new IllegalArgumentException("The specified file extension collection is null");
+        }
+
+        Map distinctKeys = new LinkedHashMap();
+        Iterator iter = fileExts.iterator();
+        while (iter.hasNext()) {
+            String fileExt = (String) iter.next();
+            if (fileExt == null) {
+                throw new IllegalArgumentException("The specified file extension is null");
+            }
+            distinctKeys.put(fileExt, AppUtility.addDotToFileExtension(fileExt));
+        }
+
+        return lookupAssociations(distinctKeys, FILE_EXT_KEY);
+    }
+
+    /**
+     * Returns the associations representing the file types of the files the 
+     * given URLs point to.
+     * <p>
+     * The result is the same as calling <code>getAssociationByContent</code> 
+     * for each URL, but the file types are detected in one pass, and the 
+     * association of each file type is retrieved only once: URLs of the 
+     * same file type share the same <code>Association</code> object. The 
+     * detection and the lookups run on several threads, see 
+     * <code>setLookupThreadCount</code>.
+     *
+     * @param urls the given URLs.
+     * @return an array with the appropriate <code>Association</code> object 
+     *         for each URL; an element is <code>null</code> if the file type
+     *         of the file the URL points to is not found in the system.
+     */
+    public Association[] getAssociationsByContent(URL[] urls) {
+        if (urls == null) {
+            throw new IllegalArgumentException("The specified URL array is null");
+        }
+        for (int i = 0; i < urls.length; i++) {
+            if (urls[i] == null) {
+                throw new IllegalArgumentException("The specified URL is null");
+            }
+        }
+
+        String[] mimeTypes = appAssocReader.getMimeTypesByURLs(urls, lookupThreadCount);
+
+        // Get association by mime type.
+        Map distinctMimeTypes = new LinkedHashMap();
+        for (int i = 0; i < urls.length; i++) {
+            if (mimeTypes[i] != null) {
+                distinctMimeTypes.put(mimeTypes[i], mimeTypes[i]);
+            }
+        }
+        Map mimeTypeAssocs = lookupAssociations(distinctMimeTypes, MIME_TYPE_KEY);
+
+        // Get association by file extension, for the URLs with none.
+        String[] fileExts = new String[urls.length];
+        Map distinctFileExts = new LinkedHashMap();
+        for (int i = 0; i < urls.length; i++) {
+            if (mimeTypes[i] == null || mimeTypeAssocs.get(mimeTypes[i]) == null) {
+                fileExts[i] = AppUtility.getFileExtensionByURL(urls[i]);
+                if (fileExts[i] != null) {
+                    distinctFileExts.put(fileExts[i], fileExts[i]);
+                }
+            }
+        }
+        Map fileExtAssocs = lookupAssociations(distinctFileExts, FILE_EXT_KEY);
+
+        Association[] assocs = new Association[urls.length];
+        for (int i = 0; i < urls.length; i++) {
+            if (fileExts[i] != null) {
+                assocs[i] = (Association) fileExtAssocs.get(fileExts[i]);
+            } else if (mimeTypes[i] != null) {
+                assocs[i] = (Association) mimeTypeAssocs.get(mimeTypes[i]);
+            }
+        }
+
+        return assocs;
+    }
+
+    /**
+     * Returns the associations representing the file types of the files the 
+     * given URLs point to, as <code>getAssociationsByContent(URL[])</code> 
+     * does.
+     *
+     * @param urls a collection of URLs.
+     * @return a map from each given URL to the appropriate 
+     *         <code>Association</code> object, or to <code>null</code> if the
+     *         file type of the file the URL points to is not found in the 
+     *         system.
+     */
+    public Map getAssociationsByContent(Collection urls) {
+        if (urls == null) {
+            throw new IllegalArgumentException("The specified URL collection is null");
+        }
+
+        // Remove the repeated URLs by their external form: URL.equals() 
+        // compares the host addresses, which may need name lookups.
+        Map urlIndexes = new HashMap();
+        List distinctUrls = new ArrayList();
+        Iterator iter = urls.iterator();
+        while (iter.hasNext()) {
+            URL url = (URL) iter.next();
+            if (url == null) {
+                throw new IllegalArgumentException("The specified URL is null");
+            }
+            String urlStr = url.toExternalForm();
+            if (!urlIndexes.containsKey(urlStr)) {
+                urlIndexes.put(urlStr, new Integer(distinctUrls.size()));
+                distinctUrls.add(url);
+            }
+        }
+
+        Association[] assocs = getAssociationsByContent(
+                (URL[]) distinctUrls.toArray(new URL[distinctUrls.size()]));
+
+        Map assocMap = new HashMap();
+        iter = urls.iterator();
+        while (iter.hasNext()) {
+            URL url = (URL) iter.next();
+            Integer index = (Integer) urlIndexes.get(url.toExternalForm());
+            assocMap.put(url, assocs[index.intValue()]);
+        }
+
+        return assocMap;
+    }
+
+    /**
+     * Looks up the associations of the given keys, on several threads if 
+     * there are enough of them. Keys mapped to the same lookup key share a 
+     * single lookup.
+     *
+     * @param keys a map from each key to the mime type or file extension to
+     *        look up.
+     * @param keyKind MIME_TYPE_KEY or FILE_EXT_KEY.
+     * @return a map from each key to its association, or to null.
+     */
+    private Map lookupAssociations(Map keys, final int keyKind) {
+        Map lookupIndexes = new HashMap();
+        List lookupKeys = new ArrayList();
+        Iterator iter = keys.values().iterator();
+        while (iter.hasNext()) {
+            Object lookupKey = iter.next();
+            if (!lookupIndexes.containsKey(lookupKey)) {
+                lookupIndexes.put(lookupKey, new Integer(lookupKeys.size()));
+                lookupKeys.add(lookupKey);
+            }
+        }
+
+        final String[] keyArray = (String[]) lookupKeys.toArray(new String[lookupKeys.size()]);
+        final Association[] assocs = new Association[keyArray.length];
+        // The index of the next key to look up, shared by the threads.
+        final int[] nextIndex = new int[1];
+        final Throwable[] failure = new Throwable[1];
+
+        Runnable lookup = new Runnable() {
+            public void run() {
+                while (true) {
+                    int index;
+                    synchronized (nextIndex) {
+                        if (nextIndex[0] >= keyArray.length || failure[0] != null) {
+                            return;
+                        }
+                        index = nextIndex[0]++;
+                    }
+                    try {
+                        if (keyKind == MIME_TYPE_KEY) {
+                            assocs[index] = getMimeTypeAssociation(keyArray[index]);
+                        } else {
+                            assocs[index] = getFileExtensionAssociation(keyArray[index]);
+                        }
+                    } catch (Throwable e) {
+                        synchronized (nextIndex) {
+                            failure[0] = e;
+                        }
+                        return;
+                    }
+                }
+            }
+        };
+
+        // A reader that isn't thread safe does all the lookups on the 
+        // calling thread.
+        int threadCount = lookupThreadCount;
+        if (!appAssocReader.isThreadSafe()) {
+            threadCount = 1;
+        } else if (threadCount == 0) {
+            threadCount = Runtime.getRuntime().availableProcessors();
+        }
+        threadCount = Math.min(threadCount, keyArray.length);
+
+        // The calling thread looks up too.
+        Thread[] threads = new Thread[Math.max(threadCount - 1, 0)];
+        for (int i = 0; i < threads.length; i++) {
+            threads[i] = new Thread(lookup, "AssociationService lookup");
+            threads[i].setDaemon(true);
+            threads[i].start();
+        }
+        lookup.run();
+
+        boolean interrupted = false;
+        for (int i = 0; i < threads.length; i++) {
+            while (threads[i].isAlive()) {
+                try {
+                    threads[i].join();
+                } catch (InterruptedException e) {
+                    interrupted = true;
+                }
+            }
+        }
+        if (interrupted) {
+            Thread.currentThread().interrupt();
+        }
+        // Rethrow the failure of any thread on the calling thread.
+        if (failure[0] instanceof RuntimeException) {
+            throw (RuntimeException) failure[0];
+        } else if (failure[0] instanceof Error) {
+            throw (Error) failure[0];
+        } else if (failure[0] != null) {
+            throw new RuntimeException(failure[0].toString());
+        }
+
+        Map assocMap = new HashMap();
+        iter = keys.entrySet().iterator();
+        while (iter.hasNext()) {
+            Map.Entry entry = (Map.Entry) iter.next();
+            Integer index = (Integer) lookupIndexes.get(entry.getValue());
+            assocMap.put(entry.getKey(), assocs[index.intValue()]);
+        }
+
+        return assocMap;
+    }
+
     /**
      * Registers the given association in the user specific level.
      * <p>
@@ -414,4 +735,128 @@ public class AssociationService {
 
         appAssocWriter.unregisterAssociation(assoc, AppAssociationWriter.SYSTEM_LEVEL);
     }
+
+    /**
+     * Registers the given associations in the user specific level at once.
+     * <p>
+     * Each association needs to satisfy the same conditions as for 
+     * <code>registerUserAssociation</code>. Either all the associations are 
+     * registered, or none of them:
+     * <ul>
+     *   <li> For Microsoft Windows platforms: the associations are registered 
+     *        one by one, and the registered ones are removed again if one fails.
+     *
+     *   <li> For Gnome/Unix platforms: each MIME database file is written only 
+     *        once, and atomically, however many associations it contains. 
+     *        The MIME database is reloaded once afterwards.
+     * </ul>
+     *
+     * @param assocs a collection of <code>Association</code> objects.
+     * @throws IllegalArgumentException if one of the given associations is not 
+     *         valid for this operation.
+     * @throws AssociationAlreadyRegisteredException if one of the given 
+     *         associations already exists in the system.
+     * @throws RegisterFailedException if the given associations fail to be 
+     *         registered in the system.
+     * @see #registerUserAssociation
+     */
+    public void registerUserAssociations(Collection assocs) 
+            throws AssociationAlreadyRegisteredException, RegisterFailedException {
+        appAssocWriter.registerAssociations(checkAssociations(assocs, true), 
+                AppAssociationWriter.USER_LEVEL);
+    }
+
+    /**
+     * Unregisters the given associations in the user specific level at once.
+     * <p>
+     * Each association needs to satisfy the same conditions as for 
+     * <code>unregisterUserAssociation</code>. All of them are checked to 
+     * exist before any is unregistered.
+     *
+     * @param assocs a collection of <code>Association</code> objects.
+     * @throws IllegalArgumentException if one of the given associations is not 
+     *         valid for this operation.
+     * @throws AssociationNotRegisteredException if one of the given associations
+     *         doesn't exist in the system.
+     * @throws RegisterFailedException if the given associations fail to be 
+     *         unregistered in the system.   
+     * @see #unregisterUserAssociation
+     */
+    public void unregisterUserAssociations(Collection assocs) 
+            throws AssociationNotRegisteredException, RegisterFailedException {
+        appAssocWriter.unregisterAssociations(checkAssociations(assocs, false), 
+                AppAssociationWriter.USER_LEVEL);
+    }
+
+    /**
+     * Registers the given associations in the system level at once.
+     * <p>
+     * Each association needs to satisfy the same conditions as for 
+     * <code>registerSystemAssociation</code>. Either all the associations are
+     * registered, or none of them, see <code>registerUserAssociations</code>.
+     *
+     * @param assocs a collection of <code>Association</code> objects.
+     * @throws IllegalArgumentException if one of the given associations is not 
+     *         valid for this operation.
+     * @throws AssociationAlreadyRegisteredException if one of the given 
+     *         associations already exists in the system.
+     * @throws RegisterFailedException if the given associations fail to be 
+     *         registered in the system.
+     * @see #registerSystemAssociation
+     * @see #registerUserAssociations
+     */
+    public void registerSystemAssociations(Collection assocs) 
+            throws AssociationAlreadyRegisteredException, RegisterFailedException {
+        appAssocWriter.registerAssociations(checkAssociations(assocs, true), 
+                AppAssociationWriter.SYSTEM_LEVEL);
+    }
+
+    /**
+     * Unregisters the given associations in the system level at once.
+     * <p>
+     * Each association needs to satisfy the same conditions as for 
+     * <code>unregisterSystemAssociation</code>. All of them are checked to 
+     * exist before any is unregistered.
+     *
+     * @param assocs a collection of <code>Association</code> objects.
+     * @throws IllegalArgumentException if one of the given associations is not 
+     *         valid for this operation.
+     * @throws AssociationNotRegisteredException if one of the given associations
+     *         doesn't exist in the system.
+     * @throws RegisterFailedException if the given associations fail to be 
+     *         unregistered in the system.   
+     * @see #unregisterSystemAssociation
+     */
+    public void unregisterSystemAssociations(Collection assocs)
+            throws AssociationNotRegisteredException, RegisterFailedException {
+        appAssocWriter.unregisterAssociations(checkAssociations(assocs, false), 
+                AppAssociationWriter.SYSTEM_LEVEL);
+    }
+
+    /**
+     * Checks whether the given associations are valid for registration or 
+     * unregistration, and returns them as a list.
+     */
+    private List checkAssociations(Collection assocs, boolean forRegistration) {
+        if (assocs == null) {
+            throw new IllegalArgumentException("The specified association collection is null");
+        }
+
+        List assocList = new ArrayList(assocs.size());
+        Iterator iter = assocs.iterator();
+        while (iter.hasNext()) {
+            Object assoc = iter.next();
+            if (!(assoc instanceof Association)) {
+                throw new IllegalArgumentException("The specified collection contains " 
+                        + "an element which is not an association: " + assoc);
+            }
+            if (forRegistration) {
+                appAssocWriter.checkAssociationValidForRegistration((Association) assoc);
+            } else {
+                appAssocWriter.checkAssociationValidForUnregistration((Association) assoc);
+            }
+            assocList.add(assoc);
+        }
+        return assocList;
+    }
 }
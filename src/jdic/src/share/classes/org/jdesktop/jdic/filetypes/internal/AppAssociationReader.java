@@ -55,6 +55,16 @@ public interface AppAssociationReader {
      */
     public abstract String getMimeTypeByURL(URL url);
 
+    /**
+     * Returns the mime types associated with the given URLs, by checking the 
+     * content of the URLs. Implementations may check the URLs in parallel.
+     * 
+     * @param urls The specified URLs
+     * @param threadCount The most threads to use, 0 for one per processor
+     * @return an array with the mime type, or null, of each URL
+     */
+    public abstract String[] getMimeTypesByURLs(URL[] urls, int threadCount);
+
     /**
      * Returns the file extensione list associated with the given mime type.
      *
@@ -118,4 +128,13 @@ public interface AppAssociationReader {
      * @return true if the file extension exists in the system
      */
 	public boolean isFileExtExist(String fileExt);
+
+    /**
+     * Returns true if the methods of this reader may be called from several
+     * threads at once. The batch lookups of AssociationService run on one 
+     * thread otherwise.
+     *
+     * @return true if this reader is thread safe
+     */
+    public boolean isThreadSafe();
 }
@@ -20,6 +20,7 @@
 
 package org.jdesktop.jdic.filetypes.internal;
 
+import java.util.List;
 import org.jdesktop.jdic.filetypes.Association;
 import org.jdesktop.jdic.filetypes.AssociationAlreadyRegisteredException;
 import org.jdesktop.jdic.filetypes.AssociationNotRegisteredException;
@@ -90,4 +91,31 @@ public interface AppAssociationWriter {
      */
     public void unregisterAssociation(Association assoc, int level) 
             throws AssociationNotRegisteredException, RegisterFailedException;
+
+    /**
+     * Registers the given associations within specified level, writing the 
+     * changes to the system at once where the platform allows.
+     * 
+     * @param assocList a list of the Association objects to register.
+     * @param level a given registration level
+     * @throws AssociationAlreadyRegisteredException if one of the given 
+     *         associations has been registered in the system. None of the 
+     *         associations is registered then.
+     * @throws RegisterFailedException if the given associations fail to be registered.
+     */
+    public void registerAssociations(List assocList, int level) 
+            throws AssociationAlreadyRegisteredException, RegisterFailedException;
+
+    /**
+     * Unregisters the given associations in specified level.
+     * 
+     * @param assocList a list of the Association objects to unregister.
+     * @param level a given registration level
+     * @throws AssociationNotRegisteredException if one of the given associations 
+     *         has not been registered before. None of the associations is 
+     *         unregistered then.
+     * @throws RegisterFailedException if the given associations fail to be unregistered.   
+     */
+    public void unregisterAssociations(List assocList, int level) 
+            throws AssociationNotRegisteredException, RegisterFailedException;
 }
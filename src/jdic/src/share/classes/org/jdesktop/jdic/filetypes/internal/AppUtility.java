@@ -20,6 +20,9 @@
 
 package org.jdesktop.jdic.filetypes.internal;
 
+import java.io.File;
+import java.net.URI;
+import java.net.URISyntaxException;
 import java.net.URL;
 
 /**
@@ -62,6 +65,29 @@ public class AppUtility {
         }
     }
 
+    /**
+     * Returns the local file the given URL points to, or null if it's not a
+     * file URL.
+     *
+     * @param url the specified URL
+     * @return the file the URL points to.
+     */
+    public static File getFileByURL(URL url) {
+        if (!"file".equals(url.getProtocol())) {
+            return null;
+        }
+        
+        try {
+            // Decodes the escaped characters, e.g. %20.
+            return new File(new URI(url.toString()));
+        } catch (URISyntaxException e) {
+            return new File(url.getPath());
+        } catch (IllegalArgumentException e) {
+            // Not a hierarchical absolute URI, e.g. file:test.html.
+            return new File(url.getPath());
+        }
+    }
+
     /**
      * Removes the leading '.' character from the specified file extension.
      *
@@ -25,9 +25,11 @@
 
 #include "Common.h"
 #include "ProfileDirServiceProvider.h"
+#include "ContentPolicy.h"
 #include "MsgServer.h"
 #include "Message.h"
 #include "Util.h"
+#include "Logger.h"
 
 // from the Gecko SDK
 #include "nsXPCOM.h"
@@ -39,7 +41,12 @@
 #include "nsIProperties.h"
 #include "nsIPrefService.h"
 #include "nsILocalFile.h"
+#include "nsIPrefBranch.h"
+#include "nsIObserverService.h"
 #include "plstr.h"
+#include "prprf.h"
+#include "prenv.h"
+#include "prinrval.h"
 #include "nsIDOMDocument.h"
 #include "nsIDOMNodeList.h"
 #include "nsIDOMElement.h"
@@ -192,9 +199,218 @@ static nsresult CopyPrefs(nsIFile *fromFile, nsIFile *toFile)
     return NS_OK;
 }
 
+// Version of what JDIC puts into its private profile. Bump it whenever that
+// changes, so profiles created by older versions get their prefs imported
+// again.
+#define JDIC_PROFILE_VERSION 1
+
+// The stamp file in the private profile records the profile version and
+// the prefs.js last imported, so the import is only redone when the user's
+// prefs.js is a different file or has been modified since.
+#define PROFILE_STAMP_FILE "jdicprofile.stamp"
+
+struct ProfileStamp
+{
+    int version;
+    char prefsSource[1024];
+    PRInt64 prefsModified;
+};
+
+static void ReadProfileStamp(nsIFile *profileDir, ProfileStamp *stamp)
+{
+    memset(stamp, 0, sizeof(ProfileStamp));
+
+    nsCOMPtr<nsIFile> stampFile;
+    if (NS_FAILED(profileDir->Clone(getter_AddRefs(stampFile))))
+        return;
+    stampFile->AppendNative(nsEmbedCString(PROFILE_STAMP_FILE));
+    nsCOMPtr<nsILocalFile> stampLocalFile = do_QueryInterface(stampFile);
+
+    FILE *fp;
+    if (!stampLocalFile || 
+        NS_FAILED(stampLocalFile->OpenANSIFileDesc("r", &fp)))
+        return;
+
+    // The stamp looks like:
+    //   <profile version>
+    //   <modification time of prefs.js>
+    //   <path of prefs.js>
+    char buf[1024];
+    if (fgets(buf, sizeof(buf), fp) != NULL)
+        stamp->version = atoi(buf);
+    if (fgets(buf, sizeof(buf), fp) != NULL)
+        PR_sscanf(buf, "%lld", &stamp->prefsModified);
+    if (fgets(stamp->prefsSource, sizeof(stamp->prefsSource), fp) != NULL) {
+        char *eol = strchr(stamp->prefsSource, '\n');
+        if (eol)
+            *eol = '\0';
+    }
+    fclose(fp);
+}
+
+static void WriteProfileStamp(nsIFile *profileDir, const ProfileStamp *stamp)
+{
+    nsCOMPtr<nsIFile> stampFile;
+    if (NS_FAILED(profileDir->Clone(getter_AddRefs(stampFile))))
+        return;
+    stampFile->AppendNative(nsEmbedCString(PROFILE_STAMP_FILE));
+    nsCOMPtr<nsILocalFile> stampLocalFile = do_QueryInterface(stampFile);
+
+    FILE *fp;
+    if (!stampLocalFile || 
+        NS_FAILED(stampLocalFile->OpenANSIFileDesc("w", &fp)))
+        return;
+
+    char buf[64];
+    PR_snprintf(buf, sizeof(buf), "%d\n%lld\n", 
+                stamp->version, stamp->prefsModified);
+    fputs(buf, fp);
+    fputs(stamp->prefsSource, fp);
+    fputs("\n", fp);
+    fclose(fp);
+}
+
+// helper function for timing the startup phases. The time spent since the
+// last call is logged when the JDIC_STARTUP_TIMING environment variable is
+// set.
+static void LogStartupPhase(const char *phase, PRIntervalTime *phaseStart)
+{
+    PRIntervalTime now = PR_IntervalNow();
+    if (PR_GetEnv("JDIC_STARTUP_TIMING")) {
+        char logBuf[128];
+        PR_snprintf(logBuf, sizeof(logBuf), "startup phase %s: %u ms", 
+                    phase, PR_IntervalToMilliseconds(now - *phaseStart));
+        LogMsg(logBuf);
+    }
+    *phaseStart = now;
+}
+
+// The resource budget passed by the Java side with the -budget= argument.
+// -1 keeps the Mozilla default.
+static int gMemoryCacheSize = -1;
+static int gDiskCacheSize = -1;
+static int gMaxHistoryEntries = -1;
+static char gDiskCacheDir[1024] = "";
+
+void SetResourceBudget(const char *budget)
+{
+    // <memory cache KB>,<disk cache KB>,<history entries>,<disk cache dir>
+    // the directory is last as it may contain commas.
+    int offset = 0;
+    if (sscanf(budget, "%d,%d,%d,%n", &gMemoryCacheSize, &gDiskCacheSize,
+               &gMaxHistoryEntries, &offset) < 3 || offset == 0) {
+        LogMsg("Invalid resource budget, using the defaults.");
+        gMemoryCacheSize = gDiskCacheSize = gMaxHistoryEntries = -1;
+        return;
+    }
+    PL_strncpyz(gDiskCacheDir, budget + offset, sizeof(gDiskCacheDir));
+}
+
+// the budget goes into the default branch, so it's never saved to the 
+// profile. A user value saved there by an older version is cleared, so it 
+// can't override the budget.
+static void ClearUserValue(nsIPrefBranch *aPrefBranch, const char *aPref)
+{
+    PRBool hasUserValue = PR_FALSE;
+    aPrefBranch->PrefHasUserValue(aPref, &hasUserValue);
+    if (hasUserValue)
+        aPrefBranch->ClearUserPref(aPref);
+}
+
+// apply the resource budget on top of the prefs read from the profile. The
+// prefs are process wide, so the history cap applies to every browser of 
+// the process alike.
+static void ApplyResourceBudget(nsIPrefService *aPrefService)
+{
+    nsCOMPtr<nsIPrefBranch> prefBranch = do_QueryInterface(aPrefService);
+    nsCOMPtr<nsIPrefBranch> defaultBranch;
+    aPrefService->GetDefaultBranch("", getter_AddRefs(defaultBranch));
+    if (!prefBranch || !defaultBranch)
+        return;
+
+    if (gMemoryCacheSize >= 0) {
+        ClearUserValue(prefBranch, "browser.cache.memory.enable");
+        ClearUserValue(prefBranch, "browser.cache.memory.capacity");
+        defaultBranch->SetBoolPref("browser.cache.memory.enable", 
+                                   gMemoryCacheSize > 0);
+        defaultBranch->SetIntPref("browser.cache.memory.capacity", 
+                                  gMemoryCacheSize);
+    }
+    if (gDiskCacheSize >= 0) {
+        ClearUserValue(prefBranch, "browser.cache.disk.enable");
+        ClearUserValue(prefBranch, "browser.cache.disk.capacity");
+        defaultBranch->SetBoolPref("browser.cache.disk.enable", 
+                                   gDiskCacheSize > 0);
+        defaultBranch->SetIntPref("browser.cache.disk.capacity", 
+                                  gDiskCacheSize);
+    }
+    if (gDiskCacheDir[0] != '\0') {
+        nsCOMPtr<nsILocalFile> cacheDir;
+        nsresult rv = NS_NewNativeLocalFile(nsEmbedCString(gDiskCacheDir), 
+                                            PR_TRUE, getter_AddRefs(cacheDir));
+        if (NS_SUCCEEDED(rv)) {
+            ClearUserValue(prefBranch, "browser.cache.disk.parent_directory");
+            defaultBranch->SetComplexValue(
+                "browser.cache.disk.parent_directory", 
+                NS_GET_IID(nsILocalFile), cacheDir);
+        } else {
+            LogMsg("Invalid disk cache directory in the resource budget.");
+        }
+    }
+    if (gMaxHistoryEntries >= 0) {
+        ClearUserValue(prefBranch, "browser.sessionhistory.max_entries");
+        defaultBranch->SetIntPref("browser.sessionhistory.max_entries", 
+                                  gMaxHistoryEntries);
+    }
+}
+
+// drop the cache content by shrinking the cache to nothing and restoring
+// its capacity. nsICacheService isn't part of the Gecko SDK, while the cache
+// service evicts entries to follow capacity changes right away.
+static void PurgeCache(nsIPrefBranch *aPrefBranch, const char *aCapacityPref)
+{
+    PRBool hasUserValue = PR_FALSE;
+    PRInt32 capacity = 0;
+    aPrefBranch->PrefHasUserValue(aCapacityPref, &hasUserValue);
+    if (hasUserValue)
+        aPrefBranch->GetIntPref(aCapacityPref, &capacity);
+
+    aPrefBranch->SetIntPref(aCapacityPref, 0);
+
+    if (hasUserValue)
+        aPrefBranch->SetIntPref(aCapacityPref, capacity);
+    else
+        aPrefBranch->ClearUserPref(aCapacityPref);
+}
+
+nsresult PurgeCaches()
+{
+    nsCOMPtr<nsIPrefBranch> prefBranch;
+    nsresult rv = GetService("@mozilla.org/preferences-service;1",
+                             NS_GET_IID(nsIPrefBranch),
+                             getter_AddRefs(prefBranch));
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    PurgeCache(prefBranch, "browser.cache.memory.capacity");
+    PurgeCache(prefBranch, "browser.cache.disk.capacity");
+
+    // let the other components (images, JS, layout) release their memory.
+    nsCOMPtr<nsIObserverService> observerService;
+    rv = GetService("@mozilla.org/observer-service;1",
+                    NS_GET_IID(nsIObserverService),
+                    getter_AddRefs(observerService));
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    nsEmbedString heapMinimize;
+    ConvertAsciiToUtf16("heap-minimize", heapMinimize);
+    return observerService->NotifyObservers(nsnull, "memory-pressure", 
+                                            heapMinimize.get());
+}
+
 nsresult InitializeProfile()
 {
     nsresult rv;
+    PRIntervalTime phaseStart = PR_IntervalNow();
          
     nsEmbedCString copiedPrefs("copiedprefs.js");
 
@@ -216,6 +432,7 @@ nsresult InitializeProfile()
     NS_ENSURE_SUCCESS(rv, rv);
     rv = locProvider->SetProfileDir(privateProfileDir);
     NS_ENSURE_SUCCESS(rv, rv);
+    LogStartupPhase("profile directory", &phaseStart);
 
     // XXX because nsIProfileInternal was altered breaking binary 
     //     compatibility, and the interface UUID was not changed.  
@@ -232,6 +449,14 @@ nsresult InitializeProfile()
         MOZILLA_1_7 = 0;
     }
 
+    // register the content policy driven by the rules from the Java side.
+    // Failing to do so only disables request filtering.
+    rv = RegisterContentPolicy(MOZILLA_1_7);
+    if (NS_FAILED(rv)) {
+        LogMsg("Failed to register the content policy!");
+    }
+    LogStartupPhase("version check", &phaseStart);
+
     nsCOMPtr<nsIProfileInternal> profileService;
     nsCOMPtr<nsIProfileInternalOld> profileServiceOld;
     if (MOZILLA_1_7) {
@@ -270,9 +495,35 @@ nsresult InitializeProfile()
         NS_ENSURE_SUCCESS(rv, rv);
         PRBool exists;
         rv = currProfileDir->Exists(&exists);
+        LogStartupPhase("profile lookup", &phaseStart);
 
         if (NS_SUCCEEDED(rv) && exists) {
-            CopyPrefs(currProfileDir, privateProfilePrefs);
+            // only import prefs.js again if it changed since the last time
+            ProfileStamp stamp;
+            ReadProfileStamp(privateProfileDir, &stamp);
+
+            nsEmbedCString prefsSource;
+            currProfileDir->GetNativePath(prefsSource);
+            PRInt64 prefsModified = LL_ZERO;
+            currProfileDir->GetLastModifiedTime(&prefsModified);
+
+            PRBool copiedExists = PR_FALSE;
+            privateProfilePrefs->Exists(&copiedExists);
+
+            if (!copiedExists 
+                || stamp.version != JDIC_PROFILE_VERSION
+                || LL_NE(stamp.prefsModified, prefsModified)
+                || strcmp(stamp.prefsSource, prefsSource.get()) != 0) {
+                if (NS_SUCCEEDED(CopyPrefs(currProfileDir, 
+                                           privateProfilePrefs))) {
+                    stamp.version = JDIC_PROFILE_VERSION;
+                    stamp.prefsModified = prefsModified;
+                    PL_strncpyz(stamp.prefsSource, prefsSource.get(), 
+                                sizeof(stamp.prefsSource));
+                    WriteProfileStamp(privateProfileDir, &stamp);
+                }
+            }
+            LogStartupPhase("prefs import", &phaseStart);
         }
     }
 
@@ -291,13 +542,15 @@ nsresult InitializeProfile()
 
     // activate our copied prefs.js
     pref->ReadUserPrefs(privateProfilePrefs);
+    ApplyResourceBudget(pref);
+    LogStartupPhase("prefs read", &phaseStart);
 
     return NS_OK;
 }
 
 void ReportError(const char* msg)
 {
-	LogMsg(msg);
+    Log(LOG_ERROR, msg);
     SendSocketMessage(-1, CEVENT_INIT_FAILED, msg);
 }
 
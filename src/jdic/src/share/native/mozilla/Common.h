@@ -28,6 +28,14 @@
 #include "Util.h"
 
 nsresult InitializeProfile();
+
+// set the memory and disk budget applied by InitializeProfile(), given as
+// "<memory cache KB>,<disk cache KB>,<history entries>,<disk cache dir>".
+void SetResourceBudget(const char *budget);
+
+// drop the content of the memory and disk caches and ask the other
+// components to release memory.
+nsresult PurgeCaches();
 void ReportError(const char* msg);
 
 // helper function for using the xpcom directory service
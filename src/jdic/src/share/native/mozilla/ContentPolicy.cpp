@@ -0,0 +1,436 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */ 
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Common.h"
+#include "ContentPolicy.h"
+
+// from the Gecko SDK
+#include "nsXPCOM.h"
+#include "nsMemory.h"
+#include "nsIComponentRegistrar.h"
+#include "nsICategoryManager.h"
+#include "nsIInterfaceRequestor.h"
+#include "nsIInterfaceRequestorUtils.h"
+#include "nsIDOMNode.h"
+#include "nsIDOMDocument.h"
+#include "nsIDOMDocumentView.h"
+#include "nsIDOMAbstractView.h"
+#include "plstr.h"
+
+#define NS_CATEGORYMANAGER_CONTRACTID "@mozilla.org/categorymanager;1"
+
+// a content rule of a browser instance
+struct ContentRule
+{
+    PRBool block;
+    PRUint32 types;
+    char *hostPattern;
+};
+
+// the content rules and blocked request counters of a browser instance
+struct InstanceRules
+{
+    WBArray rules;
+    PRUint32 blockedRequests[RESOURCE_TYPE_COUNT];
+};
+
+static ContentPolicy *gContentPolicy = nsnull;
+
+// Matches the host against "*", "*.<domain>" or an exact host name.
+static PRBool MatchHost(const char *pattern, const char *host)
+{
+    if (strcmp(pattern, "*") == 0)
+        return PR_TRUE;
+
+    if (pattern[0] == '*' && pattern[1] == '.') {
+        const char *domain = pattern + 2;
+        int hostLen = strlen(host);
+        int domainLen = strlen(domain);
+        if (hostLen == domainLen)
+            return PL_strcasecmp(host, domain) == 0;
+        if (hostLen > domainLen && host[hostLen - domainLen - 1] == '.')
+            return PL_strcasecmp(host + hostLen - domainLen, domain) == 0;
+        return PR_FALSE;
+    }
+
+    return PL_strcasecmp(pattern, host) == 0;
+}
+
+// Finds the DOM window of the context node, document or docshell passed to
+// the Mozilla 1.7 content policy.
+static void GetContextWindow(nsISupports *aContext, nsIDOMWindow **aWindow)
+{
+    *aWindow = nsnull;
+    if (!aContext)
+        return;
+
+    nsCOMPtr<nsIDOMWindow> window = do_QueryInterface(aContext);
+    if (!window) {
+        nsCOMPtr<nsIDOMDocument> doc = do_QueryInterface(aContext);
+        if (!doc) {
+            nsCOMPtr<nsIDOMNode> node = do_QueryInterface(aContext);
+            if (node)
+                node->GetOwnerDocument(getter_AddRefs(doc));
+        }
+        nsCOMPtr<nsIDOMDocumentView> docView = do_QueryInterface(doc);
+        if (docView) {
+            nsCOMPtr<nsIDOMAbstractView> view;
+            docView->GetDefaultView(getter_AddRefs(view));
+            window = do_QueryInterface(view);
+        }
+    }
+    if (!window)
+        window = do_GetInterface(aContext);
+
+    *aWindow = window;
+    NS_IF_ADDREF(*aWindow);
+}
+
+//*****************************************************************************
+// ContentPolicy
+//*****************************************************************************   
+
+ContentPolicy::ContentPolicy(PRBool aMozilla17)
+    : mMozilla17(aMozilla17)
+{
+}
+
+ContentPolicy::~ContentPolicy()
+{
+    for (int i = 0; i < mInstances.GetSize(); i++)
+        RemoveInstance(i);
+}
+
+NS_IMPL_ADDREF(ContentPolicy)
+NS_IMPL_RELEASE(ContentPolicy)
+
+NS_IMETHODIMP
+ContentPolicy::QueryInterface(REFNSIID aIID, void **aInstancePtr)
+{
+    NS_ENSURE_ARG_POINTER(aInstancePtr);
+
+    // nsIContentPolicy was changed incompatibly in Mozilla 1.7, only
+    // expose the flavour the running Mozilla expects.
+    nsISupports *found = nsnull;
+    if (mMozilla17 && aIID.Equals(NS_GET_IID(nsIContentPolicy)))
+        found = NS_STATIC_CAST(nsIContentPolicy *, this);
+    else if (!mMozilla17 && aIID.Equals(NS_GET_IID(nsIContentPolicyOld)))
+        found = NS_STATIC_CAST(nsIContentPolicyOld *, this);
+    else if (aIID.Equals(NS_GET_IID(nsISupports)))
+        found = NS_STATIC_CAST(nsISupports *, 
+                               NS_STATIC_CAST(nsIContentPolicy *, this));
+
+    if (!found) {
+        *aInstancePtr = nsnull;
+        return NS_NOINTERFACE;
+    }
+    NS_ADDREF(found);
+    *aInstancePtr = found;
+    return NS_OK;
+}
+
+void
+ContentPolicy::AddRule(int instance, const char *aRule)
+{
+    int block, types, consumed = 0;
+    if (sscanf(aRule, "%d,%d,%n", &block, &types, &consumed) < 2 
+        || consumed == 0 || aRule[consumed] == '\0')
+        return;
+
+    InstanceRules *pRules = nsnull;
+    if (instance < mInstances.GetSize())
+        pRules = (InstanceRules *)mInstances[instance];
+    if (!pRules) {
+        pRules = new InstanceRules;
+        memset(pRules->blockedRequests, 0, sizeof(pRules->blockedRequests));
+        mInstances.SetAtGrow(instance, pRules);
+    }
+
+    ContentRule *pRule = new ContentRule;
+    pRule->block = block ? PR_TRUE : PR_FALSE;
+    pRule->types = (PRUint32)types;
+    pRule->hostPattern = strdup(aRule + consumed);
+    pRules->rules.Add(pRule);
+}
+
+void
+ContentPolicy::ClearRules(int instance)
+{
+    if (instance >= mInstances.GetSize())
+        return;
+    InstanceRules *pRules = (InstanceRules *)mInstances[instance];
+    if (!pRules)
+        return;
+
+    for (int i = 0; i < pRules->rules.GetSize(); i++) {
+        ContentRule *pRule = (ContentRule *)pRules->rules[i];
+        free(pRule->hostPattern);
+        delete pRule;
+    }
+    pRules->rules.RemoveAll();
+}
+
+void
+ContentPolicy::RemoveInstance(int instance)
+{
+    ClearRules(instance);
+    if (instance >= mInstances.GetSize())
+        return;
+    delete (InstanceRules *)mInstances[instance];
+    mInstances.SetAt(instance, nsnull);
+}
+
+void
+ContentPolicy::GetBlockedCounts(int instance, char *aBuf)
+{
+    InstanceRules *pRules = nsnull;
+    if (instance < mInstances.GetSize())
+        pRules = (InstanceRules *)mInstances[instance];
+
+    aBuf[0] = '\0';
+    for (int i = 0; i < RESOURCE_TYPE_COUNT; i++) {
+        sprintf(aBuf + strlen(aBuf), i ? ",%u" : "%u", 
+                pRules ? pRules->blockedRequests[i] : 0);
+    }
+}
+
+// Returns PR_FALSE if the load should be blocked.
+PRBool
+ContentPolicy::CheckLoad(PRUint32 aResourceType, nsIURI *aLocation, 
+                         nsIDOMWindow *aWindow)
+{
+    if (!aLocation || !aWindow)
+        return PR_TRUE;
+
+    nsCOMPtr<nsIDOMWindow> topWindow;
+    aWindow->GetTop(getter_AddRefs(topWindow));
+    int instance = GetBrowserInstance(topWindow);
+    if (instance < 0 || instance >= mInstances.GetSize())
+        return PR_TRUE;
+    InstanceRules *pRules = (InstanceRules *)mInstances[instance];
+    if (!pRules || pRules->rules.GetSize() == 0)
+        return PR_TRUE;
+
+    // never block chrome, resource, data or other internal loads
+    PRBool isHttp = PR_FALSE, isHttps = PR_FALSE, isFtp = PR_FALSE;
+    aLocation->SchemeIs("http", &isHttp);
+    aLocation->SchemeIs("https", &isHttps);
+    aLocation->SchemeIs("ftp", &isFtp);
+    if (!isHttp && !isHttps && !isFtp)
+        return PR_TRUE;
+
+    nsEmbedCString host;
+    aLocation->GetHost(host);
+
+    PRBool block = PR_FALSE;
+    for (int i = 0; i < pRules->rules.GetSize(); i++) {
+        ContentRule *pRule = (ContentRule *)pRules->rules[i];
+        if ((pRule->types & aResourceType) 
+            && MatchHost(pRule->hostPattern, host.get()))
+            block = pRule->block;
+    }
+
+    if (block) {
+        for (int bit = 0; bit < RESOURCE_TYPE_COUNT; bit++) {
+            if (aResourceType == (PRUint32)(1 << bit))
+                pRules->blockedRequests[bit]++;
+        }
+    }
+    return !block;
+}
+
+NS_IMETHODIMP
+ContentPolicy::ShouldLoad(PRUint32 aContentType, nsIURI *aContentLocation, 
+                          nsIURI *aRequestOrigin, nsISupports *aContext, 
+                          const nsACString & aMimeTypeGuess, 
+                          nsISupports *aExtra, PRInt16 *_retval)
+{
+    PRUint32 resourceType;
+    switch (aContentType) {
+    case nsIContentPolicy::TYPE_SCRIPT:
+        resourceType = RESOURCE_SCRIPT;
+        break;
+    case nsIContentPolicy::TYPE_IMAGE:
+        resourceType = RESOURCE_IMAGE;
+        break;
+    case nsIContentPolicy::TYPE_STYLESHEET:
+        resourceType = RESOURCE_STYLESHEET;
+        break;
+    case nsIContentPolicy::TYPE_OBJECT:
+        resourceType = RESOURCE_OBJECT;
+        break;
+    case nsIContentPolicy::TYPE_SUBDOCUMENT:
+        resourceType = RESOURCE_SUBDOCUMENT;
+        break;
+    case nsIContentPolicy::TYPE_DOCUMENT:
+    case nsIContentPolicy::TYPE_REFRESH:
+        resourceType = RESOURCE_DOCUMENT;
+        break;
+    default:
+        resourceType = RESOURCE_OTHER;
+        break;
+    }
+
+    nsCOMPtr<nsIDOMWindow> window;
+    GetContextWindow(aContext, getter_AddRefs(window));
+    *_retval = CheckLoad(resourceType, aContentLocation, window) ?
+        nsIContentPolicy::ACCEPT : nsIContentPolicy::REJECT_REQUEST;
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+ContentPolicy::ShouldProcess(PRUint32 aContentType, nsIURI *aContentLocation, 
+                             nsIURI *aRequestOrigin, nsISupports *aContext, 
+                             const nsACString & aMimeType, 
+                             nsISupports *aExtra, PRInt16 *_retval)
+{
+    *_retval = nsIContentPolicy::ACCEPT;
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+ContentPolicy::ShouldLoad(PRInt32 contentType, nsIURI *contentLocation, 
+                          nsISupports *ctxt, nsIDOMWindow *window, 
+                          PRBool *_retval)
+{
+    PRUint32 resourceType;
+    switch (contentType) {
+    case nsIContentPolicyOld::SCRIPT:
+        resourceType = RESOURCE_SCRIPT;
+        break;
+    case nsIContentPolicyOld::IMAGE:
+        resourceType = RESOURCE_IMAGE;
+        break;
+    case nsIContentPolicyOld::STYLESHEET:
+        resourceType = RESOURCE_STYLESHEET;
+        break;
+    case nsIContentPolicyOld::OBJECT:
+        resourceType = RESOURCE_OBJECT;
+        break;
+    case nsIContentPolicyOld::SUBDOCUMENT:
+        resourceType = RESOURCE_SUBDOCUMENT;
+        break;
+    case nsIContentPolicyOld::DOCUMENT:
+        resourceType = RESOURCE_DOCUMENT;
+        break;
+    default:
+        resourceType = RESOURCE_OTHER;
+        break;
+    }
+
+    *_retval = CheckLoad(resourceType, contentLocation, window);
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+ContentPolicy::ShouldProcess(PRInt32 contentType, nsIURI *documentLocation, 
+                             nsISupports *ctxt, nsIDOMWindow *window, 
+                             PRBool *_retval)
+{
+    *_retval = PR_TRUE;
+    return NS_OK;
+}
+
+//*****************************************************************************
+// ContentPolicyFactory - hands out the one content policy instance.
+//*****************************************************************************   
+
+class ContentPolicyFactory : public nsIFactory
+{
+public:
+    NS_DECL_ISUPPORTS
+    NS_DECL_NSIFACTORY
+
+    ContentPolicyFactory() {}
+    virtual ~ContentPolicyFactory() {}
+};
+
+NS_IMPL_ISUPPORTS1(ContentPolicyFactory, nsIFactory)
+
+NS_IMETHODIMP
+ContentPolicyFactory::CreateInstance(nsISupports *aOuter, const nsIID & iid, 
+                                     void **result)
+{
+    if (aOuter)
+        return NS_ERROR_NO_AGGREGATION;
+    if (!gContentPolicy)
+        return NS_ERROR_NOT_INITIALIZED;
+    return gContentPolicy->QueryInterface(iid, result);
+}
+
+NS_IMETHODIMP
+ContentPolicyFactory::LockFactory(PRBool lock)
+{
+    return NS_OK;
+}
+
+nsresult RegisterContentPolicy(PRBool aMozilla17)
+{
+    nsresult rv;
+
+    if (gContentPolicy)
+        return NS_OK;
+
+    nsCOMPtr<nsIComponentRegistrar> registrar;
+    rv = NS_GetComponentRegistrar(getter_AddRefs(registrar));
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    gContentPolicy = new ContentPolicy(aMozilla17);
+    if (!gContentPolicy)
+        return NS_ERROR_OUT_OF_MEMORY;
+    // held until the process exits
+    NS_ADDREF(gContentPolicy);
+
+    nsCOMPtr<nsIFactory> factory = new ContentPolicyFactory();
+    if (!factory)
+        return NS_ERROR_OUT_OF_MEMORY;
+
+    static NS_DEFINE_CID(kContentPolicyCID, JDIC_CONTENTPOLICY_CID);
+    rv = registrar->RegisterFactory(kContentPolicyCID, 
+                                    "JDIC Content Policy",
+                                    JDIC_CONTENTPOLICY_CONTRACTID, 
+                                    factory);
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    nsCOMPtr<nsICategoryManager> catMan;
+    rv = GetService(NS_CATEGORYMANAGER_CONTRACTID,
+                    NS_GET_IID(nsICategoryManager),
+                    getter_AddRefs(catMan));
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    char *previous = nsnull;
+    rv = catMan->AddCategoryEntry("content-policy",
+                                  JDIC_CONTENTPOLICY_CONTRACTID,
+                                  JDIC_CONTENTPOLICY_CONTRACTID,
+                                  PR_FALSE, PR_TRUE, &previous);
+    if (previous)
+        nsMemory::Free(previous);
+    return rv;
+}
+
+ContentPolicy* GetContentPolicy()
+{
+    return gContentPolicy;
+}
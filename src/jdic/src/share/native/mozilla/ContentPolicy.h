@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */ 
+
+
+#ifndef _ContentPolicy_H_
+#define _ContentPolicy_H_
+
+#include "nsCOMPtr.h"
+#include "nsIFactory.h"
+#include "nsIURI.h"
+#include "nsIDOMWindow.h"
+#include "nsEmbedString.h"
+
+// copied from the mozilla 1.7 source tree to support 1.7+.
+#include "nsIContentPolicy.h"
+
+// copied from the mozilla 1.4 source tree to support 1.4 through 1.6.
+#include "nsIContentPolicyOld.h"
+
+#include "Util.h"
+
+// resource type bits used by the content rules, must keep same with 
+// WebBrowser.java. Gecko 1.x has no separate types for fonts and media,
+// they are loaded as RESOURCE_OTHER or, for plugins, RESOURCE_OBJECT.
+#define RESOURCE_OTHER          0x01
+#define RESOURCE_SCRIPT         0x02
+#define RESOURCE_IMAGE          0x04
+#define RESOURCE_STYLESHEET     0x08
+#define RESOURCE_OBJECT         0x10
+#define RESOURCE_SUBDOCUMENT    0x20
+#define RESOURCE_DOCUMENT       0x40
+#define RESOURCE_TYPE_COUNT     7
+
+#define JDIC_CONTENTPOLICY_CONTRACTID "@jdesktop.org/jdic/content-policy;1"
+#define JDIC_CONTENTPOLICY_CID \
+    {0x8b2f6c31, 0x4d0e, 0x4b7a, {0x9e, 0x52, 0x1f, 0x6a, 0x03, 0xc8, 0x7d, 0x94}}
+
+// --------------------------------------------------------------------------
+// ContentPolicy - blocks or allows the loads of a browser instance according
+// to the content rules sent from the Java side. Rules are checked in the 
+// order they were added, the last matching rule wins, and loads are allowed
+// when no rule matches. Only http, https and ftp loads are checked.
+//
+// Both the Mozilla 1.7 and the Mozilla 1.4 through 1.6 flavours of
+// nsIContentPolicy are implemented, QueryInterface hands out the one which
+// matches the running Mozilla.
+// --------------------------------------------------------------------------
+
+class ContentPolicy : public nsIContentPolicy,
+                      public nsIContentPolicyOld
+{
+public:
+    NS_DECL_ISUPPORTS
+    NS_DECL_NSICONTENTPOLICY
+    NS_DECL_NSICONTENTPOLICYOLD
+
+    ContentPolicy(PRBool aMozilla17);
+    virtual ~ContentPolicy();
+
+    // Adds a rule in the format of "<block>,<resource types>,<host pattern>",
+    // where <block> is 1 to block and 0 to allow, <resource types> is a 
+    // combination of the RESOURCE_* bits and <host pattern> is "*", a host
+    // name, or "*.<domain>" matching the domain and all its subdomains.
+    void AddRule(int instance, const char *aRule);
+    void ClearRules(int instance);
+
+    // Releases the rules and counters of a destroyed browser instance.
+    void RemoveInstance(int instance);
+
+    // Prints the blocked request counters of the instance as a comma 
+    // separated list, one per resource type bit, lowest bit first.
+    void GetBlockedCounts(int instance, char *aBuf);
+
+protected:
+    PRBool CheckLoad(PRUint32 aResourceType, nsIURI *aLocation, 
+                     nsIDOMWindow *aWindow);
+
+    PRBool mMozilla17;
+    WBArray mInstances;
+};
+
+// Registers the content policy component and adds it to the 
+// "content-policy" category. Called from InitializeProfile().
+nsresult RegisterContentPolicy(PRBool aMozilla17);
+
+// Returns the registered content policy, or NULL if it's not registered.
+ContentPolicy* GetContentPolicy();
+
+// Implemented by each embedding host: returns the number of the browser
+// instance whose content window is the given top level window, or -1.
+int GetBrowserInstance(nsIDOMWindow *aTopWindow);
+
+#endif // _ContentPolicy_H_
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */ 
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Common.h"
+#include "PostDataStream.h"
+#include "MsgServer.h"
+#include "Message.h"
+
+// from the Gecko SDK
+#include "nsMemory.h"
+#include "nsCOMPtr.h"
+
+// copied from the mozilla source tree on Unix.
+#include "nsIStringStream.h"
+
+//*****************************************************************************
+// PostDataStream
+//*****************************************************************************   
+
+PostDataStream::PostDataStream(Payload *aPayload)
+    : mPayload(aPayload),
+      mOffset(0)
+{
+    sprintf(mHeader, "Content-Length: %d\r\n\r\n", 
+            mPayload->mLength[POST_FIELD_DATA]);
+    mHeaderLength = strlen(mHeader);
+    mLength = mHeaderLength + mPayload->mLength[POST_FIELD_DATA];
+}
+
+PostDataStream::~PostDataStream()
+{
+    FreePayload(mPayload);
+}
+
+NS_IMPL_ISUPPORTS2(PostDataStream, nsIInputStream, nsISeekableStream)
+
+const char*
+PostDataStream::GetSegment(PRUint32 *aLength)
+{
+    if (mOffset < mHeaderLength) {
+        *aLength = mHeaderLength - mOffset;
+        return mHeader + mOffset;
+    }
+    *aLength = mLength - mOffset;
+    return mPayload->mField[POST_FIELD_DATA] + (mOffset - mHeaderLength);
+}
+
+NS_IMETHODIMP
+PostDataStream::Close()
+{
+    // keep the data, Gecko may seek back to the start to post it again.
+    mOffset = mLength;
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+PostDataStream::Available(PRUint32 *_retval)
+{
+    NS_ENSURE_ARG_POINTER(_retval);
+    *_retval = mLength - mOffset;
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+PostDataStream::Read(char *aBuf, PRUint32 aCount, PRUint32 *_retval)
+{
+    NS_ENSURE_ARG_POINTER(_retval);
+    *_retval = 0;
+    while (aCount > 0 && mOffset < mLength) {
+        PRUint32 length;
+        const char *segment = GetSegment(&length);
+        if (length > aCount)
+            length = aCount;
+        memcpy(aBuf + *_retval, segment, length);
+        mOffset += length;
+        aCount -= length;
+        *_retval += length;
+    }
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+PostDataStream::ReadSegments(nsWriteSegmentFun aWriter, void *aClosure, 
+                             PRUint32 aCount, PRUint32 *_retval)
+{
+    NS_ENSURE_ARG_POINTER(_retval);
+    *_retval = 0;
+    while (aCount > 0 && mOffset < mLength) {
+        PRUint32 length, written = 0;
+        const char *segment = GetSegment(&length);
+        if (length > aCount)
+            length = aCount;
+        // errors of the writer are not passed on, see nsIInputStream.
+        nsresult rv = aWriter(this, aClosure, segment, *_retval, length, 
+                              &written);
+        if (NS_FAILED(rv) || written == 0)
+            break;
+        mOffset += written;
+        aCount -= written;
+        *_retval += written;
+    }
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+PostDataStream::IsNonBlocking(PRBool *_retval)
+{
+    NS_ENSURE_ARG_POINTER(_retval);
+    *_retval = PR_TRUE;
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+PostDataStream::Seek(PRInt32 whence, PRInt32 offset)
+{
+    PRInt32 base;
+    switch (whence) {
+    case NS_SEEK_SET:
+        base = 0;
+        break;
+    case NS_SEEK_CUR:
+        base = mOffset;
+        break;
+    case NS_SEEK_END:
+        base = mLength;
+        break;
+    default:
+        return NS_ERROR_INVALID_ARG;
+    }
+
+    if (offset < -base || offset > (PRInt32)mLength - base)
+        return NS_ERROR_INVALID_ARG;
+
+    mOffset = base + offset;
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+PostDataStream::Tell(PRUint32 *_retval)
+{
+    NS_ENSURE_ARG_POINTER(_retval);
+    *_retval = mOffset;
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+PostDataStream::SetEOF()
+{
+    mLength = mOffset;
+    return NS_OK;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+// helper function for creating the extra headers stream of a POST, the 
+// given headers prefixed by POST_HEADER.
+static nsresult
+NewHeadersStream(const char *aHeaders, int aLength, nsIInputStream **aResult)
+{
+    nsCOMPtr<nsIStringInputStream> stream;
+    nsresult rv = CreateInstance("@mozilla.org/io/string-input-stream;1",
+                                 NS_GET_IID(nsIStringInputStream),
+                                 getter_AddRefs(stream));
+    if (NS_FAILED(rv) || !stream) 
+        return NS_ERROR_FAILURE;
+
+    // Usually, an HTTP POST includes the POST_HEADER content type header.
+    // Without this header, some Web servers (particularly ASP running on
+    // IIS) will not recognize the post data parameter.
+    int prefixLength = strlen(POST_HEADER);
+    // the string stream owns this memory.
+    char *headers = (char *) nsMemory::Alloc(prefixLength + aLength + 1);
+    if (!headers)
+        return NS_ERROR_OUT_OF_MEMORY;
+    memcpy(headers, POST_HEADER, prefixLength);
+    memcpy(headers + prefixLength, aHeaders, aLength + 1);
+
+    stream->AdoptData(headers, prefixLength + aLength);
+    return CallQueryInterface(stream, aResult);
+}
+
+nsresult 
+LoadPostPayload(nsIWebNavigation *aWebNav, Payload *aPayload)
+{
+    if (!aWebNav || aPayload->mFieldCount <= POST_FIELD_HEADERS) {
+        FreePayload(aPayload);
+        return NS_ERROR_INVALID_ARG;
+    }
+
+    nsEmbedString unicodeUrl;
+    ConvertAsciiToUtf16(aPayload->mField[POST_FIELD_URL], unicodeUrl);
+
+    nsCOMPtr<nsIInputStream> headersStream;
+    nsresult rv = NewHeadersStream(aPayload->mField[POST_FIELD_HEADERS], 
+                                   aPayload->mLength[POST_FIELD_HEADERS],
+                                   getter_AddRefs(headersStream));
+    if (NS_FAILED(rv)) {
+        FreePayload(aPayload);
+        return rv;
+    }
+
+    nsCOMPtr<nsIInputStream> postDataStream;
+    if (aPayload->mLength[POST_FIELD_DATA] > 0) {
+        // the stream owns the payload from now on.
+        postDataStream = new PostDataStream(aPayload);
+        if (!postDataStream) {
+            FreePayload(aPayload);
+            return NS_ERROR_OUT_OF_MEMORY;
+        }
+    } else {
+        FreePayload(aPayload);
+    }
+
+    return aWebNav->LoadURI(unicodeUrl.get(),                  // URI string
+                            nsIWebNavigation::LOAD_FLAGS_NONE, // Load flags
+                            nsnull,                            // Refering URI
+                            postDataStream,                    // Post data
+                            headersStream);                    // Extra headers
+}
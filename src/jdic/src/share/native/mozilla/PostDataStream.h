@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */ 
+
+
+#ifndef _PostDataStream_H_
+#define _PostDataStream_H_
+
+#include "nsIInputStream.h"
+#include "nsIWebNavigation.h"
+
+// copied from the mozilla 1.7 source tree, it's not part of the Gecko SDK.
+#include "nsISeekableStream.h"
+
+struct Payload;
+
+// --------------------------------------------------------------------------
+// PostDataStream - streams the POST data of a JEVENT_NAVIGATE_POST payload
+// to Gecko, right from the buffer it was received into. The data is 
+// preceded by the Content-Length header Gecko expects at the start of a
+// post data stream. The stream owns the payload and frees it when it's
+// released.
+//
+// The stream is seekable, so Gecko can rewind it to post the data again,
+// e.g. when the page is reloaded.
+// --------------------------------------------------------------------------
+
+class PostDataStream : public nsIInputStream,
+                       public nsISeekableStream
+{
+public:
+    NS_DECL_ISUPPORTS
+    NS_DECL_NSIINPUTSTREAM
+    NS_DECL_NSISEEKABLESTREAM
+
+    PostDataStream(Payload *aPayload);
+    virtual ~PostDataStream();
+
+protected:
+    // Returns the bytes from the current offset to the end of the header
+    // or the data, whichever the offset is in.
+    const char* GetSegment(PRUint32 *aLength);
+
+    Payload *mPayload;
+    char mHeader[64];
+    PRUint32 mHeaderLength;
+    PRUint32 mLength;
+    PRUint32 mOffset;
+};
+
+// Loads the URL of a JEVENT_NAVIGATE_POST payload with its POST data and 
+// extra headers. Takes the ownership of the payload.
+nsresult LoadPostPayload(nsIWebNavigation *aWebNav, Payload *aPayload);
+
+#endif // _PostDataStream_H_
@@ -0,0 +1,87 @@
+/*
+ * DO NOT EDIT.  THIS FILE IS GENERATED FROM nsIContentPolicy.idl
+ */
+
+#ifndef __gen_nsIContentPolicy_h__
+#define __gen_nsIContentPolicy_h__
+
+
+#ifndef __gen_nsISupports_h__
+#include "nsISupports.h"
+#endif
+
+/* For IDL files that don't want to include root IDL files. */
+#ifndef NS_NO_VTABLE
+#define NS_NO_VTABLE
+#endif
+class nsIURI; /* forward declaration */
+
+
+/* starting interface:    nsIContentPolicy */
+#define NS_ICONTENTPOLICY_IID_STR "64a5ae16-6836-475c-9938-4b6cc1eee8fb"
+
+#define NS_ICONTENTPOLICY_IID \
+  {0x64a5ae16, 0x6836, 0x475c, \
+    { 0x99, 0x38, 0x4b, 0x6c, 0xc1, 0xee, 0xe8, 0xfb }}
+
+/**
+ * Interface for content policy mechanism.  Implementations of this
+ * interface can be used to control loading of various types of out-of-line
+ * content, or processing of certain types of inline content.
+ */
+class NS_NO_VTABLE nsIContentPolicy : public nsISupports {
+ public: 
+
+  NS_DEFINE_STATIC_IID_ACCESSOR(NS_ICONTENTPOLICY_IID)
+
+  enum { TYPE_OTHER = 1U };
+
+  enum { TYPE_SCRIPT = 2U };
+
+  enum { TYPE_IMAGE = 3U };
+
+  enum { TYPE_STYLESHEET = 4U };
+
+  enum { TYPE_OBJECT = 5U };
+
+  enum { TYPE_DOCUMENT = 6U };
+
+  enum { TYPE_SUBDOCUMENT = 7U };
+
+  enum { TYPE_REFRESH = 8U };
+
+  enum { REJECT_REQUEST = -1 };
+
+  enum { REJECT_TYPE = -2 };
+
+  enum { REJECT_SERVER = -3 };
+
+  enum { REJECT_OTHER = -4 };
+
+  enum { ACCEPT = 1 };
+
+  /**
+   * Should the resource at this location be loaded?
+   * ShouldLoad will be called before loading the resource at aContentLocation
+   * to determine whether to start the load at all.
+   */
+  /* short shouldLoad (in unsigned long aContentType, in nsIURI aContentLocation, in nsIURI aRequestOrigin, in nsISupports aContext, in ACString aMimeTypeGuess, in nsISupports aExtra); */
+  NS_IMETHOD ShouldLoad(PRUint32 aContentType, nsIURI *aContentLocation, nsIURI *aRequestOrigin, nsISupports *aContext, const nsACString & aMimeTypeGuess, nsISupports *aExtra, PRInt16 *_retval) = 0;
+
+  /**
+   * Should the resource be processed?
+   * ShouldProcess will be called once all the information passed to it has
+   * been determined about the resource, typically after part of the resource
+   * has been loaded.
+   */
+  /* short shouldProcess (in unsigned long aContentType, in nsIURI aContentLocation, in nsIURI aRequestOrigin, in nsISupports aContext, in ACString aMimeType, in nsISupports aExtra); */
+  NS_IMETHOD ShouldProcess(PRUint32 aContentType, nsIURI *aContentLocation, nsIURI *aRequestOrigin, nsISupports *aContext, const nsACString & aMimeType, nsISupports *aExtra, PRInt16 *_retval) = 0;
+
+};
+
+/* Use this macro when declaring classes that implement this interface. */
+#define NS_DECL_NSICONTENTPOLICY \
+  NS_IMETHOD ShouldLoad(PRUint32 aContentType, nsIURI *aContentLocation, nsIURI *aRequestOrigin, nsISupports *aContext, const nsACString & aMimeTypeGuess, nsISupports *aExtra, PRInt16 *_retval); \
+  NS_IMETHOD ShouldProcess(PRUint32 aContentType, nsIURI *aContentLocation, nsIURI *aRequestOrigin, nsISupports *aContext, const nsACString & aMimeType, nsISupports *aExtra, PRInt16 *_retval); 
+
+#endif /* __gen_nsIContentPolicy_h__ */
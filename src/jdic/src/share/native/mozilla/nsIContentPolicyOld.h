@@ -0,0 +1,71 @@
+/*
+ * DO NOT EDIT.  THIS FILE IS GENERATED FROM nsIContentPolicy.idl
+ */
+
+#ifndef __gen_nsIContentPolicyOld_h__
+#define __gen_nsIContentPolicyOld_h__
+
+
+#ifndef __gen_nsISupports_h__
+#include "nsISupports.h"
+#endif
+
+/* For IDL files that don't want to include root IDL files. */
+#ifndef NS_NO_VTABLE
+#define NS_NO_VTABLE
+#endif
+class nsIURI; /* forward declaration */
+
+class nsIDOMWindow; /* forward declaration */
+
+
+/* starting interface:    nsIContentPolicyOld */
+#define NS_ICONTENTPOLICYOLD_IID_STR "1cb4085d-5407-4169-bcfc-7c0c6aeee1ff"
+
+#define NS_ICONTENTPOLICYOLD_IID \
+  {0x1cb4085d, 0x5407, 0x4169, \
+    { 0xbc, 0xfc, 0x7c, 0x0c, 0x6a, 0xee, 0xe1, 0xff }}
+
+class NS_NO_VTABLE nsIContentPolicyOld : public nsISupports {
+ public: 
+
+  NS_DEFINE_STATIC_IID_ACCESSOR(NS_ICONTENTPOLICYOLD_IID)
+
+  enum { OTHER = 0 };
+
+  enum { SCRIPT = 1 };
+
+  enum { IMAGE = 2 };
+
+  enum { STYLESHEET = 3 };
+
+  enum { OBJECT = 4 };
+
+  enum { SUBDOCUMENT = 5 };
+
+  enum { CONTROL_TAG = 6 };
+
+  enum { RAW_URL = 7 };
+
+  enum { DOCUMENT = 8 };
+
+  /**
+   * Should the content at this location be loaded and processed?
+   */
+  /* boolean shouldLoad (in PRInt32 contentType, in nsIURI contentLocation, in nsISupports ctxt, in nsIDOMWindow window); */
+  NS_IMETHOD ShouldLoad(PRInt32 contentType, nsIURI *contentLocation, nsISupports *ctxt, nsIDOMWindow *window, PRBool *_retval) = 0;
+
+  /**
+   * Should the contents of the element in question be processed?
+   */
+  /* boolean shouldProcess (in PRInt32 contentType, in nsIURI documentLocation, in nsISupports ctxt, in nsIDOMWindow window); */
+  NS_IMETHOD ShouldProcess(PRInt32 contentType, nsIURI *documentLocation, nsISupports *ctxt, nsIDOMWindow *window, PRBool *_retval) = 0;
+
+};
+
+/* Use this macro when declaring classes that implement this interface. */
+#define NS_DECL_NSICONTENTPOLICYOLD \
+  NS_IMETHOD ShouldLoad(PRInt32 contentType, nsIURI *contentLocation, nsISupports *ctxt, nsIDOMWindow *window, PRBool *_retval); \
+  NS_IMETHOD ShouldProcess(PRInt32 contentType, nsIURI *documentLocation, nsISupports *ctxt, nsIDOMWindow *window, PRBool *_retval); 
+
+#endif /* __gen_nsIContentPolicyOld_h__ */
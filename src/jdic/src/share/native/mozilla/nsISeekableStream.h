@@ -0,0 +1,65 @@
+/*
+ * DO NOT EDIT.  THIS FILE IS GENERATED FROM nsISeekableStream.idl
+ */
+
+#ifndef __gen_nsISeekableStream_h__
+#define __gen_nsISeekableStream_h__
+
+
+#ifndef __gen_nsISupports_h__
+#include "nsISupports.h"
+#endif
+
+/* For IDL files that don't want to include root IDL files. */
+#ifndef NS_NO_VTABLE
+#define NS_NO_VTABLE
+#endif
+
+/* starting interface:    nsISeekableStream */
+#define NS_ISEEKABLESTREAM_IID_STR "8429d350-1040-4661-8b71-f2a6ba455980"
+
+#define NS_ISEEKABLESTREAM_IID \
+  {0x8429d350, 0x1040, 0x4661, \
+    { 0x8b, 0x71, 0xf2, 0xa6, 0xba, 0x45, 0x59, 0x80 }}
+
+class NS_NO_VTABLE nsISeekableStream : public nsISupports {
+ public: 
+
+  NS_DEFINE_STATIC_IID_ACCESSOR(NS_ISEEKABLESTREAM_IID)
+
+  enum { NS_SEEK_SET = 0 };
+
+  enum { NS_SEEK_CUR = 1 };
+
+  enum { NS_SEEK_END = 2 };
+
+  /* void seek (in long whence, in long offset); */
+  NS_IMETHOD Seek(PRInt32 whence, PRInt32 offset) = 0;
+
+  /* unsigned long tell (); */
+  NS_IMETHOD Tell(PRUint32 *_retval) = 0;
+
+  /* void setEOF (); */
+  NS_IMETHOD SetEOF(void) = 0;
+
+};
+
+/* Use this macro when declaring classes that implement this interface. */
+#define NS_DECL_NSISEEKABLESTREAM \
+  NS_IMETHOD Seek(PRInt32 whence, PRInt32 offset); \
+  NS_IMETHOD Tell(PRUint32 *_retval); \
+  NS_IMETHOD SetEOF(void); 
+
+/* Use this macro to declare functions that forward the behavior of this interface to another object. */
+#define NS_FORWARD_NSISEEKABLESTREAM(_to) \
+  NS_IMETHOD Seek(PRInt32 whence, PRInt32 offset) { return _to Seek(whence, offset); } \
+  NS_IMETHOD Tell(PRUint32 *_retval) { return _to Tell(_retval); } \
+  NS_IMETHOD SetEOF(void) { return _to SetEOF(); } 
+
+/* Use this macro to declare functions that forward the behavior of this interface to another object in a safe way. */
+#define NS_FORWARD_SAFE_NSISEEKABLESTREAM(_to) \
+  NS_IMETHOD Seek(PRInt32 whence, PRInt32 offset) { return !_to ? NS_ERROR_NULL_POINTER : _to->Seek(whence, offset); } \
+  NS_IMETHOD Tell(PRUint32 *_retval) { return !_to ? NS_ERROR_NULL_POINTER : _to->Tell(_retval); } \
+  NS_IMETHOD SetEOF(void) { return !_to ? NS_ERROR_NULL_POINTER : _to->SetEOF(); } 
+
+#endif /* __gen_nsISeekableStream_h__ */
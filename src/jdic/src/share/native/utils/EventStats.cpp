@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */ 
+
+#include <stdio.h>
+#include <string.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <pthread.h>
+#endif
+#include "EventStats.h"
+
+// JEVENT_* IDs start at 0, CEVENT_* IDs at 3001.
+#define MAX_JEVENT 64
+#define CEVENT_BASE 3000
+#define MAX_CEVENT 128
+
+struct EventHistogram
+{
+    unsigned long count;
+    double totalMicros;
+    unsigned long maxMicros;
+    unsigned long buckets[STATS_BUCKET_COUNT];
+};
+
+// dispatch times are keyed by JEVENT_*, send delays by CEVENT_*.
+static EventHistogram gDispatchStats[MAX_JEVENT];
+static EventHistogram gSendDelayStats[MAX_CEVENT];
+
+// the counters are updated from both the socket thread and the UI thread.
+class StatsLock
+{
+public:
+#ifdef WIN32
+    StatsLock() { InitializeCriticalSection(&mLock); }
+    ~StatsLock() { DeleteCriticalSection(&mLock); }
+    void Lock() { EnterCriticalSection(&mLock); }
+    void Unlock() { LeaveCriticalSection(&mLock); }
+private:
+    CRITICAL_SECTION mLock;
+#else
+    StatsLock() { pthread_mutex_init(&mLock, NULL); }
+    ~StatsLock() { pthread_mutex_destroy(&mLock); }
+    void Lock() { pthread_mutex_lock(&mLock); }
+    void Unlock() { pthread_mutex_unlock(&mLock); }
+private:
+    pthread_mutex_t mLock;
+#endif
+};
+
+static StatsLock gStatsLock;
+
+unsigned long GetTimeMicros()
+{
+#ifdef WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0 && !QueryPerformanceFrequency(&frequency))
+        return GetTickCount() * 1000;
+    QueryPerformanceCounter(&counter);
+    // split into seconds first, so that the product can't overflow
+    return (unsigned long)((counter.QuadPart / frequency.QuadPart) * 1000000
+        + (counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart);
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (unsigned long)tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+}
+
+int GetMessageEvent(const char* msg)
+{
+    int event;
+    if (msg == NULL || sscanf(msg, "%*d,%d", &event) != 1)
+        return -1;
+    return event;
+}
+
+void RecordEventTime(int phase, int event, unsigned long micros)
+{
+    EventHistogram *histogram;
+    if (phase == STATS_DISPATCH && event >= 0 && event < MAX_JEVENT) {
+        histogram = &gDispatchStats[event];
+    } else if (phase == STATS_SEND_DELAY && event > CEVENT_BASE 
+               && event < CEVENT_BASE + MAX_CEVENT) {
+        histogram = &gSendDelayStats[event - CEVENT_BASE];
+    } else {
+        return;
+    }
+
+    int bucket = 0;
+    unsigned long bound = STATS_BUCKET_BASE;
+    while (bucket < STATS_BUCKET_COUNT - 1 && micros >= bound) {
+        bucket++;
+        bound <<= 1;
+    }
+
+    gStatsLock.Lock();
+    histogram->count++;
+    histogram->totalMicros += micros;
+    if (micros > histogram->maxMicros)
+        histogram->maxMicros = micros;
+    histogram->buckets[bucket]++;
+    gStatsLock.Unlock();
+}
+
+// append the entry of one histogram, return the number of characters
+// written.
+static int FormatHistogram(char* buf, int phase, int event, 
+                           const EventHistogram *histogram)
+{
+    int len = sprintf(buf, "%d,%d,%lu,%.0f,%lu", phase, event, 
+                      histogram->count, histogram->totalMicros, 
+                      histogram->maxMicros);
+    for (int i = 0; i < STATS_BUCKET_COUNT; i++)
+        len += sprintf(buf + len, ",%lu", histogram->buckets[i]);
+    buf[len++] = ';';
+    buf[len] = '\0';
+    return len;
+}
+
+char* GetEventStats()
+{
+    // 5 numbers of at most 20 digits plus the buckets of at most 10 digits
+    // each, per entry.
+    const int entrySize = 5 * 21 + STATS_BUCKET_COUNT * 11 + 2;
+    char *result = new char[(MAX_JEVENT + MAX_CEVENT) * entrySize + 1];
+    int len = 0;
+    result[0] = '\0';
+
+    gStatsLock.Lock();
+    int i;
+    for (i = 0; i < MAX_JEVENT; i++) {
+        if (gDispatchStats[i].count > 0)
+            len += FormatHistogram(result + len, STATS_DISPATCH, i, 
+                                   &gDispatchStats[i]);
+    }
+    for (i = 0; i < MAX_CEVENT; i++) {
+        if (gSendDelayStats[i].count > 0)
+            len += FormatHistogram(result + len, STATS_SEND_DELAY, 
+                                   CEVENT_BASE + i, &gSendDelayStats[i]);
+    }
+    gStatsLock.Unlock();
+
+    return result;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */ 
+
+#ifndef _EventStats_H_
+#define _EventStats_H_
+
+// Always-on latency counters of the native browser, keyed by event ID. The
+// Java side asks for them with JEVENT_GETSTATS and merges them with its own
+// counters (see EventStats.java).
+//
+// Each histogram has STATS_BUCKET_COUNT buckets. Bucket 0 counts the times
+// below STATS_BUCKET_BASE microseconds, bucket i the times between
+// STATS_BUCKET_BASE * 2^(i-1) and STATS_BUCKET_BASE * 2^i, and the last
+// bucket everything above. Must keep same with EventStats.java.
+#define STATS_BUCKET_COUNT  16
+#define STATS_BUCKET_BASE   250
+
+// the phases recorded natively, must keep same with EventStats.java.
+// time spent in the host handling a JEVENT_* message.
+#define STATS_DISPATCH      3
+// time a CEVENT_* message waits in the send buffer of the socket server.
+#define STATS_SEND_DELAY    4
+
+// returns a monotonic-enough time stamp in microseconds. Only differences
+// between two time stamps are meaningful.
+unsigned long GetTimeMicros();
+
+// returns the event ID of a socket message string "<instance>,<event>,...",
+// or -1.
+int GetMessageEvent(const char* msg);
+
+void RecordEventTime(int phase, int event, unsigned long micros);
+
+// helper function for composing the CEVENT_GETSTATS message string, one
+// entry per recorded event:
+//   <phase>,<event>,<count>,<total us>,<max us>,<bucket 0>,...,<bucket 15>;
+// The returned string must be freed with delete [].
+char* GetEventStats();
+
+#endif
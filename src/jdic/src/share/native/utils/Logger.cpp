@@ -0,0 +1,434 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */ 
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <pthread.h>
+#endif
+#include "Logger.h"
+
+// The ring buffer is a bounded multi-producer/single-consumer queue: a
+// producer claims a slot by advancing gEnqueuePos with a compare-and-swap
+// and publishes it through the slot sequence, the writer thread is the
+// only consumer.
+#define LOG_RING_SIZE   256     // must be a power of 2
+#define LOG_SLOT_SIZE   1024
+#define LOG_WRITER_SLEEP_MS 20
+
+#if defined(WIN32)
+#define LOG_CAS(ptr, oldval, newval) \
+    (InterlockedCompareExchange((LONG volatile*)(ptr), (newval), (oldval)) \
+     == (oldval))
+#define LOG_STORE(ptr, val) InterlockedExchange((LONG volatile*)(ptr), (val))
+#define LOG_INCREMENT(ptr) InterlockedIncrement((LONG volatile*)(ptr))
+#elif defined(__GNUC__)
+#define LOG_CAS(ptr, oldval, newval) \
+    __sync_bool_compare_and_swap((ptr), (oldval), (newval))
+#define LOG_STORE(ptr, val) \
+    do { __sync_synchronize(); *(ptr) = (val); } while (0)
+#define LOG_INCREMENT(ptr) __sync_add_and_fetch((ptr), 1)
+#else
+// no atomic builtins, fall back to a mutex.
+static pthread_mutex_t gAtomicMutex = PTHREAD_MUTEX_INITIALIZER;
+static int LogCas(volatile long *ptr, long oldval, long newval)
+{
+    pthread_mutex_lock(&gAtomicMutex);
+    int swapped = (*ptr == oldval);
+    if (swapped)
+        *ptr = newval;
+    pthread_mutex_unlock(&gAtomicMutex);
+    return swapped;
+}
+#define LOG_CAS(ptr, oldval, newval) LogCas((ptr), (oldval), (newval))
+#define LOG_STORE(ptr, val) \
+    do { pthread_mutex_lock(&gAtomicMutex); *(ptr) = (val); \
+         pthread_mutex_unlock(&gAtomicMutex); } while (0)
+#define LOG_INCREMENT(ptr) LogCas((ptr), *(ptr), *(ptr) + 1)
+#endif
+
+struct LogSlot
+{
+    // the slot is free for the producer of position n when
+    // seq + index == n, and holds the message of position n for the writer
+    // when seq + index == n + 1. Storing it relative to the slot index
+    // lets the zero initialized array be ready without an init call.
+    volatile long seq;
+    int level;
+    unsigned long threadId;
+    unsigned long seconds;
+    unsigned long micros;
+    char text[LOG_SLOT_SIZE];
+};
+
+static LogSlot gSlots[LOG_RING_SIZE];
+static volatile long gEnqueuePos = 0;
+static volatile long gDequeuePos = 0;
+static volatile long gDropped = 0;
+
+static volatile int gLogLevel = -2;     // not read from the environment yet
+static volatile long gWriterStarted = 0;
+static volatile int gWriterStop = 0;
+// set if the writer thread couldn't be started. The producers then write 
+// the messages out themselves, one at a time.
+static volatile int gWriteSync = 0;
+static volatile long gSyncWriting = 0;
+
+static char gLogPath[1024] = "JDIC.log";
+static long gMaxLogSize = 1024 * 1024;
+static FILE *gLogFile = NULL;
+
+#ifdef WIN32
+static HANDLE gWriterThread = NULL;
+#else
+static pthread_t gWriterThread;
+#endif
+
+static const char* const gLevelNames[] = { "ERROR", "WARN", "INFO", "DEBUG" };
+
+static void ReadLogConfig()
+{
+    const char *path = getenv("JDIC_LOG_FILE");
+    if (path && *path) {
+        strncpy(gLogPath, path, sizeof(gLogPath) - 1);
+        gLogPath[sizeof(gLogPath) - 1] = '\0';
+    }
+
+    const char *maxSize = getenv("JDIC_LOG_MAX_SIZE");
+    if (maxSize && *maxSize)
+        gMaxLogSize = atol(maxSize) * 1024;
+
+    int level = LOG_INFO;
+    const char *levelName = getenv("JDIC_LOG_LEVEL");
+    if (levelName && *levelName) {
+        switch (levelName[0]) {
+        case 'e': case 'E': level = LOG_ERROR; break;
+        case 'w': case 'W': level = LOG_WARNING; break;
+        case 'i': case 'I': level = LOG_INFO; break;
+        case 'd': case 'D': level = LOG_DEBUG; break;
+        case 'o': case 'O': case 'n': case 'N': level = LOG_OFF; break;
+        default: level = atoi(levelName); break;
+        }
+    }
+    gLogLevel = level;
+}
+
+int GetLogLevel()
+{
+    if (gLogLevel == -2)
+        ReadLogConfig();
+    return gLogLevel;
+}
+
+void SetLogLevel(int level)
+{
+    if (gLogLevel == -2)
+        ReadLogConfig();
+    if (level < LOG_OFF)
+        level = LOG_OFF;
+    if (level > LOG_DEBUG)
+        level = LOG_DEBUG;
+    gLogLevel = level;
+}
+
+static unsigned long CurrentThreadId()
+{
+#ifdef WIN32
+    return GetCurrentThreadId();
+#else
+    return (unsigned long)pthread_self();
+#endif
+}
+
+static unsigned long CurrentProcessId()
+{
+#ifdef WIN32
+    return GetCurrentProcessId();
+#else
+    return (unsigned long)getpid();
+#endif
+}
+
+///////////////////////////////////////////////////////////
+// writer side
+///////////////////////////////////////////////////////////
+
+static void OpenLogFile()
+{
+    if ((gLogFile = fopen(gLogPath, "at")) == NULL) {
+        // Log file doesn't exist, create it. 
+        gLogFile = fopen(gLogPath, "wt+");
+    }
+}
+
+// rename <file> to <file>.1, <file>.1 to <file>.2 and so on.
+static void RotateLogFile()
+{
+#ifndef WIN32
+    // another process sharing the log file (the JNI library and the native
+    // browser do) may have rotated it already.
+    struct stat pathStat, fileStat;
+    if (stat(gLogPath, &pathStat) == 0 
+        && fstat(fileno(gLogFile), &fileStat) == 0
+        && (pathStat.st_ino != fileStat.st_ino 
+            || pathStat.st_size < gMaxLogSize)) {
+        fclose(gLogFile);
+        OpenLogFile();
+        return;
+    }
+#endif
+
+    fclose(gLogFile);
+
+    char from[1100], to[1100];
+    for (int i = LOG_BACKUP_COUNT; i > 0; i--) {
+        if (i > 1)
+            sprintf(from, "%s.%d", gLogPath, i - 1);
+        else
+            strcpy(from, gLogPath);
+        sprintf(to, "%s.%d", gLogPath, i);
+        // rename fails on Windows if the target exists.
+        remove(to);
+        rename(from, to);
+    }
+
+    OpenLogFile();
+}
+
+static void WriteSlot(const LogSlot *slot)
+{
+    time_t seconds = (time_t)slot->seconds;
+    struct tm *tm;
+#ifdef WIN32
+    tm = localtime(&seconds);
+#else
+    struct tm tmBuf;
+    tm = localtime_r(&seconds, &tmBuf);
+#endif
+    char timeBuf[32] = "";
+    if (tm)
+        strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M:%S", tm);
+
+    int level = slot->level;
+    if (level < LOG_ERROR || level > LOG_DEBUG)
+        level = LOG_INFO;
+
+    fprintf(gLogFile, "%s.%03lu [%lu:%lu] %s %s\n", timeBuf, 
+            slot->micros / 1000, CurrentProcessId(), slot->threadId, 
+            gLevelNames[level], slot->text);
+}
+
+// write out the published messages, return the number of messages written.
+static int DrainLog()
+{
+    int written = 0;
+    for (;;) {
+        LogSlot *slot = &gSlots[gDequeuePos & (LOG_RING_SIZE - 1)];
+        long index = (long)(slot - gSlots);
+        if (slot->seq + index != gDequeuePos + 1)
+            break;
+
+        if (!gLogFile)
+            OpenLogFile();
+        if (gLogFile)
+            WriteSlot(slot);
+
+        // hand the slot back to the producers.
+        LOG_STORE(&slot->seq, gDequeuePos + LOG_RING_SIZE - index);
+        gDequeuePos++;
+        written++;
+    }
+
+    long dropped = gDropped;
+    if (dropped > 0 && LOG_CAS(&gDropped, dropped, 0) && gLogFile) {
+        fprintf(gLogFile, "*** %ld log messages dropped\n", dropped);
+        written++;
+    }
+
+    if (written > 0 && gLogFile) {
+        fflush(gLogFile);
+        if (gMaxLogSize > 0 && ftell(gLogFile) >= gMaxLogSize)
+            RotateLogFile();
+    }
+    return written;
+}
+
+#ifdef WIN32
+static unsigned __stdcall LogWriterThread(void *)
+#else
+static void* LogWriterThread(void *)
+#endif
+{
+    while (!gWriterStop) {
+        if (DrainLog() == 0) {
+#ifdef WIN32
+            Sleep(LOG_WRITER_SLEEP_MS);
+#else
+            usleep(LOG_WRITER_SLEEP_MS * 1000);
+#endif
+        }
+    }
+    return 0;
+}
+
+static void StopLogWriter()
+{
+    gWriterStop = 1;
+#ifdef WIN32
+    if (gWriterThread) {
+        WaitForSingleObject(gWriterThread, 1000);
+        CloseHandle(gWriterThread);
+        gWriterThread = NULL;
+    }
+#else
+    pthread_join(gWriterThread, NULL);
+#endif
+    DrainLog();
+    if (gLogFile) {
+        fclose(gLogFile);
+        gLogFile = NULL;
+    }
+}
+
+static void StartLogWriter()
+{
+    if (!LOG_CAS(&gWriterStarted, 0, 1))
+        return;
+
+#ifdef WIN32
+    gWriterThread = (HANDLE)_beginthreadex(NULL, 0, LogWriterThread, NULL, 
+                                           0, NULL);
+    int started = (gWriterThread != NULL);
+#else
+    int started = (pthread_create(&gWriterThread, NULL, LogWriterThread, 
+                                  NULL) == 0);
+#endif
+    if (started)
+        atexit(StopLogWriter);
+    else
+        gWriteSync = 1;
+}
+
+// write out the published messages on the calling thread, taking turns 
+// with the other producers.
+static void DrainLogSync()
+{
+    while (!LOG_CAS(&gSyncWriting, 0, 1)) {
+#ifdef WIN32
+        Sleep(0);
+#else
+        usleep(1000);
+#endif
+    }
+    DrainLog();
+    LOG_STORE(&gSyncWriting, 0);
+}
+
+///////////////////////////////////////////////////////////
+// producer side
+///////////////////////////////////////////////////////////
+
+int Log(int level, const char* msg)
+{
+    if (msg == NULL || level > GetLogLevel())
+        return 0;
+
+    if (!gWriterStarted)
+        StartLogWriter();
+
+    LogSlot *slot;
+    long pos = gEnqueuePos;
+    for (;;) {
+        slot = &gSlots[pos & (LOG_RING_SIZE - 1)];
+        long diff = slot->seq + (long)(slot - gSlots) - pos;
+        if (diff == 0) {
+            if (LOG_CAS(&gEnqueuePos, pos, pos + 1))
+                break;
+            pos = gEnqueuePos;
+        } else if (diff < 0) {
+            // the ring buffer is full.
+            LOG_INCREMENT(&gDropped);
+            return -1;
+        } else {
+            // another producer took this slot.
+            pos = gEnqueuePos;
+        }
+    }
+
+    slot->level = level;
+    slot->threadId = CurrentThreadId();
+#ifdef WIN32
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    // 100ns intervals since 1601 to seconds since 1970.
+    unsigned __int64 ticks = ((unsigned __int64)now.dwHighDateTime << 32) 
+                             | now.dwLowDateTime;
+    ticks -= (unsigned __int64)116444736 * 1000000000;
+    slot->seconds = (unsigned long)(ticks / 10000000);
+    slot->micros = (unsigned long)(ticks % 10000000 / 10);
+#else
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    slot->seconds = now.tv_sec;
+    slot->micros = now.tv_usec;
+#endif
+    strncpy(slot->text, msg, LOG_SLOT_SIZE - 1);
+    slot->text[LOG_SLOT_SIZE - 1] = '\0';
+
+    // publish the message to the writer.
+    LOG_STORE(&slot->seq, pos + 1 - (long)(slot - gSlots));
+    int len = strlen(msg);
+    if (len > LOG_SLOT_SIZE - 1)
+        len = LOG_SLOT_SIZE - 1;
+
+    if (gWriteSync)
+        DrainLogSync();
+
+    return len;
+}
+
+void FlushLog()
+{
+    if (gWriteSync) {
+        DrainLogSync();
+        return;
+    }
+
+    // the writer thread may be draining too, let it finish.
+    if (gWriterStarted) {
+        long pos = gEnqueuePos;
+        for (int i = 0; i < 50 && gDequeuePos < pos && !gWriterStop; i++) {
+#ifdef WIN32
+            Sleep(LOG_WRITER_SLEEP_MS);
+#else
+            usleep(LOG_WRITER_SLEEP_MS * 1000);
+#endif
+        }
+    }
+}
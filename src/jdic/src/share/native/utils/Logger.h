@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */ 
+
+#ifndef _Logger_H_
+#define _Logger_H_
+
+// The JDIC log. Log() only copies the message into a ring buffer, a
+// background thread formats and writes it, so logging never does file I/O
+// on the calling thread. When the ring buffer is full, messages are dropped
+// and counted. If the thread can't be started, Log() writes the message 
+// itself. The messages still in the ring buffer are written out at exit.
+//
+// The log is configured with environment variables, read at the first
+// call:
+//   JDIC_LOG_FILE      the log file, "JDIC.log" in the current directory
+//                      by default.
+//   JDIC_LOG_LEVEL     "error", "warning", "info" (default), "debug" or
+//                      "off", or the level number.
+//   JDIC_LOG_MAX_SIZE  the size in KB at which the log file is rotated to
+//                      <file>.1, <file>.2, ... (LOG_BACKUP_COUNT files);
+//                      1024 by default, 0 disables rotation.
+// The level may be changed at runtime with SetLogLevel(), which the native
+// browser does on JEVENT_SETLOGLEVEL.
+//
+// Each line holds the time, the process and thread IDs and the level:
+//   2005-06-01 12:00:00.000 [1234:5678] INFO message
+//
+// The level numbers must keep same with WebBrowserUtil.java.
+#define LOG_OFF     -1
+#define LOG_ERROR   0
+#define LOG_WARNING 1
+#define LOG_INFO    2
+#define LOG_DEBUG   3
+
+#define LOG_BACKUP_COUNT 3
+
+// Return Value:
+//   On success, the number of characters logged is returned, messages
+//   longer than the ring buffer slots are truncated.
+//   If the message is filtered out by the level, 0 is returned.
+//   If the message is dropped, -1 is returned.
+int Log(int level, const char* msg);
+
+int GetLogLevel();
+void SetLogLevel(int level);
+
+// wait, up to a second, for the messages logged so far to be written out.
+// Called by anything which needs the log on disk right away.
+void FlushLog();
+
+#endif
@@ -41,6 +41,13 @@
 #define JEVENT_GETCONTENT        15
 #define JEVENT_SETCONTENT        16
 #define JEVENT_EXECUTESCRIPT     17
+#define JEVENT_SNAPSHOT          18
+#define JEVENT_ADDCONTENTRULE    19
+#define JEVENT_CLEARCONTENTRULES 20
+#define JEVENT_GETBLOCKEDCOUNT   21
+#define JEVENT_PURGECACHES       22
+#define JEVENT_GETSTATS          23
+#define JEVENT_SETLOGLEVEL       24
 
 // C++ -> Java, must keep same with WebBrowserEvent.java
 #define CEVENT_BEFORE_NAVIGATE	    3001
@@ -68,6 +75,9 @@
 #define CEVENT_GETCONTENT           3061
 #define CEVENT_SETCONTENT           3062
 #define CEVENT_EXECUTESCRIPT        3063
+#define CEVENT_SNAPSHOT             3064
+#define CEVENT_GETBLOCKEDCOUNT      3065
+#define CEVENT_GETSTATS             3066
 
 // Socket message delimiters, must keep same with MsgClient.java
 #define MSG_DELIMITER         "</html><body></html>"
@@ -78,4 +88,14 @@
 #define MSG_DELIMITER_MIDDLE  "</html><body></html>_middle"
 #define MSG_DELIMITER_END     "</html><body></html>_end"
 
+// a message with a binary payload is sent as a header message
+//   #<instance>,<event>,<field length>[,<field length>...]
+// followed by the raw bytes of each field, see MsgServer::RecvData().
+#define MSG_PAYLOAD           '#'
+
+// the payload fields of JEVENT_NAVIGATE_POST.
+#define POST_FIELD_URL        0
+#define POST_FIELD_DATA       1
+#define POST_FIELD_HEADERS    2
+
 #endif
@@ -19,10 +19,12 @@
  */ 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "MsgServer.h"
 #include "Message.h"
 #include "Util.h"
+#include "EventStats.h"
 
 MsgServer gMessenger;
 
@@ -34,6 +36,62 @@ pthread_mutex_t gServerMutex;
 
 int MsgServer::mPort = 0;
 
+// the received payloads waiting to be taken by the message handler, with
+// the ids passed in their messages and the times they were received. All
+// are guarded by the server lock.
+static Payload *gPayloads[MAX_PAYLOADS];
+static int gPayloadIds[MAX_PAYLOADS];
+static unsigned long gPayloadTimes[MAX_PAYLOADS];
+static int gLastPayloadId = 0;
+
+// Keeps a received payload for TakePayload() and returns its id. Payloads 
+// nobody took within PAYLOAD_TIMEOUT are freed; if all the slots are still 
+// in use, the oldest payload makes room for the new one.
+static int StorePayload(Payload *payload)
+{
+#ifdef WIN32
+    EnterCriticalSection(&CriticalSection);
+#else
+    pthread_mutex_lock(&gServerMutex);
+#endif
+
+    unsigned long now = GetTimeMicros();
+    int slot = -1, oldest = -1;
+    for (int i = 0; i < MAX_PAYLOADS; i++) {
+        if (gPayloads[i] != NULL 
+            && now - gPayloadTimes[i] > PAYLOAD_TIMEOUT * 1000000UL) {
+            LogMsg("Dropped a payload nobody took");
+            FreePayload(gPayloads[i]);
+            gPayloads[i] = NULL;
+        }
+        if (gPayloads[i] == NULL) {
+            if (slot < 0)
+                slot = i;
+        } else if (oldest < 0 
+                   || now - gPayloadTimes[i] > now - gPayloadTimes[oldest]) {
+            oldest = i;
+        }
+    }
+    if (slot < 0) {
+        LogMsg("No room for the received payload, dropped the oldest one");
+        FreePayload(gPayloads[oldest]);
+        slot = oldest;
+    }
+
+    gPayloads[slot] = payload;
+    gPayloadIds[slot] = ++gLastPayloadId;
+    gPayloadTimes[slot] = now;
+    int id = gLastPayloadId;
+
+#ifdef WIN32
+    LeaveCriticalSection(&CriticalSection);
+#else
+    pthread_mutex_unlock(&gServerMutex);
+#endif
+
+    return id;
+}
+
 MsgServer::MsgServer()
 {
 #ifdef WIN32
@@ -48,12 +106,14 @@ MsgServer::MsgServer()
 
     mHandler = NULL;
     mSendBuffer = new char[BUFFER_SIZE];
-    mRecvBuffer = new char[BUFFER_SIZE];
-    // predefine the long receiver buffer. If it's not big enough, 
+    // predefine the receiver buffer. If it's not big enough for a message, 
     // alloc more space.
-    mLongRecvBufferSize = BUFFER_SIZE * 4;
-    mLongRecvBuffer = new char[mLongRecvBufferSize];
-    mSendBuffer[0] = mRecvBuffer[0] = mLongRecvBuffer[0] = 0;
+    mRecvBufferSize = BUFFER_SIZE * 4;
+    mRecvBuffer = new char[mRecvBufferSize];
+    mRecvLength = 0;
+    mSendBuffer[0] = mRecvBuffer[0] = 0;
+
+    mPayload = NULL;
 
     int i;
     mTriggers = new Trigger[MAX_TRIGGER];
@@ -61,6 +121,9 @@ MsgServer::MsgServer()
         mTriggers[i].mInstance = EMPTY_TRIGGER;
     }
 
+    mPendingSends = new PendingSend[MAX_PENDING_SEND];
+    mPendingSendCount = 0;
+
     mServerSock = -1;
     mMsgSock = -1;
 
@@ -71,7 +134,13 @@ MsgServer::MsgServer()
 #ifdef WIN32
     InitializeCriticalSection(&CriticalSection);
 #else
-    pthread_mutex_init(&gServerMutex,NULL);
+    // recursive like a critical section, as the listening thread holds the 
+    // lock while it stores the payloads it receives.
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&gServerMutex, &attr);
+    pthread_mutexattr_destroy(&attr);
 #endif
 }
 
@@ -85,8 +154,9 @@ MsgServer::~MsgServer()
 
     delete [] mSendBuffer;
     delete [] mRecvBuffer;
-    delete [] mLongRecvBuffer;
+    FreePayload(mPayload);
     delete [] mTriggers;
+    delete [] mPendingSends;
 
     WBTRACE("Closing socket ...\n");
 
@@ -173,6 +243,15 @@ int MsgServer::Send(const char *pData)
 {
     if (strlen(pData) + strlen(mSendBuffer) < BUFFER_SIZE) {
         strcat(mSendBuffer, pData);
+
+        // a long message is timed by its end piece.
+        if (mPendingSendCount < MAX_PENDING_SEND 
+            && (!strstr(pData, MSG_DELIMITER_) 
+                || strstr(pData, MSG_DELIMITER_END))) {
+            mPendingSends[mPendingSendCount].mEvent = GetMessageEvent(pData);
+            mPendingSends[mPendingSendCount].mQueued = GetTimeMicros();
+            mPendingSendCount++;
+        }
         return 0;
     }
     else {
@@ -287,10 +366,23 @@ int MsgServer::Listen()
 
 int MsgServer::RecvData()
 {    
-    char recvDataBuf[BUFFER_SIZE] = "\0";
-    char unfinishedMsgBuf[BUFFER_SIZE] = "\0";
+    int len;
+    if (mPayload) {
+        // receive the payload bytes right into the payload fields.
+        len = recv(mMsgSock, 
+                   mPayload->mField[mPayloadField] + mPayloadOffset, 
+                   mPayload->mLength[mPayloadField] - mPayloadOffset, 0);
+    } else {
+        if (mRecvLength + BUFFER_SIZE_HALF >= mRecvBufferSize) {
+            char *tmpRecvBuffer = mRecvBuffer;
+            mRecvBufferSize *= 2;
+            mRecvBuffer = new char[mRecvBufferSize];
+            memcpy(mRecvBuffer, tmpRecvBuffer, mRecvLength);
+            delete [] tmpRecvBuffer;
+        }
+        len = recv(mMsgSock, mRecvBuffer + mRecvLength, BUFFER_SIZE_HALF, 0);
+    }
 
-    int len = recv(mMsgSock, recvDataBuf, BUFFER_SIZE_HALF, 0);
     if (len == 0) {
         // value 0 means the network connection is closed.
         WBTRACE("client socket has been closed!\n");
@@ -301,135 +393,179 @@ int MsgServer::RecvData()
         WBTRACE("receive fail!\n");
         return len;
     }
-    
-    recvDataBuf[len] = 0;
 
-    WBTRACE("Client socket recv %s\n", recvDataBuf);
-    if (len + strlen(mRecvBuffer) < BUFFER_SIZE) {
-        strcat(mRecvBuffer, recvDataBuf);
-        memset(recvDataBuf, '\0', strlen(recvDataBuf));
-    } 
-   
-    char *delimiterPtr = strstr(mRecvBuffer, MSG_DELIMITER);
-    if (!delimiterPtr) {
-        // The message buffer has no message delimiters, should be part 
-        // of a long ( > BUFFER_SIZE) message. Cache the message piece 
-        // into the long message buffer (mLongRecvBuffer).
-        if (len + (int)strlen(mLongRecvBuffer) >= mLongRecvBufferSize) {
-            char *tmpRecvBuffer = mLongRecvBuffer;
-            mLongRecvBufferSize += BUFFER_SIZE * 4;
-            mLongRecvBuffer 
-                = new char [mLongRecvBufferSize];
-            memset(mLongRecvBuffer, '\0', mLongRecvBufferSize);
-            strcpy(mLongRecvBuffer, tmpRecvBuffer);
+    if (mPayload) {
+        WBTRACE("Client socket recv %d payload bytes\n", len);
+        FillPayload(NULL, len);
+        return len;
+    }
 
-            delete [] tmpRecvBuffer;
-        }      
-        strcat(mLongRecvBuffer, mRecvBuffer);
+    mRecvLength += len;
+    mRecvBuffer[mRecvLength] = 0;
+    WBTRACE("Client socket recv %s\n", mRecvBuffer);
+
+    // handle the complete messages, the remaining characters are part of
+    // an unfinished message. The bytes following a payload header are the
+    // payload, which may contain any character.
+    int ret = len;
+    int start = 0;
+    while (start < mRecvLength) {
+        if (mPayload) {
+            start += FillPayload(mRecvBuffer + start, mRecvLength - start);
+            continue;
+        }
 
-        // Clear the normal message buffer for incoming new messages.
-        memset(mRecvBuffer, '\0', strlen(mRecvBuffer));
-    } else {
-        // Find the last message delimiter, the remaining characters are part 
-        // of an unfinished message. 
-        char *tmpPtr;
-        while (tmpPtr = strstr(delimiterPtr + strlen(MSG_DELIMITER), \
-            MSG_DELIMITER)) 
-          delimiterPtr = tmpPtr;
-
-        for (int i = 0; i < (int)strlen(MSG_DELIMITER); i++)
-            *(delimiterPtr + i) = 0;
-
-        // save the unfinished message part, if any.
-        strcpy(unfinishedMsgBuf, delimiterPtr + strlen(MSG_DELIMITER));
-
-        char token[BUFFER_SIZE] = "\0";
-        char* bufferPtr = mRecvBuffer;
-
-        while (bufferPtr != NULL) {
-            memset(token, '\0', strlen(token));
-
-            delimiterPtr = strstr(bufferPtr, MSG_DELIMITER);
-            if (delimiterPtr == NULL) {
-                // no delimiter, return the whole string.
-                strcpy(token, bufferPtr);
-                bufferPtr = NULL;
-            } else { 
-                strncpy(token, bufferPtr, delimiterPtr - bufferPtr);
-                bufferPtr = delimiterPtr + strlen(MSG_DELIMITER);
-            }
+        char *delimiterPtr = strstr(mRecvBuffer + start, MSG_DELIMITER);
+        if (!delimiterPtr)
+            break;
 
-            if (token[0] == '@') {
-                // this is a special response message.
-                int instance, msg, data;
-                int i = sscanf(token, "@%d,%d,%d", &instance, &msg, &data);
-                if (i == 3) {
-                    for (int i = 0; i < MAX_TRIGGER; i++) {
-                        if (mTriggers[i].mInstance == instance 
-                            && mTriggers[i].mMsg == msg) {
-                            *(mTriggers[i].mTrigger) = data;
-                            mTriggers[i].mInstance = EMPTY_TRIGGER;
-                            break;
-                        }
-                    }
-                }
-            } else if (token[0] == '*') {
-                // this is quit message
-                if (mHandler) {
-                    mHandler(&token[1]);
-                }
-                return -1;
-            } else {
-                if (mHandler) {
-                    // For each message piece ending with a message delimiter, 
-                    // check whether the long message buffer is empty. If not, 
-                    // this is the end part of a long message, construct the 
-                    // complete, long message.
-                    if (!strlen(mLongRecvBuffer)) {
-                        mHandler(token);
-                    } else {
-                        // If the long message buffer is not long enough to hold this end
-                        // message piece, alloc more space.
-                        if (((int)strlen(mLongRecvBuffer) + (int)strlen(token)) 
-                            >= mLongRecvBufferSize) {
-                            char *tmpRecvBuffer = mLongRecvBuffer;
-                            // one more BUFFER_SIZE space is enough for one msgToken (message).
-                            mLongRecvBufferSize += BUFFER_SIZE;
-                            mLongRecvBuffer 
-                                = new char [mLongRecvBufferSize];
-                            memset(mLongRecvBuffer, '\0', mLongRecvBufferSize);
-                            strcpy(mLongRecvBuffer, tmpRecvBuffer);
-                                
-                            delete [] tmpRecvBuffer;
-                        }      
-
-                        strcat(mLongRecvBuffer, token);
-                        mHandler(mLongRecvBuffer);
-
-                        // Clear the long message buffer.
-                        memset(mLongRecvBuffer, '\0', 
-                            strlen(mLongRecvBuffer));
-                    }
+        *delimiterPtr = 0;
+        char *token = mRecvBuffer + start;
+        start = delimiterPtr + strlen(MSG_DELIMITER) - mRecvBuffer;
+
+        if (HandleMessage(token) < 0) {
+            ret = -1;
+            break;
+        }
+    }
+
+    // keep the unfinished message, if any.
+    mRecvLength -= start;
+    memmove(mRecvBuffer, mRecvBuffer + start, mRecvLength);
+    mRecvBuffer[mRecvLength] = 0;
+
+    return ret;
+}
+
+int MsgServer::HandleMessage(char *token)
+{
+    if (token[0] == '@') {
+        // this is a special response message.
+        int instance, msg, data;
+        int i = sscanf(token, "@%d,%d,%d", &instance, &msg, &data);
+        if (i == 3) {
+            for (int i = 0; i < MAX_TRIGGER; i++) {
+                if (mTriggers[i].mInstance == instance 
+                    && mTriggers[i].mMsg == msg) {
+                    *(mTriggers[i].mTrigger) = data;
+                    mTriggers[i].mInstance = EMPTY_TRIGGER;
+                    break;
                 }
             }
-        } // end while{}
+        }
+    } else if (token[0] == '*') {
+        // this is quit message
+        if (mHandler) {
+            mHandler(&token[1]);
+        }
+        return -1;
+    } else if (token[0] == MSG_PAYLOAD) {
+        // the header of a message with a binary payload.
+        if (BeginPayload(token) < 0) {
+            LogMsg("Wrong payload message format");
+            return -1;
+        }
+    } else if (mHandler) {
+        mHandler(token);
+    }
+
+    return 0;
+}
+
+// Allocates the payload announced by the given header, whose bytes are 
+// received next.
+int MsgServer::BeginPayload(const char *header)
+{
+    int instance, event, consumed = 0;
+    if (sscanf(header + 1, "%d,%d%n", &instance, &event, &consumed) < 2)
+        return -1;
+
+    Payload *payload = new Payload;
+    payload->mFieldCount = 0;
+    payload->mData = NULL;
+
+    int total = 0;
+    const char *p = header + 1 + consumed;
+    while (*p == ',') {
+        int length;
+        consumed = 0;
+        if (payload->mFieldCount == MAX_PAYLOAD_FIELDS 
+            || sscanf(p + 1, "%d%n", &length, &consumed) < 1 
+            || length < 0 || length >= 0x7fffffff - total) {
+            delete payload;
+            return -1;
+        }
+        payload->mLength[payload->mFieldCount++] = length;
+        total += length + 1;
+        p += 1 + consumed;
+    }
+
+    payload->mData = new char[total + 1];
+    char *field = payload->mData;
+    for (int i = 0; i < payload->mFieldCount; i++) {
+        payload->mField[i] = field;
+        field[payload->mLength[i]] = 0;
+        field += payload->mLength[i] + 1;
+    }
+
+    mPayload = payload;
+    mPayloadInstance = instance;
+    mPayloadEvent = event;
+    mPayloadField = 0;
+    mPayloadOffset = 0;
+
+    // an empty payload is complete already.
+    FillPayload(NULL, 0);
+    return 0;
+}
+
+// Adds up to len received payload bytes to the payload fields, copying 
+// them from data unless they were received in place. Once the payload is 
+// complete, the message handler gets the message 
+//   <instance>,<event>,<payload id>
+// and the payload is kept for TakePayload(). Returns the bytes used.
+int MsgServer::FillPayload(const char *data, int len)
+{
+    int used = 0;
+    while (mPayload) {
+        while (mPayloadField < mPayload->mFieldCount 
+               && mPayloadOffset == mPayload->mLength[mPayloadField]) {
+            mPayloadField++;
+            mPayloadOffset = 0;
+        }
+
+        if (mPayloadField == mPayload->mFieldCount) {
+            Payload *payload = mPayload;
+            mPayload = NULL;
+
+            if (!mHandler) {
+                FreePayload(payload);
+                break;
+            }
 
-        // clear the receiver buffer, all the messages should be handled, 
-        // except part of an unfinished message.
-        memset(mRecvBuffer, '\0', strlen(mRecvBuffer));
+            int id = StorePayload(payload);
 
-        // restore the unfinished message, if any
-        if (strlen(unfinishedMsgBuf)) {
-            strcpy(mRecvBuffer, unfinishedMsgBuf);
+            char msg[64];
+            sprintf(msg, "%d,%d,%d", mPayloadInstance, mPayloadEvent, id);
+            mHandler(msg);
+            break;
         }
 
-        // store the unhandled message since the receiver buffer is full.
-        if (strlen(recvDataBuf)) {
-            strcat(mRecvBuffer, recvDataBuf);
+        if (used == len)
+            break;
+
+        int n = mPayload->mLength[mPayloadField] - mPayloadOffset;
+        if (n > len - used)
+            n = len - used;
+        if (data) {
+            memcpy(mPayload->mField[mPayloadField] + mPayloadOffset, 
+                   data + used, n);
         }
+        mPayloadOffset += n;
+        used += n;
     }
 
-    return len;
+    return used;
 }
 
 int MsgServer::SendData()
@@ -442,6 +578,13 @@ int MsgServer::SendData()
     WBTRACE("Client socket send %s\n", mSendBuffer);
     if (len > 0) {
         mSendBuffer[0] = 0;
+
+        unsigned long now = GetTimeMicros();
+        for (int i = 0; i < mPendingSendCount; i++) {
+            RecordEventTime(STATS_SEND_DELAY, mPendingSends[i].mEvent, 
+                            now - mPendingSends[i].mQueued);
+        }
+        mPendingSendCount = 0;
     }
     else if (len < 0) {
         WBTRACE("send fail!\n");
@@ -635,6 +778,42 @@ void AddTrigger(int instance, int msg, int *trigger)
 #endif
 }
 
+Payload* TakePayload(const char *pMsgString)
+{
+    int id = atoi(pMsgString);
+    Payload *payload = NULL;
+
+#ifdef WIN32
+    EnterCriticalSection(&CriticalSection);
+#else
+    pthread_mutex_lock(&gServerMutex);
+#endif
+
+    for (int i = 0; i < MAX_PAYLOADS; i++) {
+        if (gPayloads[i] != NULL && gPayloadIds[i] == id) {
+            payload = gPayloads[i];
+            gPayloads[i] = NULL;
+            break;
+        }
+    }
+
+#ifdef WIN32
+    LeaveCriticalSection(&CriticalSection);
+#else
+    pthread_mutex_unlock(&gServerMutex);
+#endif
+
+    return payload;
+}
+
+void FreePayload(Payload *pPayload)
+{
+    if (pPayload) {
+        delete [] pPayload->mData;
+        delete pPayload;
+    }
+}
+
 // this is a socket server listening thread function.
 #ifdef _WIN32_IEEMBED
 DWORD WINAPI PortListening(void *pParam)
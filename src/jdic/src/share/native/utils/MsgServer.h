@@ -44,6 +44,11 @@
 #define MAX_TRIGGER      20
 #define EMPTY_TRIGGER    -1111
 #define MAX_WAIT         100
+#define MAX_PENDING_SEND 64
+#define MAX_PAYLOAD_FIELDS 4
+#define MAX_PAYLOADS     16
+// the seconds a received payload is kept for the message handler.
+#define PAYLOAD_TIMEOUT  60
 
 // the sleep interval time between continuous Socket recv/send 
 // operations, in *millisecond*.
@@ -51,6 +56,15 @@
 
 typedef void (*MsgHandler)(const char *);
 
+// the binary payload of a message. Each field is followed by a '\0', so 
+// text fields can be used as strings.
+struct Payload {
+    int mFieldCount;
+    int mLength[MAX_PAYLOAD_FIELDS];
+    char *mField[MAX_PAYLOAD_FIELDS];
+    char *mData;
+};
+
 class MsgServer
 {
 private:
@@ -66,12 +80,18 @@ private:
     unsigned int mCounter;
 
     char *mSendBuffer;
-    // message buffer receiving the short (<= BUFFER_SIZE) messages.
+    // message buffer receiving the messages, grows to hold the longest
+    // message received.
     char *mRecvBuffer;    
-    // message buffer storing the received message pieces for a 
-    // long (> BUFFER_SIZE) message.
-    char *mLongRecvBuffer; 
-    int mLongRecvBufferSize; 
+    int mRecvLength;
+    int mRecvBufferSize; 
+
+    // the payload being received, and the position of the next byte.
+    Payload *mPayload;
+    int mPayloadInstance;
+    int mPayloadEvent;
+    int mPayloadField;
+    int mPayloadOffset;
 
     // native browser needs a yes or no confirmation from the Java side
     // for the two trigger events: CEVENT_BEFORE_NAVIGATE and 
@@ -86,10 +106,23 @@ private:
 
     Trigger *mTriggers;
 
+    // the messages waiting in the send buffer, with the time they were
+    // queued, for the send delay statistics.
+    struct PendingSend {
+        int mEvent;
+        unsigned long mQueued;
+    };
+
+    PendingSend *mPendingSends;
+    int mPendingSendCount;
+
     MsgHandler mHandler;
 
     int RecvData();
     int SendData();
+    int HandleMessage(char *token);
+    int BeginPayload(const char *header);
+    int FillPayload(const char *data, int len);
 
 public:
     MsgServer();
@@ -112,6 +145,12 @@ public:
 void SendSocketMessage(int instance, int event, const char *pData = NULL);
 void AddTrigger(int instance, int msg, int *trigger);
 
+// Returns the payload of a message received with one, given the message 
+// string passed to the message handler. The caller owns the payload and
+// releases it with FreePayload().
+Payload* TakePayload(const char *pMsgString);
+void FreePayload(Payload *pPayload);
+
 #ifdef _WIN32_IEEMBED
 DWORD WINAPI PortListening(void *pParam);
 #else
@@ -22,7 +22,17 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 #include "Util.h"
+#include "Logger.h"
 
 #if defined(DEBUG) || defined(_DEBUG)
 
@@ -32,9 +42,14 @@ void WBTrace(const char *format, ...)
     va_start(args, format);
 
     char buffer[1024];
-    sprintf(buffer, format, args);
-    printf(buffer);
-	LogMsg(buffer);
+#ifdef WIN32
+    _vsnprintf(buffer, sizeof(buffer) - 1, format, args);
+#else
+    vsnprintf(buffer, sizeof(buffer) - 1, format, args);
+#endif
+    buffer[sizeof(buffer) - 1] = '\0';
+    printf("%s", buffer);
+    Log(LOG_DEBUG, buffer);
 
     va_end(args);
 }
@@ -217,102 +232,221 @@ char* TuneJavaScript(const char* javaScript)
 
 /////////////////////////////////////////////////////////////////////////////
 
-// helper function for parsing the post message string fields including 
-// url, post data and headers. Which is in the format of:
-//   <url><field delimiter><post data><field delimiter><headers>
-// The <field delimiter> is a string of 
-//   "<instance number>,<event ID>,"
-// which must be identical between the Java side and native side.
-int ParsePostFields(const char* postMessage, 
-                    const int instanceNum, const int eventID, 
-                    char** urlBuf, char** postDataBuf, char** headersBuf)
+// helper function for logging the given message to the JDIC log, see
+// Logger.h.
+int LogMsg(const char* logmsg) 
 {
-    // Construct the message string field delimiter with the instance 
-    // number and the event ID.
-    char fieldDelimiter[2048];
-    memset(fieldDelimiter, '\0', 2048);
-    sprintf(fieldDelimiter, "%d,%d,", instanceNum, eventID);
-
-    // Get URL field.
-    char *fieldPtr;
-    fieldPtr = (char*)postMessage;
-    char *delimiterPtr;
-    delimiterPtr = strstr(fieldPtr, fieldDelimiter);
-    int urlBufLen=delimiterPtr - fieldPtr;
-    if(urlBufLen>0){
-    	*urlBuf=new char[urlBufLen+1];
-    	memset(*urlBuf,'\0',urlBufLen+1);
-    	strncpy(*urlBuf, fieldPtr,urlBufLen);
-    }
-    
-    // Get post data field.
-    fieldPtr = delimiterPtr + strlen(fieldDelimiter);
-    delimiterPtr = strstr(fieldPtr, fieldDelimiter);
-    int postBufLen=delimiterPtr - fieldPtr;
-    if(postBufLen>0){
-    	*postDataBuf=new char[postBufLen+1];
-    	memset(*postDataBuf,'\0',postBufLen+1);
-    	strncpy(*postDataBuf, fieldPtr, postBufLen);
-    }
-    
-    // Get headers field.
-    int headerBufLen = strlen(postMessage)-urlBufLen-postBufLen-strlen(fieldDelimiter);
-	if(headerBufLen>0){
-		*headersBuf=new char[headerBufLen+1];
-		memset(*headersBuf,'\0',headerBufLen+1);
-        strcpy(*headersBuf, delimiterPtr + strlen(fieldDelimiter));
-	}
-    return 0;
+    return Log(LOG_INFO, logmsg);
+}
+
+int LogIntMsg(int i)
+{
+    char buf[16];
+    sprintf(buf, "%d", i);
+    Log(LOG_INFO, buf);
+	return i;
 }
 
 
 /////////////////////////////////////////////////////////////////////////////
 
-// helper function for logging the given message to the predefined,
-// log file "JDIC.log" under the *current/working* directory.
-int LogMsg(const char* logmsg) 
+// shared memory segment holding the last snapshot of a browser instance.
+struct SnapshotBuffer
 {
-    if (logmsg == NULL) {
-        return 0;
+    char name[SNAPSHOT_NAME_SIZE];
+    unsigned char* data;
+    int size;
+#ifdef WIN32
+    HANDLE hMapping;
+#endif
+};
+
+// the array of snapshot buffers, indexed by browser instance number
+static WBArray gSnapshotBuffers;
+
+unsigned char* CreateSnapshotBuffer(int instanceNum, int size, char* nameBuf)
+{
+    ReleaseSnapshotBuffer(instanceNum);
+    if (size <= 0)
+        return NULL;
+
+    SnapshotBuffer* pBuffer = new SnapshotBuffer;
+    memset(pBuffer, 0, sizeof(SnapshotBuffer));
+#ifdef WIN32
+    sprintf(pBuffer->name, "JDIC_Snapshot_%lu_%d", 
+        GetCurrentProcessId(), instanceNum);
+    pBuffer->hMapping = CreateFileMapping(INVALID_HANDLE_VALUE, NULL,
+        PAGE_READWRITE, 0, size, pBuffer->name);
+    if (pBuffer->hMapping == NULL) {
+        delete pBuffer;
+        return NULL;
+    }
+    pBuffer->data = (unsigned char*)MapViewOfFile(pBuffer->hMapping,
+        FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (pBuffer->data == NULL) {
+        CloseHandle(pBuffer->hMapping);
+        delete pBuffer;
+        return NULL;
     }
+#else
+    sprintf(pBuffer->name, "/jdic-snapshot-%d-%d", (int)getpid(), instanceNum);
+    int fd = shm_open(pBuffer->name, O_RDWR | O_CREAT | O_TRUNC, 
+        S_IRUSR | S_IWUSR);
+    if (fd == -1) {
+        delete pBuffer;
+        return NULL;
+    }
+    if (ftruncate(fd, size) == -1) {
+        close(fd);
+        shm_unlink(pBuffer->name);
+        delete pBuffer;
+        return NULL;
+    }
+    void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        shm_unlink(pBuffer->name);
+        delete pBuffer;
+        return NULL;
+    }
+    pBuffer->data = (unsigned char*)data;
+#endif
+    pBuffer->size = size;
+    gSnapshotBuffers.SetAtGrow(instanceNum, pBuffer);
 
-    // Predefined JDIC log file.
-    const char* logFilePath = "JDIC.log";
-    FILE* logFile;
+    strcpy(nameBuf, pBuffer->name);
+    return pBuffer->data;
+}
 
-    // Open the log file for appending messages.
-    if((logFile = fopen(logFilePath, "at")) == NULL) {
-        // Log file doesn't exist, create it. 
-        if ((logFile = fopen(logFilePath, "wt+")) == NULL) {
-            // Error creating log file.
-            return -1;
-        }
-    }
+void ReleaseSnapshotBuffer(int instanceNum)
+{
+    if (instanceNum < 0 || instanceNum >= gSnapshotBuffers.GetSize())
+        return;
+    SnapshotBuffer* pBuffer = (SnapshotBuffer*)gSnapshotBuffers[instanceNum];
+    if (pBuffer == NULL)
+        return;
+
+#ifdef WIN32
+    UnmapViewOfFile(pBuffer->data);
+    CloseHandle(pBuffer->hMapping);
+#else
+    munmap(pBuffer->data, pBuffer->size);
+    // The Java side normally unlinks the name once it has mapped the 
+    // segment, this only cleans up snapshots which were never picked up.
+    shm_unlink(pBuffer->name);
+#endif
+    delete pBuffer;
+    gSnapshotBuffers.SetAt(instanceNum, NULL);
+}
 
-    // Append the given log message to the log file.    
-    fprintf(logFile, "*** JDIC log: %s\n", logmsg);
-    fclose(logFile);
+int ClipSnapshotRect(int winWidth, int winHeight, 
+                     int* x, int* y, int* width, int* height)
+{
+    if (*x < 0) {
+        *width += *x;
+        *x = 0;
+    }
+    if (*y < 0) {
+        *height += *y;
+        *y = 0;
+    }
+    if (*width <= 0 || *x + *width > winWidth)
+        *width = winWidth - *x;
+    if (*height <= 0 || *y + *height > winHeight)
+        *height = winHeight - *y;
 
-    return strlen(logmsg);
+    return (*width > 0 && *height > 0) ? 0 : -1;
 }
 
-int LogIntMsg(int i)
+#ifdef WIN32
+
+typedef BOOL (WINAPI *PPRINTWINDOW)(HWND, HDC, UINT);
+#ifndef PW_CLIENTONLY
+#define PW_CLIENTONLY 0x00000001
+#endif
+
+int CaptureWindowSnapshot(int instanceNum, void* hWnd, 
+                          int x, int y, int width, int height, 
+                          char* resultBuf)
 {
-    // Predefined JDIC log file.
-    const char* logFilePath = "JDIC.log";
-    FILE* logFile;
-
-    // Open the log file for appending messages.
-    if((logFile = fopen(logFilePath, "at")) == NULL) {
-        // Log file doesn't exist, create it. 
-        if ((logFile = fopen(logFilePath, "wt+")) == NULL) {
-            // Error creating log file.
-            return -1;
+    HWND hwnd = (HWND)hWnd;
+    RECT rc;
+    if (hwnd == NULL || !GetClientRect(hwnd, &rc))
+        return -1;
+    int winWidth = rc.right - rc.left;
+    int winHeight = rc.bottom - rc.top;
+    if (ClipSnapshotRect(winWidth, winHeight, &x, &y, &width, &height) != 0)
+        return -1;
+
+    char name[SNAPSHOT_NAME_SIZE];
+    unsigned char* pixels = CreateSnapshotBuffer(instanceNum, 
+        width * height * 4, name);
+    if (pixels == NULL)
+        return -1;
+
+    // Render the whole client area into a top-down 32 bit DIB.
+    BITMAPINFO bmi;
+    ZeroMemory(&bmi, sizeof(BITMAPINFO));
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = winWidth;
+    bmi.bmiHeader.biHeight = -winHeight;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    HDC hdcWnd = GetDC(hwnd);
+    HDC hdcMem = CreateCompatibleDC(hdcWnd);
+    void* bits = NULL;
+    HBITMAP hBitmap = CreateDIBSection(hdcMem, &bmi, DIB_RGB_COLORS, 
+        &bits, NULL, 0);
+    if (hBitmap == NULL) {
+        DeleteDC(hdcMem);
+        ReleaseDC(hwnd, hdcWnd);
+        ReleaseSnapshotBuffer(instanceNum);
+        return -1;
+    }
+    HGDIOBJ hOldBitmap = SelectObject(hdcMem, hBitmap);
+
+    // PrintWindow is only available on Windows XP and later, fall back to
+    // copying the window bits, which only works for visible windows.
+    BOOL painted = FALSE;
+    HMODULE hUser32 = GetModuleHandle("user32.dll");
+    PPRINTWINDOW pPrintWindow = hUser32 ? 
+        (PPRINTWINDOW)GetProcAddress(hUser32, "PrintWindow") : NULL;
+    if (pPrintWindow != NULL)
+        painted = pPrintWindow(hwnd, hdcMem, PW_CLIENTONLY);
+    if (!painted)
+        painted = BitBlt(hdcMem, 0, 0, winWidth, winHeight, 
+            hdcWnd, 0, 0, SRCCOPY);
+    GdiFlush();
+
+    if (painted) {
+        // Convert the requested area from BGRX to RGBA.
+        for (int row = 0; row < height; row++) {
+            unsigned char* src = (unsigned char*)bits 
+                + ((y + row) * winWidth + x) * 4;
+            unsigned char* dst = pixels + row * width * 4;
+            for (int col = 0; col < width; col++, src += 4, dst += 4) {
+                dst[0] = src[2];
+                dst[1] = src[1];
+                dst[2] = src[0];
+                dst[3] = 0xff;
+            }
         }
     }
 
-    // Append the given log message to the log file.    
-    fprintf(logFile, "*** JDIC log: %d\n", i);
-    fclose(logFile);
-	return i;
+    SelectObject(hdcMem, hOldBitmap);
+    DeleteObject(hBitmap);
+    DeleteDC(hdcMem);
+    ReleaseDC(hwnd, hdcWnd);
+
+    if (!painted) {
+        ReleaseSnapshotBuffer(instanceNum);
+        return -1;
+    }
+
+    sprintf(resultBuf, "%s,%d,%d", name, width, height);
+    return 0;
 }
+
+#endif // WIN32
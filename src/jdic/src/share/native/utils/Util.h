@@ -108,25 +108,9 @@ inline void*& WBArray::operator[](int nIndex)
 #define JDIC_BROWSER_INTERMEDIATE_PROP "JDIC_BROWSER_INTERMEDIATE_PROP"
 char* TuneJavaScript(const char* javaScript);
 
-// helper function for parsing the post message string fields including 
-// url, post data and headers. Which is in the format of:
-//   <url><field delimiter><post data><field delimiter><headers>
-// The <field delimiter> is a string of 
-//   "<instance number>,<event ID>,"
-// which must be identical between the Java side and native side.
-//
-// This function is used to pass multiple string values in one Socket 
-// communication.
-//
-// Return Value:
-//   On success, 0 is returned.
-//   On error, -1 is returned.
-int ParsePostFields(const char* postMessage, 
-                    const int instanceNum, const int eventID, 
-                    char** urlBuf, char** postDataBuf, char** headersBuf);
-
-// helper function for logging the given message to the predefined,
-// log file "JDIC.log" under the *current/working* directory. Usage:
+// helper function for logging the given message to the JDIC log at the
+// LOG_INFO level, see Logger.h for the log file and level settings. The
+// message is written by a background thread. Usage:
 //
 //     #include "Util.h"
 //
@@ -138,9 +122,54 @@ int ParsePostFields(const char* postMessage,
 //
 // Return Value:
 //   On success, the total number of characters logged is returned.
-//   On error, -1 is returned.
+//   If the message is filtered out by the log level, 0 is returned.
+//   If the message is dropped (the log buffer is full), -1 is returned.
 int LogMsg(const char* logmsg);
 int LogIntMsg(int i);
+
+// helper functions for the shared memory segments which hand rendered page
+// snapshots over to the Java side. A segment holds width * height pixels,
+// 4 bytes per pixel in R, G, B, A order, row by row from the top.
+//
+// Each browser instance owns at most one segment. It stays alive until the
+// next snapshot of the same instance or until ReleaseSnapshotBuffer() is
+// called, so the Java side can still open it by name after the
+// CEVENT_SNAPSHOT reply is sent.
+//
+// Return Value of CreateSnapshotBuffer:
+//   On success, the address of the mapped segment is returned and the
+//   segment name is copied to nameBuf, which must hold at least
+//   SNAPSHOT_NAME_SIZE characters.
+//   On error, NULL is returned.
+#define SNAPSHOT_NAME_SIZE 64
+unsigned char* CreateSnapshotBuffer(int instanceNum, int size, char* nameBuf);
+void ReleaseSnapshotBuffer(int instanceNum);
+
+// helper function for clipping the requested snapshot area against the
+// visible area of a browser window. A width or height which is not
+// positive means "up to the right/bottom edge of the window".
+//
+// Return Value:
+//   On success, 0 is returned.
+//   On error (empty area), -1 is returned.
+int ClipSnapshotRect(int winWidth, int winHeight, 
+                     int* x, int* y, int* width, int* height);
+
+#ifdef WIN32
+// helper function for rendering the client area of the given window into
+// a snapshot buffer of the given browser instance. The window paints itself
+// through PrintWindow() when the system supports it, so covered or hidden
+// browser windows are captured too. resultBuf receives the CEVENT_SNAPSHOT
+// message string "<segment name>,<width>,<height>".
+//
+// Return Value:
+//   On success, 0 is returned.
+//   On error, -1 is returned.
+int CaptureWindowSnapshot(int instanceNum, void* hWnd, 
+                          int x, int y, int width, int height, 
+                          char* resultBuf);
+#endif
+
 #endif // _util_h
 
 
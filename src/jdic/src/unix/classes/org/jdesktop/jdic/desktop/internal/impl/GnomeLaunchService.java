@@ -23,9 +23,12 @@ package org.jdesktop.jdic.desktop.internal.impl;
 import java.awt.Toolkit;
 import java.io.File;
 import java.io.IOException;
+import java.util.ArrayList;
+import java.util.List;
 
 import org.jdesktop.jdic.desktop.internal.LaunchFailedException;
 import org.jdesktop.jdic.desktop.internal.LaunchService;
+import org.jdesktop.jdic.filetypes.internal.XdgMimeWrapper;
 
 /**
  * Concrete implementation of the LaunchService interface for Gnome.
@@ -51,7 +54,9 @@ public class GnomeLaunchService implements LaunchService {
     } 
 
     /**
-     * Launches the associated application to open the given file.
+     * Launches the associated application to open the given file. If GnomeVFS 
+     * has no application for it, the default application of the native .desktop 
+     * catalog is launched.
      * 
      * @param file the given file to be opened.
      * @throws LaunchFailedException if the given file has no associated application, 
@@ -59,6 +64,9 @@ public class GnomeLaunchService implements LaunchService {
      */
     public void open(File file) throws LaunchFailedException {
         boolean result = nativeOpenFile(file.toString());
+        if (result == false) {
+            result = openWithCatalogApplication(file);
+        }
         if (result == false) {
             throw new LaunchFailedException("Failed to launch the associated application with the specified file.");        
         }
@@ -100,5 +108,105 @@ public class GnomeLaunchService implements LaunchService {
         throw new LaunchFailedException("No application associated with the specified file and verb.");        
     }
     
+    /**
+     * Launches the default application the .desktop catalog lists for the mime 
+     * type of the given file.
+     *
+     * @return true if the application was launched.
+     */
+    private boolean openWithCatalogApplication(File file) {
+        if (!XdgMimeWrapper.isAvailable()) {
+            return false;
+        }
+        String mimeType = XdgMimeWrapper.getMimeTypeByFile(file.getPath());
+        if (mimeType == null) {
+            return false;
+        }
+        // Desktop file id, name and command line of each application.
+        String[] entries = XdgMimeWrapper.getApplicationEntries(mimeType);
+        if (entries == null || entries.length < 3) {
+            return false;
+        }
+
+        try {
+            Runtime.getRuntime().exec(expandExec(entries[2], file));
+            return true;
+        } catch (IOException e) {
+            return false;
+        }
+    }
+
+    /**
+     * Splits the Exec key of a desktop entry into the command line arguments,
+     * replacing the field codes by the given file. The file is appended if the
+     * command line has no file or URL field code.
+     */
+    private static String[] expandExec(String exec, File file) {
+        List args = new ArrayList();
+        StringBuffer arg = null;
+        boolean quoted = false;
+        boolean fileAdded = false;
+        
+        for (int i = 0; i < exec.length(); i++) {
+            char c = exec.charAt(i);
+            if (quoted) {
+                if (c == '"') {
+                    quoted = false;
+                } else if (c == '\\' && i + 1 < exec.length()) {
+                    arg.append(exec.charAt(++i));
+                } else {
+                    arg.append(c);
+                }
+            } else if (c == '"') {
+                if (arg == null) {
+                    arg = new StringBuffer();
+                }
+                quoted = true;
+            } else if (Character.isWhitespace(c)) {
+                if (arg != null) {
+                    args.add(arg.toString());
+                    arg = null;
+                }
+            } else if (c == '%' && i + 1 < exec.length()) {
+                // The other field codes are dropped, as the specification allows.
+                String value = null;
+                switch (exec.charAt(++i)) {
+                case 'f':
+                case 'F':
+                    value = file.getPath();
+                    fileAdded = true;
+                    break;
+                case 'u':
+                case 'U':
+                    value = file.toURI().toString();
+                    fileAdded = true;
+                    break;
+                case '%':
+                    value = "%";
+                    break;
+                }
+                if (value != null) {
+                    if (arg == null) {
+                        arg = new StringBuffer();
+                    }
+                    arg.append(value);
+                }
+            } else {
+                if (arg == null) {
+                    arg = new StringBuffer();
+                }
+                arg.append(c);
+            }
+        }
+        if (arg != null) {
+            args.add(arg.toString());
+        }
+        if (!fileAdded) {
+            args.add(file.getPath());
+        }
+        
+        return (String[]) args.toArray(new String[args.size()]);
+    }
+
     private native boolean nativeOpenFile(String filePath);
 }
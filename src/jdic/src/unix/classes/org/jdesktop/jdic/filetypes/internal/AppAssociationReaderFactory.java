@@ -22,10 +22,30 @@ package org.jdesktop.jdic.filetypes.internal;
 
 
 /**
- * Create an instance of GnomeAppAssociationReader
+ * Create an instance of the AppAssociationReader for the desktop.
+ * <P>
+ * The system property "org.jdesktop.jdic.filetypes.reader" selects the 
+ * implementation: "xdg" reads the freedesktop.org shared MIME-info database
+ * directly (XdgAppAssociationReader), anything else uses GnomeVFS 
+ * (GnomeAppAssociationReader). The xdg reader falls back to GnomeVFS if no 
+ * mime.cache file is installed.
  */
 public class AppAssociationReaderFactory {
+    /* The system property selecting the AppAssociationReader implementation */
+    public final static String READER_PROPERTY 
+            = "org.jdesktop.jdic.filetypes.reader";
+
     public static AppAssociationReader newInstance() {
+        String reader = null;
+        try {
+            reader = System.getProperty(READER_PROPERTY);
+        } catch (SecurityException e) {
+            // Use the default reader.
+        }
+
+        if ("xdg".equals(reader) && XdgMimeWrapper.isAvailable()) {
+            return new XdgAppAssociationReader();
+        }
         return new GnomeAppAssociationReader();
     }
 }
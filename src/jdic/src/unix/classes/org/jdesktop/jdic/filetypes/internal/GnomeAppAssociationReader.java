@@ -66,6 +66,18 @@ public class GnomeAppAssociationReader implements AppAssociationReader {
         return GnomeAssociationUtil.getMimeTypeByURL(url);
     }        
 
+    /**
+     * Returns the mime types associated with the given URLs, by checking the 
+     * content of the URLs.
+     *
+     * @param urls The specified URLs
+     * @param threadCount The most threads to use, 0 for one per processor
+     * @return String[]
+     */
+    public String[] getMimeTypesByURLs(URL[] urls, int threadCount) {
+        return GnomeAssociationUtil.getMimeTypesByURLs(urls, threadCount);
+    }
+
     /**
      * Returns the file extensione list associated with the given mime type.
      *
@@ -178,4 +190,13 @@ public class GnomeAppAssociationReader implements AppAssociationReader {
        
         return GnomeAssociationUtil.isFileExtExist(fileExt);
     }
+
+    /**
+     * Returns false, as GnomeVFS isn't thread safe.
+     *
+     * @return false
+     */
+    public boolean isThreadSafe() {
+        return false;
+    }
 }
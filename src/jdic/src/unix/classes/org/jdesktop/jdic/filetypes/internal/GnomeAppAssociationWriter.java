@@ -23,13 +23,23 @@ package org.jdesktop.jdic.filetypes.internal;
 import java.io.BufferedReader;
 import java.io.BufferedWriter;
 import java.io.File;
+import java.io.FileOutputStream;
 import java.io.FileReader;
-import java.io.FileWriter;
 import java.io.IOException;
+import java.io.OutputStreamWriter;
+import java.io.Reader;
+import java.io.Writer;
+import java.util.ArrayList;
 import java.util.Iterator;
+import java.util.LinkedHashMap;
+import java.util.LinkedHashSet;
 import java.util.List;
+import java.util.Map;
+import java.util.Set;
 import org.jdesktop.jdic.filetypes.Action;
 import org.jdesktop.jdic.filetypes.Association;
+import org.jdesktop.jdic.filetypes.AssociationAlreadyRegisteredException;
+import org.jdesktop.jdic.filetypes.AssociationNotRegisteredException;
 import org.jdesktop.jdic.filetypes.RegisterFailedException;
 
 
@@ -72,10 +82,22 @@ public class GnomeAppAssociationWriter implements AppAssociationWriter {
     static String KEYS_SUFFIX = ".keys";
     static String APPLICATIONS_SUFFIX = ".applications";
 
-    // Generated default application ID and command from the given open action, which will be written into .keys and .applications files.
-    private String defaultAppID = null;
-    private String defaultAppCommand = null;
-    
+    /**
+     * A pending change of one MIME database file in a registration.
+     */
+    private static class FileChange {
+        File file;
+        // The current content of the file, or null if it doesn't exist.
+        String oldContent;
+        StringBuffer newContent;
+        // The temporary file the new content is written to before the rename.
+        File tempFile;
+
+        FileChange(File file) {
+            this.file = file;
+        }
+    }
+
     /**
      * Converts the specified file extension list to a file extension string.
      * <P>
@@ -241,92 +263,144 @@ public class GnomeAppAssociationWriter implements AppAssociationWriter {
 
 
     /**
-     * Creates one mime file(.mime, .keys or .applications) in MIME database if not exist.
-     * 
-     * @throws IOException if the given file fails to be created.
-     */
-    private void createFile(String mimeFilePath) throws IOException {
-        boolean createSucceed = false;
-        
-        File mimeFile = new File(mimeFilePath);
-        if (!mimeFile.exists()) {
-            createSucceed = mimeFile.createNewFile();
-            if (!createSucceed) {
-                throw new IOException("Create MIME file: " + mimeFilePath + " failed.");        
-            }
-        }
-    }
-
-    /**
+     * Parses the "open" action of the given association into the application ID and 
+     * command written into the .keys and .applications files. 
+     * <P>
      * Here we only accept and write the "open" action and *ignore* other actions.
      * Since other actions are not applied/used on Gnome desktop at all.
-     * The parsed application ID and application command info will be write into .keys and .application files.  
+     *
+     * @return an array of the application ID and command, or null if the association
+     *         has no "open" action.
      */
-    private void parseOpenAction(Association assoc) {
+    private String[] parseOpenAction(Association assoc) {
         List actionList = assoc.getActionList();
-        
         if (actionList == null) {
-            return;
-        } else {
-            String verb = null;
-            Iterator actionIter = actionList.iterator();
-
-            while (actionIter.hasNext() && defaultAppCommand == null) {
-                Action oneAction = (Action) actionIter.next();
-                verb = oneAction.getVerb();
-                if (verb.equalsIgnoreCase("open")) {
-                    defaultAppCommand = oneAction.getCommand().trim();
-                }
-            }
-            
-            if (defaultAppCommand != null) {
-                // Check the application command and application id, which will be written into .applications file.
-                int sepIndex = defaultAppCommand.lastIndexOf(File.separator);
-                if (sepIndex == -1 || sepIndex == defaultAppCommand.length() - 1 ) {
-                    defaultAppID = defaultAppCommand;
-                } else {
-                    defaultAppID = defaultAppCommand.substring(sepIndex + 1, defaultAppCommand.length());
-                }
+            return null;
+        }
+
+        String appCommand = null;
+        Iterator actionIter = actionList.iterator();
+        while (actionIter.hasNext() && appCommand == null) {
+            Action oneAction = (Action) actionIter.next();
+            String verb = oneAction.getVerb();
+            if (verb != null && verb.equalsIgnoreCase("open") 
+                    && oneAction.getCommand() != null) {
+                appCommand = oneAction.getCommand().trim();
             }
         }
+        if (appCommand == null) {
+            return null;
+        }
+
+        // The application ID is the command without its directory.
+        String appID = null;
+        int sepIndex = appCommand.lastIndexOf(File.separator);
+        if (sepIndex == -1 || sepIndex == appCommand.length() - 1 ) {
+            appID = appCommand;
+        } else {
+            appID = appCommand.substring(sepIndex + 1, appCommand.length());
+        }
+        return new String[] {appID, appCommand};
     }
     
     /**
-     * Writes association fields into specified .mime file, including mime type, 
+     * Appends the .mime file entry of the given association, including mime type 
      * and extension list.
-     *       
-     * @throws IOException if the given association info fails to be write to the given 
-     *         mime file.
      */
-    private void writeDotMimeFile(Association assoc, String dotMimeFilePath) throws IOException {
-        // Create file first.
-        createFile(dotMimeFilePath);
-        
+    private void appendDotMimeEntry(Association assoc, StringBuffer content) {
         String mimeType = assoc.getMimeType();
         List fileExtList = assoc.getFileExtList();
 
-        BufferedWriter mBufferWriter = null;
-        try {
-            // Appends new mime info into .mime file.
-            mBufferWriter = new BufferedWriter(new FileWriter(dotMimeFilePath, true));
+        String fileExtensionString = null;
+        if (fileExtList == null) {
+            fileExtensionString = "";
+        } else {
+            fileExtensionString = fileExtListToString(fileExtList);
+        }
 
-            mBufferWriter.write(mimeType + "\n");
-            String fileExtensionString = null;
+        content.append(mimeType + "\n");
+        content.append("\t" + "ext: " + fileExtensionString + "\n");
+        content.append("\n");            
+    }
 
-            if (fileExtList == null) {
-                fileExtensionString = "";
-            } else {
-                fileExtensionString = fileExtListToString(fileExtList);
+    /**
+     * Appends the .keys file entry of the given association, including mime type, 
+     * description, icon file and default application.      
+     */
+    private void appendDotKeysEntry(Association assoc, String[] openAction, 
+            StringBuffer content) {
+        String description = assoc.getDescription();      
+        String iconFileName = assoc.getIconFileName();
+        
+        content.append(assoc.getMimeType() + "\n");
+        if (description != null) {
+            content.append("\t"
+                    + GnomeAssociationUtil.GNOME_VFS_MIME_KEY_DESCRIPTION 
+                    + "=" + description + "\n");
+        }
+
+        if (iconFileName != null) {
+            content.append("\t"
+                    + GnomeAssociationUtil.GNOME_VFS_MIME_KEY_ICON_FILENAME
+                    + "=" + iconFileName + "\n");
+        }
+
+        if (openAction != null) {                
+            content.append("\t" + "default_action_type=application" + "\n");
+            content.append("\t" + "default_application_id=" + openAction[0] + "\n");
+            content.append("\t" + "short_list_application_user_additions=" 
+                    + openAction[0] + "\n");
+        }
+        
+        content.append("\n");            
+    }
+
+    /**
+     * Appends the .applications file entry of the given association, if it has 
+     * an "open" action.
+     */
+    private void appendDotApplicationsEntry(Association assoc, String[] openAction, 
+            StringBuffer content) {
+        if (openAction == null) {
+            return;
+        }
+
+        content.append(openAction[0] + "\n");
+        content.append("\t" + "command=" + openAction[1] + "\n");
+        content.append("\t" + "name=" + openAction[0] + "\n");
+        content.append("\t" + "can_open_multiple_files=false" + "\n");
+        content.append("\t" + "requires_terminal=false" + "\n");
+        content.append("\t" + "mime_types=" + assoc.getMimeType() + "\n");
+        content.append("\n");
+    }
+
+    /**
+     * Reads the whole content of the given file, or returns null if the file 
+     * doesn't exist.
+     *
+     * @throws IOException if the existing file fails to be read.
+     */
+    private String readFile(File file) throws IOException {
+        if (!file.exists()) {
+            return null;
+        }
+
+        Reader reader = null;
+        try {
+            reader = new BufferedReader(new FileReader(file));
+            StringBuffer content = new StringBuffer((int) file.length());
+            char[] buffer = new char[4096];
+            int count;
+            while ((count = reader.read(buffer)) != -1) {
+                content.append(buffer, 0, count);
             }
-            mBufferWriter.write("\t" + "ext: " + fileExtensionString + "\n");
-            mBufferWriter.write("\n");            
+            return content.toString();
         } catch (IOException e) {
-            throw new IOException("Write mime info to " + dotMimeFilePath + " failed.");
+            throw new IOException("Read mime info from " + file.getPath() + " failed.");
         } finally {
-            // No matter what happens, always close streams already opened.
-            if (mBufferWriter != null) {
+            if (reader != null) {
                 try {
-                   mBufferWriter.close();
+                    reader.close();
                 } catch (IOException e) {
                 }
             }
@@ -334,54 +408,72 @@ public class GnomeAppAssociationWriter implements AppAssociationWriter {
     }
 
     /**
-     * Writes association fields into specified .keys file, including mime type, and icon file, and action list.      
+     * Returns the new content of the given file in the pending changes, starting 
+     * with the current file content the first time the file is used.
      *
-     * @throws IOException if the given association info fails to be write to the given 
-     *         mime file.
+     * @param changes the pending changes, maps file paths to FileChange objects.
      */
-    private void writeDotKeysFile(Association assoc, String dotKeysFilePath) 
-        throws IOException {
-        // Create file first.
-        createFile(dotKeysFilePath);
-
-        String mimeType = assoc.getMimeType();
-        String description = assoc.getDescription();      
-        String iconFileName = assoc.getIconFileName();
-        
-        BufferedWriter kBufferWriter = null;
-        try {
-            // Appends new mime info into .keys file.
-            kBufferWriter = new BufferedWriter(new FileWriter(dotKeysFilePath, true));
-
-            kBufferWriter.write(mimeType + "\n");
-            if (description != null) {
-                kBufferWriter.write("\t"
-                        + GnomeAssociationUtil.GNOME_VFS_MIME_KEY_DESCRIPTION 
-                        + "=" + description + "\n");
+    private StringBuffer getNewContent(Map changes, String filePath) 
+            throws IOException {
+        FileChange change = (FileChange) changes.get(filePath);
+        if (change == null) {
+            change = new FileChange(new File(filePath));
+            change.oldContent = readFile(change.file);
+            change.newContent = new StringBuffer();
+            if (change.oldContent != null) {
+                change.newContent.append(change.oldContent);
             }
+            changes.put(filePath, change);
+        }
+        return change.newContent;
+    }
 
-            if (iconFileName != null) {
-                kBufferWriter.write("\t"
-                        + GnomeAssociationUtil.GNOME_VFS_MIME_KEY_ICON_FILENAME
-                        + "=" + iconFileName + "\n");
+    /**
+     * Checks whether the given .mime file content contains the specified mime type.
+     */
+    private boolean containsMimeType(CharSequence content, String mimeType) {
+        int lineStart = 0;
+        int length = content.length();
+        while (lineStart < length) {
+            int lineEnd = lineStart;
+            while (lineEnd < length && content.charAt(lineEnd) != '\n') {
+                lineEnd++;
             }
-
-            // Parse the given action list to get the application id and command.
-            parseOpenAction(assoc);
-            if (defaultAppID != null) {                
-                    kBufferWriter.write("\t" + "default_action_type=application" + "\n");
-                    kBufferWriter.write("\t" + "default_application_id=" + defaultAppID + "\n");
-                    kBufferWriter.write("\t" + "short_list_application_user_additions="  + defaultAppID + "\n");
+            if (lineEnd - lineStart == mimeType.length() 
+                    && content.subSequence(lineStart, lineEnd).toString().equals(mimeType)) {
+                return true;
             }
-            
-            kBufferWriter.write("\n");            
+            lineStart = lineEnd + 1;
+        }
+        return false;
+    }
+
+    /**
+     * Writes the given content to a temporary file in the directory of the target 
+     * file, and syncs it to disk.
+     *
+     * @return the written temporary file.
+     */
+    private File writeTempFile(File target, String content) throws IOException {
+        File tempFile = File.createTempFile("." + target.getName() + ".", 
+                ".tmp", target.getParentFile());
+        FileOutputStream out = null;
+        try {
+            out = new FileOutputStream(tempFile);
+            Writer writer = new BufferedWriter(new OutputStreamWriter(out));
+            writer.write(content);
+            writer.flush();
+            out.getFD().sync();
+            out.close();
+            out = null;
+            return tempFile;
         } catch (IOException e) {
-            throw new IOException("Write mime info to " + dotKeysFilePath + " failed.");
+            tempFile.delete();
+            throw new IOException("Write mime info to " + target.getPath() + " failed.");
         } finally {
-            // No matter what happens, always close streams already opened.
-            if (kBufferWriter != null) {
+            if (out != null) {
                 try {
-                   kBufferWriter.close();
+                    out.close();
                 } catch (IOException e) {
                 }
             }
@@ -389,70 +481,66 @@ public class GnomeAppAssociationWriter implements AppAssociationWriter {
     }
 
     /**
-     * Writes association fields into specified .applications file,
-     *  
-     * @throws IOException if the given association info fails to be write to the given 
-     *         mime file.
+     * Commits the pending changes. Each file is written once, into a temporary file 
+     * that replaces it by rename, so a file is never seen half written. If a file 
+     * fails to be replaced, the files already replaced are restored.
+     *
+     * @param changes the pending changes, maps file paths to FileChange objects.
+     * @throws IOException if the changes fail to be committed.
      */
-    private void writeDotApplicationsFile(Association assoc, String dotApplicationsFilePath) 
-        throws IOException {
-        // Create file first.
-        createFile(dotApplicationsFilePath);
-
-        BufferedWriter mBufferWriter = null;
+    private void commitChanges(Map changes) throws IOException {
+        List written = new ArrayList();
+        List committed = new ArrayList();
         try {
-            // Parse the given action list to get the application id and command.
-            parseOpenAction(assoc);
-            if (defaultAppID != null && defaultAppCommand != null) {
-                // Appends new mime info into .applications file.
-                mBufferWriter = new BufferedWriter(new FileWriter(dotApplicationsFilePath, true));
-
-                mBufferWriter.write(defaultAppID + "\n");
-                mBufferWriter.write("\t" + "command=" + defaultAppCommand + "\n");
-                mBufferWriter.write("\t" + "name=" + defaultAppID + "\n");
-                mBufferWriter.write("\t" + "can_open_multiple_files=false" + "\n");
-                mBufferWriter.write("\t" + "requires_terminal=false" + "\n");
-
-                String mimeType = assoc.getMimeType();
-                mBufferWriter.write("\t" + "mime_types=" + mimeType + "\n");
+            // Write all the temporary files before replacing any file.
+            Iterator iter = changes.values().iterator();
+            while (iter.hasNext()) {
+                FileChange change = (FileChange) iter.next();
+                change.tempFile = writeTempFile(change.file, change.newContent.toString());
+                written.add(change);
+            }
             
-                mBufferWriter.write("\n");
-            }            
+            iter = written.iterator();
+            while (iter.hasNext()) {
+                FileChange change = (FileChange) iter.next();
+                if (!change.tempFile.renameTo(change.file)) {
+                    throw new IOException("Replace " + change.file.getPath() + " failed.");
+                }
+                committed.add(change);
+            }
         } catch (IOException e) {
-            throw new IOException("Write mime info to " + dotApplicationsFilePath + " failed.");
+            rollbackChanges(committed);
+            throw e;
         } finally {
-            // No matter what happens, always close streams already opened.
-            if (mBufferWriter != null) {
-                try {
-                   mBufferWriter.close();
-                } catch (IOException e) {
+            Iterator iter = written.iterator();
+            while (iter.hasNext()) {
+                File tempFile = ((FileChange) iter.next()).tempFile;
+                if (tempFile.exists()) {
+                    tempFile.delete();
                 }
             }
         }
     }
-    
+
     /**
-     * Checks whether the specified .mime file contains the specified mime type.
+     * Restores the old content of the given, already replaced files as far as 
+     * possible. 
      */
-    private boolean dotMimeFileContainsMimeType(File dotMimeFile, String mimeType) {
-        boolean isMimeTypeExist = false;
-
-        try {
-            BufferedReader mBufferReader = new BufferedReader(new FileReader(dotMimeFile));
-            String oneLine;
-    
-            while ((oneLine = mBufferReader.readLine()) != null) {
-                if (mimeType.equals(oneLine)) {
-                    isMimeTypeExist = true;
-                    break;
+    private void rollbackChanges(List committed) {
+        Iterator iter = committed.iterator();
+        while (iter.hasNext()) {
+            FileChange change = (FileChange) iter.next();
+            if (change.oldContent == null) {
+                change.file.delete();
+            } else {
+                try {
+                    File tempFile = writeTempFile(change.file, change.oldContent);
+                    if (!tempFile.renameTo(change.file)) {
+                        tempFile.delete();
+                    }
+                } catch (IOException e) {
                 }
             }
-          
-            mBufferReader.close();
-            
-            return isMimeTypeExist;
-        } catch (IOException e) {
-            return false;
         }
     }
 
@@ -515,7 +603,13 @@ public class GnomeAppAssociationWriter implements AppAssociationWriter {
             if (assoc.getMimeType() == null) {
                 return true;
             } else {
-                return dotMimeFileContainsMimeType(dotMimeFile, assoc.getMimeType());
+                try {
+                    String content = readFile(dotMimeFile);
+                    return content != null 
+                            && containsMimeType(content, assoc.getMimeType());
+                } catch (IOException e) {
+                    return false;
+                }
             } 
         } else {
             return false;    
@@ -531,51 +625,80 @@ public class GnomeAppAssociationWriter implements AppAssociationWriter {
      * 
      * @param assoc the given association.
      * @param level the given registration level.
+     * @throws AssociationAlreadyRegisteredException if the mime type of the given
+     *         association is already in its .mime file.
      * @throws RegisterFailedException if the registration failed.
      */
     public void registerAssociation(Association assoc, int level) 
-        throws RegisterFailedException {
-        String dotMimeFilePath = null;
-        String dotKeysFilePath = null;
-        String dotApplicationsFilePath = null;
+        throws AssociationAlreadyRegisteredException, RegisterFailedException {
+        List assocList = new ArrayList(1);
+        assocList.add(assoc);
+        registerAssociations(assocList, level);
+    }
+
+    /**
+     * Registers the given associations in the specified level, as one transaction.
+     * <P>
+     * The entries of all the associations are collected first, and each .mime, .keys 
+     * and .applications file is then written once, atomically by renaming a temporary
+     * file over it. Either all the associations are registered or none. The MIME 
+     * database is reloaded once, after all the files are written.
+     * 
+     * @param assocList the given associations.
+     * @param level the given registration level.
+     * @throws AssociationAlreadyRegisteredException if the mime type of one of the 
+     *         given associations is already in its .mime file, or given twice.
+     * @throws RegisterFailedException if the registration failed.
+     */
+    public void registerAssociations(List assocList, int level) 
+        throws AssociationAlreadyRegisteredException, RegisterFailedException {
+        // Maps the file paths to the pending FileChange objects, in write order.
+        Map changes = new LinkedHashMap();
         
         try {
             if (level == SYSTEM_LEVEL) {
                 checkSystemMIMEDatabase();
-                
-                dotMimeFilePath = getSystemDotMimeFilePath(assoc);
-                dotKeysFilePath = getSystemDotKeysFilePath(assoc);
-                dotApplicationsFilePath = getSystemDotApplicationsFilePath(assoc);
-             } else {
+            } else {
                 checkUserMIMEDatabase();
-                
-                dotMimeFilePath = getUserDotMimeFilePath(assoc);
-                dotKeysFilePath = getUserDotKeysFilePath(assoc);
-                dotApplicationsFilePath = getUserDotApplicationsFilePath(assoc);
-             }
-             
-            // Create and write .mime file.
-            writeDotMimeFile(assoc, dotMimeFilePath);
-
-            // Create and write .keys file.
-            writeDotKeysFile(assoc, dotKeysFilePath);
-            
-            // Create and write .applications file.
-            writeDotApplicationsFile(assoc, dotApplicationsFilePath);
-        } catch (IOException e) {
-            // If there are errors, try to delete all the created mime files.
-            if (dotMimeFilePath != null ) {
-                (new File(dotMimeFilePath)).delete();
-            }
-            if (dotKeysFilePath != null) {
-                (new File(dotKeysFilePath)).delete();
             }
-            if (dotApplicationsFilePath != null) {
-                (new File(dotApplicationsFilePath)).delete();
+
+            Iterator iter = assocList.iterator();
+            while (iter.hasNext()) {
+                Association assoc = (Association) iter.next();
+                String dotMimeFilePath = null;
+                String dotKeysFilePath = null;
+                String dotApplicationsFilePath = null;
+                if (level == SYSTEM_LEVEL) {
+                    dotMimeFilePath = getSystemDotMimeFilePath(assoc);
+                    dotKeysFilePath = getSystemDotKeysFilePath(assoc);
+                    dotApplicationsFilePath = getSystemDotApplicationsFilePath(assoc);
+                } else {
+                    dotMimeFilePath = getUserDotMimeFilePath(assoc);
+                    dotKeysFilePath = getUserDotKeysFilePath(assoc);
+                    dotApplicationsFilePath = getUserDotApplicationsFilePath(assoc);
+                }
+
+                StringBuffer dotMimeContent = getNewContent(changes, dotMimeFilePath);
+                if (containsMimeType(dotMimeContent, assoc.getMimeType())) {
+                    throw new AssociationAlreadyRegisteredException("Assocation already " 
+                            + "exists: " + assoc.getName() + " " + assoc.getMimeType());
+                }
+                
+                String[] openAction = parseOpenAction(assoc);
+                appendDotMimeEntry(assoc, dotMimeContent);
+                appendDotKeysEntry(assoc, openAction, 
+                        getNewContent(changes, dotKeysFilePath));
+                appendDotApplicationsEntry(assoc, openAction, 
+                        getNewContent(changes, dotApplicationsFilePath));
             }
-            
+
+            commitChanges(changes);
+        } catch (IOException e) {
             throw new RegisterFailedException(e.getMessage());
         }
+
+        GnomeVfsWrapper.reloadMimeDatabase();
+        GnomeMimeDatabase.invalidate();
     }
   
     /**
@@ -586,34 +709,69 @@ public class GnomeAppAssociationWriter implements AppAssociationWriter {
      * 
      * @param assoc the given association.
      * @param level the given unregistration level.     
+     * @throws AssociationNotRegisteredException if the given association doesn't exist.
      * @throws RegisterFailedException if the unregistration failed.     
      */
-    public void unregisterAssociation(Association assoc, int level) throws RegisterFailedException {
-        String dotMimeFilePath = null;
-        String dotKeysFilePath = null;
-        String dotApplicationsFilePath = null;
-                
+    public void unregisterAssociation(Association assoc, int level) 
+        throws AssociationNotRegisteredException, RegisterFailedException {
+        List assocList = new ArrayList(1);
+        assocList.add(assoc);
+        unregisterAssociations(assocList, level);
+    }
+
+    /**
+     * Unregisters the given associations in the specified level.
+     * <P>
+     * All the associations are checked to exist before any file is removed, and the
+     * MIME database is reloaded once, after all the files are removed.
+     * 
+     * @param assocList the given associations.
+     * @param level the given unregistration level.     
+     * @throws AssociationNotRegisteredException if one of the given associations 
+     *         doesn't exist.
+     * @throws RegisterFailedException if the unregistration failed.     
+     */
+    public void unregisterAssociations(List assocList, int level) 
+        throws AssociationNotRegisteredException, RegisterFailedException {
+        // The files to remove, each one only once.
+        Set files = new LinkedHashSet();
+        
         try {
             if (level == SYSTEM_LEVEL) {
                 checkSystemMIMEDatabase();
-                
-                dotMimeFilePath = getSystemDotMimeFilePath(assoc);
-                dotKeysFilePath = getSystemDotKeysFilePath(assoc);
-                dotApplicationsFilePath = getSystemDotApplicationsFilePath(assoc);
-             } else {
+            } else {
                 checkUserMIMEDatabase();
-                
-                dotMimeFilePath = getUserDotMimeFilePath(assoc);
-                dotKeysFilePath = getUserDotKeysFilePath(assoc);
-                dotApplicationsFilePath = getUserDotApplicationsFilePath(assoc);
-             }
-
-            // Delete the mime files.
-            (new File(dotMimeFilePath)).delete();
-            (new File(dotKeysFilePath)).delete();
-            (new File(dotApplicationsFilePath)).delete();                        
+            }
         } catch (IOException e) {
             throw new RegisterFailedException(e.getMessage());
         }
+
+        Iterator iter = assocList.iterator();
+        while (iter.hasNext()) {
+            Association assoc = (Association) iter.next();
+            if (!isAssociationExist(assoc, level)) {
+                throw new AssociationNotRegisteredException("Assocation not exists: " 
+                        + assoc.getName());
+            }
+
+            if (level == SYSTEM_LEVEL) {
+                files.add(getSystemDotMimeFilePath(assoc));
+                files.add(getSystemDotKeysFilePath(assoc));
+                files.add(getSystemDotApplicationsFilePath(assoc));
+            } else {
+                files.add(getUserDotMimeFilePath(assoc));
+                files.add(getUserDotKeysFilePath(assoc));
+                files.add(getUserDotApplicationsFilePath(assoc));
+            }
+        }
+
+        // Delete the mime files.
+        iter = files.iterator();
+        while (iter.hasNext()) {
+            (new File((String) iter.next())).delete();
+        }
+
+        GnomeVfsWrapper.reloadMimeDatabase();
+        GnomeMimeDatabase.invalidate();
     }
-}
\ No newline at end of file
+}
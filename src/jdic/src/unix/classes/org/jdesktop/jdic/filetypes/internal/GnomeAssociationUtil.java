@@ -47,31 +47,7 @@ public class GnomeAssociationUtil {
      *
      */
     public static String getMimeTypeByFileExt(String fileExt) {
-        String resultMimeType = null;
-        String[] allMimeTypes = GnomeVfsWrapper.gnome_vfs_get_registered_mime_types();
-
-        if (allMimeTypes == null) {
-            return null;
-        } 
-
-        for (int i = 0; i < allMimeTypes.length; i++) {
-            String curMimeType = allMimeTypes[i];
-            String[] fileExtensions = GnomeVfsWrapper.gnome_vfs_mime_get_extensions_list(curMimeType);
-
-            if (fileExtensions != null) {
-                for (int j = 0; j < fileExtensions.length; j++) {
-                    if (fileExtensions[j].equals(fileExt)) {
-                        resultMimeType = allMimeTypes[i];
-                        break;
-                    }
-                }
-            }
-            if (resultMimeType != null) { 
-                break;
-            }
-        }
-
-        return resultMimeType;
+        return GnomeVfsWrapper.getMimeTypeByExtension(fileExt);
     }
   
     /**
@@ -80,7 +56,7 @@ public class GnomeAssociationUtil {
      * @param mimeType Given mime type
      */
     public static List getFileExtListByMimeType(String mimeType) {
-        String[] fileExtensions = GnomeVfsWrapper.gnome_vfs_mime_get_extensions_list(mimeType);
+        String[] fileExtensions = GnomeVfsWrapper.getExtensionsByMimeType(mimeType);
 
         if (fileExtensions == null) {
             return null;
@@ -100,6 +76,11 @@ public class GnomeAssociationUtil {
      *
      */
     public static String getIconFileNameByMimeType(String mimeType) {
+        GnomeMimeDatabase.Entry entry 
+                = GnomeMimeDatabase.getInstance().getEntry(mimeType);
+        if (entry != null) {
+            return entry.iconFileName;
+        }
         return GnomeVfsWrapper.gnome_vfs_mime_get_icon(mimeType);
     }
   
@@ -110,6 +91,11 @@ public class GnomeAssociationUtil {
      * @return String
      */
     public static String getDescriptionByMimeType(String mimeType) {
+        GnomeMimeDatabase.Entry entry 
+                = GnomeMimeDatabase.getInstance().getEntry(mimeType);
+        if (entry != null) {
+            return entry.description;
+        }
         return GnomeVfsWrapper.gnome_vfs_mime_get_description(mimeType);
     }
 
@@ -150,11 +136,18 @@ public class GnomeAssociationUtil {
          
         // Get the default/first available application's command to construct an "open" action.
         // Which will be used by upper level launcher code.
-        String defaultCmd = GnomeVfsWrapper.gnome_vfs_mime_get_default_application_command(mimeType);
+        String defaultCmd;
+        GnomeMimeDatabase.Entry entry 
+                = GnomeMimeDatabase.getInstance().getEntry(mimeType);
+        if (entry != null) {
+            defaultCmd = entry.defaultCommand;
+        } else {
+            defaultCmd = GnomeVfsWrapper.gnome_vfs_mime_get_default_application_command(mimeType);
+        }
         if (defaultCmd != null) {
             actionList.add(new Action("open", defaultCmd));
         }
-      
+
         if (actionList.isEmpty()) {
             return null;
         } else {
@@ -172,27 +165,26 @@ public class GnomeAssociationUtil {
         return GnomeVfsWrapper.gnome_vfs_get_mime_type(url.toString());
     }
 
+    /**
+     * Returns the mime types associated with the given URLs, by checking the content 
+     * of the URLs one by one. The native shared MIME-info sniffer, which checks 
+     * local files in parallel, is used by XdgAppAssociationReader instead.
+     */
+    public static String[] getMimeTypesByURLs(URL[] urls, int threadCount) {
+        String[] mimeTypes = new String[urls.length];
+        for (int i = 0; i < urls.length; i++) {
+            mimeTypes[i] = getMimeTypeByURL(urls[i]);
+        }
+        return mimeTypes;
+    }
+
     /**
      * Returns true if the given mime type exists in the GnomeVFS MIME database.
      */
     public static boolean isMimeTypeExist(String mimeType) {
         // Check that the mime type is known and not deleted.
-        boolean isMimeTypeExist = false;
-        String[] allMimeTypes = GnomeVfsWrapper.gnome_vfs_get_registered_mime_types();
-
-        if (allMimeTypes == null) {
-            return false;
-        }
-
-        for (int i = 0; i < allMimeTypes.length; i++) {
-            if (mimeType.equals(allMimeTypes[i])) {
-                isMimeTypeExist = true;
-                break;
-            }
-        }
-
-        return isMimeTypeExist;
-}               
+        return GnomeMimeDatabase.getInstance().getEntry(mimeType) != null;
+    }               
 
     /**
      * Returns true if the given file extension exists in the GnomeVFS MIME database.
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */ 
+
+package org.jdesktop.jdic.filetypes.internal;
+
+import java.util.HashMap;
+import java.util.Map;
+
+
+/**
+ * A copy of the GnomeVFS MIME database, fetched with a single JNI call 
+ * and fetched again once the native side reports that the MIME database 
+ * files have changed. The native side is asked at most once every 
+ * CHECK_INTERVAL milliseconds.
+ */
+class GnomeMimeDatabase {
+    // the same interval the native side checks the MIME database files at.
+    private final static long CHECK_INTERVAL = 5000;
+
+    /**
+     * The MIME database information of one mime type. 
+     */
+    static class Entry {
+        String description;
+        String iconFileName;
+        String[] extensions;
+        String defaultCommand;
+    }
+
+    private static GnomeMimeDatabase current;
+
+    // when the native version was last checked.
+    private static long checked;
+
+    private long version;
+
+    // mime type -> Entry
+    private Map entries = new HashMap();
+
+    private GnomeMimeDatabase(long version, Object[] database) {
+        this.version = version;
+        // Parallel arrays of the mime types, descriptions, icon file names, 
+        // extensions and default application commands.
+        String[] mimeTypes = (String[]) database[0];
+        String[] descriptions = (String[]) database[1];
+        String[] iconFileNames = (String[]) database[2];
+        String[][] extensions = (String[][]) database[3];
+        String[] defaultCommands = (String[]) database[4];
+
+        for (int i = 0; i < mimeTypes.length; i++) {
+            Entry entry = new Entry();
+            entry.description = descriptions[i];
+            entry.iconFileName = iconFileNames[i];
+            entry.extensions = extensions[i];
+            entry.defaultCommand = defaultCommands[i];
+            entries.put(mimeTypes[i], entry);
+        }
+    }
+
+    /**
+     * Returns the current copy of the MIME database.
+     */
+    static synchronized GnomeMimeDatabase getInstance() {
+        long now = System.currentTimeMillis();
+        if (current != null && now - checked < CHECK_INTERVAL && now >= checked) {
+            return current;
+        }
+        checked = now;
+
+        long version = GnomeVfsWrapper.getMimeDatabaseVersion();
+        if (current == null || current.version != version) {
+            current = new GnomeMimeDatabase(version, 
+                    GnomeVfsWrapper.getMimeDatabase());
+        }
+        return current;
+    }
+
+    /**
+     * Makes the next getInstance() check the native version, after the MIME
+     * database was reloaded.
+     */
+    static synchronized void invalidate() {
+        checked = 0;
+    }
+
+    /**
+     * Returns the information of the given mime type, or null if it's not
+     * registered.
+     */
+    Entry getEntry(String mimeType) {
+        return (Entry) entries.get(mimeType);
+    }
+}
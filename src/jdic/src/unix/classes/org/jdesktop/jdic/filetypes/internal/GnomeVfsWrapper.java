@@ -187,6 +187,47 @@ public class GnomeVfsWrapper {
      */
     public static native String[] gnome_vfs_mime_get_extensions_list(String mimeType);
   
+    /**
+     * Returns the mime type the given file extension is registered for, or 
+     * null. The lookup uses an index of the MIME database kept in native 
+     * code, shared by all threads and rebuilt when the MIME database files 
+     * change. If the extension is registered for several mime types, the 
+     * first one returned by gnome_vfs_get_registered_mime_types() is used.
+     * <PRE>
+     * For example:
+     *     for html, returns text/html.
+     * </PRE>
+     */
+    public static native String getMimeTypeByExtension(String fileExt);
+
+    /**
+     * Returns the extensions of the given mime type like 
+     * gnome_vfs_mime_get_extensions_list(), using the same index as 
+     * getMimeTypeByExtension(), or null.
+     */
+    public static native String[] getExtensionsByMimeType(String mimeType);
+  
+    /**
+     * Returns the version of the MIME database index kept in native code, 
+     * which changes whenever the index is rebuilt because the MIME database
+     * files have changed.
+     */
+    public static native long getMimeDatabaseVersion();
+
+    /**
+     * Makes GnomeVFS reread the MIME database files and rebuilds the index
+     * right away, instead of on the next periodic check.
+     */
+    public static native void reloadMimeDatabase();
+
+    /**
+     * Returns the whole MIME database at once, as parallel arrays of the 
+     * registered mime types (String[]), their descriptions (String[]), 
+     * icon file names (String[]), extensions (String[][]) and default 
+     * application commands (String[]). Missing values are null.
+     */
+    public static native Object[] getMimeDatabase();
+  
     /**
      * Return the value of the specified environment variable, or NULL if there is no match.
      * This method is not related with Gnome VFS API or library.
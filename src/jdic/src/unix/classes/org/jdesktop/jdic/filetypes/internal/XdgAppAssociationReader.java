@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */ 
+
+package org.jdesktop.jdic.filetypes.internal;
+
+import java.io.File;
+import java.net.URL;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import org.jdesktop.jdic.filetypes.Action;
+
+
+/**
+ * Concrete implementation of the AppAssociationReader class reading the 
+ * freedesktop.org shared MIME-info database directly, without GnomeVFS.
+ * <P>
+ * Icons are returned as icon names of the freedesktop.org icon naming 
+ * specification, like text-html, rather than file names.
+ */
+public class XdgAppAssociationReader implements AppAssociationReader {
+    // mime type -> description, dropped when the MIME database is reloaded.
+    private Map descriptions = new HashMap();
+    private long descriptionsVersion = -1;
+
+    /**
+     * Returns the description associated with the given mime type.
+     *
+     * @param mimeType Given mime type
+     * @return String
+     */
+    public String getDescriptionByMimeType(String mimeType) {
+        synchronized (descriptions) {
+            long version = XdgMimeWrapper.getDatabaseVersion();
+            if (version != descriptionsVersion) {
+                descriptions.clear();
+                descriptionsVersion = version;
+            }
+            if (descriptions.containsKey(mimeType)) {
+                return (String) descriptions.get(mimeType);
+            }
+        }
+
+        String description = XdgMimeWrapper.getDescription(mimeType);
+        synchronized (descriptions) {
+            descriptions.put(mimeType, description);
+        }
+        return description;
+    }
+  
+    /**
+     * Returns the description associated with the given file extension.
+     *
+     * @param fileExt Given file extension
+     * @return String
+     */
+    public String getDescriptionByFileExt(String fileExt) {
+        String mimeType = getMimeTypeByFileExt(fileExt);
+        if (mimeType == null) {
+            return null;
+        } else {
+            return getDescriptionByMimeType(mimeType);
+        }
+    }
+
+    /**
+     * Returns the mime type associated with the given URL. Local files are 
+     * checked by their name and content, other URLs by the file name only.
+     *
+     * @param url The specified URL
+     * @return String
+     */
+    public String getMimeTypeByURL(URL url) {
+        File file = AppUtility.getFileByURL(url);
+        if (file != null) {
+            return XdgMimeWrapper.getMimeTypeByFile(file.getPath());
+        }
+        return getMimeTypeByFileName(url);
+    }        
+
+    /**
+     * Returns the mime types associated with the given URLs. Local files are
+     * checked in parallel, in a single native call.
+     *
+     * @param urls The specified URLs
+     * @param threadCount The most threads to use, 0 for one per processor
+     * @return String[]
+     */
+    public String[] getMimeTypesByURLs(URL[] urls, int threadCount) {
+        String[] mimeTypes = new String[urls.length];
+        String[] paths = new String[urls.length];
+        int fileCount = 0;
+
+        for (int i = 0; i < urls.length; i++) {
+            File file = AppUtility.getFileByURL(urls[i]);
+            if (file != null) {
+                paths[i] = file.getPath();
+                fileCount++;
+            } else {
+                mimeTypes[i] = getMimeTypeByFileName(urls[i]);
+            }
+        }
+
+        if (fileCount > 0) {
+            String[] fileMimeTypes = XdgMimeWrapper.getMimeTypesByFiles(paths, threadCount);
+            for (int i = 0; i < urls.length; i++) {
+                if (paths[i] != null) {
+                    mimeTypes[i] = fileMimeTypes[i];
+                }
+            }
+        }
+        return mimeTypes;
+    }
+
+    /**
+     * Returns the mime type of the file name part of the given URL.
+     */
+    private String getMimeTypeByFileName(URL url) {
+        String path = url.getPath();
+        String fileName = path.substring(path.lastIndexOf('/') + 1);
+        if (fileName.length() == 0) {
+            return null;
+        }
+        return XdgMimeWrapper.getMimeTypeByFileName(fileName);
+    }
+
+    /**
+     * Returns the file extensione list associated with the given mime type.
+     *
+     * @param mimeType Given mime type
+     * @return String
+     */
+    public List getFileExtListByMimeType(String mimeType) {
+        String[] fileExtensions = XdgMimeWrapper.getExtensionsByMimeType(mimeType);
+
+        if (fileExtensions == null) {
+            return null;
+        } else {
+            // All returned file extensions has no leading "." character.
+            List fileExtList = new ArrayList();
+            for (int index = 0; index < fileExtensions.length; index++) {
+                fileExtList.add(fileExtensions[index]);
+            }
+            
+            return fileExtList;
+        }
+    }
+  
+    /**
+     * Returns the mime type associated with the given file extension.
+     *
+     * @param fileExt Given file extension
+     * @return String
+     */
+    public String getMimeTypeByFileExt(String fileExt) {
+        // Removes the leading '.' character from the file extension if exists.
+        fileExt = AppUtility.removeDotFromFileExtension(fileExt);        
+        return XdgMimeWrapper.getMimeTypeByExtension(fileExt);
+    }
+  
+    /**
+     * Returns the icon name associated with the given mime type. If the 
+     * MIME database sets none, the icon name is derived from the mime type
+     * as the icon naming specification suggests, e.g. text-html for 
+     * text/html.
+     *
+     * @param mimeType Given mime type.
+     * @return String
+     */
+    public String getIconFileNameByMimeType(String mimeType) {
+        if (!isMimeTypeExist(mimeType)) {
+            return null;
+        }
+        String iconName = XdgMimeWrapper.getIconName(mimeType);
+        if (iconName == null) {
+            iconName = XdgMimeWrapper.unaliasMimeType(mimeType).replace('/', '-');
+        }
+        return iconName;
+    }
+  
+    /**
+     * Returns the icon name associated with the given file extension.
+     *
+     * @param fileExt Given file extension.
+     * @return String
+     */
+    public String getIconFileNameByFileExt(String fileExt) {
+        String mimeType = getMimeTypeByFileExt(fileExt);
+        if (mimeType == null) {
+            return null;
+        } else {       
+            return getIconFileNameByMimeType(mimeType);
+        }
+    }
+ 
+    /**
+     * Returns the action list associated with the given mime type. The 
+     * default application gives the "open" action, the other applications 
+     * give actions named by their desktop file ids.
+     *
+     * @param mimeType the given mime type.
+     * @return List the action list associated with the given mime type.
+     */
+    public List getActionListByMimeType(String mimeType) {
+        return getActionList(XdgMimeWrapper.getApplicationEntries(mimeType));
+    }
+
+    /**
+     * Creates the action list from the entries returned by 
+     * XdgMimeWrapper.getApplicationEntries(), or returns null if there are
+     * none.
+     */
+    private static List getActionList(String[] entries) {
+        if (entries == null) {
+            return null;
+        }
+
+        List actionList = new ArrayList();
+        for (int i = 0; i + 2 < entries.length; i += 3) {
+            String desktopId = entries[i];
+            String verb;
+            if (actionList.isEmpty()) {
+                verb = "open";
+            } else if (desktopId.endsWith(".desktop")) {
+                verb = desktopId.substring(0, 
+                        desktopId.length() - ".desktop".length());
+            } else {
+                verb = desktopId;
+            }
+            actionList.add(new Action(verb, stripFieldCodes(entries[i + 2]), 
+                                      entries[i + 1]));
+        }
+
+        if (actionList.isEmpty()) {
+            return null;
+        } else {
+            return actionList;
+        }
+    }
+
+    /**
+     * Removes the field codes, like %f or %U, from the Exec key of a desktop
+     * entry, as the file is appended to the command of an action when it's 
+     * launched. Arguments made of field codes only are removed entirely.
+     */
+    private static String stripFieldCodes(String exec) {
+        StringBuffer command = new StringBuffer();
+        int argStart = -1;          // where the current argument starts
+        boolean argHasText = false; // if it has more than field codes
+        boolean quoted = false;
+
+        for (int i = 0; i < exec.length(); i++) {
+            char c = exec.charAt(i);
+            if (!quoted && Character.isWhitespace(c)) {
+                if (argStart >= 0 && !argHasText) {
+                    command.setLength(argStart);
+                }
+                argStart = -1;
+                continue;
+            }
+            if (argStart < 0) {
+                argStart = command.length();
+                argHasText = false;
+                if (argStart > 0) {
+                    command.append(' ');
+                }
+            }
+
+            if (c == '"') {
+                quoted = !quoted;
+                command.append(c);
+            } else if (c == '\\' && quoted && i + 1 < exec.length()) {
+                command.append(c).append(exec.charAt(++i));
+                argHasText = true;
+            } else if (c == '%' && i + 1 < exec.length()) {
+                if (exec.charAt(++i) == '%') {
+                    command.append('%');
+                    argHasText = true;
+                }
+            } else {
+                command.append(c);
+                argHasText = true;
+            }
+        }
+        if (argStart >= 0 && !argHasText) {
+            command.setLength(argStart);
+        }
+
+        return command.toString();
+    }
+
+    /**
+     * Returns the action list associated with the given file extension.
+     *
+     * @param fileExt the given file extension.
+     * @return List the action list associated with the given file extension.
+     */
+    public List getActionListByFileExt(String fileExt) {
+        String mimeType = getMimeTypeByFileExt(fileExt);
+        if (mimeType == null) {
+            return null;
+        } else {
+            return getActionListByMimeType(mimeType);        
+        }
+    }
+
+    /**
+     * Returns true if the mime type exists in the MIME database.
+     *
+     * @param mimeType given mimeType
+     * @return true if the mime type exists in the MIME database
+     */
+    public boolean isMimeTypeExist(String mimeType) {
+        return XdgMimeWrapper.isMimeTypeKnown(mimeType);
+    }
+    
+    /**
+     * Returns true if the file extension exists in the MIME database.
+     * 
+     * @param fileExt given file extension 
+     * @return true if the file extension exists in the MIME database
+     */
+    public boolean isFileExtExist(String fileExt) {
+        return getMimeTypeByFileExt(fileExt) != null;
+    }
+
+    /**
+     * Returns true, as the native MIME database is guarded by a read/write 
+     * lock.
+     *
+     * @return true
+     */
+    public boolean isThreadSafe() {
+        return true;
+    }
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */ 
+
+package org.jdesktop.jdic.filetypes.internal;
+
+
+/**
+ * Java wrapper class for the native reader of the freedesktop.org shared 
+ * MIME-info database, used on desktops without GnomeVFS.
+ * <P>
+ * The database is read from the mime/mime.cache, mime/types and 
+ * mime/&lt;media&gt;/&lt;subtype&gt;.xml files under $XDG_DATA_HOME and 
+ * $XDG_DATA_DIRS, as written by update-mime-database. The mime.cache files
+ * are mapped into memory and searched in place, and reloaded when they 
+ * change. The applications for a mime type come from a catalog of all the 
+ * .desktop files in the applications dirs and the rules of the 
+ * mimeapps.list and defaults.list files, which is read once and reloaded 
+ * when inotify reports a change. No daemon or GConf is used.
+ * <P>
+ * The catalog is kept in $XDG_CACHE_HOME/jdic/applications.cache across 
+ * processes, unless the system property 
+ * <code>org.jdesktop.jdic.filetypes.cache</code> is set to "false".
+ */
+public class XdgMimeWrapper {
+    /* The system property disabling the application catalog cache file */
+    public final static String CACHE_PROPERTY 
+            = "org.jdesktop.jdic.filetypes.cache";
+
+    static {
+        System.loadLibrary("jdic");
+
+        String cache = null;
+        try {
+            cache = System.getProperty(CACHE_PROPERTY);
+        } catch (SecurityException e) {
+            // Use the cache file.
+        }
+        setCacheEnabled(!"false".equalsIgnoreCase(cache));
+    }
+
+    /**
+     * Suppress default constructor for noninstantiability.
+     */
+    private XdgMimeWrapper() {}
+
+    /**
+     * Sets whether the application catalog is read from and written to the 
+     * cache file.
+     */
+    private static native void setCacheEnabled(boolean enabled);
+
+    /**
+     * Returns true if a mime.cache file was found in the data dirs.
+     */
+    public static native boolean isAvailable();
+
+    /**
+     * Returns a number which changes each time the MIME database files are
+     * reloaded.
+     */
+    public static native long getDatabaseVersion();
+
+    /**
+     * Returns the mime type of the given file name, found by the literal 
+     * file names and glob patterns of the MIME database, or null.
+     * <PRE>
+     * For example:
+     *     for Makefile, returns text/x-makefile.
+     *     for index.html, returns text/html.
+     * </PRE>
+     */
+    public static native String getMimeTypeByFileName(String fileName);
+
+    /**
+     * Returns the mime type of the given file, detected by its name and 
+     * the magic rules of the MIME database matched against the start of 
+     * its content, or null.
+     * <PRE>
+     * For example:
+     *     for a PNG image named picture, returns image/png.
+     *     for a directory, returns inode/directory.
+     * </PRE>
+     */
+    public static native String getMimeTypeByFile(String path);
+
+    /**
+     * Returns the mime types of the given files, as getMimeTypeByFile does,
+     * detected in parallel by the given number of threads, or one thread 
+     * per processor if it's not positive. The returned array has an 
+     * element, possibly null, for each file.
+     */
+    public static native String[] getMimeTypesByFiles(String[] paths, 
+            int threadCount);
+
+    /**
+     * Returns the mime type the given file extension is registered for, 
+     * or null. The extension has no leading '.' character.
+     */
+    public static native String getMimeTypeByExtension(String fileExt);
+
+    /**
+     * Returns the file extensions registered for the given mime type, with 
+     * no leading '.' character, or null.
+     */
+    public static native String[] getExtensionsByMimeType(String mimeType);
+
+    /**
+     * Returns the canonical name of the given mime type, or the mime type 
+     * itself if it's not an alias.
+     * <PRE>
+     * For example:
+     *     for application/x-pdf, returns application/pdf.
+     * </PRE>
+     */
+    public static native String unaliasMimeType(String mimeType);
+
+    /**
+     * Returns true if the given mime type, or alias, is registered.
+     */
+    public static native boolean isMimeTypeKnown(String mimeType);
+
+    /**
+     * Returns the icon name, following the freedesktop.org icon naming 
+     * specification, set for the given mime type, or null.
+     */
+    public static native String getIconName(String mimeType);
+
+    /**
+     * Returns the description of the given mime type in the language of 
+     * the current locale, or null.
+     */
+    public static native String getDescription(String mimeType);
+
+    /**
+     * Returns the desktop file ids of the applications for the given mime 
+     * type, the default application first, or null.
+     * <PRE>
+     * For example:
+     *     for text/plain, returns gedit.desktop, vim.desktop.
+     * </PRE>
+     */
+    public static native String[] getApplications(String mimeType);
+
+    /**
+     * Returns the desktop file id, the localized name and the command line
+     * of each installed application for the given mime type, the default
+     * application first, in one array of three strings per application, or
+     * null.
+     */
+    public static native String[] getApplicationEntries(String mimeType);
+
+    /**
+     * Returns the localized name and the command line (the Exec key) of the
+     * application with the given desktop file id, or null if the 
+     * application isn't installed.
+     */
+    public static native String[] getDesktopEntry(String desktopId);
+}
@@ -20,12 +20,10 @@
 
 #include <jni.h>
 #include "GnomeBrowserService.h"
+#include "GnomeSettings.h"
 #include <string.h>
 
 #include <libgnome/libgnome.h>
-#include <gconf/gconf-client.h>
-  
-#define GCONF_URL_HANDLER_PATH "/desktop/gnome/url-handlers/"
 
 JNIEXPORT jboolean JNICALL Java_org_jdesktop_jdic_desktop_internal_impl_GnomeBrowserService_nativeBrowseURL
   (JNIEnv *env, jobject obj, jstring url) 
@@ -35,13 +33,9 @@ JNIEXPORT jboolean JNICALL Java_org_jdesktop_jdic_desktop_internal_impl_GnomeBro
     char *command = NULL;
     gboolean result;
 
-    g_type_init();
-    GConfClient *client = gconf_client_get_default ();
-    char *schemes[2] = {"http", "unknown"};
-    char *path;
-    for (int i = 0; i < sizeof(schemes); i++) {
-        path = g_strconcat (GCONF_URL_HANDLER_PATH, schemes[i], "/command", NULL);
-        command = gconf_client_get_string (client, path, NULL);
+    const char *schemes[2] = {"http", "unknown"};
+    for (int i = 0; i < 2; i++) {
+        command = GetUrlHandlerCommand(schemes[i]);
         if (command != NULL) {
             break;
         }
@@ -74,7 +68,9 @@ JNIEXPORT jboolean JNICALL Java_org_jdesktop_jdic_desktop_internal_impl_GnomeBro
                                     NULL,
                                     NULL,
                                     NULL);
+            g_strfreev (argv);
         }
+        g_free (command);
     }
 
     env->ReleaseStringUTFChars(url, urlStr);
@@ -20,30 +20,28 @@
  
 #include <jni.h>
 #include "GnomeUtility.h"
+#include "GnomeSettings.h"
 #include <stdio.h>
 #include <stdlib.h>
 
 #include <glib.h>
-#include <gconf/gconf-client.h>
   
-#define GCONF_URL_HANDLER_PATH "/desktop/gnome/url-handlers/"
 #define SCHEME "mailto"
 
 JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_desktop_internal_impl_GnomeUtility_nativeGetDefaultMailerPath
   (JNIEnv *env, jclass obj) {
-    g_type_init();
-    GConfClient *client = gconf_client_get_default ();
-    char* path = g_strconcat (GCONF_URL_HANDLER_PATH, SCHEME, "/command", NULL);
-    char* command = gconf_client_get_string (client, path, NULL);
+    char* command = GetUrlHandlerCommand(SCHEME);
 
-    char* mailerPathStr = NULL;
+    jstring mailerPath = NULL;
     if (command != NULL) {
         char **argv;
         int argc;
         if (g_shell_parse_argv (command, &argc, &argv, NULL)) {
-            mailerPathStr = argv[0];
+            mailerPath = env->NewStringUTF(argv[0]);
+            g_strfreev(argv);
         }
+        g_free(command);
     }
 
-    return (mailerPathStr == NULL) ? NULL : env->NewStringUTF(mailerPathStr);
+    return mailerPath;
 }
@@ -22,15 +22,277 @@
 #include "GnomeVfsWrapper.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
 #include <libgnomevfs/gnome-vfs-init.h>
 #include <libgnomevfs/gnome-vfs-mime.h>
 #include <libgnomevfs/gnome-vfs-mime-handlers.h>
 #include <libgnomevfs/gnome-vfs-mime-info.h>
+
+// the interval in seconds between the checks whether the MIME database 
+// files have changed, the same as GnomeVFS uses to reload them.
+#define MIME_DB_CHECK_INTERVAL 5
+
+// Index of the MIME database: file extension -> MIME type, and MIME type
+// -> NULL terminated file extension array. An extension registered for 
+// several MIME types maps to the first one GnomeVFS reports.
+struct MimeIndex {
+  GHashTable *extToMimeType;
+  GHashTable *mimeTypeToExts;
+  // all the registered MIME types, in the order GnomeVFS reports them.
+  GPtrArray *mimeTypes;
+  // tells the Java side when to refresh its copy of the MIME database.
+  jlong version;
+  int refs;
+};
+
+// The current index, built on the first lookup, shared by all the threads,
+// and rebuilt when the MIME database files change. The files are checked 
+// and the index is built by one thread at a time, without holding 
+// gMimeIndexMutex, which only guards swapping the new index in. A thread 
+// that is still using the old index holds a reference to it.
+static MimeIndex *gMimeIndex = NULL;
+static unsigned long gMimeDbStamp = 0;
+static time_t gMimeDbChecked = 0;
+static bool gMimeDbChecking = false;
+static jlong gMimeIndexVersion = 0;
+static pthread_mutex_t gMimeIndexMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gMimeIndexCond = PTHREAD_COND_INITIALIZER;
+
+static pthread_once_t gGnomeVfsInitOnce = PTHREAD_ONCE_INIT;
+
+extern "C" {
+static void DoInitGnomeVfs() {
+  gnome_vfs_init();
+}
+}
+
+// Initializes GnomeVFS on the first call of any native method.
+static void InitGnomeVfs() {
+  pthread_once(&gGnomeVfsInitOnce, DoInitGnomeVfs);
+}
+
+// Folds the modification time and size of the given file, or of the given
+// directory and the files in it, into the stamp.
+static void AddMimeDbStamp(const char *path, unsigned long *stamp) {
+  struct stat st;
+  if (stat(path, &st) != 0) {
+    return;
+  }
+  *stamp = *stamp * 31 + (unsigned long)st.st_mtime;
+  *stamp = *stamp * 31 + (unsigned long)st.st_size;
+
+  if (S_ISDIR(st.st_mode)) {
+    DIR *dir = opendir(path);
+    if (dir == NULL) {
+      return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+      if (entry->d_name[0] == '.') {
+        continue;
+      }
+      gchar *file = g_build_filename(path, entry->d_name, NULL);
+      if (stat(file, &st) == 0) {
+        *stamp = *stamp * 31 + (unsigned long)st.st_mtime;
+        *stamp = *stamp * 31 + (unsigned long)st.st_size;
+      }
+      g_free(file);
+    }
+    closedir(dir);
+  }
+}
+
+// Adds the MIME database files under the given data directory.
+static void AddMimeDbDataDir(const char *dataDir, unsigned long *stamp) {
+  gchar *path = g_build_filename(dataDir, "mime-info", NULL);
+  AddMimeDbStamp(path, stamp);
+  g_free(path);
+  path = g_build_filename(dataDir, "mime", "globs", NULL);
+  AddMimeDbStamp(path, stamp);
+  g_free(path);
+  path = g_build_filename(dataDir, "application-registry", NULL);
+  AddMimeDbStamp(path, stamp);
+  g_free(path);
+}
+
+// Returns a stamp of the files GnomeVFS reads the MIME database from: the
+// mime-info and application-registry directories of GnomeVFS, and the 
+// shared MIME info globs used by newer GnomeVFS releases.
+static unsigned long GetMimeDbStamp() {
+  unsigned long stamp = 0;
+  const char *home = g_get_home_dir();
+  const char *gnomeDir = getenv("GNOMEDIR");
+  const char *dataHome = getenv("XDG_DATA_HOME");
+  const char *dataDirs = getenv("XDG_DATA_DIRS");
+
+  if (gnomeDir != NULL) {
+    gchar *path = g_build_filename(gnomeDir, "share", NULL);
+    AddMimeDbDataDir(path, &stamp);
+    g_free(path);
+  }
+
+  if (home != NULL) {
+    gchar *path = g_build_filename(home, ".gnome", "mime-info", NULL);
+    AddMimeDbStamp(path, &stamp);
+    g_free(path);
+    path = g_build_filename(home, ".gnome", "application-info", NULL);
+    AddMimeDbStamp(path, &stamp);
+    g_free(path);
+  }
+
+  if (dataHome != NULL && *dataHome != '\0') {
+    AddMimeDbDataDir(dataHome, &stamp);
+  } else if (home != NULL) {
+    gchar *path = g_build_filename(home, ".local", "share", NULL);
+    AddMimeDbDataDir(path, &stamp);
+    g_free(path);
+  }
+
+  gchar **dirs = g_strsplit((dataDirs != NULL && *dataDirs != '\0') 
+                            ? dataDirs : "/usr/local/share:/usr/share", ":", 0);
+  for (int i = 0; dirs[i] != NULL; i++) {
+    AddMimeDbDataDir(dirs[i], &stamp);
+  }
+  g_strfreev(dirs);
+
+  return stamp;
+}
+
+static void FreeMimeIndex(MimeIndex *index) {
+  g_hash_table_destroy(index->extToMimeType);
+  g_hash_table_destroy(index->mimeTypeToExts);
+  for (guint i = 0; i < index->mimeTypes->len; i++) {
+    g_free(g_ptr_array_index(index->mimeTypes, i));
+  }
+  g_ptr_array_free(index->mimeTypes, TRUE);
+  delete index;
+}
+
+static MimeIndex *BuildMimeIndex() {
+  MimeIndex *index = new MimeIndex;
+  index->refs = 1;
+  index->mimeTypes = g_ptr_array_new();
+  index->extToMimeType = g_hash_table_new_full(g_str_hash, g_str_equal, 
+                                               g_free, g_free);
+  index->mimeTypeToExts = g_hash_table_new_full(g_str_hash, g_str_equal, 
+      g_free, (GDestroyNotify)g_strfreev);
+
+  GList *mimeTypeList = gnome_vfs_get_registered_mime_types();
+  for (GList *type = mimeTypeList; type != NULL; type = type->next) {
+    const char *mimeTypeStr = (const char *)type->data;
+    if (mimeTypeStr == NULL) {
+      continue;
+    }
+    g_ptr_array_add(index->mimeTypes, g_strdup(mimeTypeStr));
+
+    GList *extList = gnome_vfs_mime_get_extensions_list(mimeTypeStr);
+    if (extList == NULL) {
+      continue;
+    }
+
+    GPtrArray *exts = g_ptr_array_new();
+    for (GList *ext = extList; ext != NULL; ext = ext->next) {
+      const char *extStr = (const char *)ext->data;
+      if (extStr == NULL) {
+        continue;
+      }
+      g_ptr_array_add(exts, g_strdup(extStr));
+      if (g_hash_table_lookup(index->extToMimeType, extStr) == NULL) {
+        g_hash_table_insert(index->extToMimeType, g_strdup(extStr), 
+                            g_strdup(mimeTypeStr));
+      }
+    }
+    g_ptr_array_add(exts, NULL);
+    g_hash_table_insert(index->mimeTypeToExts, g_strdup(mimeTypeStr), 
+                        g_ptr_array_free(exts, FALSE));
+    gnome_vfs_mime_extensions_list_free(extList);
+  }
+  gnome_vfs_mime_registered_mime_type_list_free(mimeTypeList);
+  return index;
+}
+
+static void ReleaseMimeIndex(MimeIndex *index) {
+  pthread_mutex_lock(&gMimeIndexMutex);
+  bool unused = (--index->refs == 0);
+  pthread_mutex_unlock(&gMimeIndexMutex);
+  if (unused) {
+    FreeMimeIndex(index);
+  }
+}
+
+// Returns the MIME index, to be released with ReleaseMimeIndex(). It's 
+// built first, or rebuilt if the MIME database files have changed since 
+// the last check, or if a reload is forced. The files are only checked 
+// every MIME_DB_CHECK_INTERVAL seconds.
+static MimeIndex *AcquireMimeIndex(bool reload) {
+  pthread_mutex_lock(&gMimeIndexMutex);
+  for (;;) {
+    time_t now = time(NULL);
+    if (gMimeDbChecking) {
+      // another thread is checking the files, use the index it has, or 
+      // wait for the first one.
+      if (gMimeIndex != NULL && !reload) {
+        break;
+      }
+      pthread_cond_wait(&gMimeIndexCond, &gMimeIndexMutex);
+      continue;
+    }
+    if (gMimeIndex != NULL && !reload
+        && now - gMimeDbChecked < MIME_DB_CHECK_INTERVAL 
+        && now >= gMimeDbChecked) {
+      break;
+    }
+
+    gMimeDbChecking = true;
+    bool built = (gMimeIndex != NULL);
+    unsigned long oldStamp = gMimeDbStamp;
+    pthread_mutex_unlock(&gMimeIndexMutex);
+
+    unsigned long stamp = GetMimeDbStamp();
+    MimeIndex *index = NULL;
+    if (!built || reload || stamp != oldStamp) {
+      if (built) {
+        // make GnomeVFS read the changed files now, not on its own schedule.
+        gnome_vfs_mime_info_reload();
+      }
+      index = BuildMimeIndex();
+    }
+
+    pthread_mutex_lock(&gMimeIndexMutex);
+    MimeIndex *oldIndex = NULL;
+    if (index != NULL) {
+      oldIndex = gMimeIndex;
+      index->version = ++gMimeIndexVersion;
+      gMimeIndex = index;
+      if (oldIndex != NULL && --oldIndex->refs > 0) {
+        oldIndex = NULL;
+      }
+    }
+    gMimeDbStamp = stamp;
+    gMimeDbChecked = now;
+    gMimeDbChecking = false;
+    pthread_cond_broadcast(&gMimeIndexCond);
+    if (oldIndex != NULL) {
+      pthread_mutex_unlock(&gMimeIndexMutex);
+      FreeMimeIndex(oldIndex);
+      pthread_mutex_lock(&gMimeIndexMutex);
+    }
+    break;
+  }
+  MimeIndex *index = gMimeIndex;
+  index->refs++;
+  pthread_mutex_unlock(&gMimeIndexMutex);
+  return index;
+}
   
 JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_gnome_1vfs_1get_1mime_1type
   (JNIEnv *env, jclass cl, jstring url) {
-  gnome_vfs_init();
+  InitGnomeVfs();
 
   const char* urlStr = env->GetStringUTFChars(url, JNI_FALSE);
   const char* mimeTypeStr = gnome_vfs_get_mime_type(urlStr);
@@ -47,7 +309,7 @@ JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrap
 
 JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_gnome_1vfs_1mime_1get_1value
   (JNIEnv *env, jclass cl, jstring mimeType, jstring key) {
-  gnome_vfs_init();	  
+  InitGnomeVfs();	  
 
   const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
   const char* keyStr = env->GetStringUTFChars(key, JNI_FALSE);
@@ -65,7 +327,7 @@ JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrap
   
 JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_gnome_1vfs_1mime_1get_1description
   (JNIEnv *env, jclass cl, jstring mimeType) {
-  gnome_vfs_init();
+  InitGnomeVfs();
 
   const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
   const char* descStr = gnome_vfs_mime_get_description(mimeTypeStr);
@@ -81,7 +343,7 @@ JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrap
 
 JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_gnome_1vfs_1mime_1get_1icon
   (JNIEnv *env, jclass cl, jstring mimeType) {
-  gnome_vfs_init();
+  InitGnomeVfs();
 
   const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
   const char* iconFileStr = gnome_vfs_mime_get_icon(mimeTypeStr);
@@ -97,7 +359,7 @@ JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrap
 
 JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_gnome_1vfs_1mime_1get_1key_1list
   (JNIEnv *env, jclass cl, jstring mimeType) {
-  gnome_vfs_init();
+  InitGnomeVfs();
 
   const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
   GList* keyList = gnome_vfs_mime_get_key_list(mimeTypeStr);
@@ -128,7 +390,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVf
 
 JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_gnome_1vfs_1mime_1get_1default_1application_1command
   (JNIEnv *env, jclass cl, jstring mimeType) {
-  gnome_vfs_init();
+  InitGnomeVfs();
 
   const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
   GnomeVFSMimeApplication *mimeApp = gnome_vfs_mime_get_default_application(mimeTypeStr);
@@ -149,7 +411,7 @@ JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrap
 
 JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_gnome_1vfs_1get_1registered_1mime_1types
   (JNIEnv *env, jclass cl) {
-  gnome_vfs_init();
+  InitGnomeVfs();
 
   GList* mimeTypeList = gnome_vfs_get_registered_mime_types();
 
@@ -179,7 +441,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVf
 
 JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_gnome_1vfs_1mime_1get_1extensions_1list
     (JNIEnv *env, jclass cl, jstring mimeType) {
-  gnome_vfs_init();
+  InitGnomeVfs();
   
   const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
   GList* extList = gnome_vfs_mime_get_extensions_list(mimeTypeStr);
@@ -208,6 +470,143 @@ JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVf
   }  
 }	    
 
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_getMimeTypeByExtension
+    (JNIEnv *env, jclass cl, jstring fileExt) {
+  InitGnomeVfs();
+
+  const char* fileExtStr = env->GetStringUTFChars(fileExt, JNI_FALSE);
+  jstring mimeType = NULL;
+
+  MimeIndex *index = AcquireMimeIndex(false);
+  const char* mimeTypeStr 
+      = (const char*)g_hash_table_lookup(index->extToMimeType, fileExtStr);
+  if (mimeTypeStr != NULL) {
+    mimeType = env->NewStringUTF(mimeTypeStr);
+  }
+  ReleaseMimeIndex(index);
+
+  env->ReleaseStringUTFChars(fileExt, fileExtStr);
+  return mimeType;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_getExtensionsByMimeType
+    (JNIEnv *env, jclass cl, jstring mimeType) {
+  InitGnomeVfs();
+
+  const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
+  jobjectArray retArray = NULL;
+
+  MimeIndex *index = AcquireMimeIndex(false);
+  gchar** exts = (gchar**)g_hash_table_lookup(index->mimeTypeToExts, mimeTypeStr);
+  if (exts != NULL && exts[0] != NULL) {
+    int listLen = 0;
+    while (exts[listLen] != NULL) {
+      listLen++;
+    }
+    retArray = (jobjectArray)env->NewObjectArray(listLen, 
+                                                 env->FindClass("java/lang/String"), 
+                                                 NULL);
+    for (int i = 0; i < listLen; i++) {
+      jstring ext = env->NewStringUTF(exts[i]);
+      env->SetObjectArrayElement(retArray, i, ext);
+      env->DeleteLocalRef(ext);
+    }
+  }
+  ReleaseMimeIndex(index);
+
+  env->ReleaseStringUTFChars(mimeType, mimeTypeStr);
+  return retArray;
+}
+
+JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_getMimeDatabaseVersion
+    (JNIEnv *env, jclass cl) {
+  InitGnomeVfs();
+
+  MimeIndex *index = AcquireMimeIndex(false);
+  jlong version = index->version;
+  ReleaseMimeIndex(index);
+
+  return version;
+}
+
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_reloadMimeDatabase
+    (JNIEnv *env, jclass cl) {
+  InitGnomeVfs();
+
+  // reload even if the stamp is unchanged: files rewritten within the same
+  // second with the same size don't change it.
+  ReleaseMimeIndex(AcquireMimeIndex(true));
+}
+
+// Sets a string array element, releasing the local reference right away
+// so that large arrays don't exhaust the local reference table.
+static void SetStringElement(JNIEnv *env, jobjectArray array, int index, 
+                             const char *str) {
+  if (str != NULL) {
+    jstring jstr = env->NewStringUTF(str);
+    env->SetObjectArrayElement(array, index, jstr);
+    env->DeleteLocalRef(jstr);
+  }
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_getMimeDatabase
+    (JNIEnv *env, jclass cl) {
+  InitGnomeVfs();
+
+  jclass stringClass = env->FindClass("java/lang/String");
+  jclass stringArrayClass = env->FindClass("[Ljava/lang/String;");
+  jclass objectClass = env->FindClass("java/lang/Object");
+
+  MimeIndex *index = AcquireMimeIndex(false);
+
+  int count = index->mimeTypes->len;
+  jobjectArray types = env->NewObjectArray(count, stringClass, NULL);
+  jobjectArray descs = env->NewObjectArray(count, stringClass, NULL);
+  jobjectArray icons = env->NewObjectArray(count, stringClass, NULL);
+  jobjectArray commands = env->NewObjectArray(count, stringClass, NULL);
+  jobjectArray extensions = env->NewObjectArray(count, stringArrayClass, NULL);
+
+  for (int i = 0; i < count; i++) {
+    const char *mimeTypeStr 
+        = (const char *)g_ptr_array_index(index->mimeTypes, i);
+    SetStringElement(env, types, i, mimeTypeStr);
+    SetStringElement(env, descs, i, 
+                     gnome_vfs_mime_get_description(mimeTypeStr));
+    SetStringElement(env, icons, i, gnome_vfs_mime_get_icon(mimeTypeStr));
+
+    GnomeVFSMimeApplication *mimeApp 
+        = gnome_vfs_mime_get_default_application(mimeTypeStr);
+    if (mimeApp != NULL) {
+      SetStringElement(env, commands, i, mimeApp->command);
+      gnome_vfs_mime_application_free(mimeApp);
+    }
+
+    gchar **exts 
+        = (gchar **)g_hash_table_lookup(index->mimeTypeToExts, mimeTypeStr);
+    if (exts != NULL && exts[0] != NULL) {
+      int extCount = 0;
+      while (exts[extCount] != NULL) {
+        extCount++;
+      }
+      jobjectArray extArray = env->NewObjectArray(extCount, stringClass, NULL);
+      for (int j = 0; j < extCount; j++) {
+        SetStringElement(env, extArray, j, exts[j]);
+      }
+      env->SetObjectArrayElement(extensions, i, extArray);
+      env->DeleteLocalRef(extArray);
+    }
+  }
+  ReleaseMimeIndex(index);
+
+  jobjectArray retArray = env->NewObjectArray(5, objectClass, NULL);
+  env->SetObjectArrayElement(retArray, 0, types);
+  env->SetObjectArrayElement(retArray, 1, descs);
+  env->SetObjectArrayElement(retArray, 2, icons);
+  env->SetObjectArrayElement(retArray, 3, extensions);
+  env->SetObjectArrayElement(retArray, 4, commands);
+  return retArray;
+}
+
 JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_getenv
     (JNIEnv *env, jclass cl, jstring envName) {
   const char* envNameStr = env->GetStringUTFChars(envName, JNI_FALSE);
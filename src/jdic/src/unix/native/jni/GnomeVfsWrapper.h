@@ -71,6 +71,46 @@ JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVf
 JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_gnome_1vfs_1mime_1get_1extensions_1list
   (JNIEnv *, jclass, jstring);
 
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper
+ * Method:    getMimeTypeByExtension
+ * Signature: (Ljava/lang/String;)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_getMimeTypeByExtension
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper
+ * Method:    getExtensionsByMimeType
+ * Signature: (Ljava/lang/String;)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_getExtensionsByMimeType
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper
+ * Method:    getMimeDatabaseVersion
+ * Signature: ()J
+ */
+JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_getMimeDatabaseVersion
+  (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper
+ * Method:    reloadMimeDatabase
+ * Signature: ()V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_reloadMimeDatabase
+  (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper
+ * Method:    getMimeDatabase
+ * Signature: ()[Ljava/lang/Object;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper_getMimeDatabase
+  (JNIEnv *, jclass);
+
 /*
  * Class:     org_jdesktop_jdic_filetypes_internal_GnomeVfsWrapper
  * Method:    getenv
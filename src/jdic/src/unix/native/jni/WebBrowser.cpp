@@ -24,6 +24,11 @@
 #include "WebBrowser.h"
 #include <stdlib.h>
 #include <dlfcn.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 /*
  * Class:     org_jdesktop_jdic_browser_WebBrowser
@@ -63,3 +68,46 @@ JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_browser_WebBrowser_nativeGetWindow
     return (jint)handle_x11;
 }
 
+/*
+ * Class:     org_jdesktop_jdic_browser_WebBrowser
+ * Method:    nativeMapSnapshot
+ * Signature: (Ljava/lang/String;I)Ljava/nio/ByteBuffer;
+ */
+JNIEXPORT jobject JNICALL Java_org_jdesktop_jdic_browser_WebBrowser_nativeMapSnapshot
+  (JNIEnv *env, jclass clazz, jstring name, jint size)
+{
+    const char* nameStr = env->GetStringUTFChars(name, NULL);
+    int fd = shm_open(nameStr, O_RDONLY, 0);
+    if (fd != -1) {
+        // The segment stays valid while it's mapped, so drop the name right
+        // away to leave nothing behind in case the browser process dies.
+        shm_unlink(nameStr);
+    }
+    env->ReleaseStringUTFChars(name, nameStr);
+    if (fd == -1)
+        return NULL;
+
+    void* data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return NULL;
+
+    jobject buffer = env->NewDirectByteBuffer(data, size);
+    if (buffer == NULL)
+        munmap(data, size);
+    return buffer;
+}
+
+/*
+ * Class:     org_jdesktop_jdic_browser_WebBrowser
+ * Method:    nativeUnmapSnapshot
+ * Signature: (Ljava/nio/ByteBuffer;)V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_browser_WebBrowser_nativeUnmapSnapshot
+  (JNIEnv *env, jclass clazz, jobject buffer)
+{
+    void* data = env->GetDirectBufferAddress(buffer);
+    jlong size = env->GetDirectBufferCapacity(buffer);
+    if (data != NULL && size > 0)
+        munmap(data, (size_t)size);
+}
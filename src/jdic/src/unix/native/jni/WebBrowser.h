@@ -14,6 +14,22 @@ extern "C" {
  */
 JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_browser_WebBrowser_nativeGetWindow
   (JNIEnv *, jobject, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_browser_WebBrowser
+ * Method:    nativeMapSnapshot
+ * Signature: (Ljava/lang/String;I)Ljava/nio/ByteBuffer;
+ */
+JNIEXPORT jobject JNICALL Java_org_jdesktop_jdic_browser_WebBrowser_nativeMapSnapshot
+  (JNIEnv *, jclass, jstring, jint);
+
+/*
+ * Class:     org_jdesktop_jdic_browser_WebBrowser
+ * Method:    nativeUnmapSnapshot
+ * Signature: (Ljava/nio/ByteBuffer;)V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_browser_WebBrowser_nativeUnmapSnapshot
+  (JNIEnv *, jclass, jobject);
   
 #ifdef __cplusplus
 }
@@ -22,13 +22,13 @@
 #include <jawt.h>
 #include <X11/Xlib.h>
 #include "WebBrowserUtil.h"
+#include "GnomeSettings.h"
+#include "../../../share/native/utils/Logger.h"
 #include <stdlib.h>
 #include <limits.h>
 
 #include <sys/stat.h>
-#include <gconf/gconf-client.h>
-
-#define GCONF_URL_HANDLER_PATH "/desktop/gnome/url-handlers/"
+#include <glib.h>
 
 #ifndef PATH_MAX
 #define PATH_MAX 512
@@ -73,18 +73,13 @@ Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeGetBrowserPath
      *  If MOZILLA_FIVE_HOME is found and set, add it to LD_LIBRARY_PATH.
      */
     gboolean result;
-    char *schemes[2] = {"http", "unknown"};
-    char *path;
+    const char *schemes[2] = {"http", "unknown"};
     char *command;
     char *mozpath = NULL;
                                                                                                           
     // Check GConf to find the default browser path.
-    g_type_init();
-    GConfClient *client = gconf_client_get_default ();
-    for (int i = 0; i < sizeof(schemes); i++) {
-        path = g_strconcat (GCONF_URL_HANDLER_PATH, schemes[i], "/command", NULL);
-        command = gconf_client_get_string (client, path, NULL);
-        g_free(path);
+    for (int i = 0; i < 2; i++) {
+        command = GetUrlHandlerCommand(schemes[i]);
         if (command != NULL) {
 #ifdef DEBUG
             fprintf(stderr, "The default browser path set in GConf: %s\n", command);
@@ -100,6 +95,7 @@ Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeGetBrowserPath
                 } 
             }
 
+            g_free(command);
             break;
         }
     }                                                                                                          
@@ -202,3 +198,43 @@ Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeGetBrowserPath
     return (moz5home == NULL) ? 
         NULL : env->NewStringUTF(moz5home);
 }
+
+/*
+ * Class:     org_jdesktop_jdic_browser_internal_WebBrowserUtil
+ * Method:    nativeLog
+ * Signature: (ILjava/lang/String;)V
+ */
+JNIEXPORT void JNICALL 
+Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeLog
+  (JNIEnv *env, jclass, jint level, jstring msg)
+{
+    const char *msgChars = env->GetStringUTFChars(msg, NULL);
+    if (msgChars == NULL)
+        return;
+    Log(level, msgChars);
+    env->ReleaseStringUTFChars(msg, msgChars);
+}
+
+/*
+ * Class:     org_jdesktop_jdic_browser_internal_WebBrowserUtil
+ * Method:    nativeGetLogLevel
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL 
+Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeGetLogLevel
+  (JNIEnv *, jclass)
+{
+    return GetLogLevel();
+}
+
+/*
+ * Class:     org_jdesktop_jdic_browser_internal_WebBrowserUtil
+ * Method:    nativeSetLogLevel
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL 
+Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeSetLogLevel
+  (JNIEnv *, jclass, jint level)
+{
+    SetLogLevel(level);
+}
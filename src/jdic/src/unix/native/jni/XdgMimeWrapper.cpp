@@ -0,0 +1,2995 @@
+/*
+ * Copyright (C) 2004 Sun Microsystems, Inc. All rights reserved. Use is
+ * subject to license terms.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA.
+ */ 
+ 
+/*
+ * Reads the freedesktop.org shared MIME-info database directly, without 
+ * GnomeVFS, GConf or any daemon:
+ *   - <data dir>/mime/mime.cache files, generated by update-mime-database,
+ *     are mapped into memory and searched in place (the literal, alias and
+ *     icon tables are sorted, the suffix globs form a reverse suffix tree). 
+ *   - <data dir>/mime/types and <data dir>/mime/<media>/<subtype>.xml give
+ *     the known MIME types and their descriptions.
+ *   - the .desktop files in <data dir>/applications, with the rules of 
+ *     the mimeapps.list and defaults.list files, give the applications 
+ *     handling a MIME type. They are read once into a catalog, which is
+ *     reloaded when inotify reports a change.
+ * The data dirs are $XDG_DATA_HOME followed by $XDG_DATA_DIRS, in priority
+ * order, as specified by the XDG Base Directory Specification.
+ */
+
+#include <jni.h>
+#include "XdgMimeWrapper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <wctype.h>
+#include <time.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+#ifndef PATH_MAX
+#define PATH_MAX 1024
+#endif
+
+// the interval in seconds between the checks whether the MIME database 
+// files have changed.
+#define MIME_DB_CHECK_INTERVAL 5
+
+#define MAX_DATA_DIRS 32
+
+// mime.cache header layout, all the numbers are big endian.
+#define MIME_CACHE_MAJOR_VERSION 1
+#define MIME_CACHE_HEADER_SIZE 40
+#define MIME_CACHE_ALIAS_LIST 4
+#define MIME_CACHE_PARENT_LIST 8
+#define MIME_CACHE_LITERAL_LIST 12
+#define MIME_CACHE_SUFFIX_TREE 16
+#define MIME_CACHE_GLOB_LIST 20
+#define MIME_CACHE_MAGIC_LIST 24
+#define MIME_CACHE_ICONS_LIST 32
+#define MIME_CACHE_GENERIC_ICONS_LIST 36
+
+#define GLOB_WEIGHT_MASK 0xff
+#define GLOB_CASE_SENSITIVE 0x100
+
+// the deepest suffix tree path followed, and the longest name matched.
+#define MAX_SUFFIX_LENGTH 256
+
+// the most bytes read from the start of a file to sniff its content, and 
+// the deepest magic matchlet tree followed.
+#define MAX_MAGIC_EXTENT 65536
+#define MAX_MAGIC_DEPTH 32
+// the most matchlets compiled from all the caches. The shared database has 
+// a few thousand, so only a corrupt cache comes close.
+#define MAX_MATCHLETS (1 << 20)
+
+struct MimeCache {
+  char *path;
+  const unsigned char *buffer;
+  size_t size;
+  time_t mtime;
+};
+
+// A file extension registered for a MIME type, taken from a "*.ext" glob.
+struct ExtensionEntry {
+  const char *mimeType;   // points into the mapped cache
+  char *extension;
+  int order;
+};
+
+// A MIME type with the weight of the glob it was found by.
+struct MimeMatch {
+  const char *mimeType;
+  int weight;
+};
+
+// A magic rule, compiled from a mime.cache match: the MIME type is 
+// detected if any of its top level matchlets matches.
+struct MagicMatch {
+  int priority;
+  int order;
+  const char *mimeType;   // points into the mapped cache
+  int firstMatchlet;
+  int matchletCount;
+};
+
+// A byte pattern looked for at each offset of a range, with an optional 
+// mask. It matches if any of its children matches too, or it has none.
+struct MagicMatchlet {
+  unsigned int rangeStart;
+  unsigned int rangeLength;
+  unsigned int valueLength;
+  const unsigned char *value;   // points into the mapped cache
+  const unsigned char *mask;    // NULL if no mask
+  int firstChild;
+  int childCount;
+};
+
+// A top level matchlet of a magic rule, to try against the file content.
+struct MagicCandidate {
+  int match;
+  int matchlet;
+};
+
+// A growable list of distinct strings, kept in insertion order.
+struct StringList {
+  char **items;
+  int count;
+  int capacity;
+};
+
+static char *gDataDirs[MAX_DATA_DIRS];
+static int gDataDirCount = 0;
+static char *gConfigDirs[MAX_DATA_DIRS];
+static int gConfigDirCount = 0;
+
+static MimeCache gCaches[MAX_DATA_DIRS];
+static int gCacheCount = 0;
+// "*.ext" globs sorted by MIME type, for the MIME type -> extensions lookup.
+static ExtensionEntry *gExtensions = NULL;
+static int gExtensionCount = 0;
+static int gExtensionCapacity = 0;
+// the sorted contents of all the mime/types files.
+static char **gKnownTypes = NULL;
+static int gKnownTypeCount = 0;
+static int gKnownTypeCapacity = 0;
+// the magic rules of all the caches, highest priority first.
+static MagicMatch *gMagicMatches = NULL;
+static int gMagicMatchCount = 0;
+static int gMagicMatchCapacity = 0;
+static MagicMatchlet *gMatchlets = NULL;
+static int gMatchletCount = 0;
+static int gMatchletCapacity = 0;
+// the top level matchlets at offset 0 with an unmasked first byte, bucketed
+// by that byte, and all the others. Both sorted by rule priority. A file 
+// is only tried against the bucket of its first byte and the others.
+static MagicCandidate *gMagicBuckets[256];
+static int gMagicBucketCount[256];
+static MagicCandidate *gMagicOthers = NULL;
+static int gMagicOtherCount = 0;
+// the number of bytes at the start of a file the rules look at.
+static unsigned int gMagicExtent = 0;
+
+static unsigned long gMimeDbStamp = 0;
+static time_t gMimeDbChecked = 0;
+static int gMimeDbLoaded = 0;
+// incremented each time the database is loaded, tells the Java side when to
+// drop the values it has cached.
+static jlong gMimeDbVersion = 0;
+// lookups take it for reading, so they run concurrently; loading the 
+// database takes it for writing.
+static pthread_rwlock_t gMimeDbLock = PTHREAD_RWLOCK_INITIALIZER;
+
+static void StringListAdd(StringList *list, const char *str) {
+  for (int i = 0; i < list->count; i++) {
+    if (strcmp(list->items[i], str) == 0) {
+      return;
+    }
+  }
+  if (list->count == list->capacity) {
+    list->capacity = (list->capacity == 0) ? 8 : list->capacity * 2;
+    list->items = (char **)realloc(list->items, 
+                                   list->capacity * sizeof(char *));
+  }
+  list->items[list->count++] = strdup(str);
+}
+
+static int StringListContains(const StringList *list, const char *str) {
+  for (int i = 0; i < list->count; i++) {
+    if (strcmp(list->items[i], str) == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void StringListFree(StringList *list) {
+  for (int i = 0; i < list->count; i++) {
+    free(list->items[i]);
+  }
+  free(list->items);
+  list->items = NULL;
+  list->count = list->capacity = 0;
+}
+
+// Splits a colon separated search path, appending the non empty entries.
+static void AddSearchPath(const char *value, const char *defaultValue, 
+                          char **dirs, int *count) {
+  if (value == NULL || *value == '\0') {
+    value = defaultValue;
+  }
+  if (value == NULL) {
+    return;
+  }
+  const char *start = value;
+  while (*start != '\0' && *count < MAX_DATA_DIRS) {
+    const char *end = strchr(start, ':');
+    size_t len = (end == NULL) ? strlen(start) : (size_t)(end - start);
+    if (len > 0) {
+      char *dir = (char *)malloc(len + 1);
+      memcpy(dir, start, len);
+      dir[len] = '\0';
+      dirs[(*count)++] = dir;
+    }
+    if (end == NULL) {
+      break;
+    }
+    start = end + 1;
+  }
+}
+
+// Builds the data and config dir lists from the XDG environment variables.
+static void InitSearchPaths() {
+  char path[PATH_MAX];
+  const char *home = getenv("HOME");
+  const char *dataHome = getenv("XDG_DATA_HOME");
+  const char *configHome = getenv("XDG_CONFIG_HOME");
+
+  if ((dataHome == NULL || *dataHome == '\0') && home != NULL) {
+    snprintf(path, sizeof(path), "%s/.local/share", home);
+    dataHome = path;
+  }
+  AddSearchPath(dataHome, NULL, gDataDirs, &gDataDirCount);
+  AddSearchPath(getenv("XDG_DATA_DIRS"), "/usr/local/share:/usr/share", 
+                gDataDirs, &gDataDirCount);
+
+  if ((configHome == NULL || *configHome == '\0') && home != NULL) {
+    snprintf(path, sizeof(path), "%s/.config", home);
+    configHome = path;
+  }
+  AddSearchPath(configHome, NULL, gConfigDirs, &gConfigDirCount);
+  AddSearchPath(getenv("XDG_CONFIG_DIRS"), "/etc/xdg", 
+                gConfigDirs, &gConfigDirCount);
+}
+
+static inline unsigned int GetUInt32(const MimeCache *cache, 
+                                     unsigned int offset) {
+  if (offset > cache->size - 4) {
+    return 0;
+  }
+  const unsigned char *p = cache->buffer + offset;
+  return ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) 
+      | ((unsigned int)p[2] << 8) | (unsigned int)p[3];
+}
+
+// Returns the NUL terminated string at the given offset, or NULL if the 
+// offset doesn't point to one, so that a corrupt cache can't make us read
+// past the mapping.
+static const char *GetString(const MimeCache *cache, unsigned int offset) {
+  if (offset >= cache->size 
+      || memchr(cache->buffer + offset, '\0', cache->size - offset) == NULL) {
+    return NULL;
+  }
+  return (const char *)cache->buffer + offset;
+}
+
+// Binary searches a table of entries sorted by the string their first 
+// field points to, returning the offset of the matching entry or 0.
+static unsigned int SearchTable(const MimeCache *cache, unsigned int table, 
+                                unsigned int entrySize, const char *key) {
+  if (table == 0) {
+    return 0;
+  }
+  int min = 0;
+  int max = (int)GetUInt32(cache, table) - 1;
+  while (min <= max) {
+    int mid = (min + max) / 2;
+    unsigned int entry = table + 4 + entrySize * mid;
+    const char *str = GetString(cache, GetUInt32(cache, entry));
+    if (str == NULL) {
+      return 0;
+    }
+    int cmp = strcmp(str, key);
+    if (cmp < 0) {
+      min = mid + 1;
+    } else if (cmp > 0) {
+      max = mid - 1;
+    } else {
+      return entry;
+    }
+  }
+  return 0;
+}
+
+static void UnmapCaches() {
+  for (int i = 0; i < gCacheCount; i++) {
+    munmap((void *)gCaches[i].buffer, gCaches[i].size);
+    free(gCaches[i].path);
+  }
+  gCacheCount = 0;
+  for (int i = 0; i < gExtensionCount; i++) {
+    free(gExtensions[i].extension);
+  }
+  free(gExtensions);
+  gExtensions = NULL;
+  gExtensionCount = gExtensionCapacity = 0;
+  for (int i = 0; i < gKnownTypeCount; i++) {
+    free(gKnownTypes[i]);
+  }
+  free(gKnownTypes);
+  gKnownTypes = NULL;
+  gKnownTypeCount = gKnownTypeCapacity = 0;
+
+  free(gMagicMatches);
+  gMagicMatches = NULL;
+  gMagicMatchCount = gMagicMatchCapacity = 0;
+  free(gMatchlets);
+  gMatchlets = NULL;
+  gMatchletCount = gMatchletCapacity = 0;
+  for (int i = 0; i < 256; i++) {
+    free(gMagicBuckets[i]);
+    gMagicBuckets[i] = NULL;
+    gMagicBucketCount[i] = 0;
+  }
+  free(gMagicOthers);
+  gMagicOthers = NULL;
+  gMagicOtherCount = 0;
+  gMagicExtent = 0;
+}
+
+static int MapCache(const char *path, MimeCache *cache) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return 0;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < MIME_CACHE_HEADER_SIZE) {
+    close(fd);
+    return 0;
+  }
+  void *buffer = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (buffer == MAP_FAILED) {
+    return 0;
+  }
+  cache->buffer = (const unsigned char *)buffer;
+  cache->size = st.st_size;
+  cache->mtime = st.st_mtime;
+  if ((cache->buffer[0] << 8 | cache->buffer[1]) != MIME_CACHE_MAJOR_VERSION) {
+    munmap(buffer, st.st_size);
+    return 0;
+  }
+  cache->path = strdup(path);
+  return 1;
+}
+
+static void AddExtension(const char *mimeType, const char *extension) {
+  if (gExtensionCount == gExtensionCapacity) {
+    gExtensionCapacity = (gExtensionCapacity == 0) 
+        ? 1024 : gExtensionCapacity * 2;
+    gExtensions = (ExtensionEntry *)realloc(gExtensions, 
+        gExtensionCapacity * sizeof(ExtensionEntry));
+  }
+  gExtensions[gExtensionCount].mimeType = mimeType;
+  gExtensions[gExtensionCount].extension = strdup(extension);
+  gExtensions[gExtensionCount].order = gExtensionCount;
+  gExtensionCount++;
+}
+
+// Encodes a UCS-4 character as UTF-8, returning the number of bytes.
+static int EncodeUtf8(unsigned int c, char *out) {
+  if (c < 0x80) {
+    out[0] = (char)c;
+    return 1;
+  } else if (c < 0x800) {
+    out[0] = (char)(0xc0 | (c >> 6));
+    out[1] = (char)(0x80 | (c & 0x3f));
+    return 2;
+  } else if (c < 0x10000) {
+    out[0] = (char)(0xe0 | (c >> 12));
+    out[1] = (char)(0x80 | ((c >> 6) & 0x3f));
+    out[2] = (char)(0x80 | (c & 0x3f));
+    return 3;
+  }
+  out[0] = (char)(0xf0 | ((c >> 18) & 0x07));
+  out[1] = (char)(0x80 | ((c >> 12) & 0x3f));
+  out[2] = (char)(0x80 | ((c >> 6) & 0x3f));
+  out[3] = (char)(0x80 | (c & 0x3f));
+  return 4;
+}
+
+// Walks the reverse suffix tree, collecting the "*.ext" globs. The path 
+// holds the characters from the root, that is the suffix reversed. The 
+// budget is the number of nodes left to visit: a corrupt cache may point
+// to the same nodes over and over, but can't hold more nodes than fit in
+// its size.
+static void CollectExtensions(const MimeCache *cache, unsigned int count, 
+                              unsigned int offset, unsigned int *path, 
+                              int depth, size_t *budget) {
+  if (offset > cache->size || count > (cache->size - offset) / 12 
+      || count > *budget) {
+    return;
+  }
+  *budget -= count;
+  for (unsigned int i = 0; i < count; i++) {
+    unsigned int node = offset + 12 * i;
+    unsigned int c = GetUInt32(cache, node);
+    if (c == 0) {
+      // a leaf: the suffix must be ".ext" with no wildcards in it.
+      if (depth < 2 || path[depth - 1] != '.') {
+        continue;
+      }
+      char ext[MAX_SUFFIX_LENGTH * 4 + 1];
+      int len = 0;
+      bool plain = true;
+      for (int j = depth - 2; j >= 0 && plain; j--) {
+        if (path[j] == '*' || path[j] == '?' || path[j] == '[') {
+          plain = false;
+        }
+        len += EncodeUtf8(path[j], ext + len);
+      }
+      ext[len] = '\0';
+      const char *mimeType = GetString(cache, GetUInt32(cache, node + 4));
+      if (plain && mimeType != NULL) {
+        AddExtension(mimeType, ext);
+      }
+    } else if (depth < MAX_SUFFIX_LENGTH) {
+      path[depth] = c;
+      CollectExtensions(cache, GetUInt32(cache, node + 4), 
+                        GetUInt32(cache, node + 8), path, depth + 1, budget);
+    }
+  }
+}
+
+static int CompareExtensions(const void *a, const void *b) {
+  const ExtensionEntry *ea = (const ExtensionEntry *)a;
+  const ExtensionEntry *eb = (const ExtensionEntry *)b;
+  int cmp = strcmp(ea->mimeType, eb->mimeType);
+  return (cmp != 0) ? cmp : ea->order - eb->order;
+}
+
+static int CompareStrings(const void *a, const void *b) {
+  return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+// Reads one line of any length, returning 0 at the end of the file. The 
+// line buffer is reused and grown as needed, the newline is stripped.
+static int ReadLine(FILE *file, char **line, size_t *size) {
+  if (*line == NULL) {
+    *size = 256;
+    *line = (char *)malloc(*size);
+  }
+  size_t len = 0;
+  while (fgets(*line + len, *size - len, file) != NULL) {
+    len += strlen(*line + len);
+    if (len > 0 && (*line)[len - 1] == '\n') {
+      (*line)[--len] = '\0';
+      if (len > 0 && (*line)[len - 1] == '\r') {
+        (*line)[--len] = '\0';
+      }
+      return 1;
+    }
+    *size *= 2;
+    *line = (char *)realloc(*line, *size);
+  }
+  return len > 0;
+}
+
+static void ReadKnownTypes(const char *path) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    return;
+  }
+  char *line = NULL;
+  size_t size = 0;
+  while (ReadLine(file, &line, &size)) {
+    if (line[0] == '\0') {
+      continue;
+    }
+    if (gKnownTypeCount == gKnownTypeCapacity) {
+      gKnownTypeCapacity = (gKnownTypeCapacity == 0) 
+          ? 1024 : gKnownTypeCapacity * 2;
+      gKnownTypes = (char **)realloc(gKnownTypes, 
+                                     gKnownTypeCapacity * sizeof(char *));
+    }
+    gKnownTypes[gKnownTypeCount++] = strdup(line);
+  }
+  free(line);
+  fclose(file);
+}
+
+// Reserves a block of matchlets, returning the index of the first one, or 
+// -1 if there would be more than MAX_MATCHLETS or they can't be allocated.
+static int AllocMatchlets(unsigned int count) {
+  size_t needed = (size_t)gMatchletCount + count;
+  if (needed > MAX_MATCHLETS) {
+    return -1;
+  }
+  if (needed > (size_t)gMatchletCapacity) {
+    size_t capacity = (gMatchletCapacity == 0) ? 4096 : gMatchletCapacity;
+    while (needed > capacity) {
+      capacity *= 2;
+    }
+    MagicMatchlet *matchlets = (MagicMatchlet *)realloc(gMatchlets, 
+        capacity * sizeof(MagicMatchlet));
+    if (matchlets == NULL) {
+      return -1;
+    }
+    gMatchlets = matchlets;
+    gMatchletCapacity = (int)capacity;
+  }
+  int first = gMatchletCount;
+  gMatchletCount += count;
+  return first;
+}
+
+// Compiles the matchlets of a mime.cache magic rule into a block of 
+// gMatchlets, the children of each into a block of their own. A matchlet 
+// whose pattern lies outside the mapping is kept but never matches. 
+// Returns -1 if the matchlets themselves lie outside the mapping, or can't
+// be allocated.
+static int CompileMatchlets(const MimeCache *cache, unsigned int count, 
+                            unsigned int offset, int depth) {
+  if (offset > cache->size || count > (cache->size - offset) / 32) {
+    return -1;
+  }
+  int first = AllocMatchlets(count);
+  if (first < 0) {
+    return -1;
+  }
+  for (unsigned int i = 0; i < count; i++) {
+    unsigned int entry = offset + 32 * i;
+    unsigned int valueLength = GetUInt32(cache, entry + 12);
+    unsigned int valueOffset = GetUInt32(cache, entry + 16);
+    unsigned int maskOffset = GetUInt32(cache, entry + 20);
+    unsigned int childCount = GetUInt32(cache, entry + 24);
+    unsigned int children = GetUInt32(cache, entry + 28);
+
+    MagicMatchlet matchlet;
+    matchlet.rangeStart = GetUInt32(cache, entry);
+    matchlet.rangeLength = GetUInt32(cache, entry + 4);
+    matchlet.valueLength = valueLength;
+    matchlet.value = cache->buffer + valueOffset;
+    matchlet.mask = (maskOffset == 0) ? NULL : cache->buffer + maskOffset;
+    matchlet.firstChild = 0;
+    matchlet.childCount = 0;
+    if (valueLength == 0 || valueLength > MAX_MAGIC_EXTENT
+        || valueLength > cache->size
+        || valueOffset > cache->size - valueLength
+        || (maskOffset != 0 && maskOffset > cache->size - valueLength)
+        || matchlet.rangeStart > MAX_MAGIC_EXTENT
+        || matchlet.rangeLength > MAX_MAGIC_EXTENT) {
+      matchlet.valueLength = MAX_MAGIC_EXTENT + 1;
+      matchlet.rangeLength = 0;
+    } else if (childCount > 0 && depth < MAX_MAGIC_DEPTH) {
+      matchlet.firstChild = CompileMatchlets(cache, childCount, children, 
+                                             depth + 1);
+      if (matchlet.firstChild < 0) {
+        return -1;
+      }
+      matchlet.childCount = childCount;
+    }
+    gMatchlets[first + i] = matchlet;
+  }
+  return first;
+}
+
+// Compiles the magic rules of a cache. If its match list is corrupt, or 
+// the rules can't be allocated, none of them are kept.
+static void CompileMagic(const MimeCache *cache) {
+  unsigned int list = GetUInt32(cache, MIME_CACHE_MAGIC_LIST);
+  if (list == 0) {
+    return;
+  }
+  unsigned int count = GetUInt32(cache, list);
+  unsigned int extent = GetUInt32(cache, list + 4);
+  unsigned int first = GetUInt32(cache, list + 8);
+  if (first > cache->size || count > (cache->size - first) / 16) {
+    return;
+  }
+
+  int matchCount = gMagicMatchCount;
+  int matchletCount = gMatchletCount;
+  bool failed = false;
+  for (unsigned int i = 0; i < count && !failed; i++) {
+    unsigned int entry = first + 16 * i;
+    const char *mimeType = GetString(cache, GetUInt32(cache, entry + 4));
+    if (mimeType == NULL) {
+      continue;
+    }
+    if (gMagicMatchCount == gMagicMatchCapacity) {
+      int capacity = (gMagicMatchCapacity == 0) 
+          ? 1024 : gMagicMatchCapacity * 2;
+      MagicMatch *matches = (MagicMatch *)realloc(gMagicMatches, 
+          (size_t)capacity * sizeof(MagicMatch));
+      if (matches == NULL) {
+        failed = true;
+        break;
+      }
+      gMagicMatches = matches;
+      gMagicMatchCapacity = capacity;
+    }
+    MagicMatch *match = &gMagicMatches[gMagicMatchCount];
+    match->priority = GetUInt32(cache, entry);
+    // keep the order of the caches, then of the rules in a cache.
+    match->order = gMagicMatchCount;
+    match->mimeType = mimeType;
+    unsigned int matchlets = GetUInt32(cache, entry + 8);
+    match->firstMatchlet = CompileMatchlets(cache, matchlets, 
+                                            GetUInt32(cache, entry + 12), 0);
+    if (match->firstMatchlet < 0) {
+      failed = true;
+      break;
+    }
+    match->matchletCount = (int)matchlets;
+    gMagicMatchCount++;
+  }
+
+  if (failed) {
+    gMagicMatchCount = matchCount;
+    gMatchletCount = matchletCount;
+  } else if (extent > gMagicExtent) {
+    gMagicExtent = (extent > MAX_MAGIC_EXTENT) ? MAX_MAGIC_EXTENT : extent;
+  }
+}
+
+static int CompareMagicMatches(const void *a, const void *b) {
+  const MagicMatch *ma = (const MagicMatch *)a;
+  const MagicMatch *mb = (const MagicMatch *)b;
+  if (ma->priority != mb->priority) {
+    return mb->priority - ma->priority;
+  }
+  return ma->order - mb->order;
+}
+
+static void AddMagicCandidate(MagicCandidate **list, int *count, 
+                              int match, int matchlet) {
+  // grow in powers of two.
+  if (*count == 0 || (*count & (*count - 1)) == 0) {
+    *list = (MagicCandidate *)realloc(*list, 
+        ((*count == 0) ? 1 : *count * 2) * sizeof(MagicCandidate));
+  }
+  (*list)[*count].match = match;
+  (*list)[*count].matchlet = matchlet;
+  (*count)++;
+}
+
+// Sorts the magic rules of all the caches by priority and buckets their 
+// top level matchlets.
+static void IndexMagic() {
+  if (gMagicMatchCount == 0) {
+    return;
+  }
+  qsort(gMagicMatches, gMagicMatchCount, sizeof(MagicMatch), 
+        CompareMagicMatches);
+  for (int m = 0; m < gMagicMatchCount; m++) {
+    const MagicMatch *match = &gMagicMatches[m];
+    for (int k = 0; k < match->matchletCount; k++) {
+      int index = match->firstMatchlet + k;
+      const MagicMatchlet *matchlet = &gMatchlets[index];
+      if (matchlet->rangeStart == 0 && matchlet->rangeLength == 1
+          && matchlet->valueLength <= MAX_MAGIC_EXTENT
+          && (matchlet->mask == NULL || matchlet->mask[0] == 0xff)) {
+        unsigned char c = matchlet->value[0];
+        AddMagicCandidate(&gMagicBuckets[c], &gMagicBucketCount[c], m, index);
+      } else {
+        AddMagicCandidate(&gMagicOthers, &gMagicOtherCount, m, index);
+      }
+    }
+  }
+}
+
+static void LoadMimeDb() {
+  UnmapCaches();
+  gMimeDbVersion++;
+
+  char path[PATH_MAX];
+  unsigned int suffixPath[MAX_SUFFIX_LENGTH];
+  for (int i = 0; i < gDataDirCount; i++) {
+    snprintf(path, sizeof(path), "%s/mime/types", gDataDirs[i]);
+    ReadKnownTypes(path);
+
+    snprintf(path, sizeof(path), "%s/mime/mime.cache", gDataDirs[i]);
+    MimeCache *cache = &gCaches[gCacheCount];
+    if (!MapCache(path, cache)) {
+      continue;
+    }
+    gCacheCount++;
+    unsigned int tree = GetUInt32(cache, MIME_CACHE_SUFFIX_TREE);
+    size_t budget = cache->size / 12;
+    CollectExtensions(cache, GetUInt32(cache, tree), 
+                      GetUInt32(cache, tree + 4), suffixPath, 0, &budget);
+    CompileMagic(cache);
+  }
+  IndexMagic();
+
+  if (gExtensionCount > 0) {
+    qsort(gExtensions, gExtensionCount, sizeof(ExtensionEntry), 
+          CompareExtensions);
+  }
+  if (gKnownTypeCount > 0) {
+    qsort(gKnownTypes, gKnownTypeCount, sizeof(char *), CompareStrings);
+  }
+}
+
+static void AddMimeDbStamp(const char *path, unsigned long *stamp) {
+  struct stat st;
+  if (stat(path, &st) == 0) {
+    *stamp = *stamp * 31 + (unsigned long)st.st_mtime;
+    *stamp = *stamp * 31 + (unsigned long)st.st_size;
+    *stamp = *stamp * 31 + (unsigned long)st.st_ino;
+  } else {
+    *stamp = *stamp * 31 + 1;
+  }
+}
+
+// Returns a stamp of the mime.cache and mime/types files. They are 
+// rewritten together by update-mime-database.
+static unsigned long GetMimeDbStamp() {
+  char path[PATH_MAX];
+  unsigned long stamp = 0;
+  for (int i = 0; i < gDataDirCount; i++) {
+    snprintf(path, sizeof(path), "%s/mime/mime.cache", gDataDirs[i]);
+    AddMimeDbStamp(path, &stamp);
+    snprintf(path, sizeof(path), "%s/mime/types", gDataDirs[i]);
+    AddMimeDbStamp(path, &stamp);
+  }
+  return stamp;
+}
+
+// Loads the MIME database, or reloads it if its files have changed. Called
+// with gMimeDbLock locked for writing.
+static void UpdateMimeDb() {
+  time_t now = time(NULL);
+  if (gMimeDbLoaded 
+      && now - gMimeDbChecked < MIME_DB_CHECK_INTERVAL
+      && now >= gMimeDbChecked) {
+    return;
+  }
+  if (!gMimeDbLoaded) {
+    InitSearchPaths();
+  }
+  gMimeDbChecked = now;
+
+  unsigned long stamp = GetMimeDbStamp();
+  if (gMimeDbLoaded && stamp == gMimeDbStamp) {
+    return;
+  }
+  gMimeDbStamp = stamp;
+  gMimeDbLoaded = 1;
+  LoadMimeDb();
+}
+
+// Locks the MIME database for reading, loading or reloading it first when 
+// it's time to check its files.
+static void LockMimeDb() {
+  pthread_rwlock_rdlock(&gMimeDbLock);
+  time_t now = time(NULL);
+  if (gMimeDbLoaded 
+      && now - gMimeDbChecked < MIME_DB_CHECK_INTERVAL
+      && now >= gMimeDbChecked) {
+    return;
+  }
+  pthread_rwlock_unlock(&gMimeDbLock);
+  pthread_rwlock_wrlock(&gMimeDbLock);
+  UpdateMimeDb();
+  pthread_rwlock_unlock(&gMimeDbLock);
+  pthread_rwlock_rdlock(&gMimeDbLock);
+}
+
+static void UnlockMimeDb() {
+  pthread_rwlock_unlock(&gMimeDbLock);
+}
+
+static const char *UnaliasMimeType(const char *mimeType) {
+  for (int i = 0; i < gCacheCount; i++) {
+    const MimeCache *cache = &gCaches[i];
+    unsigned int entry = SearchTable(cache, 
+                                     GetUInt32(cache, MIME_CACHE_ALIAS_LIST), 
+                                     8, mimeType);
+    if (entry != 0) {
+      const char *target = GetString(cache, GetUInt32(cache, entry + 4));
+      if (target != NULL) {
+        return target;
+      }
+    }
+  }
+  return mimeType;
+}
+
+// Decodes a UTF-8 string into UCS-4 characters, returning their number.
+static int DecodeUtf8(const char *str, unsigned int *out, int maxLen) {
+  const unsigned char *p = (const unsigned char *)str;
+  int len = 0;
+  while (*p != '\0' && len < maxLen) {
+    unsigned int c = *p++;
+    int extra = 0;
+    if (c >= 0xf0) {
+      c &= 0x07;
+      extra = 3;
+    } else if (c >= 0xe0) {
+      c &= 0x0f;
+      extra = 2;
+    } else if (c >= 0xc0) {
+      c &= 0x1f;
+      extra = 1;
+    }
+    while (extra-- > 0 && (*p & 0xc0) == 0x80) {
+      c = (c << 6) | (*p++ & 0x3f);
+    }
+    out[len++] = c;
+  }
+  return len;
+}
+
+// Matches the end of the name against the reverse suffix tree, adding the
+// MIME types of the longest matching suffix to the matches.
+static int LookupSuffix(const MimeCache *cache, unsigned int count, 
+                        unsigned int offset, const unsigned int *name, 
+                        int len, bool caseSensitiveCheck, 
+                        MimeMatch *matches, int maxMatches) {
+  unsigned int c = name[len - 1];
+  int min = 0;
+  int max = (int)count - 1;
+  while (min <= max) {
+    int mid = (min + max) / 2;
+    unsigned int node = offset + 12 * mid;
+    unsigned int nodeChar = GetUInt32(cache, node);
+    if (nodeChar < c) {
+      min = mid + 1;
+    } else if (nodeChar > c) {
+      max = mid - 1;
+    } else {
+      unsigned int childCount = GetUInt32(cache, node + 4);
+      unsigned int children = GetUInt32(cache, node + 8);
+      int n = 0;
+      if (len > 1) {
+        n = LookupSuffix(cache, childCount, children, name, len - 1, 
+                         caseSensitiveCheck, matches, maxMatches);
+      }
+      if (n > 0) {
+        return n;
+      }
+      // the leaves sort first among the children.
+      for (unsigned int i = 0; i < childCount && n < maxMatches; i++) {
+        unsigned int leaf = children + 12 * i;
+        if (GetUInt32(cache, leaf) != 0) {
+          break;
+        }
+        unsigned int flags = GetUInt32(cache, leaf + 8);
+        const char *mimeType = GetString(cache, GetUInt32(cache, leaf + 4));
+        if (mimeType != NULL
+            && (caseSensitiveCheck || !(flags & GLOB_CASE_SENSITIVE))) {
+          matches[n].mimeType = mimeType;
+          matches[n].weight = flags & GLOB_WEIGHT_MASK;
+          n++;
+        }
+      }
+      return n;
+    }
+  }
+  return 0;
+}
+
+// the most MIME types a single glob lookup collects.
+#define MAX_MATCHES 10
+
+// Records a glob match, keeping the heaviest one and noting whether 
+// another MIME type matches with the same weight.
+static void AddGlobMatch(const char *mimeType, int weight, 
+                         const char **best, int *bestWeight, bool *ambiguous) {
+  if (weight > *bestWeight) {
+    *best = mimeType;
+    *bestWeight = weight;
+    *ambiguous = false;
+  } else if (weight == *bestWeight && strcmp(mimeType, *best) != 0) {
+    *ambiguous = true;
+  }
+}
+
+// Looks up a file name in the suffix tree and then the glob list of every 
+// cache, returning the MIME type of the heaviest matching glob, the first 
+// one on a tie, or NULL. Sets ambiguous if the tie is between different 
+// MIME types. Called with gMimeDbLock locked.
+static const char *LookupGlobs(const char *fileName, const char *lowerName, 
+                               bool *ambiguous) {
+  int len = strlen(fileName);
+  unsigned int *name = (unsigned int *)malloc((len + 1) * sizeof(unsigned int));
+  unsigned int *lower = (unsigned int *)malloc((len + 1) * sizeof(unsigned int));
+  len = DecodeUtf8(fileName, name, len);
+  for (int i = 0; i < len; i++) {
+    lower[i] = (unsigned int)towlower((wint_t)name[i]);
+  }
+
+  const char *best = NULL;
+  int bestWeight = -1;
+  *ambiguous = false;
+  for (int i = 0; i < gCacheCount && len > 0; i++) {
+    const MimeCache *cache = &gCaches[i];
+    unsigned int tree = GetUInt32(cache, MIME_CACHE_SUFFIX_TREE);
+    unsigned int roots = GetUInt32(cache, tree);
+    unsigned int firstRoot = GetUInt32(cache, tree + 4);
+    MimeMatch matches[MAX_MATCHES];
+    int n = LookupSuffix(cache, roots, firstRoot, name, len, true, 
+                         matches, MAX_MATCHES);
+    if (n == 0) {
+      n = LookupSuffix(cache, roots, firstRoot, lower, len, false, 
+                       matches, MAX_MATCHES);
+    }
+    for (int j = 0; j < n; j++) {
+      AddGlobMatch(matches[j].mimeType, matches[j].weight, 
+                   &best, &bestWeight, ambiguous);
+    }
+  }
+  free(name);
+  free(lower);
+
+  // the few globs that aren't plain suffixes, like "*.[1-9]".
+  for (int i = 0; i < gCacheCount; i++) {
+    const MimeCache *cache = &gCaches[i];
+    unsigned int list = GetUInt32(cache, MIME_CACHE_GLOB_LIST);
+    unsigned int count = (list == 0) ? 0 : GetUInt32(cache, list);
+    for (unsigned int j = 0; j < count; j++) {
+      unsigned int entry = list + 4 + 12 * j;
+      const char *glob = GetString(cache, GetUInt32(cache, entry));
+      const char *mimeType = GetString(cache, GetUInt32(cache, entry + 4));
+      unsigned int flags = GetUInt32(cache, entry + 8);
+      if (glob == NULL || mimeType == NULL
+          || (int)(flags & GLOB_WEIGHT_MASK) < bestWeight) {
+        continue;
+      }
+      const char *target 
+          = (flags & GLOB_CASE_SENSITIVE) ? fileName : lowerName;
+      if (fnmatch(glob, target, 0) == 0) {
+        AddGlobMatch(mimeType, flags & GLOB_WEIGHT_MASK, 
+                     &best, &bestWeight, ambiguous);
+      }
+    }
+  }
+  return best;
+}
+
+// Returns a copy of the string with the ASCII letters lowercased.
+static char *AsciiLower(const char *str) {
+  char *lower = strdup(str);
+  for (char *p = lower; *p != '\0'; p++) {
+    if ((unsigned char)*p < 0x80) {
+      *p = tolower(*p);
+    }
+  }
+  return lower;
+}
+
+// Looks up the MIME type of a file name by the literal file names first,
+// then by the globs. Called with gMimeDbLock locked.
+static const char *LookupFileName(const char *fileName, bool *ambiguous) {
+  char *lowerName = AsciiLower(fileName);
+  const char *mimeType = NULL;
+
+  for (int i = 0; i < gCacheCount && mimeType == NULL; i++) {
+    const MimeCache *cache = &gCaches[i];
+    unsigned int list = GetUInt32(cache, MIME_CACHE_LITERAL_LIST);
+    unsigned int entry = SearchTable(cache, list, 12, fileName);
+    if (entry == 0) {
+      // case insensitive literals are stored lowercased.
+      entry = SearchTable(cache, list, 12, lowerName);
+      if (entry != 0 
+          && (GetUInt32(cache, entry + 8) & GLOB_CASE_SENSITIVE)) {
+        entry = 0;
+      }
+    }
+    if (entry != 0) {
+      mimeType = GetString(cache, GetUInt32(cache, entry + 4));
+    }
+  }
+
+  if (mimeType == NULL) {
+    mimeType = LookupGlobs(fileName, lowerName, ambiguous);
+  } else {
+    *ambiguous = false;
+  }
+  free(lowerName);
+  return mimeType;
+}
+
+static int IsKnownMimeType(const char *mimeType) {
+  if (gKnownTypeCount > 0 
+      && bsearch(&mimeType, gKnownTypes, gKnownTypeCount, sizeof(char *), 
+                 CompareStrings) != NULL) {
+    return 1;
+  }
+  // aliases aren't listed in the mime/types files.
+  return UnaliasMimeType(mimeType) != mimeType;
+}
+
+static const char *LookupIconName(const char *mimeType) {
+  const int lists[] = { MIME_CACHE_ICONS_LIST, MIME_CACHE_GENERIC_ICONS_LIST };
+  for (int l = 0; l < 2; l++) {
+    for (int i = 0; i < gCacheCount; i++) {
+      const MimeCache *cache = &gCaches[i];
+      // the icon lists are optional, older caches end before them.
+      if (cache->size < (size_t)lists[l] + 4) {
+        continue;
+      }
+      unsigned int entry = SearchTable(cache, GetUInt32(cache, lists[l]), 
+                                       8, mimeType);
+      if (entry != 0) {
+        const char *icon = GetString(cache, GetUInt32(cache, entry + 4));
+        if (icon != NULL) {
+          return icon;
+        }
+      }
+    }
+  }
+  return NULL;
+}
+
+// Gets the language of the current locale, as "ll_CC" and as "ll". Both 
+// are empty for the C locale.
+static void GetLocaleNames(char *full, char *lang, size_t size) {
+  const char *names[] = { "LC_ALL", "LC_MESSAGES", "LANG" };
+  const char *locale = NULL;
+  for (int i = 0; i < 3 && locale == NULL; i++) {
+    locale = getenv(names[i]);
+    if (locale != NULL && *locale == '\0') {
+      locale = NULL;
+    }
+  }
+  full[0] = lang[0] = '\0';
+  if (locale == NULL || strcmp(locale, "C") == 0 
+      || strcmp(locale, "POSIX") == 0) {
+    return;
+  }
+  size_t len = strcspn(locale, ".@");
+  if (len >= size) {
+    return;
+  }
+  memcpy(full, locale, len);
+  full[len] = '\0';
+  len = strcspn(full, "_");
+  memcpy(lang, full, len);
+  lang[len] = '\0';
+}
+
+// Ranks a translation by how well its language matches the locale: 3 for
+// the exact language and country, 2 for the language, 1 for the 
+// untranslated value and 0 for another language.
+static int RankLocale(const char *value, size_t len, 
+                      const char *full, const char *lang) {
+  if (value == NULL) {
+    return 1;
+  }
+  if (full[0] != '\0' && strlen(full) == len 
+      && strncmp(value, full, len) == 0) {
+    return 3;
+  }
+  if (lang[0] != '\0' && strlen(lang) == len 
+      && strncmp(value, lang, len) == 0) {
+    return 2;
+  }
+  return 0;
+}
+
+// Copies XML character data, replacing the entity and character references.
+static char *XmlUnescape(const char *start, size_t len) {
+  char *result = (char *)malloc(len + 1);
+  char *out = result;
+  const char *end = start + len;
+  const char *p = start;
+  while (p < end) {
+    if (*p != '&') {
+      *out++ = *p++;
+      continue;
+    }
+    const char *semi = (const char *)memchr(p, ';', end - p);
+    if (semi == NULL) {
+      *out++ = *p++;
+      continue;
+    }
+    size_t refLen = semi - p - 1;
+    if (refLen == 3 && strncmp(p + 1, "amp", 3) == 0) {
+      *out++ = '&';
+    } else if (refLen == 2 && strncmp(p + 1, "lt", 2) == 0) {
+      *out++ = '<';
+    } else if (refLen == 2 && strncmp(p + 1, "gt", 2) == 0) {
+      *out++ = '>';
+    } else if (refLen == 4 && strncmp(p + 1, "quot", 4) == 0) {
+      *out++ = '"';
+    } else if (refLen == 4 && strncmp(p + 1, "apos", 4) == 0) {
+      *out++ = '\'';
+    } else if (refLen > 1 && p[1] == '#') {
+      unsigned long c = (p[2] == 'x') ? strtoul(p + 3, NULL, 16)
+                                      : strtoul(p + 2, NULL, 10);
+      // a reference is never shorter than the UTF-8 it stands for.
+      out += EncodeUtf8((unsigned int)c, out);
+    } else {
+      memcpy(out, p, semi - p + 1);
+      out += semi - p + 1;
+    }
+    p = semi + 1;
+  }
+  *out = '\0';
+  return result;
+}
+
+// Reads the comment for the current locale from a <media>/<subtype>.xml 
+// file, which update-mime-database writes for every MIME type.
+static char *ReadDescription(const char *path) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    return NULL;
+  }
+  char *buffer = NULL;
+  size_t len = 0;
+  size_t size = 0;
+  size_t n;
+  do {
+    if (len == size) {
+      size = (size == 0) ? 4096 : size * 2;
+      buffer = (char *)realloc(buffer, size + 1);
+    }
+    n = fread(buffer + len, 1, size - len, file);
+    len += n;
+  } while (n > 0);
+  fclose(file);
+  buffer[len] = '\0';
+
+  char full[64];
+  char lang[64];
+  GetLocaleNames(full, lang, sizeof(full));
+
+  char *description = NULL;
+  int bestRank = 0;
+  const char *p = buffer;
+  while ((p = strstr(p, "<comment")) != NULL) {
+    p += 8;
+    if (*p != '>' && !isspace((unsigned char)*p)) {
+      continue;
+    }
+    const char *tagEnd = strchr(p, '>');
+    if (tagEnd == NULL) {
+      break;
+    }
+    if (tagEnd[-1] == '/') {
+      continue;
+    }
+    const char *langValue = NULL;
+    size_t langLen = 0;
+    const char *attr = strstr(p, "xml:lang=");
+    if (attr != NULL && attr < tagEnd) {
+      char quote = attr[9];
+      langValue = attr + 10;
+      const char *langEnd = strchr(langValue, quote);
+      langLen = (langEnd == NULL || langEnd > tagEnd) 
+          ? 0 : langEnd - langValue;
+    }
+    const char *textEnd = strstr(tagEnd + 1, "</comment>");
+    if (textEnd == NULL) {
+      break;
+    }
+    int rank = RankLocale(langValue, langLen, full, lang);
+    if (rank > bestRank) {
+      free(description);
+      description = XmlUnescape(tagEnd + 1, textEnd - tagEnd - 1);
+      bestRank = rank;
+    }
+    p = textEnd;
+  }
+  free(buffer);
+  return description;
+}
+
+// Returns true if the matchlet, and one of its children if it has any, 
+// matches the data.
+static bool MatchletMatches(int index, const unsigned char *data, 
+                            unsigned int len) {
+  const MagicMatchlet *matchlet = &gMatchlets[index];
+  unsigned int valueLength = matchlet->valueLength;
+  unsigned int end = matchlet->rangeStart + matchlet->rangeLength;
+  bool found = false;
+  for (unsigned int i = matchlet->rangeStart; i < end && !found; i++) {
+    if (valueLength > len || i > len - valueLength) {
+      return false;
+    }
+    if (matchlet->mask == NULL) {
+      found = (memcmp(data + i, matchlet->value, valueLength) == 0);
+    } else {
+      found = true;
+      for (unsigned int j = 0; j < valueLength && found; j++) {
+        found = ((data[i + j] & matchlet->mask[j]) 
+                 == (matchlet->value[j] & matchlet->mask[j]));
+      }
+    }
+  }
+  if (!found) {
+    return false;
+  }
+  if (matchlet->childCount == 0) {
+    return true;
+  }
+  for (int i = 0; i < matchlet->childCount; i++) {
+    if (MatchletMatches(matchlet->firstChild + i, data, len)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the MIME type of the highest priority magic rule matching the 
+// data, or NULL. Only the rules that can match the first byte are tried.
+// Called with gMimeDbLock locked.
+static const char *MatchMagic(const unsigned char *data, unsigned int len) {
+  const MagicCandidate *bucket = (len > 0) ? gMagicBuckets[data[0]] : NULL;
+  int bucketCount = (len > 0) ? gMagicBucketCount[data[0]] : 0;
+  int i = 0;
+  int j = 0;
+  // both lists are in priority order, merge them.
+  while (i < bucketCount || j < gMagicOtherCount) {
+    const MagicCandidate *candidate;
+    if (j >= gMagicOtherCount 
+        || (i < bucketCount && bucket[i].match <= gMagicOthers[j].match)) {
+      candidate = &bucket[i++];
+    } else {
+      candidate = &gMagicOthers[j++];
+    }
+    if (MatchletMatches(candidate->matchlet, data, len)) {
+      return gMagicMatches[candidate->match].mimeType;
+    }
+  }
+  return NULL;
+}
+
+// Returns true if the MIME type is the base type or a subclass of it.
+static bool IsSubclass(const char *mimeType, const char *base, int depth) {
+  mimeType = UnaliasMimeType(mimeType);
+  base = UnaliasMimeType(base);
+  if (strcmp(mimeType, base) == 0) {
+    return true;
+  }
+  // the implicit parents, see the shared MIME-info specification.
+  if (strcmp(base, "text/plain") == 0 && strncmp(mimeType, "text/", 5) == 0) {
+    return true;
+  }
+  if (strcmp(base, "application/octet-stream") == 0 
+      && strncmp(mimeType, "inode/", 6) != 0) {
+    return true;
+  }
+  if (depth >= MAX_MAGIC_DEPTH) {
+    return false;
+  }
+  for (int i = 0; i < gCacheCount; i++) {
+    const MimeCache *cache = &gCaches[i];
+    unsigned int entry = SearchTable(cache, 
+                                     GetUInt32(cache, MIME_CACHE_PARENT_LIST), 
+                                     8, mimeType);
+    if (entry == 0) {
+      continue;
+    }
+    unsigned int parents = GetUInt32(cache, entry + 4);
+    unsigned int count = GetUInt32(cache, parents);
+    for (unsigned int j = 0; j < count; j++) {
+      const char *parent = GetString(cache, 
+                                     GetUInt32(cache, parents + 4 + 4 * j));
+      if (parent != NULL && IsSubclass(parent, base, depth + 1)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Returns true if the data has no control characters but whitespace.
+static bool LooksLikeText(const unsigned char *data, unsigned int len) {
+  for (unsigned int i = 0; i < len; i++) {
+    unsigned char c = data[i];
+    if (c < 0x20 && c != '\t' && c != '\n' && c != '\r' && c != '\f' 
+        && c != '\b' && c != 0x1b) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// the bytes read to tell text from binary data when no rule matches.
+#define TEXT_SNIFF_LENGTH 512
+
+// Returns the size of the buffer SniffFile needs.
+static unsigned int GetSniffLength() {
+  return (gMagicExtent > TEXT_SNIFF_LENGTH) ? gMagicExtent : TEXT_SNIFF_LENGTH;
+}
+
+// Detects the MIME type of a file as the shared MIME-info specification 
+// recommends. A glob matching the name unambiguously is trusted without 
+// reading the file. Otherwise the start of the file, read with a single 
+// pread into the buffer, is matched against the magic rules, a glob match 
+// that is a subclass of the magic match winning. Failing both, the content
+// is classified as plain text or binary data. Called with gMimeDbLock 
+// locked.
+static const char *SniffFile(const char *path, unsigned char *buffer) {
+  const char *baseName = strrchr(path, '/');
+  baseName = (baseName == NULL) ? path : baseName + 1;
+
+  // don't block on FIFOs.
+  int fd = open(path, O_RDONLY | O_NONBLOCK);
+  if (fd < 0) {
+    bool ambiguous;
+    return (*baseName == '\0') ? NULL : LookupFileName(baseName, &ambiguous);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return NULL;
+  }
+  if (!S_ISREG(st.st_mode)) {
+    close(fd);
+    if (S_ISDIR(st.st_mode)) {
+      return "inode/directory";
+    } else if (S_ISCHR(st.st_mode)) {
+      return "inode/chardevice";
+    } else if (S_ISBLK(st.st_mode)) {
+      return "inode/blockdevice";
+    } else if (S_ISFIFO(st.st_mode)) {
+      return "inode/fifo";
+    } else if (S_ISSOCK(st.st_mode)) {
+      return "inode/socket";
+    }
+    return NULL;
+  }
+
+  bool ambiguous = false;
+  const char *globType = LookupFileName(baseName, &ambiguous);
+  if (globType != NULL && !ambiguous) {
+    close(fd);
+    return globType;
+  }
+  if (st.st_size == 0) {
+    close(fd);
+    return (globType != NULL) ? globType : "application/x-zerosize";
+  }
+
+  ssize_t len = pread(fd, buffer, GetSniffLength(), 0);
+  close(fd);
+  if (len < 0) {
+    len = 0;
+  }
+
+  const char *magicType = MatchMagic(buffer, len);
+  if (magicType != NULL) {
+    if (globType != NULL && IsSubclass(globType, magicType, 0)) {
+      return globType;
+    }
+    return magicType;
+  }
+  if (globType != NULL) {
+    return globType;
+  }
+  return LooksLikeText(buffer, len) ? "text/plain" : "application/octet-stream";
+}
+
+// the most threads sniffing a batch of files, and the number of files a 
+// thread takes at a time.
+#define MAX_SNIFF_THREADS 64
+#define SNIFF_CHUNK 16
+
+struct SniffBatch {
+  char **paths;
+  const char **mimeTypes;
+  int count;
+  int next;
+  pthread_mutex_t mutex;
+};
+
+extern "C" {
+static void *SniffWorker(void *arg) {
+  SniffBatch *batch = (SniffBatch *)arg;
+  unsigned char *buffer = (unsigned char *)malloc(GetSniffLength());
+  for (;;) {
+    pthread_mutex_lock(&batch->mutex);
+    int first = batch->next;
+    batch->next += SNIFF_CHUNK;
+    pthread_mutex_unlock(&batch->mutex);
+    if (first >= batch->count) {
+      break;
+    }
+    int end = (first + SNIFF_CHUNK < batch->count) 
+        ? first + SNIFF_CHUNK : batch->count;
+    for (int i = first; i < end; i++) {
+      if (batch->paths[i] != NULL) {
+        batch->mimeTypes[i] = SniffFile(batch->paths[i], buffer);
+      }
+    }
+  }
+  free(buffer);
+  return NULL;
+}
+}
+
+// Called for every key of a key file, with the group it's in.
+typedef void (*KeyFileCallback)(const char *group, const char *key, 
+                                const char *value, void *data);
+
+// Reads a desktop entry style key file, returning 0 if it can't be read.
+static int ReadKeyFile(const char *path, KeyFileCallback callback, 
+                       void *data) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    return 0;
+  }
+  char *line = NULL;
+  size_t size = 0;
+  char *group = NULL;
+  while (ReadLine(file, &line, &size)) {
+    if (line[0] == '#' || line[0] == '\0') {
+      continue;
+    }
+    if (line[0] == '[') {
+      char *end = strchr(line, ']');
+      if (end != NULL) {
+        *end = '\0';
+        free(group);
+        group = strdup(line + 1);
+      }
+      continue;
+    }
+    char *eq = strchr(line, '=');
+    if (group == NULL || eq == NULL) {
+      continue;
+    }
+    char *keyEnd = eq;
+    while (keyEnd > line && isspace((unsigned char)keyEnd[-1])) {
+      keyEnd--;
+    }
+    *keyEnd = '\0';
+    char *value = eq + 1;
+    while (isspace((unsigned char)*value)) {
+      value++;
+    }
+    callback(group, line, value, data);
+  }
+  free(group);
+  free(line);
+  fclose(file);
+  return 1;
+}
+
+// The catalog of the installed applications: every .desktop file in the 
+// applications dirs, and the rules of the mimeapps.list and defaults.list 
+// files, parsed once and indexed by desktop file id and by MIME type. On 
+// Linux inotify reports the changes of those files, elsewhere their 
+// modification times are checked every MIME_DB_CHECK_INTERVAL seconds.
+// Either way the whole catalog is reloaded when they change.
+//
+// The catalog is also written to $XDG_CACHE_HOME/jdic/applications.cache,
+// so that the next process doesn't need to parse all the .desktop files. 
+// The cache file records the paths the catalog was read from, and is used 
+// if their modification times still match. A stale cache file is used as 
+// well, while a background thread reloads the catalog and rewrites it.
+
+// the deepest subdirectory of an applications dir that is scanned.
+#define MAX_CATALOG_DEPTH 8
+
+// the kinds of rules of the mimeapps.list and defaults.list files, in the
+// order they apply within a file.
+#define RULE_DEFAULT 0
+#define RULE_ADDED 1
+#define RULE_REMOVED 2
+
+// the kinds of paths the catalog is read from: the directories are watched 
+// for changes, the files only checked for their modification times.
+#define WATCH_DATA_DIR 0
+#define WATCH_CONFIG_DIR 1
+#define WATCH_APPLICATIONS_DIR 2
+#define WATCH_NONE 3
+
+#define CATALOG_CACHE_MAGIC "JDICAPP\001"
+#define CATALOG_CACHE_HEADER_SIZE 56
+
+struct CatalogEntry {
+  char *id;
+  char *name;
+  char *exec;
+  // set for Hidden=true, which deletes the entries of lower priority dirs.
+  int hidden;
+};
+
+// a MIME type listed by the MimeType key of an entry.
+struct CatalogMimeType {
+  char *mimeType;
+  CatalogEntry *entry;
+  int dirIndex;
+};
+
+// a desktop file id listed for a MIME type by a mimeapps.list file.
+struct CatalogRule {
+  char *mimeType;
+  char *id;
+  // the priority of the file the rule is in, 0 highest.
+  int file;
+  int kind;
+  // the position in the file, keeps the order of the listed ids.
+  int seq;
+};
+
+struct CatalogPath {
+  char *path;
+  int kind;
+};
+
+struct Catalog {
+  // sorted by id.
+  CatalogEntry **entries;
+  int entryCount;
+  // sorted by MIME type, then dir priority and id.
+  CatalogMimeType *mimeTypes;
+  int mimeTypeCount;
+  int mimeTypeCapacity;
+  // sorted by MIME type, then file, kind and position.
+  CatalogRule *rules;
+  int ruleCount;
+  int ruleCapacity;
+  // the dirs and files the catalog is read from.
+  CatalogPath *paths;
+  int pathCount;
+  int pathCapacity;
+  // the inotify instance, and the kind of dir of each watch descriptor.
+  int notify;
+  int *watchKinds;
+  int watchKindCapacity;
+  unsigned long stamp;
+  time_t checked;
+};
+
+// a .desktop file found while scanning, before the ones shadowed by the 
+// same id in a higher priority dir are dropped.
+struct CatalogFile {
+  char *id;
+  char *path;
+  int dirIndex;
+};
+
+static Catalog *gCatalog = NULL;
+// set while a background thread reloads the catalog.
+static int gCatalogRefreshing = 0;
+// lookups take it for reading; replacing the catalog takes it for writing.
+static pthread_rwlock_t gCatalogLock = PTHREAD_RWLOCK_INITIALIZER;
+static pthread_mutex_t gCatalogCacheMutex = PTHREAD_MUTEX_INITIALIZER;
+static int gCatalogCacheEnabled = 1;
+
+static bool EndsWith(const char *str, const char *suffix) {
+  size_t len = strlen(str);
+  size_t suffixLen = strlen(suffix);
+  return len >= suffixLen && strcmp(str + len - suffixLen, suffix) == 0;
+}
+
+static void AddCatalogPath(Catalog *catalog, const char *path, int kind) {
+  if (catalog->pathCount == catalog->pathCapacity) {
+    catalog->pathCapacity = (catalog->pathCapacity == 0) 
+        ? 256 : catalog->pathCapacity * 2;
+    catalog->paths = (CatalogPath *)realloc(catalog->paths, 
+        catalog->pathCapacity * sizeof(CatalogPath));
+  }
+  catalog->paths[catalog->pathCount].path = strdup(path);
+  catalog->paths[catalog->pathCount].kind = kind;
+  catalog->pathCount++;
+}
+
+// Watches a directory for the changes of the catalog files in it.
+static void WatchCatalogDir(Catalog *catalog, const char *path, int kind) {
+#ifdef __linux__
+  if (catalog->notify < 0) {
+    return;
+  }
+  uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO 
+      | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+  int wd = inotify_add_watch(catalog->notify, path, mask);
+  if (wd < 0) {
+    return;
+  }
+  if (wd >= catalog->watchKindCapacity) {
+    int capacity = (catalog->watchKindCapacity == 0) 
+        ? 64 : catalog->watchKindCapacity;
+    while (capacity <= wd) {
+      capacity *= 2;
+    }
+    catalog->watchKinds = (int *)realloc(catalog->watchKinds, 
+                                         capacity * sizeof(int));
+    for (int i = catalog->watchKindCapacity; i < capacity; i++) {
+      catalog->watchKinds[i] = WATCH_APPLICATIONS_DIR;
+    }
+    catalog->watchKindCapacity = capacity;
+  }
+  catalog->watchKinds[wd] = kind;
+#endif
+}
+
+// Starts watching the directories the catalog is read from.
+static void WatchCatalog(Catalog *catalog) {
+#ifdef __linux__
+  catalog->notify = inotify_init();
+  if (catalog->notify < 0) {
+    return;
+  }
+  fcntl(catalog->notify, F_SETFL, O_NONBLOCK);
+  fcntl(catalog->notify, F_SETFD, FD_CLOEXEC);
+  for (int i = 0; i < catalog->pathCount; i++) {
+    if (catalog->paths[i].kind != WATCH_NONE) {
+      WatchCatalogDir(catalog, catalog->paths[i].path, catalog->paths[i].kind);
+    }
+  }
+#endif
+}
+
+#ifdef __linux__
+// Returns true if the inotify event changes the catalog. The data and 
+// config dirs are watched for a single name only, as other programs write
+// to them all the time.
+static bool IsCatalogEvent(const Catalog *catalog, 
+                           const struct inotify_event *event) {
+  if (event->wd < 0 || (event->mask & (IN_Q_OVERFLOW | IN_IGNORED 
+                                       | IN_DELETE_SELF | IN_MOVE_SELF))) {
+    return true;
+  }
+  const char *name = (event->len > 0) ? event->name : "";
+  int kind = (event->wd < catalog->watchKindCapacity) 
+      ? catalog->watchKinds[event->wd] : WATCH_APPLICATIONS_DIR;
+  switch (kind) {
+  case WATCH_DATA_DIR:
+    return strcmp(name, "applications") == 0;
+  case WATCH_CONFIG_DIR:
+    return strcmp(name, "mimeapps.list") == 0;
+  default:
+    return (event->mask & IN_ISDIR) != 0 || EndsWith(name, ".desktop") 
+        || EndsWith(name, ".list");
+  }
+}
+
+// Reads the pending inotify events, returning true if one of them changes
+// the catalog.
+static bool ReadCatalogEvents(const Catalog *catalog) {
+  char buffer[4096] 
+      __attribute__((aligned(__alignof__(struct inotify_event))));
+  bool changed = false;
+  ssize_t len;
+  while ((len = read(catalog->notify, buffer, sizeof(buffer))) > 0) {
+    char *p = buffer;
+    while (p < buffer + len) {
+      const struct inotify_event *event = (const struct inotify_event *)p;
+      if (IsCatalogEvent(catalog, event)) {
+        changed = true;
+      }
+      p += sizeof(struct inotify_event) + event->len;
+    }
+  }
+  return changed;
+}
+#endif
+
+static unsigned long GetCatalogStamp(const Catalog *catalog) {
+  unsigned long stamp = 0;
+  for (int i = 0; i < catalog->pathCount; i++) {
+    AddMimeDbStamp(catalog->paths[i].path, &stamp);
+  }
+  return stamp;
+}
+
+static void AddCatalogFile(CatalogFile **files, int *count, int *capacity, 
+                           const char *id, const char *path, int dirIndex) {
+  if (*count == *capacity) {
+    *capacity = (*capacity == 0) ? 256 : *capacity * 2;
+    *files = (CatalogFile *)realloc(*files, *capacity * sizeof(CatalogFile));
+  }
+  CatalogFile *file = &(*files)[(*count)++];
+  file->id = strdup(id);
+  file->path = strdup(path);
+  file->dirIndex = dirIndex;
+}
+
+static bool IsDirectory(const struct dirent *entry, const char *path) {
+#ifdef _DIRENT_HAVE_D_TYPE
+  if (entry->d_type == DT_DIR) {
+    return true;
+  }
+  if (entry->d_type != DT_UNKNOWN && entry->d_type != DT_LNK) {
+    return false;
+  }
+#endif
+  struct stat st;
+  return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+// Collects the .desktop files of an applications dir and its subdirs. The
+// id of <dir>/kde4/kate.desktop is kde4-kate.desktop.
+static void ScanApplicationsDir(Catalog *catalog, const char *dir, 
+                                const char *prefix, int dirIndex, int depth,
+                                CatalogFile **files, int *count, 
+                                int *capacity) {
+  DIR *d = opendir(dir);
+  if (d == NULL) {
+    return;
+  }
+  AddCatalogPath(catalog, dir, WATCH_APPLICATIONS_DIR);
+  WatchCatalogDir(catalog, dir, WATCH_APPLICATIONS_DIR);
+
+  char path[PATH_MAX];
+  char id[PATH_MAX];
+  struct dirent *entry;
+  while ((entry = readdir(d)) != NULL) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+    snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+    snprintf(id, sizeof(id), "%s%s", prefix, entry->d_name);
+    if (EndsWith(entry->d_name, ".desktop")) {
+      AddCatalogFile(files, count, capacity, id, path, dirIndex);
+    } else if (depth < MAX_CATALOG_DEPTH && IsDirectory(entry, path)) {
+      strncat(id, "-", sizeof(id) - strlen(id) - 1);
+      ScanApplicationsDir(catalog, path, id, dirIndex, depth + 1, files, 
+                          count, capacity);
+    }
+  }
+  closedir(d);
+}
+
+struct DesktopEntryData {
+  char full[64];
+  char lang[64];
+  char *name;
+  int nameRank;
+  char *exec;
+  char *mimeTypes;
+  int hidden;
+};
+
+extern "C" {
+static void DesktopEntryCallback(const char *group, const char *key, 
+                                 const char *value, void *data) {
+  DesktopEntryData *entry = (DesktopEntryData *)data;
+  if (strcmp(group, "Desktop Entry") != 0) {
+    return;
+  }
+  if (strcmp(key, "Exec") == 0) {
+    free(entry->exec);
+    entry->exec = strdup(value);
+  } else if (strcmp(key, "MimeType") == 0) {
+    free(entry->mimeTypes);
+    entry->mimeTypes = strdup(value);
+  } else if (strcmp(key, "Hidden") == 0) {
+    entry->hidden = (strcmp(value, "true") == 0);
+  } else if (strncmp(key, "Name", 4) == 0) {
+    int rank = 0;
+    if (key[4] == '\0') {
+      rank = 1;
+    } else if (key[4] == '[') {
+      const char *end = strchr(key, ']');
+      if (end != NULL) {
+        rank = RankLocale(key + 5, end - key - 5, entry->full, entry->lang);
+      }
+    }
+    if (rank > entry->nameRank) {
+      free(entry->name);
+      entry->name = strdup(value);
+      entry->nameRank = rank;
+    }
+  }
+}
+}
+
+static void AddCatalogMimeType(Catalog *catalog, const char *mimeType, 
+                               CatalogEntry *entry, int dirIndex) {
+  if (catalog->mimeTypeCount == catalog->mimeTypeCapacity) {
+    catalog->mimeTypeCapacity = (catalog->mimeTypeCapacity == 0) 
+        ? 1024 : catalog->mimeTypeCapacity * 2;
+    catalog->mimeTypes = (CatalogMimeType *)realloc(catalog->mimeTypes, 
+        catalog->mimeTypeCapacity * sizeof(CatalogMimeType));
+  }
+  CatalogMimeType *item = &catalog->mimeTypes[catalog->mimeTypeCount++];
+  item->mimeType = strdup(mimeType);
+  item->entry = entry;
+  item->dirIndex = dirIndex;
+}
+
+// Parses a .desktop file into a catalog entry, indexing its MIME types.
+static CatalogEntry *LoadCatalogEntry(Catalog *catalog, 
+                                      const CatalogFile *file, 
+                                      const char *full, const char *lang) {
+  DesktopEntryData data;
+  memset(&data, 0, sizeof(data));
+  strcpy(data.full, full);
+  strcpy(data.lang, lang);
+  ReadKeyFile(file->path, DesktopEntryCallback, &data);
+
+  CatalogEntry *entry = (CatalogEntry *)malloc(sizeof(CatalogEntry));
+  entry->id = strdup(file->id);
+  entry->name = data.name;
+  entry->exec = data.exec;
+  entry->hidden = data.hidden || data.exec == NULL;
+  if (data.mimeTypes != NULL && !entry->hidden) {
+    char *savePtr = NULL;
+    for (char *type = strtok_r(data.mimeTypes, ";", &savePtr); 
+         type != NULL; type = strtok_r(NULL, ";", &savePtr)) {
+      while (isspace((unsigned char)*type)) {
+        type++;
+      }
+      if (*type != '\0') {
+        AddCatalogMimeType(catalog, type, entry, file->dirIndex);
+      }
+    }
+  }
+  free(data.mimeTypes);
+  return entry;
+}
+
+struct RuleData {
+  Catalog *catalog;
+  int file;
+  int seq;
+};
+
+static void AddCatalogRule(Catalog *catalog, const char *mimeType, 
+                           const char *id, int file, int kind, int seq) {
+  if (catalog->ruleCount == catalog->ruleCapacity) {
+    catalog->ruleCapacity = (catalog->ruleCapacity == 0) 
+        ? 256 : catalog->ruleCapacity * 2;
+    catalog->rules = (CatalogRule *)realloc(catalog->rules, 
+        catalog->ruleCapacity * sizeof(CatalogRule));
+  }
+  CatalogRule *rule = &catalog->rules[catalog->ruleCount++];
+  rule->mimeType = strdup(mimeType);
+  rule->id = strdup(id);
+  rule->file = file;
+  rule->kind = kind;
+  rule->seq = seq;
+}
+
+extern "C" {
+static void RuleCallback(const char *group, const char *key, 
+                         const char *value, void *data) {
+  RuleData *rules = (RuleData *)data;
+  int kind;
+  if (strcmp(group, "Default Applications") == 0) {
+    kind = RULE_DEFAULT;
+  } else if (strcmp(group, "Added Associations") == 0) {
+    kind = RULE_ADDED;
+  } else if (strcmp(group, "Removed Associations") == 0) {
+    kind = RULE_REMOVED;
+  } else {
+    return;
+  }
+  char *ids = strdup(value);
+  char *savePtr = NULL;
+  for (char *id = strtok_r(ids, ";", &savePtr); id != NULL; 
+       id = strtok_r(NULL, ";", &savePtr)) {
+    while (isspace((unsigned char)*id)) {
+      id++;
+    }
+    if (*id != '\0') {
+      AddCatalogRule(rules->catalog, key, id, rules->file, kind, 
+                     rules->seq++);
+    }
+  }
+  free(ids);
+}
+}
+
+// Reads the rules of a mimeapps.list style file, each file having a lower 
+// priority than the ones read before.
+static void LoadCatalogRules(const char *path, RuleData *rules) {
+  AddCatalogPath(rules->catalog, path, WATCH_NONE);
+  ReadKeyFile(path, RuleCallback, rules);
+  rules->file++;
+}
+
+static int CompareCatalogFiles(const void *a, const void *b) {
+  const CatalogFile *fa = (const CatalogFile *)a;
+  const CatalogFile *fb = (const CatalogFile *)b;
+  int result = strcmp(fa->id, fb->id);
+  return (result != 0) ? result : fa->dirIndex - fb->dirIndex;
+}
+
+static int CompareCatalogMimeTypes(const void *a, const void *b) {
+  const CatalogMimeType *ta = (const CatalogMimeType *)a;
+  const CatalogMimeType *tb = (const CatalogMimeType *)b;
+  int result = strcmp(ta->mimeType, tb->mimeType);
+  if (result == 0) {
+    result = ta->dirIndex - tb->dirIndex;
+  }
+  return (result != 0) ? result : strcmp(ta->entry->id, tb->entry->id);
+}
+
+static int CompareCatalogRules(const void *a, const void *b) {
+  const CatalogRule *ra = (const CatalogRule *)a;
+  const CatalogRule *rb = (const CatalogRule *)b;
+  int result = strcmp(ra->mimeType, rb->mimeType);
+  if (result == 0) {
+    result = ra->file - rb->file;
+  }
+  if (result == 0) {
+    result = ra->kind - rb->kind;
+  }
+  return (result != 0) ? result : ra->seq - rb->seq;
+}
+
+static Catalog *NewCatalog() {
+  Catalog *catalog = (Catalog *)calloc(1, sizeof(Catalog));
+  catalog->notify = -1;
+  return catalog;
+}
+
+static void FreeCatalog(Catalog *catalog) {
+  for (int i = 0; i < catalog->entryCount; i++) {
+    free(catalog->entries[i]->id);
+    free(catalog->entries[i]->name);
+    free(catalog->entries[i]->exec);
+    free(catalog->entries[i]);
+  }
+  free(catalog->entries);
+  for (int i = 0; i < catalog->mimeTypeCount; i++) {
+    free(catalog->mimeTypes[i].mimeType);
+  }
+  free(catalog->mimeTypes);
+  for (int i = 0; i < catalog->ruleCount; i++) {
+    free(catalog->rules[i].mimeType);
+    free(catalog->rules[i].id);
+  }
+  free(catalog->rules);
+  for (int i = 0; i < catalog->pathCount; i++) {
+    free(catalog->paths[i].path);
+  }
+  free(catalog->paths);
+  if (catalog->notify >= 0) {
+    close(catalog->notify);
+  }
+  free(catalog->watchKinds);
+  free(catalog);
+}
+
+// Sorts the indexes of a catalog and takes the stamp of its files.
+static void IndexCatalog(Catalog *catalog) {
+  if (catalog->mimeTypeCount > 0) {
+    qsort(catalog->mimeTypes, catalog->mimeTypeCount, 
+          sizeof(CatalogMimeType), CompareCatalogMimeTypes);
+  }
+  if (catalog->ruleCount > 0) {
+    qsort(catalog->rules, catalog->ruleCount, sizeof(CatalogRule), 
+          CompareCatalogRules);
+  }
+  catalog->stamp = GetCatalogStamp(catalog);
+  catalog->checked = time(NULL);
+}
+
+// Reads the catalog from the applications dirs and the mimeapps.list 
+// files. The directories are watched from before they're read, so no 
+// change gets lost.
+static Catalog *LoadCatalog() {
+  char path[PATH_MAX];
+  Catalog *catalog = NewCatalog();
+#ifdef __linux__
+  catalog->notify = inotify_init();
+  if (catalog->notify >= 0) {
+    fcntl(catalog->notify, F_SETFL, O_NONBLOCK);
+    fcntl(catalog->notify, F_SETFD, FD_CLOEXEC);
+  }
+#endif
+
+  CatalogFile *files = NULL;
+  int fileCount = 0;
+  int fileCapacity = 0;
+  for (int i = 0; i < gDataDirCount; i++) {
+    AddCatalogPath(catalog, gDataDirs[i], WATCH_DATA_DIR);
+    WatchCatalogDir(catalog, gDataDirs[i], WATCH_DATA_DIR);
+    snprintf(path, sizeof(path), "%s/applications", gDataDirs[i]);
+    ScanApplicationsDir(catalog, path, "", i, 0, &files, &fileCount, 
+                        &fileCapacity);
+  }
+
+  // only the file of the highest priority dir is read for each id.
+  qsort(files, fileCount, sizeof(CatalogFile), CompareCatalogFiles);
+  catalog->entries = (CatalogEntry **)malloc(
+      (fileCount > 0 ? fileCount : 1) * sizeof(CatalogEntry *));
+  char full[64];
+  char lang[64];
+  GetLocaleNames(full, lang, sizeof(full));
+  for (int i = 0; i < fileCount; i++) {
+    if (i == 0 || strcmp(files[i].id, files[i - 1].id) != 0) {
+      catalog->entries[catalog->entryCount++] 
+          = LoadCatalogEntry(catalog, &files[i], full, lang);
+      AddCatalogPath(catalog, files[i].path, WATCH_NONE);
+    }
+  }
+  for (int i = 0; i < fileCount; i++) {
+    free(files[i].id);
+    free(files[i].path);
+  }
+  free(files);
+
+  RuleData rules;
+  rules.catalog = catalog;
+  rules.file = 0;
+  rules.seq = 0;
+  for (int i = 0; i < gConfigDirCount; i++) {
+    AddCatalogPath(catalog, gConfigDirs[i], WATCH_CONFIG_DIR);
+    WatchCatalogDir(catalog, gConfigDirs[i], WATCH_CONFIG_DIR);
+    snprintf(path, sizeof(path), "%s/mimeapps.list", gConfigDirs[i]);
+    LoadCatalogRules(path, &rules);
+  }
+  for (int i = 0; i < gDataDirCount; i++) {
+    snprintf(path, sizeof(path), "%s/applications/mimeapps.list", 
+             gDataDirs[i]);
+    LoadCatalogRules(path, &rules);
+    snprintf(path, sizeof(path), "%s/applications/defaults.list", 
+             gDataDirs[i]);
+    LoadCatalogRules(path, &rules);
+  }
+
+  IndexCatalog(catalog);
+  return catalog;
+}
+
+// Returns what a catalog depends on besides its files: the locale its 
+// names are translated for, and the data and config dirs.
+static char *GetCatalogKey() {
+  char full[64];
+  char lang[64];
+  GetLocaleNames(full, lang, sizeof(full));
+  size_t size = strlen(full) + 2;
+  for (int i = 0; i < gDataDirCount; i++) {
+    size += strlen(gDataDirs[i]) + 1;
+  }
+  for (int i = 0; i < gConfigDirCount; i++) {
+    size += strlen(gConfigDirs[i]) + 1;
+  }
+  char *key = (char *)malloc(size);
+  strcpy(key, full);
+  for (int i = 0; i < gDataDirCount; i++) {
+    strcat(key, ":");
+    strcat(key, gDataDirs[i]);
+  }
+  strcat(key, "|");
+  for (int i = 0; i < gConfigDirCount; i++) {
+    strcat(key, ":");
+    strcat(key, gConfigDirs[i]);
+  }
+  return key;
+}
+
+static bool GetCatalogCachePath(char *path, size_t size) {
+  const char *cacheHome = getenv("XDG_CACHE_HOME");
+  if (cacheHome != NULL && *cacheHome != '\0') {
+    snprintf(path, size, "%s/jdic/applications.cache", cacheHome);
+    return true;
+  }
+  const char *home = getenv("HOME");
+  if (home == NULL) {
+    return false;
+  }
+  snprintf(path, size, "%s/.cache/jdic/applications.cache", home);
+  return true;
+}
+
+// The cache file, in native byte order, starts with this header. All the
+// offsets are from the start of the file, strings are NUL terminated and
+// offset 0 stands for a NULL string. Each table is an array of uint32s:
+//   paths:      path, kind
+//   entries:    id, name, exec, hidden
+//   mime types: MIME type, entry index, dir index
+//   rules:      MIME type, id, file, kind, position
+struct CatalogCacheHeader {
+  char magic[8];
+  uint32_t size;
+  uint32_t key;
+  uint32_t stampLow;
+  uint32_t stampHigh;
+  uint32_t pathCount;
+  uint32_t paths;
+  uint32_t entryCount;
+  uint32_t entries;
+  uint32_t mimeTypeCount;
+  uint32_t mimeTypes;
+  uint32_t ruleCount;
+  uint32_t rules;
+};
+
+// A growable buffer the cache file is written to.
+struct CacheWriter {
+  char *data;
+  uint32_t size;
+  uint32_t capacity;
+};
+
+static void CacheReserve(CacheWriter *writer, size_t len) {
+  if (writer->size + len > writer->capacity) {
+    while (writer->size + len > writer->capacity) {
+      writer->capacity *= 2;
+    }
+    writer->data = (char *)realloc(writer->data, writer->capacity);
+  }
+}
+
+static uint32_t CacheAddString(CacheWriter *writer, const char *str) {
+  if (str == NULL) {
+    return 0;
+  }
+  size_t len = strlen(str) + 1;
+  CacheReserve(writer, len);
+  uint32_t offset = writer->size;
+  memcpy(writer->data + offset, str, len);
+  writer->size += len;
+  return offset;
+}
+
+// Appends a table of count rows of width uint32s, returning its offset.
+static uint32_t CacheAddTable(CacheWriter *writer, int count, int width) {
+  writer->size = (writer->size + 3) & ~3;
+  CacheReserve(writer, count * width * sizeof(uint32_t));
+  uint32_t offset = writer->size;
+  writer->size += count * width * sizeof(uint32_t);
+  return offset;
+}
+
+static void CacheSet(CacheWriter *writer, uint32_t table, int index, 
+                     uint32_t value) {
+  memcpy(writer->data + table + index * sizeof(uint32_t), &value, 
+         sizeof(value));
+}
+
+static int FindEntryIndex(const Catalog *catalog, const CatalogEntry *entry);
+
+// Lays the catalog out the way the cache file holds it, into a buffer to 
+// be written by SaveCatalogCache(). Sets the buffer to NULL if the cache is
+// disabled.
+static void BuildCatalogCache(const Catalog *catalog, CacheWriter *out) {
+  out->data = NULL;
+  out->size = out->capacity = 0;
+  if (!gCatalogCacheEnabled) {
+    return;
+  }
+
+  CacheWriter writer;
+  writer.capacity = 65536;
+  writer.data = (char *)malloc(writer.capacity);
+  writer.size = CATALOG_CACHE_HEADER_SIZE;
+  memset(writer.data, 0, writer.size);
+
+  CatalogCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CATALOG_CACHE_MAGIC, sizeof(header.magic));
+  char *key = GetCatalogKey();
+  header.key = CacheAddString(&writer, key);
+  free(key);
+  header.stampLow = (uint32_t)(catalog->stamp & 0xffffffffUL);
+  header.stampHigh = (uint32_t)((unsigned long long)catalog->stamp >> 32);
+
+  header.pathCount = catalog->pathCount;
+  header.paths = CacheAddTable(&writer, catalog->pathCount, 2);
+  for (int i = 0; i < catalog->pathCount; i++) {
+    uint32_t str = CacheAddString(&writer, catalog->paths[i].path);
+    CacheSet(&writer, header.paths, i * 2, str);
+    CacheSet(&writer, header.paths, i * 2 + 1, catalog->paths[i].kind);
+  }
+  header.entryCount = catalog->entryCount;
+  header.entries = CacheAddTable(&writer, catalog->entryCount, 4);
+  for (int i = 0; i < catalog->entryCount; i++) {
+    const CatalogEntry *entry = catalog->entries[i];
+    uint32_t id = CacheAddString(&writer, entry->id);
+    uint32_t name = CacheAddString(&writer, entry->name);
+    uint32_t exec = CacheAddString(&writer, entry->exec);
+    CacheSet(&writer, header.entries, i * 4, id);
+    CacheSet(&writer, header.entries, i * 4 + 1, name);
+    CacheSet(&writer, header.entries, i * 4 + 2, exec);
+    CacheSet(&writer, header.entries, i * 4 + 3, entry->hidden);
+  }
+  header.mimeTypeCount = catalog->mimeTypeCount;
+  header.mimeTypes = CacheAddTable(&writer, catalog->mimeTypeCount, 3);
+  for (int i = 0; i < catalog->mimeTypeCount; i++) {
+    const CatalogMimeType *item = &catalog->mimeTypes[i];
+    uint32_t mimeType = CacheAddString(&writer, item->mimeType);
+    CacheSet(&writer, header.mimeTypes, i * 3, mimeType);
+    CacheSet(&writer, header.mimeTypes, i * 3 + 1, 
+             FindEntryIndex(catalog, item->entry));
+    CacheSet(&writer, header.mimeTypes, i * 3 + 2, item->dirIndex);
+  }
+  header.ruleCount = catalog->ruleCount;
+  header.rules = CacheAddTable(&writer, catalog->ruleCount, 5);
+  for (int i = 0; i < catalog->ruleCount; i++) {
+    const CatalogRule *rule = &catalog->rules[i];
+    uint32_t mimeType = CacheAddString(&writer, rule->mimeType);
+    uint32_t id = CacheAddString(&writer, rule->id);
+    CacheSet(&writer, header.rules, i * 5, mimeType);
+    CacheSet(&writer, header.rules, i * 5 + 1, id);
+    CacheSet(&writer, header.rules, i * 5 + 2, rule->file);
+    CacheSet(&writer, header.rules, i * 5 + 3, rule->kind);
+    CacheSet(&writer, header.rules, i * 5 + 4, rule->seq);
+  }
+  header.size = writer.size;
+  memcpy(writer.data, &header, sizeof(header));
+  *out = writer;
+}
+
+// Writes a buffer built by BuildCatalogCache() to the cache file, through
+// a temporary file renamed over it, and frees the buffer. Needs no lock on
+// the catalog.
+static void SaveCatalogCache(CacheWriter *writer) {
+  char path[PATH_MAX];
+  if (writer->data == NULL || !GetCatalogCachePath(path, sizeof(path))) {
+    free(writer->data);
+    writer->data = NULL;
+    return;
+  }
+
+  // create the jdic directory, and the cache dir if it doesn't exist yet.
+  char *slash = strrchr(path, '/');
+  *slash = '\0';
+  char *parent = strrchr(path, '/');
+  if (parent != NULL) {
+    *parent = '\0';
+    mkdir(path, 0700);
+    *parent = '/';
+  }
+  mkdir(path, 0700);
+  *slash = '/';
+
+  char tempPath[PATH_MAX + 16];
+  snprintf(tempPath, sizeof(tempPath), "%s.%ld", path, (long)getpid());
+  // processes may write the cache at the same time, but not the threads of
+  // one process, as they use the same temporary file.
+  pthread_mutex_lock(&gCatalogCacheMutex);
+  int fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd >= 0) {
+    bool written = write(fd, writer->data, writer->size) 
+        == (ssize_t)writer->size;
+    if (close(fd) != 0 || !written || rename(tempPath, path) != 0) {
+      unlink(tempPath);
+    }
+  }
+  pthread_mutex_unlock(&gCatalogCacheMutex);
+  free(writer->data);
+  writer->data = NULL;
+}
+
+// Reads a uint32 of a cache table, 0 if it's outside of the file.
+static uint32_t CacheGet(const unsigned char *data, uint32_t size, 
+                         uint32_t table, uint32_t index) {
+  uint32_t offset = table + index * sizeof(uint32_t);
+  if (offset < table || offset > size - sizeof(uint32_t)) {
+    return 0;
+  }
+  uint32_t value;
+  memcpy(&value, data + offset, sizeof(value));
+  return value;
+}
+
+// Returns a string of the cache file, or NULL if the offset isn't that of
+// a string in the file.
+static const char *CacheGetString(const unsigned char *data, uint32_t size,
+                                  uint32_t offset) {
+  if (offset < CATALOG_CACHE_HEADER_SIZE || offset >= size 
+      || memchr(data + offset, '\0', size - offset) == NULL) {
+    return NULL;
+  }
+  return (const char *)data + offset;
+}
+
+static char *CacheDupString(const unsigned char *data, uint32_t size, 
+                            uint32_t offset) {
+  const char *str = CacheGetString(data, size, offset);
+  return (str != NULL) ? strdup(str) : NULL;
+}
+
+// Reads the catalog from the mapped cache file, or returns NULL if the 
+// file is corrupt or was written for another locale or other dirs. 
+static Catalog *ReadCatalogCache(const unsigned char *data, uint32_t size) {
+  CatalogCacheHeader header;
+  if (size < CATALOG_CACHE_HEADER_SIZE) {
+    return NULL;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.magic, CATALOG_CACHE_MAGIC, sizeof(header.magic)) != 0
+      || header.size != size) {
+    return NULL;
+  }
+  const char *cacheKey = CacheGetString(data, size, header.key);
+  char *key = GetCatalogKey();
+  bool sameKey = cacheKey != NULL && strcmp(cacheKey, key) == 0;
+  free(key);
+  if (!sameKey) {
+    return NULL;
+  }
+
+  Catalog *catalog = NewCatalog();
+  for (uint32_t i = 0; i < header.pathCount; i++) {
+    const char *path = CacheGetString(data, size, 
+        CacheGet(data, size, header.paths, i * 2));
+    if (path == NULL) {
+      FreeCatalog(catalog);
+      return NULL;
+    }
+    AddCatalogPath(catalog, path, 
+                   CacheGet(data, size, header.paths, i * 2 + 1));
+  }
+
+  // entries are stored sorted by id, as the catalog keeps them.
+  if (header.entryCount > size / 16) {
+    FreeCatalog(catalog);
+    return NULL;
+  }
+  catalog->entries = (CatalogEntry **)malloc(
+      (header.entryCount > 0 ? header.entryCount : 1) 
+      * sizeof(CatalogEntry *));
+  for (uint32_t i = 0; i < header.entryCount; i++) {
+    CatalogEntry *entry = (CatalogEntry *)malloc(sizeof(CatalogEntry));
+    entry->id = CacheDupString(data, size, 
+        CacheGet(data, size, header.entries, i * 4));
+    entry->name = CacheDupString(data, size, 
+        CacheGet(data, size, header.entries, i * 4 + 1));
+    entry->exec = CacheDupString(data, size, 
+        CacheGet(data, size, header.entries, i * 4 + 2));
+    entry->hidden = CacheGet(data, size, header.entries, i * 4 + 3);
+    catalog->entries[catalog->entryCount++] = entry;
+    if (entry->id == NULL || (entry->exec == NULL && !entry->hidden)) {
+      FreeCatalog(catalog);
+      return NULL;
+    }
+  }
+  for (uint32_t i = 0; i < header.mimeTypeCount; i++) {
+    const char *mimeType = CacheGetString(data, size, 
+        CacheGet(data, size, header.mimeTypes, i * 3));
+    uint32_t entry = CacheGet(data, size, header.mimeTypes, i * 3 + 1);
+    if (mimeType == NULL || entry >= header.entryCount) {
+      FreeCatalog(catalog);
+      return NULL;
+    }
+    AddCatalogMimeType(catalog, mimeType, catalog->entries[entry],
+                       CacheGet(data, size, header.mimeTypes, i * 3 + 2));
+  }
+  for (uint32_t i = 0; i < header.ruleCount; i++) {
+    const char *mimeType = CacheGetString(data, size, 
+        CacheGet(data, size, header.rules, i * 5));
+    const char *id = CacheGetString(data, size, 
+        CacheGet(data, size, header.rules, i * 5 + 1));
+    if (mimeType == NULL || id == NULL) {
+      FreeCatalog(catalog);
+      return NULL;
+    }
+    AddCatalogRule(catalog, mimeType, id, 
+                   CacheGet(data, size, header.rules, i * 5 + 2),
+                   CacheGet(data, size, header.rules, i * 5 + 3),
+                   CacheGet(data, size, header.rules, i * 5 + 4));
+  }
+  catalog->stamp = ((unsigned long)header.stampLow) 
+      | (unsigned long)((unsigned long long)header.stampHigh << 32);
+  catalog->checked = time(NULL);
+  return catalog;
+}
+
+// Maps the cache file and reads the catalog from it. Sets stale if the 
+// files the catalog was read from have changed since.
+static Catalog *LoadCatalogCache(bool *stale) {
+  char path[PATH_MAX];
+  if (!gCatalogCacheEnabled || !GetCatalogCachePath(path, sizeof(path))) {
+    return NULL;
+  }
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat st;
+  Catalog *catalog = NULL;
+  if (fstat(fd, &st) == 0 && st.st_size > 0 && st.st_size < INT_MAX) {
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      catalog = ReadCatalogCache((const unsigned char *)data, 
+                                 (uint32_t)st.st_size);
+      munmap(data, st.st_size);
+    }
+  }
+  close(fd);
+
+  if (catalog != NULL) {
+    // watch before checking, so no change after the check gets lost.
+    WatchCatalog(catalog);
+    *stale = GetCatalogStamp(catalog) != catalog->stamp;
+  }
+  return catalog;
+}
+
+extern "C" {
+// Reloads the catalog in the background, replacing a stale one read from
+// the cache file.
+static void *RefreshCatalog(void *arg) {
+  Catalog *catalog = LoadCatalog();
+  CacheWriter cache;
+  BuildCatalogCache(catalog, &cache);
+  SaveCatalogCache(&cache);
+
+  pthread_rwlock_wrlock(&gCatalogLock);
+  Catalog *old = gCatalog;
+  gCatalog = catalog;
+  gCatalogRefreshing = 0;
+  pthread_rwlock_unlock(&gCatalogLock);
+
+  FreeCatalog(old);
+  return NULL;
+}
+}
+
+// Returns true if the catalog must be loaded, or may have changed. Called
+// with gCatalogLock locked for reading.
+static bool IsCatalogCheckDue() {
+  if (gCatalog == NULL) {
+    return true;
+  }
+  if (gCatalogRefreshing) {
+    return false;
+  }
+#ifdef __linux__
+  if (gCatalog->notify >= 0) {
+    return ReadCatalogEvents(gCatalog);
+  }
+#endif
+  time_t now = time(NULL);
+  return now - gCatalog->checked >= MIME_DB_CHECK_INTERVAL 
+      || now < gCatalog->checked;
+}
+
+// Loads, reloads or refreshes the catalog. Called with gCatalogLock 
+// locked for writing. A reloaded catalog is laid out into the cache buffer,
+// to be saved once the lock is released; the buffer is NULL otherwise.
+static void UpdateCatalog(CacheWriter *cache) {
+  cache->data = NULL;
+  if (gCatalogRefreshing) {
+    return;
+  }
+  if (gCatalog == NULL) {
+    bool stale = false;
+    gCatalog = LoadCatalogCache(&stale);
+    if (gCatalog != NULL) {
+      if (stale) {
+        pthread_t thread;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        gCatalogRefreshing = 
+            (pthread_create(&thread, &attr, RefreshCatalog, NULL) == 0);
+        pthread_attr_destroy(&attr);
+        if (!gCatalogRefreshing) {
+          FreeCatalog(gCatalog);
+          gCatalog = NULL;
+        }
+      }
+      if (gCatalog != NULL) {
+        return;
+      }
+    }
+  } else if (gCatalog->notify < 0) {
+    gCatalog->checked = time(NULL);
+    if (GetCatalogStamp(gCatalog) == gCatalog->stamp) {
+      return;
+    }
+  }
+
+  if (gCatalog != NULL) {
+    FreeCatalog(gCatalog);
+  }
+  gCatalog = LoadCatalog();
+  BuildCatalogCache(gCatalog, cache);
+}
+
+// Locks the catalog for reading, loading or reloading it first if it has 
+// changed.
+static void LockCatalog() {
+  // the data and config dirs are set up with the MIME database.
+  LockMimeDb();
+  UnlockMimeDb();
+
+  pthread_rwlock_rdlock(&gCatalogLock);
+  if (!IsCatalogCheckDue()) {
+    return;
+  }
+  pthread_rwlock_unlock(&gCatalogLock);
+  pthread_rwlock_wrlock(&gCatalogLock);
+  CacheWriter cache;
+  UpdateCatalog(&cache);
+  pthread_rwlock_unlock(&gCatalogLock);
+  SaveCatalogCache(&cache);
+  pthread_rwlock_rdlock(&gCatalogLock);
+}
+
+static void UnlockCatalog() {
+  pthread_rwlock_unlock(&gCatalogLock);
+}
+
+static CatalogEntry *FindCatalogEntry(const Catalog *catalog, 
+                                      const char *id) {
+  int low = 0;
+  int high = catalog->entryCount - 1;
+  while (low <= high) {
+    int mid = (low + high) / 2;
+    int result = strcmp(catalog->entries[mid]->id, id);
+    if (result == 0) {
+      return catalog->entries[mid];
+    } else if (result < 0) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return NULL;
+}
+
+static int FindEntryIndex(const Catalog *catalog, const CatalogEntry *entry) {
+  int low = 0;
+  int high = catalog->entryCount - 1;
+  while (low <= high) {
+    int mid = (low + high) / 2;
+    int result = strcmp(catalog->entries[mid]->id, entry->id);
+    if (result == 0) {
+      return mid;
+    } else if (result < 0) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return -1;
+}
+
+// Returns the first index of the MIME type in a table sorted by MIME type,
+// whose items start with the MIME type, or the table size if it isn't 
+// there.
+static int FindFirst(const void *table, int count, size_t itemSize, 
+                     const char *mimeType) {
+  int low = 0;
+  int high = count;
+  while (low < high) {
+    int mid = (low + high) / 2;
+    const char *item = *(const char **)((const char *)table + mid * itemSize);
+    if (strcmp(item, mimeType) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+struct EntryList {
+  CatalogEntry **items;
+  int count;
+  int capacity;
+};
+
+// Adds an entry, unless it's hidden, removed or already in the list.
+static void AddApplication(EntryList *apps, CatalogEntry *entry, 
+                           const StringList *removed) {
+  if (entry == NULL || entry->hidden 
+      || StringListContains(removed, entry->id)) {
+    return;
+  }
+  for (int i = 0; i < apps->count; i++) {
+    if (apps->items[i] == entry) {
+      return;
+    }
+  }
+  if (apps->count == apps->capacity) {
+    apps->capacity = (apps->capacity == 0) ? 8 : apps->capacity * 2;
+    apps->items = (CatalogEntry **)realloc(apps->items, 
+        apps->capacity * sizeof(CatalogEntry *));
+  }
+  apps->items[apps->count++] = entry;
+}
+
+// Lists the installed applications for the MIME type, the default one 
+// first: the defaults and additions of the mimeapps.list files in priority
+// order, then the applications listing the MIME type themselves. Removals
+// only affect the files of lower priority, and the applications. Called
+// with gCatalogLock locked.
+static void GetApplications(const Catalog *catalog, const char *mimeType, 
+                            EntryList *apps) {
+  StringList removed;
+  memset(&removed, 0, sizeof(removed));
+
+  const CatalogRule *rules = catalog->rules;
+  int ruleCount = catalog->ruleCount;
+  int i = FindFirst(rules, ruleCount, sizeof(CatalogRule), mimeType);
+  while (i < ruleCount && strcmp(rules[i].mimeType, mimeType) == 0) {
+    // the rules of one file, the removals last.
+    int file = rules[i].file;
+    int fileEnd = i;
+    while (fileEnd < ruleCount && rules[fileEnd].file == file
+           && strcmp(rules[fileEnd].mimeType, mimeType) == 0) {
+      fileEnd++;
+    }
+    for (; i < fileEnd; i++) {
+      if (rules[i].kind == RULE_REMOVED) {
+        StringListAdd(&removed, rules[i].id);
+      } else {
+        AddApplication(apps, FindCatalogEntry(catalog, rules[i].id), 
+                       &removed);
+      }
+    }
+  }
+
+  const CatalogMimeType *mimeTypes = catalog->mimeTypes;
+  i = FindFirst(mimeTypes, catalog->mimeTypeCount, sizeof(CatalogMimeType),
+                mimeType);
+  for (; i < catalog->mimeTypeCount 
+         && strcmp(mimeTypes[i].mimeType, mimeType) == 0; i++) {
+    AddApplication(apps, mimeTypes[i].entry, &removed);
+  }
+  StringListFree(&removed);
+}
+
+// Creates a string array from a list, releasing the element references as
+// it goes.
+static jobjectArray NewStringArray(JNIEnv *env, char **items, int count) {
+  jobjectArray array = env->NewObjectArray(count, 
+                                           env->FindClass("java/lang/String"), 
+                                           NULL);
+  for (int i = 0; i < count; i++) {
+    jstring str = env->NewStringUTF(items[i]);
+    env->SetObjectArrayElement(array, i, str);
+    env->DeleteLocalRef(str);
+  }
+  return array;
+}
+
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_setCacheEnabled
+    (JNIEnv *env, jclass cl, jboolean enabled) {
+  pthread_rwlock_wrlock(&gCatalogLock);
+  gCatalogCacheEnabled = enabled;
+  pthread_rwlock_unlock(&gCatalogLock);
+}
+
+JNIEXPORT jboolean JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_isAvailable
+    (JNIEnv *env, jclass cl) {
+  LockMimeDb();
+  jboolean available = (gCacheCount > 0) ? JNI_TRUE : JNI_FALSE;
+  UnlockMimeDb();
+
+  return available;
+}
+
+JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getDatabaseVersion
+    (JNIEnv *env, jclass cl) {
+  LockMimeDb();
+  jlong version = gMimeDbVersion;
+  UnlockMimeDb();
+
+  return version;
+}
+
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getMimeTypeByFileName
+    (JNIEnv *env, jclass cl, jstring fileName) {
+  const char* fileNameStr = env->GetStringUTFChars(fileName, JNI_FALSE);
+  jstring mimeType = NULL;
+
+  LockMimeDb();
+  bool ambiguous;
+  const char* mimeTypeStr = LookupFileName(fileNameStr, &ambiguous);
+  if (mimeTypeStr != NULL) {
+    mimeType = env->NewStringUTF(mimeTypeStr);
+  }
+  UnlockMimeDb();
+
+  env->ReleaseStringUTFChars(fileName, fileNameStr);
+  return mimeType;
+}
+
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getMimeTypeByExtension
+    (JNIEnv *env, jclass cl, jstring fileExt) {
+  const char* fileExtStr = env->GetStringUTFChars(fileExt, JNI_FALSE);
+  jstring mimeType = NULL;
+
+  // match the extension alone, so literal file names and globs like 
+  // "README*" don't.
+  size_t len = strlen(fileExtStr);
+  char *fileName = (char *)malloc(len + 2);
+  fileName[0] = '.';
+  memcpy(fileName + 1, fileExtStr, len + 1);
+  char *lowerName = AsciiLower(fileName);
+
+  LockMimeDb();
+  bool ambiguous;
+  const char* mimeTypeStr = LookupGlobs(fileName, lowerName, &ambiguous);
+  if (mimeTypeStr != NULL) {
+    mimeType = env->NewStringUTF(mimeTypeStr);
+  }
+  UnlockMimeDb();
+
+  free(lowerName);
+  free(fileName);
+  env->ReleaseStringUTFChars(fileExt, fileExtStr);
+  return mimeType;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getExtensionsByMimeType
+    (JNIEnv *env, jclass cl, jstring mimeType) {
+  const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
+  jobjectArray retArray = NULL;
+
+  LockMimeDb();
+  const char *canonical = UnaliasMimeType(mimeTypeStr);
+  // find the first entry for the MIME type.
+  int min = 0;
+  int max = gExtensionCount;
+  while (min < max) {
+    int mid = (min + max) / 2;
+    if (strcmp(gExtensions[mid].mimeType, canonical) < 0) {
+      min = mid + 1;
+    } else {
+      max = mid;
+    }
+  }
+  StringList exts;
+  memset(&exts, 0, sizeof(exts));
+  for (int i = min; i < gExtensionCount 
+           && strcmp(gExtensions[i].mimeType, canonical) == 0; i++) {
+    StringListAdd(&exts, gExtensions[i].extension);
+  }
+  UnlockMimeDb();
+
+  if (exts.count > 0) {
+    retArray = NewStringArray(env, exts.items, exts.count);
+  }
+  StringListFree(&exts);
+  env->ReleaseStringUTFChars(mimeType, mimeTypeStr);
+  return retArray;
+}
+
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_unaliasMimeType
+    (JNIEnv *env, jclass cl, jstring mimeType) {
+  const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
+  jstring canonical = mimeType;
+
+  LockMimeDb();
+  const char* canonicalStr = UnaliasMimeType(mimeTypeStr);
+  if (canonicalStr != mimeTypeStr) {
+    canonical = env->NewStringUTF(canonicalStr);
+  }
+  UnlockMimeDb();
+
+  env->ReleaseStringUTFChars(mimeType, mimeTypeStr);
+  return canonical;
+}
+
+JNIEXPORT jboolean JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_isMimeTypeKnown
+    (JNIEnv *env, jclass cl, jstring mimeType) {
+  const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
+
+  LockMimeDb();
+  jboolean known = IsKnownMimeType(mimeTypeStr) ? JNI_TRUE : JNI_FALSE;
+  UnlockMimeDb();
+
+  env->ReleaseStringUTFChars(mimeType, mimeTypeStr);
+  return known;
+}
+
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getIconName
+    (JNIEnv *env, jclass cl, jstring mimeType) {
+  const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
+  jstring iconName = NULL;
+
+  LockMimeDb();
+  const char* iconNameStr = LookupIconName(UnaliasMimeType(mimeTypeStr));
+  if (iconNameStr != NULL) {
+    iconName = env->NewStringUTF(iconNameStr);
+  }
+  UnlockMimeDb();
+
+  env->ReleaseStringUTFChars(mimeType, mimeTypeStr);
+  return iconName;
+}
+
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getDescription
+    (JNIEnv *env, jclass cl, jstring mimeType) {
+  const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
+  char *descStr = NULL;
+
+  LockMimeDb();
+  char *canonical = strdup(UnaliasMimeType(mimeTypeStr));
+  UnlockMimeDb();
+
+  // the search paths don't change once set, the files are read unlocked.
+  if (strstr(canonical, "..") == NULL) {
+    char path[PATH_MAX];
+    for (int i = 0; i < gDataDirCount && descStr == NULL; i++) {
+      snprintf(path, sizeof(path), "%s/mime/%s.xml", gDataDirs[i], canonical);
+      descStr = ReadDescription(path);
+    }
+  }
+  free(canonical);
+  env->ReleaseStringUTFChars(mimeType, mimeTypeStr);
+
+  if (descStr == NULL) {
+    return NULL;
+  }
+  jstring desc = env->NewStringUTF(descStr);
+  free(descStr);
+  return desc;
+}
+
+// Lists the applications for the MIME type and, if it's an alias, for the
+// MIME type it stands for.
+static void GetApplicationsUnaliased(const char *mimeType, EntryList *apps) {
+  LockMimeDb();
+  char *canonical = strdup(UnaliasMimeType(mimeType));
+  UnlockMimeDb();
+
+  GetApplications(gCatalog, canonical, apps);
+  if (strcmp(canonical, mimeType) != 0) {
+    GetApplications(gCatalog, mimeType, apps);
+  }
+  free(canonical);
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getApplications
+    (JNIEnv *env, jclass cl, jstring mimeType) {
+  const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
+  jobjectArray retArray = NULL;
+
+  EntryList apps;
+  memset(&apps, 0, sizeof(apps));
+  LockCatalog();
+  GetApplicationsUnaliased(mimeTypeStr, &apps);
+  if (apps.count > 0) {
+    char **ids = (char **)malloc(apps.count * sizeof(char *));
+    for (int i = 0; i < apps.count; i++) {
+      ids[i] = apps.items[i]->id;
+    }
+    retArray = NewStringArray(env, ids, apps.count);
+    free(ids);
+  }
+  UnlockCatalog();
+  free(apps.items);
+
+  env->ReleaseStringUTFChars(mimeType, mimeTypeStr);
+  return retArray;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getApplicationEntries
+    (JNIEnv *env, jclass cl, jstring mimeType) {
+  const char* mimeTypeStr = env->GetStringUTFChars(mimeType, JNI_FALSE);
+  jobjectArray retArray = NULL;
+
+  EntryList apps;
+  memset(&apps, 0, sizeof(apps));
+  LockCatalog();
+  GetApplicationsUnaliased(mimeTypeStr, &apps);
+  if (apps.count > 0) {
+    char **fields = (char **)malloc(apps.count * 3 * sizeof(char *));
+    for (int i = 0; i < apps.count; i++) {
+      CatalogEntry *entry = apps.items[i];
+      fields[i * 3] = entry->id;
+      fields[i * 3 + 1] = (entry->name != NULL) ? entry->name : entry->exec;
+      fields[i * 3 + 2] = entry->exec;
+    }
+    retArray = NewStringArray(env, fields, apps.count * 3);
+    free(fields);
+  }
+  UnlockCatalog();
+  free(apps.items);
+
+  env->ReleaseStringUTFChars(mimeType, mimeTypeStr);
+  return retArray;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getDesktopEntry
+    (JNIEnv *env, jclass cl, jstring desktopId) {
+  const char* desktopIdStr = env->GetStringUTFChars(desktopId, JNI_FALSE);
+  jobjectArray retArray = NULL;
+
+  LockCatalog();
+  CatalogEntry *entry = FindCatalogEntry(gCatalog, desktopIdStr);
+  if (entry != NULL && !entry->hidden) {
+    char *fields[2];
+    fields[0] = (entry->name != NULL) ? entry->name : entry->exec;
+    fields[1] = entry->exec;
+    retArray = NewStringArray(env, fields, 2);
+  }
+  UnlockCatalog();
+
+  env->ReleaseStringUTFChars(desktopId, desktopIdStr);
+  return retArray;
+}
+
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getMimeTypeByFile
+    (JNIEnv *env, jclass cl, jstring path) {
+  const char* pathStr = env->GetStringUTFChars(path, JNI_FALSE);
+  jstring mimeType = NULL;
+
+  LockMimeDb();
+  unsigned char *buffer = (unsigned char *)malloc(GetSniffLength());
+  const char* mimeTypeStr = SniffFile(pathStr, buffer);
+  free(buffer);
+  if (mimeTypeStr != NULL) {
+    mimeType = env->NewStringUTF(mimeTypeStr);
+  }
+  UnlockMimeDb();
+
+  env->ReleaseStringUTFChars(path, pathStr);
+  return mimeType;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getMimeTypesByFiles
+    (JNIEnv *env, jclass cl, jobjectArray paths, jint threadCount) {
+  SniffBatch batch;
+  batch.count = env->GetArrayLength(paths);
+  batch.next = 0;
+  batch.paths = (char **)calloc(batch.count + 1, sizeof(char *));
+  batch.mimeTypes = (const char **)calloc(batch.count + 1, sizeof(char *));
+  pthread_mutex_init(&batch.mutex, NULL);
+  for (int i = 0; i < batch.count; i++) {
+    jstring path = (jstring)env->GetObjectArrayElement(paths, i);
+    if (path != NULL) {
+      const char* pathStr = env->GetStringUTFChars(path, JNI_FALSE);
+      batch.paths[i] = strdup(pathStr);
+      env->ReleaseStringUTFChars(path, pathStr);
+      env->DeleteLocalRef(path);
+    }
+  }
+
+  if (threadCount <= 0) {
+    threadCount = sysconf(_SC_NPROCESSORS_ONLN);
+  }
+  int chunks = (batch.count + SNIFF_CHUNK - 1) / SNIFF_CHUNK;
+  if (threadCount > chunks) {
+    threadCount = chunks;
+  }
+  if (threadCount > MAX_SNIFF_THREADS) {
+    threadCount = MAX_SNIFF_THREADS;
+  }
+
+  // the results point into the MIME database, keep it locked until they 
+  // are copied.
+  LockMimeDb();
+  pthread_t threads[MAX_SNIFF_THREADS];
+  int started = 0;
+  for (int i = 1; i < threadCount; i++) {
+    if (pthread_create(&threads[started], NULL, SniffWorker, &batch) == 0) {
+      started++;
+    }
+  }
+  // the calling thread sniffs too.
+  SniffWorker(&batch);
+  for (int i = 0; i < started; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  jobjectArray retArray = env->NewObjectArray(batch.count, 
+                                              env->FindClass("java/lang/String"), 
+                                              NULL);
+  for (int i = 0; i < batch.count; i++) {
+    if (batch.mimeTypes[i] != NULL) {
+      jstring mimeType = env->NewStringUTF(batch.mimeTypes[i]);
+      env->SetObjectArrayElement(retArray, i, mimeType);
+      env->DeleteLocalRef(mimeType);
+    }
+  }
+  UnlockMimeDb();
+
+  for (int i = 0; i < batch.count; i++) {
+    free(batch.paths[i]);
+  }
+  free(batch.paths);
+  free(batch.mimeTypes);
+  pthread_mutex_destroy(&batch.mutex);
+  return retArray;
+}
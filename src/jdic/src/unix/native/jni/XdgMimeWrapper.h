@@ -0,0 +1,133 @@
+/* DO NOT EDIT THIS FILE - it is machine generated */
+#include <jni.h>
+/* Header for class org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper */
+
+#ifndef _Included_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+#define _Included_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    setCacheEnabled
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_setCacheEnabled
+  (JNIEnv *, jclass, jboolean);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    isAvailable
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_isAvailable
+  (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    getDatabaseVersion
+ * Signature: ()J
+ */
+JNIEXPORT jlong JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getDatabaseVersion
+  (JNIEnv *, jclass);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    getMimeTypeByFileName
+ * Signature: (Ljava/lang/String;)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getMimeTypeByFileName
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    getMimeTypeByExtension
+ * Signature: (Ljava/lang/String;)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getMimeTypeByExtension
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    getExtensionsByMimeType
+ * Signature: (Ljava/lang/String;)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getExtensionsByMimeType
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    unaliasMimeType
+ * Signature: (Ljava/lang/String;)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_unaliasMimeType
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    isMimeTypeKnown
+ * Signature: (Ljava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_isMimeTypeKnown
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    getIconName
+ * Signature: (Ljava/lang/String;)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getIconName
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    getDescription
+ * Signature: (Ljava/lang/String;)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getDescription
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    getApplications
+ * Signature: (Ljava/lang/String;)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getApplications
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    getApplicationEntries
+ * Signature: (Ljava/lang/String;)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getApplicationEntries
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    getDesktopEntry
+ * Signature: (Ljava/lang/String;)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getDesktopEntry
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    getMimeTypeByFile
+ * Signature: (Ljava/lang/String;)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getMimeTypeByFile
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper
+ * Method:    getMimeTypesByFiles
+ * Signature: ([Ljava/lang/String;I)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_org_jdesktop_jdic_filetypes_internal_XdgMimeWrapper_getMimeTypesByFiles
+  (JNIEnv *, jclass, jobjectArray, jint);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -38,8 +38,12 @@
 
 #include "MozEmbed.h"
 #include "MsgServer.h"
+#include "EventStats.h"
+#include "Logger.h"
 #include "Message.h"
 #include "Common.h"
+#include "ContentPolicy.h"
+#include "PostDataStream.h"
 
 // These are included from the Gecko SDK
 #include "prenv.h"
@@ -55,7 +59,6 @@
 // copy of these files.  If these interfaces ever change in the future, then
 // our application may stop working.
 #include "nsIWebNavigation.h"
-#include "nsIStringStream.h"
 
 //-----------------------------------------------------------------------------
 
@@ -329,92 +332,113 @@ set_browser_visibility (GtkBrowser *browser, gboolean visibility)
         gtk_widget_show(browser->topLevelWindow);
 }
 
-void
-OpenURL(GtkBrowser *pBrowser, const char *pUrl, 
-        const char *pPostData, const char *pHeader)
+// Find the browser instance which shows the given top level content window,
+// used by the content policy to apply the rules of that instance.
+int
+GetBrowserInstance(nsIDOMWindow *aTopWindow)
 {
-    nsresult rv;
-    nsCOMPtr<nsIInputStream> postDataStream;
-    nsCOMPtr<nsIInputStream> headersStream;
+    if (!aTopWindow)
+        return -1;
+    for (int i = 0; i < gBrowserArray.GetSize(); i++) {
+        GtkBrowser *pBrowser = (GtkBrowser *)gBrowserArray[i];
+        if (!pBrowser || !pBrowser->mozEmbed)
+            continue;
+        nsCOMPtr<nsIWebBrowser> webBrowser;
+        gtk_moz_embed_get_nsIWebBrowser(GTK_MOZ_EMBED(pBrowser->mozEmbed), 
+                getter_AddRefs(webBrowser));
+        if (!webBrowser)
+            continue;
+        nsCOMPtr<nsIDOMWindow> contentWindow;
+        webBrowser->GetContentDOMWindow(getter_AddRefs(contentWindow));
+        if (contentWindow.get() == aTopWindow)
+            return i;
+    }
+    return -1;
+}
 
-    if (pPostData) 
-    {
-        unsigned long nSizeData = strlen(pPostData);
-        if (nSizeData > 0) 
-        {
-            char szCL[64];
-            sprintf(szCL, "Content-Length: %lu\r\n\r\n", nSizeData);
-            unsigned long nSizeCL = strlen(szCL);
-            unsigned long nSize = nSizeCL + nSizeData;
-
-            // byte stream owns this mem
-            char *tmp = (char *) nsMemory::Alloc(nSize + 1); 
-            if (tmp) 
-            {
-                memcpy(tmp, szCL, nSizeCL);
-                memcpy(tmp + nSizeCL, pPostData, nSizeData);
-                tmp[nSize] = '\0';
-
-                nsCOMPtr<nsIStringInputStream> stream;
-                rv = CreateInstance("@mozilla.org/io/string-input-stream;1",
-                                    NS_GET_IID(nsIStringInputStream),
-                                    getter_AddRefs(stream));
-                if (NS_FAILED(rv) || !stream) 
-                {
-                    NS_ASSERTION(0, "cannot create PostData stream");
-                    nsMemory::Free(tmp);
-                    return;
-                }
-
-                stream->AdoptData(tmp, nSize);
-                postDataStream = do_QueryInterface(stream);
-            }
-        }
+// Render the given area of the browser window into the snapshot buffer of
+// the browser instance. On success the result string is filled with the
+// CEVENT_SNAPSHOT message "<segment name>,<width>,<height>".
+int
+TakeSnapshot(GtkBrowser *pBrowser, int x, int y, int width, int height,
+             char *result)
+{
+    if (!pBrowser->mozEmbed || !pBrowser->mozEmbed->window)
+        return -1;
+    GdkWindow *window = pBrowser->mozEmbed->window;
+
+    int winWidth, winHeight;
+    gdk_window_get_size(window, &winWidth, &winHeight);
+    if (ClipSnapshotRect(winWidth, winHeight, &x, &y, &width, &height) != 0)
+        return -1;
+
+#ifdef MOZ_GTK2X
+    // paint any pending exposures before reading the window back
+    gdk_window_process_updates(window, TRUE);
+    GdkPixbuf *pixbuf = gdk_pixbuf_get_from_drawable(NULL, window,
+        gdk_drawable_get_colormap(window), x, y, 0, 0, width, height);
+    if (!pixbuf)
+        return -1;
+
+    char name[SNAPSHOT_NAME_SIZE];
+    unsigned char *pixels = CreateSnapshotBuffer(pBrowser->id, 
+        width * height * 4, name);
+    if (!pixels) {
+        g_object_unref(pixbuf);
+        return -1;
     }
-    
-    if (pHeader) 
-    {
-        unsigned long nSize = strlen(pHeader) + 1;
-        if (nSize > 0) 
-        {
-            // byteArray stream owns this mem
-            char *tmp = (char *) nsMemory::Alloc(nSize); 
-            if (tmp) 
-            {
-                memcpy(tmp, pHeader, nSize);
-
-                nsCOMPtr<nsIStringInputStream> stream;
-                rv = CreateInstance("@mozilla.org/io/string-input-stream;1",
-                                    NS_GET_IID(nsIStringInputStream),
-                                    getter_AddRefs(stream));
-                if (NS_FAILED(rv) || !stream) 
-                {
-                    NS_ASSERTION(0, "cannot create Header stream");
-                    nsMemory::Free(tmp);
-                    return;
-                }
-
-                stream->AdoptData(tmp, nSize);
-                headersStream = do_QueryInterface(stream);
-            }
+
+    int channels = gdk_pixbuf_get_n_channels(pixbuf);
+    int rowstride = gdk_pixbuf_get_rowstride(pixbuf);
+    guchar *srcPixels = gdk_pixbuf_get_pixels(pixbuf);
+    for (int row = 0; row < height; row++) {
+        guchar *src = srcPixels + row * rowstride;
+        unsigned char *dst = pixels + row * width * 4;
+        for (int col = 0; col < width; col++, src += channels, dst += 4) {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = (channels == 4) ? src[3] : 0xff;
         }
     }
+    g_object_unref(pixbuf);
+#endif /* MOZ_GTK2X */
 
-    nsCOMPtr<nsIWebBrowser> webBrowser;
-    gtk_moz_embed_get_nsIWebBrowser(GTK_MOZ_EMBED(pBrowser->mozEmbed), 
-                                    getter_AddRefs(webBrowser));
-    nsCOMPtr<nsIWebNavigation> webNavigation(do_QueryInterface(webBrowser));
-    if (!webNavigation)
-        return;
+#ifdef MOZ_GTK12
+    GdkVisual *visual = gdk_window_get_visual(window);
+    if (!visual || visual->type != GDK_VISUAL_TRUE_COLOR)
+        return -1;
+    GdkImage *image = gdk_image_get(window, x, y, width, height);
+    if (!image)
+        return -1;
+
+    char name[SNAPSHOT_NAME_SIZE];
+    unsigned char *pixels = CreateSnapshotBuffer(pBrowser->id, 
+        width * height * 4, name);
+    if (!pixels) {
+        gdk_image_destroy(image);
+        return -1;
+    }
 
-    nsEmbedString unicodeUrl;
-    ConvertAsciiToUtf16(pUrl, unicodeUrl);
+    for (int row = 0; row < height; row++) {
+        unsigned char *dst = pixels + row * width * 4;
+        for (int col = 0; col < width; col++, dst += 4) {
+            guint32 pixel = gdk_image_get_pixel(image, col, row);
+            guint32 r = (pixel & visual->red_mask) >> visual->red_shift;
+            guint32 g = (pixel & visual->green_mask) >> visual->green_shift;
+            guint32 b = (pixel & visual->blue_mask) >> visual->blue_shift;
+            // scale each channel up to 8 bits
+            dst[0] = (unsigned char)(r << (8 - visual->red_prec));
+            dst[1] = (unsigned char)(g << (8 - visual->green_prec));
+            dst[2] = (unsigned char)(b << (8 - visual->blue_prec));
+            dst[3] = 0xff;
+        }
+    }
+    gdk_image_destroy(image);
+#endif /* MOZ_GTK12 */
 
-    webNavigation->LoadURI(unicodeUrl.get(), // URI string
-                           nsIWebNavigation::LOAD_FLAGS_NONE, // Load flags
-                           nsnull,                            // Refering URI
-                           postDataStream,                    // Post data
-                           headersStream);                    // Extra headers
+    sprintf(result, "%s,%d,%d", name, width, height);
+    return 0;
 }
 
 void 
@@ -478,6 +502,9 @@ HandleSocketMessage(gpointer data, gpointer user_data)
         }
         break;
     case JEVENT_DESTROYWINDOW:
+        ReleaseSnapshotBuffer(instance);
+        if (GetContentPolicy())
+            GetContentPolicy()->RemoveInstance(instance);
         pBrowser = (GtkBrowser *)gBrowserArray[instance];
         if(pBrowser != NULL){
             gtk_widget_destroy(pBrowser->mozEmbed);
@@ -509,30 +536,22 @@ HandleSocketMessage(gpointer data, gpointer user_data)
         break;
     case JEVENT_NAVIGATE_POST:
         NS_ASSERTION(i == 3, "Wrong message format\n");
+        {
+            // the url, post data and headers are received as a payload.
+            Payload *payload = TakePayload(mMsgString);
+            pBrowser = (GtkBrowser *)gBrowserArray[instance];
+            NS_ASSERTION(pBrowser, "Can't get native browser instance\n");
+            if (!payload || !pBrowser) {
+                FreePayload(payload);
+                break;
+            }
 
-        // Parse the post fields including url, post data and headers.
-        char *urlBuf; 
-		char *postDataBuf;
-		char *headersBuf; 
-
-        ParsePostFields(mMsgString, instance, type, 
-                        &urlBuf, &postDataBuf, &headersBuf);
-
-        char tmpHeadersBuf[2048];
-        memset(tmpHeadersBuf, '\0', 2048);
-        strcpy(tmpHeadersBuf, POST_HEADER);
-        if (strlen(headersBuf) != 0) {
-            strcat(tmpHeadersBuf, headersBuf);
+            nsCOMPtr<nsIWebBrowser> webBrowser;
+            gtk_moz_embed_get_nsIWebBrowser(GTK_MOZ_EMBED(pBrowser->mozEmbed), 
+                                            getter_AddRefs(webBrowser));
+            nsCOMPtr<nsIWebNavigation> webNavigation(do_QueryInterface(webBrowser));
+            LoadPostPayload(webNavigation, payload);
         }
-
-        char* postDataParam;
-        postDataParam = (strlen(postDataBuf) == 0) ? NULL : postDataBuf;
-
-        pBrowser = (GtkBrowser *)gBrowserArray[instance];
-        OpenURL(pBrowser, urlBuf, postDataParam, tmpHeadersBuf);
-        delete [] urlBuf;
-        delete [] postDataBuf;
-        delete [] headersBuf;
         break;
     case JEVENT_GOBACK:
         pBrowser = (GtkBrowser *)gBrowserArray[instance];
@@ -666,6 +685,54 @@ HandleSocketMessage(gpointer data, gpointer user_data)
                 SendSocketMessage(instance, CEVENT_EXECUTESCRIPT, retStr);
         } 
         break;
+    case JEVENT_SNAPSHOT:
+        {
+            NS_ASSERTION(i == 3, "Wrong message format\n");
+            pBrowser = (GtkBrowser *)gBrowserArray[instance];
+            NS_ASSERTION(pBrowser, "Can't get native browser instance\n");
+            int x = 0, y = 0, w = 0, h = 0;
+            sscanf(mMsgString, "%d,%d,%d,%d", &x, &y, &w, &h);
+
+            char result[SNAPSHOT_NAME_SIZE + 32];
+            if (TakeSnapshot(pBrowser, x, y, w, h, result) == 0)
+                SendSocketMessage(instance, CEVENT_SNAPSHOT, result);
+            else
+                SendSocketMessage(instance, CEVENT_SNAPSHOT, "");
+        }
+        break;
+    case JEVENT_ADDCONTENTRULE:
+        NS_ASSERTION(i == 3, "Wrong message format\n");
+        if (GetContentPolicy())
+            GetContentPolicy()->AddRule(instance, mMsgString);
+        break;
+    case JEVENT_CLEARCONTENTRULES:
+        if (GetContentPolicy())
+            GetContentPolicy()->ClearRules(instance);
+        break;
+    case JEVENT_GETBLOCKEDCOUNT:
+        {
+            char counts[RESOURCE_TYPE_COUNT * 12];
+            if (GetContentPolicy()) {
+                GetContentPolicy()->GetBlockedCounts(instance, counts);
+                SendSocketMessage(instance, CEVENT_GETBLOCKEDCOUNT, counts);
+            } else {
+                SendSocketMessage(instance, CEVENT_GETBLOCKEDCOUNT, "");
+            }
+        }
+        break;
+    case JEVENT_PURGECACHES:
+        PurgeCaches();
+        break;
+    case JEVENT_GETSTATS:
+        {
+            char *stats = GetEventStats();
+            SendSocketMessage(instance, CEVENT_GETSTATS, stats);
+            delete [] stats;
+        }
+        break;
+    case JEVENT_SETLOGLEVEL:
+        SetLogLevel(atoi(mMsgString));
+        break;
     }
 }
 
@@ -674,13 +741,16 @@ extern "C" int mozembed_main(int argc, char **argv);
 int
 mozembed_main(int argc, char **argv)
 {
-    if (argc > 1) {
-        if (strstr(argv[1], "-port=")) {
-            int port = atoi(&(argv[1][6]));
+    for (int i = 1; i < argc; i++) {
+        if (strstr(argv[i], "-port=")) {
+            int port = atoi(&(argv[i][6]));
             gMessenger.SetPort(port);
             gMessenger.CreateServerSocket();
         }
-        else if (strcmp(argv[1], "-test") == 0) {
+        else if (strncmp(argv[i], "-budget=", 8) == 0) {
+            SetResourceBudget(&(argv[i][8]));
+        }
+        else if (strcmp(argv[i], "-test") == 0) {
             gTestMode = 1;
         }
     }
@@ -820,7 +890,13 @@ gs_dispatch_cb(GSource    *source,
     gMessageList = NULL;
     PR_Unlock(gMsgLock);
 
-    g_list_foreach(tmpList, HandleSocketMessage, NULL);
+    for (GList *item = tmpList; item != NULL; item = item->next) {
+        int event = GetMessageEvent((const char *)item->data);
+        unsigned long dispatchStart = GetTimeMicros();
+        HandleSocketMessage(item->data, NULL);
+        RecordEventTime(STATS_DISPATCH, event, 
+                        GetTimeMicros() - dispatchStart);
+    }
 
     return TRUE;
 }
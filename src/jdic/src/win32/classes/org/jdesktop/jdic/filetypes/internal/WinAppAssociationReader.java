@@ -65,6 +65,21 @@ public class WinAppAssociationReader implements AppAssociationReader {
         return WinRegistryUtil.getMimeTypeByURL(url);
     }        
 
+    /**
+     * Retrieves the mime types associated with the given URLs.
+     *
+     * @param urls given URLs (not null)
+     * @param threadCount ignored, the URLs are checked on the calling thread
+     * @return the corresponding mime type, or null, of each URL.
+     */
+    public String[] getMimeTypesByURLs(URL[] urls, int threadCount) {
+        String[] mimeTypes = new String[urls.length];
+        for (int i = 0; i < urls.length; i++) {
+            mimeTypes[i] = getMimeTypeByURL(urls[i]);
+        }
+        return mimeTypes;
+    }
+
     /**
      * Retrieves the file extension list associated with the given mime type.
      *
@@ -162,4 +177,13 @@ public class WinAppAssociationReader implements AppAssociationReader {
     public boolean isFileExtExist(String fileExt) {
         return WinRegistryUtil.isFileExtExist(fileExt);
     }
+
+    /**
+     * Returns true, as the Registry may be read from several threads at once.
+     *
+     * @return true
+     */
+    public boolean isThreadSafe() {
+        return true;
+    }
 }
@@ -20,9 +20,12 @@
 
 package org.jdesktop.jdic.filetypes.internal;
 
+import java.util.ArrayList;
 import java.util.Iterator;
 import java.util.List;
 import org.jdesktop.jdic.filetypes.Association;
+import org.jdesktop.jdic.filetypes.AssociationAlreadyRegisteredException;
+import org.jdesktop.jdic.filetypes.AssociationNotRegisteredException;
 import org.jdesktop.jdic.filetypes.RegisterFailedException;
 
 
@@ -502,4 +505,69 @@ public class WinAppAssociationWriter implements AppAssociationWriter {
             throw e;
         }
     }
+
+    /**
+     * Registers the given associations in the specified level. The registry has no
+     * transactions, so the associations are registered one by one, and the ones 
+     * already registered are unregistered again if one fails.
+     * 
+     * @param assocList given associations (not null)
+     * @param regLevel given registry level
+     * @throws AssociationAlreadyRegisteredException if one of the given associations
+     *         already exists.
+     * @throws RegisterFailedException if the operation fails.
+     */
+    public void registerAssociations(List assocList, int regLevel) 
+        throws AssociationAlreadyRegisteredException, RegisterFailedException {
+        Iterator iter = assocList.iterator();
+        while (iter.hasNext()) {
+            if (isAssociationExist((Association) iter.next(), regLevel)) {
+                throw new AssociationAlreadyRegisteredException("Assocation already exists!");
+            }
+        }
+
+        List registered = new ArrayList();
+        try {
+            iter = assocList.iterator();
+            while (iter.hasNext()) {
+                Association assoc = (Association) iter.next();
+                registerAssociation(assoc, regLevel);
+                registered.add(assoc);
+            }
+        } catch (RegisterFailedException e) {
+            iter = registered.iterator();
+            while (iter.hasNext()) {
+                try {
+                    unregisterAssociation((Association) iter.next(), regLevel);
+                } catch (RegisterFailedException ue) {
+                }
+            }
+            throw e;
+        }
+    }
+
+    /**
+     * Unregisters the given associations in the specified level, one by one, after
+     * checking that all of them exist.
+     * 
+     * @param assocList given associations (not null)
+     * @param regLevel given registry level
+     * @throws AssociationNotRegisteredException if one of the given associations
+     *         doesn't exist.
+     * @throws RegisterFailedException if the operation fails.
+     */
+    public void unregisterAssociations(List assocList, int regLevel) 
+        throws AssociationNotRegisteredException, RegisterFailedException {
+        Iterator iter = assocList.iterator();
+        while (iter.hasNext()) {
+            if (!isAssociationExist((Association) iter.next(), regLevel)) {
+                throw new AssociationNotRegisteredException("Assocation not exists!");
+            }
+        }
+
+        iter = assocList.iterator();
+        while (iter.hasNext()) {
+            unregisterAssociation((Association) iter.next(), regLevel);
+        }
+    }
 }
@@ -20,6 +20,8 @@
 #include <Ole2.h>
 #include "stdafx.h"
 #include "MsgServer.h"
+#include "EventStats.h"
+#include "Logger.h"
 #include "BrowserWindow.h"
 #include "resource.h"
 #include "Message.h"
@@ -309,6 +311,7 @@ void CommandProc(char* pInputChar)
 
     case JEVENT_DESTROYWINDOW:
 		LogMsg("IeEmbed:CommandProc:JEVENT_DESTROYWINDOW");
+        ReleaseSnapshotBuffer(instanceNum);
         pBrowserWnd = (BrowserWindow *) ABrowserWnd[instanceNum];
         if(pBrowserWnd != NULL){
             hRes = pBrowserWnd->DispEventUnadvise(pBrowserWnd->m_pWB);
@@ -344,13 +347,10 @@ void CommandProc(char* pInputChar)
 
     case JEVENT_NAVIGATE_POST: 
         {
-            // Parse the post fields including url, post data and headers.
-            char * urlBuf;
-			char * postDataBuf;
-			char * headersBuf;
-
-            ParsePostFields(mMsgString, instanceNum, eventID, 
-                            &urlBuf, &postDataBuf, &headersBuf);
+            // The url, post data and headers are received as a payload.
+            Payload *payload = TakePayload(mMsgString);
+            if (payload == NULL)
+                break;
 
             pBrowserWnd = (BrowserWindow *) ABrowserWnd[instanceNum];
             ATLASSERT(pBrowserWnd != NULL);
@@ -360,20 +360,24 @@ void CommandProc(char* pInputChar)
             // defined as POST_HEADER.
             // Without this header, some Web servers (particularly ASP running 
             // on IIS) will not recognize the post data parameter.       
+            int headersLen = strlen(POST_HEADER) 
+                + payload->mLength[POST_FIELD_HEADERS];
+            char *headersBuf = new char[headersLen + 1];
+            strcpy(headersBuf, POST_HEADER);
+            strcat(headersBuf, payload->mField[POST_FIELD_HEADERS]);
+
+            int wszHeaderLen = MultiByteToWideChar(CP_ACP, 0, headersBuf, -1, 
+                NULL, 0);
+            WCHAR *wszHeader = new WCHAR[wszHeaderLen];
+            MultiByteToWideChar(CP_ACP, 0, headersBuf, -1, wszHeader, 
+                wszHeaderLen);
+            delete [] headersBuf;
+
             BSTR bstrHeaders;
             VARIANT vHeaders;
             VariantInit(&vHeaders);
-
-            char tmpHeadersBuf[2048];
-            memset(tmpHeadersBuf, '\0', 2048);
-            strcpy(tmpHeadersBuf, POST_HEADER);
-            if (strlen(headersBuf) != 0) {
-                strcat(tmpHeadersBuf, headersBuf);
-            }
-            WCHAR wszHeader[2048];
-            MultiByteToWideChar(CP_ACP, 0, tmpHeadersBuf, -1, wszHeader, 2048);
-
             bstrHeaders = SysAllocString(wszHeader);
+            delete [] wszHeader;
 
             V_VT(&vHeaders) = VT_BSTR;
             V_BSTR(&vHeaders) = bstrHeaders;
@@ -384,12 +388,14 @@ void CommandProc(char* pInputChar)
             VARIANT vPostData;
             VariantInit(&vPostData);
 
-            if (strlen(postDataBuf) != 0) {
+            int postDataLen = payload->mLength[POST_FIELD_DATA];
+            if (postDataLen != 0) {
                 // post data is specified.
-                psa = SafeArrayCreateVector(VT_UI1, 0, strlen(postDataBuf));
+                psa = SafeArrayCreateVector(VT_UI1, 0, postDataLen);
                 LPSTR pPostData;
                 SafeArrayAccessData(psa, (LPVOID*)&pPostData);
-                memcpy(pPostData, postDataBuf, strlen(postDataBuf));
+                memcpy(pPostData, payload->mField[POST_FIELD_DATA], 
+                    postDataLen);
                 SafeArrayUnaccessData(psa);
         
                 // Package the SafeArray into a VARIANT.
@@ -398,17 +404,14 @@ void CommandProc(char* pInputChar)
             }
 
             // Navigate to the URL, with the post data and headers.
-            pBrowserWnd->m_pWB->Navigate(CComBSTR(urlBuf), NULL, NULL,
+            pBrowserWnd->m_pWB->Navigate(
+                CComBSTR(payload->mField[POST_FIELD_URL]), NULL, NULL,
                 &vPostData, &vHeaders);
 
-            if (bstrHeaders) {
-                SysFreeString(bstrHeaders);
-            }
+            // VariantClear() frees the header string and the safe array.
             VariantClear(&vHeaders);
             VariantClear(&vPostData);
-            delete [] urlBuf;
-            delete [] postDataBuf;
-            delete [] headersBuf;
+            FreePayload(payload);
             break;
         }
     case JEVENT_GOBACK:
@@ -472,6 +475,40 @@ void CommandProc(char* pInputChar)
         SendSocketMessage(instanceNum, CEVENT_RETURN_URL, W2A(bsUrl));
         SysFreeString(bsUrl);
         break;
+
+    case JEVENT_SNAPSHOT:
+        {
+            pBrowserWnd = (BrowserWindow *) ABrowserWnd[instanceNum];
+            int x = 0, y = 0, w = 0, h = 0;
+            sscanf(mMsgString, "%d,%d,%d,%d", &x, &y, &w, &h);
+
+            char result[SNAPSHOT_NAME_SIZE + 32];
+            if (pBrowserWnd != NULL 
+                && CaptureWindowSnapshot(instanceNum, pBrowserWnd->m_hWnd, 
+                       x, y, w, h, result) == 0)
+                SendSocketMessage(instanceNum, CEVENT_SNAPSHOT, result);
+            else
+                SendSocketMessage(instanceNum, CEVENT_SNAPSHOT, "");
+            break;
+        }
+
+    case JEVENT_GETBLOCKEDCOUNT:
+        // Request filtering is only supported by the Mozilla hosts, answer
+        // anyway as the Java side is waiting for the result.
+        SendSocketMessage(instanceNum, CEVENT_GETBLOCKEDCOUNT, "");
+        break;
+
+    case JEVENT_GETSTATS:
+        {
+        char *stats = GetEventStats();
+        SendSocketMessage(instanceNum, CEVENT_GETSTATS, stats);
+        delete [] stats;
+        }
+        break;
+
+    case JEVENT_SETLOGLEVEL:
+        SetLogLevel(atoi(mMsgString));
+        break;
     }
     delete pInputChar;
     return;
@@ -484,7 +521,14 @@ LRESULT CALLBACK MainWindowProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lPar
     switch (uMsg)
     {
     case WM_SOCKET_MSG:
+        {
+        // CommandProc() frees the message.
+        int event = GetMessageEvent((char*)lParam);
+        unsigned long dispatchStart = GetTimeMicros();
         CommandProc ((char*)lParam);
+        RecordEventTime(STATS_DISPATCH, event, 
+                        GetTimeMicros() - dispatchStart);
+        }
         return 0;
     }
     return DefWindowProc(hWnd, uMsg, wParam, lParam);
@@ -119,6 +119,16 @@ SOURCE=..\..\..\share\native\utils\Util.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\..\share\native\utils\EventStats.cpp
+# SUBTRACT CPP /YX /Yc /Yu
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\..\share\native\utils\Logger.cpp
+# SUBTRACT CPP /YX /Yc /Yu
+# End Source File
+# Begin Source File
+
 SOURCE=.\VariantWrapper.cpp
 # End Source File
 # End Group
@@ -155,6 +165,14 @@ SOURCE=..\..\..\share\native\utils\Util.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\..\share\native\utils\EventStats.h
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\..\share\native\utils\Logger.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\VariantWrapper.h
 # End Source File
 # End Group
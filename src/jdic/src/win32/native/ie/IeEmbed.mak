@@ -48,6 +48,8 @@ CLEAN :
 	-@erase "$(INTDIR)\IeEmbed.res"
 	-@erase "$(INTDIR)\MsgServer.obj"
 	-@erase "$(INTDIR)\StdAfx.obj"
+	-@erase "$(INTDIR)\Logger.obj"
+	-@erase "$(INTDIR)\EventStats.obj"
 	-@erase "$(INTDIR)\Util.obj"
 	-@erase "$(INTDIR)\VariantWrapper.obj"
 	-@erase "$(INTDIR)\vc60.idb"
@@ -73,6 +75,8 @@ LINK32_OBJS= \
 	"$(INTDIR)\IeEmbed.obj" \
 	"$(INTDIR)\MsgServer.obj" \
 	"$(INTDIR)\StdAfx.obj" \
+	"$(INTDIR)\Logger.obj" \
+	"$(INTDIR)\EventStats.obj" \
 	"$(INTDIR)\Util.obj" \
 	"$(INTDIR)\VariantWrapper.obj" \	
 	"$(INTDIR)\IeEmbed.res" \
@@ -107,6 +111,10 @@ CLEAN :
 	-@erase "$(INTDIR)\MsgServer.sbr"
 	-@erase "$(INTDIR)\StdAfx.obj"
 	-@erase "$(INTDIR)\StdAfx.sbr"
+	-@erase "$(INTDIR)\Logger.obj"
+	-@erase "$(INTDIR)\Logger.sbr"
+	-@erase "$(INTDIR)\EventStats.obj"
+	-@erase "$(INTDIR)\EventStats.sbr"
 	-@erase "$(INTDIR)\Util.obj"
 	-@erase "$(INTDIR)\Util.sbr"
 	-@erase "$(INTDIR)\VariantWrapper.obj"
@@ -127,6 +135,8 @@ BSC32_SBRS= \
 	"$(INTDIR)\IeEmbed.sbr" \
 	"$(INTDIR)\MsgServer.sbr" \
 	"$(INTDIR)\StdAfx.sbr" \
+	"$(INTDIR)\Logger.sbr" \
+	"$(INTDIR)\EventStats.sbr" \
 	"$(INTDIR)\Util.sbr" \
 	"$(INTDIR)\VariantWrapper.sbr" \
 	"$(INTDIR)\BrowserFrameWindow.sbr"
@@ -143,6 +153,8 @@ LINK32_OBJS= \
 	"$(INTDIR)\IeEmbed.obj" \
 	"$(INTDIR)\MsgServer.obj" \
 	"$(INTDIR)\StdAfx.obj" \
+	"$(INTDIR)\Logger.obj" \
+	"$(INTDIR)\EventStats.obj" \
 	"$(INTDIR)\Util.obj" \
 	"$(INTDIR)\VariantWrapper.obj" \
 	"$(INTDIR)\IeEmbed.res" \
@@ -321,6 +333,54 @@ CPP_SWITCHES=/nologo /MD /W3 /GX /O1 /I "../../../share/native/utils" /D "NDEBUG
 <<
 
 
+!ENDIF 
+
+SOURCE=..\..\..\share\native\utils\EventStats.cpp
+
+!IF  "$(CFG)" == "IeEmbed - Win32 Debug"
+
+CPP_SWITCHES=/nologo /MDd /W3 /Gm /GX /ZI /Od /I "../../../share/native/utils" /D "_DEBUG" /D "WIN32" /D "_WINDOWS" /D "_MBCS" /D "_AFXDLL" /D "_WIN32_IEEMBED" /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /GZ /c 
+
+"$(INTDIR)\EventStats.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) @<<
+  $(CPP_SWITCHES) $(SOURCE)
+<<
+
+
+!ELSEIF  "$(CFG)" == "IeEmbed - Win32 Release"
+
+CPP_SWITCHES=/nologo /MD /W3 /GX /O1 /I "../../../share/native/utils" /D "NDEBUG" /D "WIN32" /D "_WINDOWS" /D "_MBCS" /D "_AFXDLL" /D "_WIN32_IEEMBED" /FR"$(INTDIR)\\" /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /c 
+
+"$(INTDIR)\EventStats.obj"	"$(INTDIR)\EventStats.sbr" : $(SOURCE) "$(INTDIR)"
+	$(CPP) @<<
+  $(CPP_SWITCHES) $(SOURCE)
+<<
+
+
+!ENDIF 
+
+SOURCE=..\..\..\share\native\utils\Logger.cpp
+
+!IF  "$(CFG)" == "IeEmbed - Win32 Debug"
+
+CPP_SWITCHES=/nologo /MDd /W3 /Gm /GX /ZI /Od /I "../../../share/native/utils" /D "_DEBUG" /D "WIN32" /D "_WINDOWS" /D "_MBCS" /D "_AFXDLL" /D "_WIN32_IEEMBED" /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /GZ /c 
+
+"$(INTDIR)\Logger.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) @<<
+  $(CPP_SWITCHES) $(SOURCE)
+<<
+
+
+!ELSEIF  "$(CFG)" == "IeEmbed - Win32 Release"
+
+CPP_SWITCHES=/nologo /MD /W3 /GX /O1 /I "../../../share/native/utils" /D "NDEBUG" /D "WIN32" /D "_WINDOWS" /D "_MBCS" /D "_AFXDLL" /D "_WIN32_IEEMBED" /FR"$(INTDIR)\\" /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /c 
+
+"$(INTDIR)\Logger.obj"	"$(INTDIR)\Logger.sbr" : $(SOURCE) "$(INTDIR)"
+	$(CPP) @<<
+  $(CPP_SWITCHES) $(SOURCE)
+<<
+
+
 !ENDIF 
 
 SOURCE=.\VariantWrapper.cpp
@@ -84,6 +84,46 @@ JNIEXPORT jint JNICALL Java_org_jdesktop_jdic_browser_WebBrowser_nativeGetWindow
     return (jint)hWnd;
 }
 
+/*
+ * Class:     org_jdesktop_jdic_browser_WebBrowser
+ * Method:    nativeMapSnapshot
+ * Signature: (Ljava/lang/String;I)Ljava/nio/ByteBuffer;
+ */
+JNIEXPORT jobject JNICALL Java_org_jdesktop_jdic_browser_WebBrowser_nativeMapSnapshot
+  (JNIEnv *env, jclass clazz, jstring name, jint size)
+{
+    const char* nameStr = env->GetStringUTFChars(name, NULL);
+    HANDLE hMapping = OpenFileMapping(FILE_MAP_READ, FALSE, nameStr);
+    env->ReleaseStringUTFChars(name, nameStr);
+    if (hMapping == NULL)
+        return NULL;
+
+    // The view keeps the mapping object alive, the handle isn't needed 
+    // any more.
+    void* data = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, size);
+    CloseHandle(hMapping);
+    if (data == NULL)
+        return NULL;
+
+    jobject buffer = env->NewDirectByteBuffer(data, size);
+    if (buffer == NULL)
+        UnmapViewOfFile(data);
+    return buffer;
+}
+
+/*
+ * Class:     org_jdesktop_jdic_browser_WebBrowser
+ * Method:    nativeUnmapSnapshot
+ * Signature: (Ljava/nio/ByteBuffer;)V
+ */
+JNIEXPORT void JNICALL Java_org_jdesktop_jdic_browser_WebBrowser_nativeUnmapSnapshot
+  (JNIEnv *env, jclass clazz, jobject buffer)
+{
+    void* data = env->GetDirectBufferAddress(buffer);
+    if (data != NULL)
+        UnmapViewOfFile(data);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,7 @@
 #include <jawt_md.h>
 #include <jawt.h>
 #include "WebBrowserUtil.h"
+#include "../../../share/native/utils/Logger.h"
 #include <stdlib.h>
 #include <stdio.h>
 #ifdef __cplusplus
@@ -159,6 +160,46 @@ Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeSetEnv
 {
     _putenv("JAVA_PLUGIN_WEBCONTROL_ENABLE=1");
 }
+
+/*
+ * Class:     org_jdesktop_jdic_browser_internal_WebBrowserUtil
+ * Method:    nativeLog
+ * Signature: (ILjava/lang/String;)V
+ */
+JNIEXPORT void JNICALL 
+Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeLog
+  (JNIEnv *env, jclass, jint level, jstring msg)
+{
+    const char *msgChars = env->GetStringUTFChars(msg, NULL);
+    if (msgChars == NULL)
+        return;
+    Log(level, msgChars);
+    env->ReleaseStringUTFChars(msg, msgChars);
+}
+
+/*
+ * Class:     org_jdesktop_jdic_browser_internal_WebBrowserUtil
+ * Method:    nativeGetLogLevel
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL 
+Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeGetLogLevel
+  (JNIEnv *, jclass)
+{
+    return GetLogLevel();
+}
+
+/*
+ * Class:     org_jdesktop_jdic_browser_internal_WebBrowserUtil
+ * Method:    nativeSetLogLevel
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL 
+Java_org_jdesktop_jdic_browser_internal_WebBrowserUtil_nativeSetLogLevel
+  (JNIEnv *, jclass, jint level)
+{
+    SetLogLevel(level);
+}
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
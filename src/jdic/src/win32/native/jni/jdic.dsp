@@ -140,6 +140,21 @@ SOURCE=..\..\..\share\native\utils\InitUtility.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\..\share\native\utils\Logger.cpp
+
+!IF  "$(CFG)" == "jdic - Win32 Release"
+
+!ELSEIF  "$(CFG)" == "jdic - Win32 Debug"
+
+!ELSEIF  "$(CFG)" == "jdic - Win32 Tray"
+
+# PROP Exclude_From_Build 1
+
+!ENDIF 
+
+# End Source File
+# Begin Source File
+
 SOURCE=.\jdic.rc
 # End Source File
 # Begin Source File
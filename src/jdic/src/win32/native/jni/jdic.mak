@@ -38,6 +38,7 @@ ALL : "$(OUTDIR)\jdic.dll"
 
 
 CLEAN :
+	-@erase "$(INTDIR)\Logger.obj"
 	-@erase "$(INTDIR)\InitUtility.obj"
 	-@erase "$(INTDIR)\jdic.res"
 	-@erase "$(INTDIR)\JNIloader.obj"
@@ -97,6 +98,7 @@ BSC32_SBRS= \
 LINK32=link.exe
 LINK32_FLAGS=kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib shlwapi.lib /nologo /dll /incremental:no /pdb:"$(OUTDIR)\jdic.pdb" /machine:I386 /out:"$(OUTDIR)\jdic.dll" /implib:"$(OUTDIR)\jdic.lib" /force:multiple 
 LINK32_OBJS= \
+	"$(INTDIR)\Logger.obj" \
 	"$(INTDIR)\InitUtility.obj" \
 	"$(INTDIR)\JNIloader.obj" \
 	"$(INTDIR)\WebBrowser.obj" \
@@ -122,6 +124,7 @@ ALL : "$(OUTDIR)\jdic.dll"
 
 
 CLEAN :
+	-@erase "$(INTDIR)\Logger.obj"
 	-@erase "$(INTDIR)\InitUtility.obj"
 	-@erase "$(INTDIR)\jdic.res"
 	-@erase "$(INTDIR)\JNIloader.obj"
@@ -184,6 +187,7 @@ BSC32_SBRS= \
 LINK32=link.exe
 LINK32_FLAGS=kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib shlwapi.lib /nologo /dll /incremental:yes /pdb:"$(OUTDIR)\jdic.pdb" /debug /machine:I386 /out:"$(OUTDIR)\jdic.dll" /implib:"$(OUTDIR)\jdic.lib" /pdbtype:sept /force:multiple 
 LINK32_OBJS= \
+	"$(INTDIR)\Logger.obj" \
 	"$(INTDIR)\InitUtility.obj" \
 	"$(INTDIR)\JNIloader.obj" \
 	"$(INTDIR)\WebBrowser.obj" \
@@ -302,6 +306,26 @@ SOURCE=..\..\..\share\native\utils\InitUtility.cpp
 	$(CPP) $(CPP_PROJ) $(SOURCE)
 
 
+!ELSEIF  "$(CFG)" == "jdic - Win32 Tray"
+
+!ENDIF 
+
+SOURCE=..\..\..\share\native\utils\Logger.cpp
+
+!IF  "$(CFG)" == "jdic - Win32 Release"
+
+
+"$(INTDIR)\Logger.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
+!ELSEIF  "$(CFG)" == "jdic - Win32 Debug"
+
+
+"$(INTDIR)\Logger.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
 !ELSEIF  "$(CFG)" == "jdic - Win32 Tray"
 
 !ENDIF 
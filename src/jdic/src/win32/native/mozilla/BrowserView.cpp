@@ -659,84 +659,21 @@ nsresult CBrowserView::GetURL(nsCAutoString &uriString)
         return currentURI->GetSpec(uriString);
 }
 
-void CBrowserView::OpenURL(const char* pUrl, const char* pPostData, const char* pHeader)
+void CBrowserView::OpenURL(const char* pUrl)
 {
-    OpenURL(NS_ConvertASCIItoUCS2(pUrl).get(), pPostData, pHeader);
+    OpenURL(NS_ConvertASCIItoUCS2(pUrl).get());
 }
 
-void CBrowserView::OpenURL(const PRUnichar* pUrl, const char* pPostData, const char* pHeader)
+void CBrowserView::OpenURL(const PRUnichar* pUrl)
 {
     if (! mWebNav)
         return;
 
-    nsresult rv;
-    nsCOMPtr<nsIInputStream> postDataStream;
-    nsCOMPtr<nsIInputStream> headersStream;
-
-    if (pPostData) 
-    {
-        unsigned long nSizeData = strlen(pPostData);
-        if (nSizeData > 0) 
-        {
-            char szCL[64];
-            sprintf(szCL, "Content-Length: %lu\r\n\r\n", nSizeData);
-            unsigned long nSizeCL = strlen(szCL);
-            unsigned long nSize = nSizeCL + nSizeData;
-
-            // byte stream owns this memory.
-            char *tmpPostData = (char *) nsMemory::Alloc(nSize + 1); 
-            if (tmpPostData) 
-            {
-                memcpy(tmpPostData, szCL, nSizeCL);
-                memcpy(tmpPostData + nSizeCL, pPostData, nSizeData);
-                tmpPostData[nSize] = '\0';
-
-                nsCOMPtr<nsIStringInputStream> stream;
-                stream = do_CreateInstance(NS_STRINGINPUTSTREAM_CONTRACTID, &rv);
-                if (NS_FAILED(rv) || !stream) 
-                {
-                    NS_ASSERTION(0, "cannot create PostData stream");
-                    nsMemory::Free(tmpPostData);
-                    return;
-                }
-
-                stream->AdoptData(tmpPostData, nSize);
-                postDataStream = do_QueryInterface(stream);
-            }
-        }
-    }
-    
-    if (pHeader) 
-    {
-        unsigned long nSize = strlen(pHeader) + 1;
-        if (nSize > 0) 
-        {
-            // byteArray stream owns this memory.
-            char *tmpHeader = (char *) nsMemory::Alloc(nSize); 
-            if (tmpHeader) 
-            {
-                memcpy(tmpHeader, pHeader, nSize);
-
-                nsCOMPtr<nsIStringInputStream> stream;
-                stream = do_CreateInstance(NS_STRINGINPUTSTREAM_CONTRACTID, &rv);
-                if (NS_FAILED(rv) || !stream) 
-                {
-                    NS_ASSERTION(0, "cannot create Header stream");
-                    nsMemory::Free(tmpHeader);
-                    return;
-                }
-
-                stream->AdoptData(tmpHeader, nSize);
-                headersStream = do_QueryInterface(stream);
-            }
-        }
-    }
-
     mWebNav->LoadURI(pUrl,                              // URI string
                      nsIWebNavigation::LOAD_FLAGS_NONE, // Load flags
                      nsnull,                            // Refering URI
-                     postDataStream,                    // Post data
-                     headersStream);                    // Extra headers
+                     nsnull,                            // Post data
+                     nsnull);                           // Extra headers
 }
 
 CBrowserFrame* CBrowserView::CreateNewBrowserFrame(
@@ -68,8 +68,8 @@ public:
     HRESULT CreateBrowser();
     HRESULT DestroyBrowser();
     nsresult GetURL(nsCAutoString &uriString);
-    void OpenURL(const char* pUrl, const char* pPostData = NULL, const char* pHeader = NULL);
-    void OpenURL(const PRUnichar* pUrl, const char* pPostData = NULL, const char* pHeader = NULL);
+    void OpenURL(const char* pUrl);
+    void OpenURL(const PRUnichar* pUrl);
     CBrowserFrame* CreateNewBrowserFrame(
                             PRUint32 chromeMask = nsIWebBrowserChrome::CHROME_ALL, 
                             PRInt32 x = -1, PRInt32 y = -1, 
@@ -65,6 +65,10 @@
 #include "prthread.h"
 #include "nsXPCOMGlue.h"
 #include "Common.h"
+#include "ContentPolicy.h"
+#include "PostDataStream.h"
+#include "EventStats.h"
+#include "Logger.h"
 #include "nsEmbedString.h"
 
 #ifdef _DEBUG
@@ -136,6 +140,9 @@ public:
         else if (Substring(flag, 0, 4).Equals("port")) {
             gMessenger.SetPort(atoi(PromiseFlatCString(Substring(flag, 5, flag.Length() - 5)).get()));
         }
+        else if (Substring(flag, 0, 6).Equals("budget")) {
+            SetResourceBudget(PromiseFlatCString(Substring(flag, 7, flag.Length() - 7)).get());
+        }
         // add new flag handlers here (please add a DoFoo() method below!)
     }
 
@@ -167,6 +174,25 @@ MozEmbedApp theApp;
 
 void SocketMsgHandler(const char *pMsg);
 
+// Find the browser instance which shows the given top level content window,
+// used by the content policy to apply the rules of that instance.
+int GetBrowserInstance(nsIDOMWindow *aTopWindow)
+{
+    if (!aTopWindow)
+        return -1;
+    for (int i = 0; i < theApp.m_FrameWndArray.GetSize(); i++) {
+        CBrowserFrame *pBrowserFrame = (CBrowserFrame *)theApp.m_FrameWndArray[i];
+        if (!pBrowserFrame || !pBrowserFrame->m_wndBrowserView.mWebBrowser)
+            continue;
+        nsCOMPtr<nsIDOMWindow> contentWindow;
+        pBrowserFrame->m_wndBrowserView.mWebBrowser->GetContentDOMWindow(
+            getter_AddRefs(contentWindow));
+        if (contentWindow.get() == aTopWindow)
+            return i;
+    }
+    return -1;
+}
+
 MozEmbedApp::MozEmbedApp()
 {
     mRefCnt = 1; // Start at one - nothing is going to addref this object
@@ -272,7 +298,11 @@ BOOL MozEmbedApp::PreTranslateMessage(MSG* pMsg)
         char *p = (char *)pMsg->lParam;
         if (p) {
             WBTRACE("Event from socket: %s\n", p);
+            int event = GetMessageEvent(p);
+            unsigned long dispatchStart = GetTimeMicros();
             MessageReceived(p);
+            RecordEventTime(STATS_DISPATCH, event, 
+                            GetTimeMicros() - dispatchStart);
         }
         else {
             WBTRACE("Wrong Event\n");
@@ -590,8 +620,8 @@ void MozEmbedApp::MessageReceived(const char * msg)
     mMsgString++;
     mMsgString = (char*)strchr(mMsgString, ',');
     mMsgString++;
-    LogMsg("eventMessage:");
-    LogMsg(eventMessage);  //need to visit eventMessage.
+    Log(LOG_DEBUG, "eventMessage:");
+    Log(LOG_DEBUG, eventMessage);  //need to visit eventMessage.
 	delete [] eventMessage;
     switch (eventID) {
     case JEVENT_INIT:
@@ -622,6 +652,9 @@ void MozEmbedApp::MessageReceived(const char * msg)
         }
         break;
     case JEVENT_DESTROYWINDOW:
+        ReleaseSnapshotBuffer(instanceNum);
+        if (GetContentPolicy())
+            GetContentPolicy()->RemoveInstance(instanceNum);
         if( m_FrameWndArray[instanceNum] != NULL){
             ((CBrowserFrame *)m_FrameWndArray[instanceNum])->DestroyBrowserFrame();
             m_FrameWndArray.SetAt(instanceNum, NULL);
@@ -647,29 +680,14 @@ void MozEmbedApp::MessageReceived(const char * msg)
         break;
     case JEVENT_NAVIGATE_POST:
         ASSERT(i == 3);
-		// Parse the post fields including url, post data and headers.
-        char *urlBuf; 
-		char *postDataBuf;
-		char *headersBuf; 
-
-        ParsePostFields(mMsgString, instanceNum, eventID, 
-                        &urlBuf, &postDataBuf, &headersBuf);
-
-        char tmpHeadersBuf[2048];
-        memset(tmpHeadersBuf, '\0', 2048);
-        strcpy(tmpHeadersBuf, POST_HEADER);
-        if (strlen(headersBuf) != 0) {
-            strcat(tmpHeadersBuf, headersBuf);
+        {
+            // the url, post data and headers are received as a payload.
+            Payload *payload = TakePayload(mMsgString);
+            if (payload) {
+                LoadPostPayload(((CBrowserFrame *)m_FrameWndArray[instanceNum])
+                                ->m_wndBrowserView.mWebNav, payload);
+            }
         }
-
-        char* postDataParam;
-        postDataParam = (strlen(postDataBuf) == 0) ? NULL : postDataBuf;
-        
-        ((CBrowserFrame *)m_FrameWndArray[instanceNum])
-            ->m_wndBrowserView.OpenURL(urlBuf, postDataParam, tmpHeadersBuf);
-        delete [] urlBuf;
-        delete [] postDataBuf;
-        delete [] headersBuf;
         break;
     case JEVENT_GOBACK:
         ((CBrowserFrame *)m_FrameWndArray[instanceNum])->m_wndBrowserView.PostMessage(WM_COMMAND, ID_NAV_BACK);
@@ -732,6 +750,54 @@ void MozEmbedApp::MessageReceived(const char * msg)
             SendSocketMessage(instanceNum, CEVENT_EXECUTESCRIPT, retStr);
         }
         break;
+    case JEVENT_SNAPSHOT:
+        {
+        ASSERT(i == 3);
+        int x = 0, y = 0, w = 0, h = 0;
+        sscanf(mMsgString, "%d,%d,%d,%d", &x, &y, &w, &h);
+
+        char result[SNAPSHOT_NAME_SIZE + 32];
+        HWND hWndView = 
+            ((CBrowserFrame *)m_FrameWndArray[instanceNum])->m_wndBrowserView.GetSafeHwnd();
+        if (CaptureWindowSnapshot(instanceNum, hWndView, x, y, w, h, result) == 0)
+            SendSocketMessage(instanceNum, CEVENT_SNAPSHOT, result);
+        else
+            SendSocketMessage(instanceNum, CEVENT_SNAPSHOT, "");
+        }
+        break;
+    case JEVENT_ADDCONTENTRULE:
+        ASSERT(i == 3);
+        if (GetContentPolicy())
+            GetContentPolicy()->AddRule(instanceNum, mMsgString);
+        break;
+    case JEVENT_CLEARCONTENTRULES:
+        if (GetContentPolicy())
+            GetContentPolicy()->ClearRules(instanceNum);
+        break;
+    case JEVENT_GETBLOCKEDCOUNT:
+        {
+        char counts[RESOURCE_TYPE_COUNT * 12];
+        if (GetContentPolicy()) {
+            GetContentPolicy()->GetBlockedCounts(instanceNum, counts);
+            SendSocketMessage(instanceNum, CEVENT_GETBLOCKEDCOUNT, counts);
+        }
+        else
+            SendSocketMessage(instanceNum, CEVENT_GETBLOCKEDCOUNT, "");
+        }
+        break;
+    case JEVENT_PURGECACHES:
+        PurgeCaches();
+        break;
+    case JEVENT_GETSTATS:
+        {
+        char *stats = GetEventStats();
+        SendSocketMessage(instanceNum, CEVENT_GETSTATS, stats);
+        delete [] stats;
+        }
+        break;
+    case JEVENT_SETLOGLEVEL:
+        SetLogLevel(atoi(mMsgString));
+        break;
     }
 }
 
@@ -192,6 +192,16 @@ SOURCE=..\..\..\share\native\mozilla\ProfileDirServiceProvider.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\..\share\native\mozilla\ContentPolicy.cpp
+# SUBTRACT CPP /YX /Yc /Yu
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\..\share\native\mozilla\PostDataStream.cpp
+# SUBTRACT CPP /YX /Yc /Yu
+# End Source File
+# Begin Source File
+
 SOURCE=.\PromptService.cpp
 
 !IF  "$(CFG)" == "MozEmbed - Win32 Release"
@@ -213,6 +223,16 @@ SOURCE=.\StdAfx.cpp
 SOURCE=..\..\..\share\native\utils\Util.cpp
 # SUBTRACT CPP /YX /Yc /Yu
 # End Source File
+# Begin Source File
+
+SOURCE=..\..\..\share\native\utils\EventStats.cpp
+# SUBTRACT CPP /YX /Yc /Yu
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\..\share\native\utils\Logger.cpp
+# SUBTRACT CPP /YX /Yc /Yu
+# End Source File
 # End Group
 # Begin Group "Header Files"
 
@@ -259,6 +279,14 @@ SOURCE=..\..\..\share\native\mozilla\ProfileDirServiceProvider.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\..\share\native\mozilla\ContentPolicy.h
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\..\share\native\mozilla\PostDataStream.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\PromptService.h
 # End Source File
 # Begin Source File
@@ -273,6 +301,14 @@ SOURCE=.\StdAfx.h
 
 SOURCE=..\..\..\share\native\utils\Util.h
 # End Source File
+# Begin Source File
+
+SOURCE=..\..\..\share\native\utils\EventStats.h
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\..\share\native\utils\Logger.h
+# End Source File
 # End Group
 # Begin Group "Resource Files"
 
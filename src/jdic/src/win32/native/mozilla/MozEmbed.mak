@@ -51,9 +51,13 @@ CLEAN :
 	-@erase "$(INTDIR)\MozEmbed.pch"
 	-@erase "$(INTDIR)\MozEmbed.res"
 	-@erase "$(INTDIR)\MsgServer.obj"
+	-@erase "$(INTDIR)\PostDataStream.obj"
+	-@erase "$(INTDIR)\ContentPolicy.obj"
 	-@erase "$(INTDIR)\ProfileDirServiceProvider.obj"
 	-@erase "$(INTDIR)\PromptService.obj"
 	-@erase "$(INTDIR)\StdAfx.obj"
+	-@erase "$(INTDIR)\Logger.obj"
+	-@erase "$(INTDIR)\EventStats.obj"
 	-@erase "$(INTDIR)\Util.obj"
 	-@erase "$(INTDIR)\vc60.idb"
 	-@erase "$(OUTDIR)\MozEmbed.exe"
@@ -80,9 +84,13 @@ LINK32_OBJS= \
 	"$(INTDIR)\Dialogs.obj" \
 	"$(INTDIR)\MozEmbed.obj" \
 	"$(INTDIR)\MsgServer.obj" \
+	"$(INTDIR)\PostDataStream.obj" \
+	"$(INTDIR)\ContentPolicy.obj" \
 	"$(INTDIR)\ProfileDirServiceProvider.obj" \
 	"$(INTDIR)\PromptService.obj" \
 	"$(INTDIR)\StdAfx.obj" \
+	"$(INTDIR)\Logger.obj" \
+	"$(INTDIR)\EventStats.obj" \
 	"$(INTDIR)\Util.obj" \
 	"$(INTDIR)\MozEmbed.res"
 
@@ -121,12 +129,20 @@ CLEAN :
 	-@erase "$(INTDIR)\MozEmbed.sbr"
 	-@erase "$(INTDIR)\MsgServer.obj"
 	-@erase "$(INTDIR)\MsgServer.sbr"
+	-@erase "$(INTDIR)\PostDataStream.obj"
+	-@erase "$(INTDIR)\PostDataStream.sbr"
+	-@erase "$(INTDIR)\ContentPolicy.obj"
+	-@erase "$(INTDIR)\ContentPolicy.sbr"
 	-@erase "$(INTDIR)\ProfileDirServiceProvider.obj"
 	-@erase "$(INTDIR)\ProfileDirServiceProvider.sbr"
 	-@erase "$(INTDIR)\PromptService.obj"
 	-@erase "$(INTDIR)\PromptService.sbr"
 	-@erase "$(INTDIR)\StdAfx.obj"
 	-@erase "$(INTDIR)\StdAfx.sbr"
+	-@erase "$(INTDIR)\Logger.obj"
+	-@erase "$(INTDIR)\Logger.sbr"
+	-@erase "$(INTDIR)\EventStats.obj"
+	-@erase "$(INTDIR)\EventStats.sbr"
 	-@erase "$(INTDIR)\Util.obj"
 	-@erase "$(INTDIR)\Util.sbr"
 	-@erase "$(INTDIR)\vc60.idb"
@@ -154,9 +170,13 @@ BSC32_SBRS= \
 	"$(INTDIR)\Dialogs.sbr" \
 	"$(INTDIR)\MozEmbed.sbr" \
 	"$(INTDIR)\MsgServer.sbr" \
+	"$(INTDIR)\PostDataStream.sbr" \
+	"$(INTDIR)\ContentPolicy.sbr" \
 	"$(INTDIR)\ProfileDirServiceProvider.sbr" \
 	"$(INTDIR)\PromptService.sbr" \
 	"$(INTDIR)\StdAfx.sbr" \
+	"$(INTDIR)\Logger.sbr"
+	"$(INTDIR)\EventStats.sbr"
 	"$(INTDIR)\Util.sbr"
 
 "$(OUTDIR)\MozEmbed.bsc" : "$(OUTDIR)" $(BSC32_SBRS)
@@ -175,9 +195,13 @@ LINK32_OBJS= \
 	"$(INTDIR)\Dialogs.obj" \
 	"$(INTDIR)\MozEmbed.obj" \
 	"$(INTDIR)\MsgServer.obj" \
+	"$(INTDIR)\PostDataStream.obj" \
+	"$(INTDIR)\ContentPolicy.obj" \
 	"$(INTDIR)\ProfileDirServiceProvider.obj" \
 	"$(INTDIR)\PromptService.obj" \
 	"$(INTDIR)\StdAfx.obj" \
+	"$(INTDIR)\Logger.obj" \
+	"$(INTDIR)\EventStats.obj" \
 	"$(INTDIR)\Util.obj" \
 	"$(INTDIR)\MozEmbed.res"
 
@@ -467,6 +491,58 @@ CPP_SWITCHES=/nologo /MDd /W3 /Gm /GX /ZI /Od /I "../../../share/native/mozilla"
 <<
 
 
+!ENDIF 
+
+SOURCE=..\..\..\share\native\mozilla\ContentPolicy.cpp
+
+!IF  "$(CFG)" == "MozEmbed - Win32 Release"
+
+CPP_SWITCHES=/nologo /MD /W3 /GX /O2 /I "../../../share/native/mozilla" /I "../../../share/native/utils" /I "$(MOZILLA_SRC_HOME)/dist/include/xpcom" /I "$(MOZILLA_SRC_HOME)/dist/include/string" /I "$(MOZILLA_SRC_HOME)/dist/include/necko" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrwsr" /I "$(MOZILLA_SRC_HOME)/dist/include/widget" /I "$(MOZILLA_SRC_HOME)/dist/include/dom" /I "$(MOZILLA_SRC_HOME)/dist/include/uriloader" /I "$(MOZILLA_SRC_HOME)/dist/include/embed_base" /I "$(MOZILLA_SRC_HOME)/dist/include/webshell" /I "$(MOZILLA_SRC_HOME)/dist/include/shistory" /I "$(MOZILLA_SRC_HOME)/dist/include/pref" /I "$(MOZILLA_SRC_HOME)/dist/include/profile" /I "$(MOZILLA_SRC_HOME)/dist/include/find" /I "$(MOZILLA_SRC_HOME)/dist/include/gfx" /I "$(MOZILLA_SRC_HOME)/dist/include/windowwatcher" /I "$(MOZILLA_SRC_HOME)/dist/include/layout" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrowserpersist" /I "$(MOZILLA_SRC_HOME)/dist/include/composer" /I "$(MOZILLA_SRC_HOME)/dist/include/commandhandler" /I "$(MOZILLA_SRC_HOME)/dist/include/imglib2" /I "$(MOZILLA_SRC_HOME)/dist/include" /I "$(MOZILLA_SRC_HOME)/dist/include/nspr" /I "$(MOZILLA_SRC_HOME)/dist/include/docshell" /I\
+ "$(MOZILLA_SRC_HOME)/dist/include/embedstring" /D "USE_SINGLE_SIGN_ON" /D HAVE_MMINTRIN_H=1 /D HAVE_SNPRINTF=1 /D _WINDOWS=1 /D _WIN32=1 /D WIN32=1 /D XP_PC=1 /D XP_WIN=1 /D XP_WIN32=1 /D HW_THREADS=1 /D WINVER=0x400 /D MSVC4=1 /D STDC_HEADERS=1 /D NEW_H=<new> /D WIN32_LEAN_AND_MEAN=1 /D NO_X11=1 /D _X86_=1 /D D_INO=d_ino /D MOZ_DEFAULT_TOOLKIT="windows" /D MOZ_ENABLE_COREXFONTS=1 /D IBMBIDI=1 /D ACCESSIBILITY=1 /D MOZ_LOGGING=1 /D DETECT_WEBSHELL_LEAKS=1 /D CPP_THROW_NEW=throw() /D MOZ_XUL=1 /D INCLUDE_XUL=1 /D NS_MT_SUPPORTED=1 /D JS_THREADSAFE=1 /D NS_PRINT_PREVIEW=1 /D NS_PRINTING=1 /D MOZ_REFLOW_PERF=1 /D MOZ_REFLOW_PERF_DSP=1 /D MOZILLA_VERSION=\"1.3\" /D "_MOZILLA_CONFIG_H_" /D "MOZILLA_CLIENT" /D "NDEBUG" /D "WIN32" /D "_WINDOWS" /D "_AFXDLL" /D "_MBCS" /D "XPCOM_GLUE" /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /c 
+
+"$(INTDIR)\ContentPolicy.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) @<<
+  $(CPP_SWITCHES) $(SOURCE)
+<<
+
+
+!ELSEIF  "$(CFG)" == "MozEmbed - Win32 Debug"
+
+CPP_SWITCHES=/nologo /MDd /W3 /Gm /GX /ZI /Od /I "../../../share/native/mozilla" /I "../../../share/native/utils" /I "$(MOZILLA_SRC_HOME)/dist/include/xpcom" /I "$(MOZILLA_SRC_HOME)/dist/include/string" /I "$(MOZILLA_SRC_HOME)/dist/include/necko" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrwsr" /I "$(MOZILLA_SRC_HOME)/dist/include/widget" /I "$(MOZILLA_SRC_HOME)/dist/include/dom" /I "$(MOZILLA_SRC_HOME)/dist/include/uriloader" /I "$(MOZILLA_SRC_HOME)/dist/include/embed_base" /I "$(MOZILLA_SRC_HOME)/dist/include/webshell" /I "$(MOZILLA_SRC_HOME)/dist/include/shistory" /I "$(MOZILLA_SRC_HOME)/dist/include/pref" /I "$(MOZILLA_SRC_HOME)/dist/include/profile" /I "$(MOZILLA_SRC_HOME)/dist/include/find" /I "$(MOZILLA_SRC_HOME)/dist/include/gfx" /I "$(MOZILLA_SRC_HOME)/dist/include/windowwatcher" /I "$(MOZILLA_SRC_HOME)/dist/include/layout" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrowserpersist" /I "$(MOZILLA_SRC_HOME)/dist/include/composer" /I "$(MOZILLA_SRC_HOME)/dist/include/commandhandler" /I "$(MOZILLA_SRC_HOME)/dist/include/imglib2" /I "$(MOZILLA_SRC_HOME)/dist/include" /I "$(MOZILLA_SRC_HOME)/dist/include/nspr" /I "$(MOZILLA_SRC_HOME)/dist/include/docshell" /I\
+ "$(MOZILLA_SRC_HOME)/dist/include/embedstring" /D "_DEBUG" /D "DEBUG" /D "USE_SINGLE_SIGN_ON" /D HAVE_MMINTRIN_H=1 /D HAVE_SNPRINTF=1 /D _WINDOWS=1 /D _WIN32=1 /D WIN32=1 /D XP_PC=1 /D XP_WIN=1 /D XP_WIN32=1 /D HW_THREADS=1 /D WINVER=0x400 /D MSVC4=1 /D STDC_HEADERS=1 /D NEW_H=<new> /D WIN32_LEAN_AND_MEAN=1 /D NO_X11=1 /D _X86_=1 /D D_INO=d_ino /D MOZ_DEFAULT_TOOLKIT="windows" /D MOZ_ENABLE_COREXFONTS=1 /D IBMBIDI=1 /D ACCESSIBILITY=1 /D MOZ_LOGGING=1 /D DETECT_WEBSHELL_LEAKS=1 /D CPP_THROW_NEW=throw() /D MOZ_XUL=1 /D INCLUDE_XUL=1 /D NS_MT_SUPPORTED=1 /D JS_THREADSAFE=1 /D NS_PRINT_PREVIEW=1 /D NS_PRINTING=1 /D MOZ_REFLOW_PERF=1 /D MOZ_REFLOW_PERF_DSP=1 /D MOZILLA_VERSION=\"1.3\" /D "_MOZILLA_CONFIG_H_" /D "MOZILLA_CLIENT" /D "XPCOM_GLUE" /D "WIN32" /D "_WINDOWS" /D "_AFXDLL" /D "_MBCS" /FR"$(INTDIR)\\" /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /I /dist/include/docshell" /GZ " /c 
+
+"$(INTDIR)\ContentPolicy.obj"	"$(INTDIR)\ContentPolicy.sbr" : $(SOURCE) "$(INTDIR)"
+	$(CPP) @<<
+  $(CPP_SWITCHES) $(SOURCE)
+<<
+
+
+!ENDIF 
+
+SOURCE=..\..\..\share\native\mozilla\PostDataStream.cpp
+
+!IF  "$(CFG)" == "MozEmbed - Win32 Release"
+
+CPP_SWITCHES=/nologo /MD /W3 /GX /O2 /I "../../../share/native/mozilla" /I "../../../share/native/utils" /I "$(MOZILLA_SRC_HOME)/dist/include/xpcom" /I "$(MOZILLA_SRC_HOME)/dist/include/string" /I "$(MOZILLA_SRC_HOME)/dist/include/necko" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrwsr" /I "$(MOZILLA_SRC_HOME)/dist/include/widget" /I "$(MOZILLA_SRC_HOME)/dist/include/dom" /I "$(MOZILLA_SRC_HOME)/dist/include/uriloader" /I "$(MOZILLA_SRC_HOME)/dist/include/embed_base" /I "$(MOZILLA_SRC_HOME)/dist/include/webshell" /I "$(MOZILLA_SRC_HOME)/dist/include/shistory" /I "$(MOZILLA_SRC_HOME)/dist/include/pref" /I "$(MOZILLA_SRC_HOME)/dist/include/profile" /I "$(MOZILLA_SRC_HOME)/dist/include/find" /I "$(MOZILLA_SRC_HOME)/dist/include/gfx" /I "$(MOZILLA_SRC_HOME)/dist/include/windowwatcher" /I "$(MOZILLA_SRC_HOME)/dist/include/layout" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrowserpersist" /I "$(MOZILLA_SRC_HOME)/dist/include/composer" /I "$(MOZILLA_SRC_HOME)/dist/include/commandhandler" /I "$(MOZILLA_SRC_HOME)/dist/include/imglib2" /I "$(MOZILLA_SRC_HOME)/dist/include" /I "$(MOZILLA_SRC_HOME)/dist/include/nspr" /I "$(MOZILLA_SRC_HOME)/dist/include/docshell" /I\
+ "$(MOZILLA_SRC_HOME)/dist/include/embedstring" /D "USE_SINGLE_SIGN_ON" /D HAVE_MMINTRIN_H=1 /D HAVE_SNPRINTF=1 /D _WINDOWS=1 /D _WIN32=1 /D WIN32=1 /D XP_PC=1 /D XP_WIN=1 /D XP_WIN32=1 /D HW_THREADS=1 /D WINVER=0x400 /D MSVC4=1 /D STDC_HEADERS=1 /D NEW_H=<new> /D WIN32_LEAN_AND_MEAN=1 /D NO_X11=1 /D _X86_=1 /D D_INO=d_ino /D MOZ_DEFAULT_TOOLKIT="windows" /D MOZ_ENABLE_COREXFONTS=1 /D IBMBIDI=1 /D ACCESSIBILITY=1 /D MOZ_LOGGING=1 /D DETECT_WEBSHELL_LEAKS=1 /D CPP_THROW_NEW=throw() /D MOZ_XUL=1 /D INCLUDE_XUL=1 /D NS_MT_SUPPORTED=1 /D JS_THREADSAFE=1 /D NS_PRINT_PREVIEW=1 /D NS_PRINTING=1 /D MOZ_REFLOW_PERF=1 /D MOZ_REFLOW_PERF_DSP=1 /D MOZILLA_VERSION=\"1.3\" /D "_MOZILLA_CONFIG_H_" /D "MOZILLA_CLIENT" /D "NDEBUG" /D "WIN32" /D "_WINDOWS" /D "_AFXDLL" /D "_MBCS" /D "XPCOM_GLUE" /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /c 
+
+"$(INTDIR)\PostDataStream.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) @<<
+  $(CPP_SWITCHES) $(SOURCE)
+<<
+
+
+!ELSEIF  "$(CFG)" == "MozEmbed - Win32 Debug"
+
+CPP_SWITCHES=/nologo /MDd /W3 /Gm /GX /ZI /Od /I "../../../share/native/mozilla" /I "../../../share/native/utils" /I "$(MOZILLA_SRC_HOME)/dist/include/xpcom" /I "$(MOZILLA_SRC_HOME)/dist/include/string" /I "$(MOZILLA_SRC_HOME)/dist/include/necko" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrwsr" /I "$(MOZILLA_SRC_HOME)/dist/include/widget" /I "$(MOZILLA_SRC_HOME)/dist/include/dom" /I "$(MOZILLA_SRC_HOME)/dist/include/uriloader" /I "$(MOZILLA_SRC_HOME)/dist/include/embed_base" /I "$(MOZILLA_SRC_HOME)/dist/include/webshell" /I "$(MOZILLA_SRC_HOME)/dist/include/shistory" /I "$(MOZILLA_SRC_HOME)/dist/include/pref" /I "$(MOZILLA_SRC_HOME)/dist/include/profile" /I "$(MOZILLA_SRC_HOME)/dist/include/find" /I "$(MOZILLA_SRC_HOME)/dist/include/gfx" /I "$(MOZILLA_SRC_HOME)/dist/include/windowwatcher" /I "$(MOZILLA_SRC_HOME)/dist/include/layout" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrowserpersist" /I "$(MOZILLA_SRC_HOME)/dist/include/composer" /I "$(MOZILLA_SRC_HOME)/dist/include/commandhandler" /I "$(MOZILLA_SRC_HOME)/dist/include/imglib2" /I "$(MOZILLA_SRC_HOME)/dist/include" /I "$(MOZILLA_SRC_HOME)/dist/include/nspr" /I "$(MOZILLA_SRC_HOME)/dist/include/docshell" /I\
+ "$(MOZILLA_SRC_HOME)/dist/include/embedstring" /D "_DEBUG" /D "DEBUG" /D "USE_SINGLE_SIGN_ON" /D HAVE_MMINTRIN_H=1 /D HAVE_SNPRINTF=1 /D _WINDOWS=1 /D _WIN32=1 /D WIN32=1 /D XP_PC=1 /D XP_WIN=1 /D XP_WIN32=1 /D HW_THREADS=1 /D WINVER=0x400 /D MSVC4=1 /D STDC_HEADERS=1 /D NEW_H=<new> /D WIN32_LEAN_AND_MEAN=1 /D NO_X11=1 /D _X86_=1 /D D_INO=d_ino /D MOZ_DEFAULT_TOOLKIT="windows" /D MOZ_ENABLE_COREXFONTS=1 /D IBMBIDI=1 /D ACCESSIBILITY=1 /D MOZ_LOGGING=1 /D DETECT_WEBSHELL_LEAKS=1 /D CPP_THROW_NEW=throw() /D MOZ_XUL=1 /D INCLUDE_XUL=1 /D NS_MT_SUPPORTED=1 /D JS_THREADSAFE=1 /D NS_PRINT_PREVIEW=1 /D NS_PRINTING=1 /D MOZ_REFLOW_PERF=1 /D MOZ_REFLOW_PERF_DSP=1 /D MOZILLA_VERSION=\"1.3\" /D "_MOZILLA_CONFIG_H_" /D "MOZILLA_CLIENT" /D "XPCOM_GLUE" /D "WIN32" /D "_WINDOWS" /D "_AFXDLL" /D "_MBCS" /FR"$(INTDIR)\\" /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /I /dist/include/docshell" /GZ " /c 
+
+"$(INTDIR)\PostDataStream.obj"	"$(INTDIR)\PostDataStream.sbr" : $(SOURCE) "$(INTDIR)"
+	$(CPP) @<<
+  $(CPP_SWITCHES) $(SOURCE)
+<<
+
+
 !ENDIF 
 
 SOURCE=.\PromptService.cpp
@@ -545,6 +621,58 @@ CPP_SWITCHES=/nologo /MDd /W3 /Gm /GX /ZI /Od /I "../../../share/native/mozilla"
 <<
 
 
+!ENDIF 
+
+SOURCE=..\..\..\share\native\utils\EventStats.cpp
+
+!IF  "$(CFG)" == "MozEmbed - Win32 Release"
+
+CPP_SWITCHES=/nologo /MD /W3 /GX /O2 /I "../../../share/native/mozilla" /I "../../../share/native/utils" /I "$(MOZILLA_SRC_HOME)/dist/include/xpcom" /I "$(MOZILLA_SRC_HOME)/dist/include/string" /I "$(MOZILLA_SRC_HOME)/dist/include/necko" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrwsr" /I "$(MOZILLA_SRC_HOME)/dist/include/widget" /I "$(MOZILLA_SRC_HOME)/dist/include/dom" /I "$(MOZILLA_SRC_HOME)/dist/include/uriloader" /I "$(MOZILLA_SRC_HOME)/dist/include/embed_base" /I "$(MOZILLA_SRC_HOME)/dist/include/webshell" /I "$(MOZILLA_SRC_HOME)/dist/include/shistory" /I "$(MOZILLA_SRC_HOME)/dist/include/pref" /I "$(MOZILLA_SRC_HOME)/dist/include/profile" /I "$(MOZILLA_SRC_HOME)/dist/include/find" /I "$(MOZILLA_SRC_HOME)/dist/include/gfx" /I "$(MOZILLA_SRC_HOME)/dist/include/windowwatcher" /I "$(MOZILLA_SRC_HOME)/dist/include/layout" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrowserpersist" /I "$(MOZILLA_SRC_HOME)/dist/include/composer" /I "$(MOZILLA_SRC_HOME)/dist/include/commandhandler" /I "$(MOZILLA_SRC_HOME)/dist/include/imglib2" /I "$(MOZILLA_SRC_HOME)/dist/include" /I "$(MOZILLA_SRC_HOME)/dist/include/nspr" /I "$(MOZILLA_SRC_HOME)/dist/include/docshell" /I\
+ "$(MOZILLA_SRC_HOME)/dist/include/embedstring" /D "USE_SINGLE_SIGN_ON" /D HAVE_MMINTRIN_H=1 /D HAVE_SNPRINTF=1 /D _WINDOWS=1 /D _WIN32=1 /D WIN32=1 /D XP_PC=1 /D XP_WIN=1 /D XP_WIN32=1 /D HW_THREADS=1 /D WINVER=0x400 /D MSVC4=1 /D STDC_HEADERS=1 /D NEW_H=<new> /D WIN32_LEAN_AND_MEAN=1 /D NO_X11=1 /D _X86_=1 /D D_INO=d_ino /D MOZ_DEFAULT_TOOLKIT="windows" /D MOZ_ENABLE_COREXFONTS=1 /D IBMBIDI=1 /D ACCESSIBILITY=1 /D MOZ_LOGGING=1 /D DETECT_WEBSHELL_LEAKS=1 /D CPP_THROW_NEW=throw() /D MOZ_XUL=1 /D INCLUDE_XUL=1 /D NS_MT_SUPPORTED=1 /D JS_THREADSAFE=1 /D NS_PRINT_PREVIEW=1 /D NS_PRINTING=1 /D MOZ_REFLOW_PERF=1 /D MOZ_REFLOW_PERF_DSP=1 /D MOZILLA_VERSION=\"1.3\" /D "_MOZILLA_CONFIG_H_" /D "MOZILLA_CLIENT" /D "NDEBUG" /D "WIN32" /D "_WINDOWS" /D "_AFXDLL" /D "_MBCS" /D "XPCOM_GLUE" /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /c 
+
+"$(INTDIR)\EventStats.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) @<<
+  $(CPP_SWITCHES) $(SOURCE)
+<<
+
+
+!ELSEIF  "$(CFG)" == "MozEmbed - Win32 Debug"
+
+CPP_SWITCHES=/nologo /MDd /W3 /Gm /GX /ZI /Od /I "../../../share/native/mozilla" /I "../../../share/native/utils" /I "$(MOZILLA_SRC_HOME)/dist/include/xpcom" /I "$(MOZILLA_SRC_HOME)/dist/include/string" /I "$(MOZILLA_SRC_HOME)/dist/include/necko" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrwsr" /I "$(MOZILLA_SRC_HOME)/dist/include/widget" /I "$(MOZILLA_SRC_HOME)/dist/include/dom" /I "$(MOZILLA_SRC_HOME)/dist/include/uriloader" /I "$(MOZILLA_SRC_HOME)/dist/include/embed_base" /I "$(MOZILLA_SRC_HOME)/dist/include/webshell" /I "$(MOZILLA_SRC_HOME)/dist/include/shistory" /I "$(MOZILLA_SRC_HOME)/dist/include/pref" /I "$(MOZILLA_SRC_HOME)/dist/include/profile" /I "$(MOZILLA_SRC_HOME)/dist/include/find" /I "$(MOZILLA_SRC_HOME)/dist/include/gfx" /I "$(MOZILLA_SRC_HOME)/dist/include/windowwatcher" /I "$(MOZILLA_SRC_HOME)/dist/include/layout" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrowserpersist" /I "$(MOZILLA_SRC_HOME)/dist/include/composer" /I "$(MOZILLA_SRC_HOME)/dist/include/commandhandler" /I "$(MOZILLA_SRC_HOME)/dist/include/imglib2" /I "$(MOZILLA_SRC_HOME)/dist/include" /I "$(MOZILLA_SRC_HOME)/dist/include/nspr" /I "$(MOZILLA_SRC_HOME)/dist/include/docshell" /I\
+ "$(MOZILLA_SRC_HOME)/dist/include/embedstring" /D "_DEBUG" /D "DEBUG" /D "USE_SINGLE_SIGN_ON" /D HAVE_MMINTRIN_H=1 /D HAVE_SNPRINTF=1 /D _WINDOWS=1 /D _WIN32=1 /D WIN32=1 /D XP_PC=1 /D XP_WIN=1 /D XP_WIN32=1 /D HW_THREADS=1 /D WINVER=0x400 /D MSVC4=1 /D STDC_HEADERS=1 /D NEW_H=<new> /D WIN32_LEAN_AND_MEAN=1 /D NO_X11=1 /D _X86_=1 /D D_INO=d_ino /D MOZ_DEFAULT_TOOLKIT="windows" /D MOZ_ENABLE_COREXFONTS=1 /D IBMBIDI=1 /D ACCESSIBILITY=1 /D MOZ_LOGGING=1 /D DETECT_WEBSHELL_LEAKS=1 /D CPP_THROW_NEW=throw() /D MOZ_XUL=1 /D INCLUDE_XUL=1 /D NS_MT_SUPPORTED=1 /D JS_THREADSAFE=1 /D NS_PRINT_PREVIEW=1 /D NS_PRINTING=1 /D MOZ_REFLOW_PERF=1 /D MOZ_REFLOW_PERF_DSP=1 /D MOZILLA_VERSION=\"1.3\" /D "_MOZILLA_CONFIG_H_" /D "MOZILLA_CLIENT" /D "XPCOM_GLUE" /D "WIN32" /D "_WINDOWS" /D "_AFXDLL" /D "_MBCS" /FR"$(INTDIR)\\" /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /I /dist/include/docshell" /GZ " /c 
+
+"$(INTDIR)\EventStats.obj"	"$(INTDIR)\EventStats.sbr" : $(SOURCE) "$(INTDIR)"
+	$(CPP) @<<
+  $(CPP_SWITCHES) $(SOURCE)
+<<
+
+
+!ENDIF 
+
+SOURCE=..\..\..\share\native\utils\Logger.cpp
+
+!IF  "$(CFG)" == "MozEmbed - Win32 Release"
+
+CPP_SWITCHES=/nologo /MD /W3 /GX /O2 /I "../../../share/native/mozilla" /I "../../../share/native/utils" /I "$(MOZILLA_SRC_HOME)/dist/include/xpcom" /I "$(MOZILLA_SRC_HOME)/dist/include/string" /I "$(MOZILLA_SRC_HOME)/dist/include/necko" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrwsr" /I "$(MOZILLA_SRC_HOME)/dist/include/widget" /I "$(MOZILLA_SRC_HOME)/dist/include/dom" /I "$(MOZILLA_SRC_HOME)/dist/include/uriloader" /I "$(MOZILLA_SRC_HOME)/dist/include/embed_base" /I "$(MOZILLA_SRC_HOME)/dist/include/webshell" /I "$(MOZILLA_SRC_HOME)/dist/include/shistory" /I "$(MOZILLA_SRC_HOME)/dist/include/pref" /I "$(MOZILLA_SRC_HOME)/dist/include/profile" /I "$(MOZILLA_SRC_HOME)/dist/include/find" /I "$(MOZILLA_SRC_HOME)/dist/include/gfx" /I "$(MOZILLA_SRC_HOME)/dist/include/windowwatcher" /I "$(MOZILLA_SRC_HOME)/dist/include/layout" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrowserpersist" /I "$(MOZILLA_SRC_HOME)/dist/include/composer" /I "$(MOZILLA_SRC_HOME)/dist/include/commandhandler" /I "$(MOZILLA_SRC_HOME)/dist/include/imglib2" /I "$(MOZILLA_SRC_HOME)/dist/include" /I "$(MOZILLA_SRC_HOME)/dist/include/nspr" /I "$(MOZILLA_SRC_HOME)/dist/include/docshell" /I\
+ "$(MOZILLA_SRC_HOME)/dist/include/embedstring" /D "USE_SINGLE_SIGN_ON" /D HAVE_MMINTRIN_H=1 /D HAVE_SNPRINTF=1 /D _WINDOWS=1 /D _WIN32=1 /D WIN32=1 /D XP_PC=1 /D XP_WIN=1 /D XP_WIN32=1 /D HW_THREADS=1 /D WINVER=0x400 /D MSVC4=1 /D STDC_HEADERS=1 /D NEW_H=<new> /D WIN32_LEAN_AND_MEAN=1 /D NO_X11=1 /D _X86_=1 /D D_INO=d_ino /D MOZ_DEFAULT_TOOLKIT="windows" /D MOZ_ENABLE_COREXFONTS=1 /D IBMBIDI=1 /D ACCESSIBILITY=1 /D MOZ_LOGGING=1 /D DETECT_WEBSHELL_LEAKS=1 /D CPP_THROW_NEW=throw() /D MOZ_XUL=1 /D INCLUDE_XUL=1 /D NS_MT_SUPPORTED=1 /D JS_THREADSAFE=1 /D NS_PRINT_PREVIEW=1 /D NS_PRINTING=1 /D MOZ_REFLOW_PERF=1 /D MOZ_REFLOW_PERF_DSP=1 /D MOZILLA_VERSION=\"1.3\" /D "_MOZILLA_CONFIG_H_" /D "MOZILLA_CLIENT" /D "NDEBUG" /D "WIN32" /D "_WINDOWS" /D "_AFXDLL" /D "_MBCS" /D "XPCOM_GLUE" /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /c 
+
+"$(INTDIR)\Logger.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) @<<
+  $(CPP_SWITCHES) $(SOURCE)
+<<
+
+
+!ELSEIF  "$(CFG)" == "MozEmbed - Win32 Debug"
+
+CPP_SWITCHES=/nologo /MDd /W3 /Gm /GX /ZI /Od /I "../../../share/native/mozilla" /I "../../../share/native/utils" /I "$(MOZILLA_SRC_HOME)/dist/include/xpcom" /I "$(MOZILLA_SRC_HOME)/dist/include/string" /I "$(MOZILLA_SRC_HOME)/dist/include/necko" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrwsr" /I "$(MOZILLA_SRC_HOME)/dist/include/widget" /I "$(MOZILLA_SRC_HOME)/dist/include/dom" /I "$(MOZILLA_SRC_HOME)/dist/include/uriloader" /I "$(MOZILLA_SRC_HOME)/dist/include/embed_base" /I "$(MOZILLA_SRC_HOME)/dist/include/webshell" /I "$(MOZILLA_SRC_HOME)/dist/include/shistory" /I "$(MOZILLA_SRC_HOME)/dist/include/pref" /I "$(MOZILLA_SRC_HOME)/dist/include/profile" /I "$(MOZILLA_SRC_HOME)/dist/include/find" /I "$(MOZILLA_SRC_HOME)/dist/include/gfx" /I "$(MOZILLA_SRC_HOME)/dist/include/windowwatcher" /I "$(MOZILLA_SRC_HOME)/dist/include/layout" /I "$(MOZILLA_SRC_HOME)/dist/include/webbrowserpersist" /I "$(MOZILLA_SRC_HOME)/dist/include/composer" /I "$(MOZILLA_SRC_HOME)/dist/include/commandhandler" /I "$(MOZILLA_SRC_HOME)/dist/include/imglib2" /I "$(MOZILLA_SRC_HOME)/dist/include" /I "$(MOZILLA_SRC_HOME)/dist/include/nspr" /I "$(MOZILLA_SRC_HOME)/dist/include/docshell" /I\
+ "$(MOZILLA_SRC_HOME)/dist/include/embedstring" /D "_DEBUG" /D "DEBUG" /D "USE_SINGLE_SIGN_ON" /D HAVE_MMINTRIN_H=1 /D HAVE_SNPRINTF=1 /D _WINDOWS=1 /D _WIN32=1 /D WIN32=1 /D XP_PC=1 /D XP_WIN=1 /D XP_WIN32=1 /D HW_THREADS=1 /D WINVER=0x400 /D MSVC4=1 /D STDC_HEADERS=1 /D NEW_H=<new> /D WIN32_LEAN_AND_MEAN=1 /D NO_X11=1 /D _X86_=1 /D D_INO=d_ino /D MOZ_DEFAULT_TOOLKIT="windows" /D MOZ_ENABLE_COREXFONTS=1 /D IBMBIDI=1 /D ACCESSIBILITY=1 /D MOZ_LOGGING=1 /D DETECT_WEBSHELL_LEAKS=1 /D CPP_THROW_NEW=throw() /D MOZ_XUL=1 /D INCLUDE_XUL=1 /D NS_MT_SUPPORTED=1 /D JS_THREADSAFE=1 /D NS_PRINT_PREVIEW=1 /D NS_PRINTING=1 /D MOZ_REFLOW_PERF=1 /D MOZ_REFLOW_PERF_DSP=1 /D MOZILLA_VERSION=\"1.3\" /D "_MOZILLA_CONFIG_H_" /D "MOZILLA_CLIENT" /D "XPCOM_GLUE" /D "WIN32" /D "_WINDOWS" /D "_AFXDLL" /D "_MBCS" /FR"$(INTDIR)\\" /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /I /dist/include/docshell" /GZ " /c 
+
+"$(INTDIR)\Logger.obj"	"$(INTDIR)\Logger.sbr" : $(SOURCE) "$(INTDIR)"
+	$(CPP) @<<
+  $(CPP_SWITCHES) $(SOURCE)
+<<
+
+
 !ENDIF 
 
 